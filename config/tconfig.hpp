@@ -30,7 +30,20 @@
 #endif
 
 #define MFEM_TEMPLATE_BLOCK_SIZE 4
+
+// --- MFEM_SIMD_SIZE: the width of the SIMD values in bytes, 32 by default
+// (as before the SIMD types in linalg/simd.hpp), or 64 with AVX-512. Without
+// AVX, the 4-lane AutoSIMD<double,4> uses the generic implementation, which
+// the compilers vectorize with pairs of SSE2 instructions. Keeping 32 as the
+// minimum also keeps the padding of MFEM_ALIGN_SIZE independent of the target.
+#ifndef MFEM_SIMD_SIZE
+#if defined(__AVX512F__)
+#define MFEM_SIMD_SIZE 64
+#else
 #define MFEM_SIMD_SIZE 32
+#endif
+#endif
+
 #define MFEM_TEMPLATE_ENABLE_SERIALIZE
 
 // #define MFEM_TEMPLATE_ELTRANS_HAS_NODE_DOFS
@@ -47,7 +60,9 @@ namespace mfem
 {
 namespace internal
 {
-long long flop_count;
+// Defined in general/globals.cpp, so that this file can be included in several
+// translation units.
+extern long long flop_count;
 }
 }
 
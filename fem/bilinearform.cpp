@@ -17,18 +17,86 @@
 namespace mfem
 {
 
+// Build the table of the element vdofs of fes, without their signs.
+static void GetElementToVDofTable(const FiniteElementSpace &fes, Table &el_vdof)
+{
+   const int ne = fes.GetNE();
+   Array<int> vdofs;
+   el_vdof.MakeI(ne);
+   for (int i = 0; i < ne; i++)
+   {
+      fes.GetElementVDofs(i, vdofs);
+      el_vdof.AddColumnsInRow(i, vdofs.Size());
+   }
+   el_vdof.MakeJ();
+   for (int i = 0; i < ne; i++)
+   {
+      fes.GetElementVDofs(i, vdofs);
+      for (int j = 0; j < vdofs.Size(); j++)
+      {
+         if (vdofs[j] < 0) { vdofs[j] = -1-vdofs[j]; }
+      }
+      el_vdof.AddConnections(i, vdofs.GetData(), vdofs.Size());
+   }
+   el_vdof.ShiftUpI();
+}
+
+void GetElementMatrixMap(const SparseMatrix &A,
+                         const FiniteElementSpace &test_fes,
+                         const FiniteElementSpace &trial_fes, bool bdr,
+                         Table &elem_map)
+{
+   const int ne = bdr ? test_fes.GetNBE() : test_fes.GetNE();
+   Array<int> te_vdofs, tr_vdofs;
+   elem_map.MakeI(ne);
+   for (int i = 0; i < ne; i++)
+   {
+      if (bdr)
+      {
+         test_fes.GetBdrElementVDofs(i, te_vdofs);
+         trial_fes.GetBdrElementVDofs(i, tr_vdofs);
+      }
+      else
+      {
+         test_fes.GetElementVDofs(i, te_vdofs);
+         trial_fes.GetElementVDofs(i, tr_vdofs);
+      }
+      elem_map.AddColumnsInRow(i, te_vdofs.Size()*tr_vdofs.Size());
+   }
+   elem_map.MakeJ();
+   for (int i = 0; i < ne; i++)
+   {
+      if (bdr)
+      {
+         test_fes.GetBdrElementVDofs(i, te_vdofs);
+         trial_fes.GetBdrElementVDofs(i, tr_vdofs);
+      }
+      else
+      {
+         test_fes.GetElementVDofs(i, te_vdofs);
+         trial_fes.GetElementVDofs(i, tr_vdofs);
+      }
+      A.GetSubMatrixMap(te_vdofs, tr_vdofs, elem_map.GetRow(i));
+   }
+}
+
 void BilinearForm::AllocMat()
 {
+   ClearNonzeroMaps();
+
    if (static_cond) { return; }
 
-   if (precompute_sparsity == 0 || fes->GetVDim() > 1)
+   if (coo_assembly || precompute_sparsity == 0)
    {
       mat = new SparseMatrix(height);
+      if (coo_assembly) { mat->UseCOOAssembly(); }
       return;
    }
 
-   const Table &elem_dof = fes->GetElementToDofTable();
-   Table dof_dof;
+   // for vector spaces, all the components of the element dofs are coupled;
+   // the signs of the dofs (e.g. in ND spaces) are removed
+   Table elem_dof, dof_dof;
+   GetElementToVDofTable(*fes, elem_dof);
 
    if (fbfi.Size() > 0)
    {
@@ -73,6 +141,11 @@ BilinearForm::BilinearForm (FiniteElementSpace * f)
    static_cond = NULL;
    hybridization = NULL;
    precompute_sparsity = 0;
+   threaded_assembly = false;
+   coo_assembly = false;
+   cached_sparsity = false;
+   assembly = AssemblyLevel::FULL;
+   elem_restrict = NULL;
    diag_policy = DIAG_KEEP;
 }
 
@@ -87,6 +160,11 @@ BilinearForm::BilinearForm (FiniteElementSpace * f, BilinearForm * bf, int ps)
    static_cond = NULL;
    hybridization = NULL;
    precompute_sparsity = ps;
+   threaded_assembly = false;
+   coo_assembly = false;
+   cached_sparsity = false;
+   assembly = AssemblyLevel::FULL;
+   elem_restrict = NULL;
    diag_policy = DIAG_KEEP;
 
    // Copy the pointers to the integrators
@@ -142,6 +220,7 @@ void BilinearForm::UseSparsity(int *I, int *J, bool isSorted)
       }
       delete mat;
    }
+   ClearNonzeroMaps();
    height = width = fes->GetVSize();
    mat = new SparseMatrix(I, J, NULL, height, width, false, true, isSorted);
 }
@@ -166,6 +245,59 @@ const double& BilinearForm::Elem (int i, int j) const
    return mat -> Elem(i,j);
 }
 
+void BilinearForm::Mult(const Vector &x, Vector &y) const
+{
+   if (assembly == AssemblyLevel::PARTIAL)
+   {
+      y = 0.0;
+      AddMultPA(x, y, 1.0, false);
+   }
+   else
+   {
+      mat->Mult(x, y);
+   }
+}
+
+void BilinearForm::AddMult(const Vector &x, Vector &y, const double a) const
+{
+   if (assembly == AssemblyLevel::PARTIAL)
+   {
+      AddMultPA(x, y, a, false);
+   }
+   else
+   {
+      mat->AddMult(x, y, a);
+   }
+}
+
+void BilinearForm::AddMultTranspose(const Vector &x, Vector &y,
+                                    const double a) const
+{
+   if (assembly == AssemblyLevel::PARTIAL)
+   {
+      AddMultPA(x, y, a, true);
+   }
+   else
+   {
+      mat->AddMultTranspose(x, y, a);
+   }
+}
+
+void BilinearForm::AddMultPA(const Vector &x, Vector &y, double a,
+                             bool transpose) const
+{
+   MFEM_VERIFY(elem_restrict, "the form is not assembled");
+   elem_restrict->Mult(x, pa_x);
+   pa_y.SetSize(pa_x.Size());
+   pa_y = 0.0;
+   for (int k = 0; k < dbfi.Size(); k++)
+   {
+      if (transpose) { dbfi[k]->AddMultTransposePA(pa_x, pa_y); }
+      else { dbfi[k]->AddMultPA(pa_x, pa_y); }
+   }
+   elem_restrict->AddMultTranspose(pa_y, y, a);
+}
+
 MatrixInverse * BilinearForm::Inverse() const
 {
    return mat -> Inverse();
@@ -173,6 +305,7 @@ MatrixInverse * BilinearForm::Inverse() const
 
 void BilinearForm::Finalize (int skip_zeros)
 {
+   if (assembly == AssemblyLevel::PARTIAL) { return; }
    if (!static_cond) { mat->Finalize(skip_zeros); }
    if (mat_e) { mat_e->Finalize(skip_zeros); }
    if (static_cond) { static_cond->Finalize(); }
@@ -287,6 +420,23 @@ void BilinearForm::AssembleBdrElementMatrix(
    }
 }
 
+void BilinearForm::AssemblePA()
+{
+   MFEM_VERIFY(bbfi.Size() == 0 && fbfi.Size() == 0 && bfbfi.Size() == 0,
+               "partial assembly supports only domain integrators");
+   MFEM_VERIFY(!static_cond && !hybridization, "partial assembly does not "
+               "support static condensation or hybridization");
+
+   if (elem_restrict == NULL)
+   {
+      elem_restrict = new ElementRestriction(*fes);
+   }
+   for (int k = 0; k < dbfi.Size(); k++)
+   {
+      dbfi[k]->AssemblePA(*fes);
+   }
+}
+
 void BilinearForm::Assemble (int skip_zeros)
 {
    ElementTransformation *eltrans;
@@ -295,10 +445,30 @@ void BilinearForm::Assemble (int skip_zeros)
 
    int i;
 
+   // the nodes may have been modified since the factors were cached
+   mesh->CheckGeometricFactors();
+
+   if (assembly == AssemblyLevel::PARTIAL)
+   {
+      AssemblePA();
+      return;
+   }
+
    if (mat == NULL)
    {
       AllocMat();
    }
+   // AddSubMatrixByMap() and ThreadSafeAddSubMatrix() keep the transpose
+   // cached by the matrix, see SparseMatrix::EnsureMultTranspose()
+   if (mat) { mat->ResetTranspose(); }
+
+   if (threaded_assembly && !static_cond && !hybridization &&
+       !element_matrices)
+   {
+      ColoredAssemble(skip_zeros);
+      if (mat->UsesCOOAssembly()) { mat->Finalize(skip_zeros); }
+      return;
+   }
 
 #ifdef MFEM_USE_OPENMP
    int free_element_matrices = 0;
@@ -309,6 +479,8 @@ void BilinearForm::Assemble (int skip_zeros)
    }
 #endif
 
+   const bool nz_maps = PrepareNonzeroMaps();
+
    if (dbfi.Size())
    {
       for (i = 0; i < fes -> GetNE(); i++)
@@ -336,7 +508,14 @@ void BilinearForm::Assemble (int skip_zeros)
          }
          else
          {
-            mat->AddSubMatrix(vdofs, vdofs, *elmat_p, skip_zeros);
+            if (nz_maps)
+            {
+               mat->AddSubMatrixByMap(elem_nz_map.GetRow(i), *elmat_p);
+            }
+            else
+            {
+               mat->AddSubMatrix(vdofs, vdofs, *elmat_p, skip_zeros);
+            }
             if (hybridization)
             {
                hybridization->AssembleMatrix(i, *elmat_p);
@@ -387,7 +566,14 @@ void BilinearForm::Assemble (int skip_zeros)
          }
          if (!static_cond)
          {
-            mat->AddSubMatrix(vdofs, vdofs, elmat, skip_zeros);
+            if (nz_maps)
+            {
+               mat->AddSubMatrixByMap(bdr_elem_nz_map.GetRow(i), elmat);
+            }
+            else
+            {
+               mat->AddSubMatrix(vdofs, vdofs, elmat, skip_zeros);
+            }
             if (hybridization)
             {
                hybridization->AssembleBdrMatrix(i, elmat);
@@ -483,6 +669,251 @@ void BilinearForm::Assemble (int skip_zeros)
       FreeElementMatrices();
    }
 #endif
+
+   if (mat && mat->UsesCOOAssembly()) { mat->Finalize(skip_zeros); }
+}
+
+bool BilinearForm::PrepareNonzeroMaps()
+{
+   if (!cached_sparsity || !mat || !mat->Finalized()) { return false; }
+
+   if (dbfi.Size() && elem_nz_map.Size() != fes->GetNE())
+   {
+      GetElementMatrixMap(*mat, *fes, *fes, false, elem_nz_map);
+   }
+   if (bbfi.Size() && bdr_elem_nz_map.Size() != fes->GetNBE())
+   {
+      GetElementMatrixMap(*mat, *fes, *fes, true, bdr_elem_nz_map);
+   }
+   return true;
+}
+
+// Add a local matrix to A; with 'concurrent' set, A must be finalized or in
+// the COO assembly mode and the method can be called by several threads adding
+// to disjoint sets of rows.
+static inline void AddLocalMatrix(SparseMatrix &A, bool concurrent,
+                                  const Array<int> &rows,
+                                  const Array<int> &cols,
+                                  const DenseMatrix &elmat, int skip_zeros)
+{
+   if (concurrent && A.Finalized())
+   {
+      A.ThreadSafeAddSubMatrix(rows, cols, elmat, skip_zeros);
+   }
+   else
+   {
+      A.AddSubMatrix(rows, cols, elmat, skip_zeros);
+   }
+}
+
+void BilinearForm::ColoredAssemble(int skip_zeros)
+{
+   Mesh *mesh = fes->GetMesh();
+
+   // Threads can only add concurrently to a matrix in CSR or COO format and
+   // only use the integrators that are thread-safe; otherwise the colors are
+   // processed serially.
+   const bool mat_concurrent = mat->Finalized() || mat->UsesCOOAssembly();
+   const bool nz_maps = PrepareNonzeroMaps();
+
+   if (dbfi.Size())
+   {
+      const bool concurrent =
+         mat_concurrent && internal::IntegratorsAreThreadSafe(dbfi);
+      const Table &colors = fes->GetElementColoring();
+      for (int c = 0; c < colors.Size(); c++)
+      {
+         const int *elems = colors.GetRow(c);
+         const int num_elems = colors.RowSize(c);
+#ifdef MFEM_USE_OPENMP
+         #pragma omp parallel if (concurrent)
+#endif
+         {
+            DenseMatrix elmat, tmp;
+            Array<int> el_vdofs;
+            IsoparametricTransformation eltrans;
+#ifdef MFEM_USE_OPENMP
+            #pragma omp for
+#endif
+            for (int j = 0; j < num_elems; j++)
+            {
+               const int i = elems[j];
+               const FiniteElement &fe = *fes->GetFE(i);
+               fes->GetElementVDofs(i, el_vdofs);
+               fes->GetElementTransformation(i, &eltrans);
+               dbfi[0]->AssembleElementMatrix(fe, eltrans, elmat);
+               for (int k = 1; k < dbfi.Size(); k++)
+               {
+                  dbfi[k]->AssembleElementMatrix(fe, eltrans, tmp);
+                  elmat += tmp;
+               }
+               if (nz_maps)
+               {
+                  mat->AddSubMatrixByMap(elem_nz_map.GetRow(i), elmat);
+               }
+               else
+               {
+                  AddLocalMatrix(*mat, concurrent, el_vdofs, el_vdofs, elmat,
+                                 skip_zeros);
+               }
+            }
+         }
+      }
+   }
+
+   if (bbfi.Size())
+   {
+      const bool concurrent =
+         mat_concurrent && internal::IntegratorsAreThreadSafe(bbfi);
+      Array<int> bdr_attr_marker;
+      internal::MarkBdrAttributes(*mesh, bbfi_marker, bdr_attr_marker);
+
+      const Table &colors = fes->GetBdrElementColoring();
+      for (int c = 0; c < colors.Size(); c++)
+      {
+         const int *belems = colors.GetRow(c);
+         const int num_belems = colors.RowSize(c);
+#ifdef MFEM_USE_OPENMP
+         #pragma omp parallel if (concurrent)
+#endif
+         {
+            DenseMatrix elmat, tmp;
+            Array<int> be_vdofs;
+            IsoparametricTransformation eltrans;
+#ifdef MFEM_USE_OPENMP
+            #pragma omp for
+#endif
+            for (int j = 0; j < num_belems; j++)
+            {
+               const int i = belems[j];
+               const int bdr_attr = mesh->GetBdrAttribute(i);
+               if (bdr_attr_marker[bdr_attr-1] == 0) { continue; }
+
+               const FiniteElement &be = *fes->GetBE(i);
+               fes->GetBdrElementVDofs(i, be_vdofs);
+               mesh->GetBdrElementTransformation(i, &eltrans);
+               bbfi[0]->AssembleElementMatrix(be, eltrans, elmat);
+               for (int k = 1; k < bbfi.Size(); k++)
+               {
+                  if (bbfi_marker[k] &&
+                      (*bbfi_marker[k])[bdr_attr-1] == 0) { continue; }
+
+                  bbfi[k]->AssembleElementMatrix(be, eltrans, tmp);
+                  elmat += tmp;
+               }
+               if (nz_maps)
+               {
+                  mat->AddSubMatrixByMap(bdr_elem_nz_map.GetRow(i), elmat);
+               }
+               else
+               {
+                  AddLocalMatrix(*mat, concurrent, be_vdofs, be_vdofs, elmat,
+                                 skip_zeros);
+               }
+            }
+         }
+      }
+   }
+
+   if (fbfi.Size())
+   {
+      const bool concurrent =
+         mat_concurrent && internal::IntegratorsAreThreadSafe(fbfi);
+      const Table &colors = fes->GetFaceColoring();
+      for (int c = 0; c < colors.Size(); c++)
+      {
+         const int *faces = colors.GetRow(c);
+         const int num_faces = colors.RowSize(c);
+#ifdef MFEM_USE_OPENMP
+         #pragma omp parallel if (concurrent)
+#endif
+         {
+            DenseMatrix elmat;
+            Array<int> face_vdofs, vdofs2;
+            FaceElementTransformations tr;
+            IsoparametricTransformation eltrans1, eltrans2, ftrans;
+#ifdef MFEM_USE_OPENMP
+            #pragma omp for
+#endif
+            for (int j = 0; j < num_faces; j++)
+            {
+               const int f = faces[j];
+               if (!mesh->FaceIsInterior(f)) { continue; }
+
+               mesh->GetFaceElementTransformations(f, tr, eltrans1, eltrans2,
+                                                   ftrans);
+               fes->GetElementVDofs(tr.Elem1No, face_vdofs);
+               fes->GetElementVDofs(tr.Elem2No, vdofs2);
+               face_vdofs.Append(vdofs2);
+               for (int k = 0; k < fbfi.Size(); k++)
+               {
+                  fbfi[k]->AssembleFaceMatrix(*fes->GetFE(tr.Elem1No),
+                                              *fes->GetFE(tr.Elem2No),
+                                              tr, elmat);
+                  AddLocalMatrix(*mat, concurrent, face_vdofs, face_vdofs,
+                                 elmat, skip_zeros);
+               }
+            }
+         }
+      }
+   }
+
+   if (bfbfi.Size())
+   {
+      const bool concurrent =
+         mat_concurrent && internal::IntegratorsAreThreadSafe(bfbfi);
+      Array<int> bdr_attr_marker;
+      internal::MarkBdrAttributes(*mesh, bfbfi_marker, bdr_attr_marker);
+
+      // The boundary faces are processed using the face coloring.
+      Array<int> face_bdr(mesh->GetNumFaces());
+      face_bdr = -1;
+      for (int i = 0; i < mesh->GetNBE(); i++)
+      {
+         face_bdr[mesh->GetBdrElementEdgeIndex(i)] = i;
+      }
+
+      const Table &colors = fes->GetFaceColoring();
+      for (int c = 0; c < colors.Size(); c++)
+      {
+         const int *faces = colors.GetRow(c);
+         const int num_faces = colors.RowSize(c);
+#ifdef MFEM_USE_OPENMP
+         #pragma omp parallel if (concurrent)
+#endif
+         {
+            DenseMatrix elmat;
+            Array<int> face_vdofs;
+            FaceElementTransformations tr;
+            IsoparametricTransformation eltrans1, eltrans2, ftrans;
+#ifdef MFEM_USE_OPENMP
+            #pragma omp for
+#endif
+            for (int j = 0; j < num_faces; j++)
+            {
+               const int i = face_bdr[faces[j]];
+               if (i < 0) { continue; }
+               const int bdr_attr = mesh->GetBdrAttribute(i);
+               if (bdr_attr_marker[bdr_attr-1] == 0) { continue; }
+
+               if (!mesh->GetBdrFaceTransformations(i, tr, eltrans1, eltrans2,
+                                                    ftrans)) { continue; }
+               fes->GetElementVDofs(tr.Elem1No, face_vdofs);
+               // As in Assemble(), fe1 is also used as the dummy fe2.
+               const FiniteElement *fe1 = fes->GetFE(tr.Elem1No);
+               for (int k = 0; k < bfbfi.Size(); k++)
+               {
+                  if (bfbfi_marker[k] &&
+                      (*bfbfi_marker[k])[bdr_attr-1] == 0) { continue; }
+
+                  bfbfi[k]->AssembleFaceMatrix(*fe1, *fe1, tr, elmat);
+                  AddLocalMatrix(*mat, concurrent, face_vdofs, face_vdofs,
+                                 elmat, skip_zeros);
+               }
+            }
+         }
+      }
+   }
 }
 
 void BilinearForm::ConformingAssemble()
@@ -500,6 +931,7 @@ void BilinearForm::ConformingAssemble()
    SparseMatrix *R = Transpose(*P);
    SparseMatrix *RA = mfem::Mult(*R, *mat);
    delete mat;
+   ClearNonzeroMaps();
    if (mat_e)
    {
       SparseMatrix *RAe = mfem::Mult(*R, *mat_e);
@@ -586,6 +1018,60 @@ void BilinearForm::FormLinearSystem(const Array<int> &ess_tdof_list,
    }
 }
 
+void BilinearForm::FormLinearSystem(const Array<int> &ess_tdof_list,
+                                    const Array<Vector *> &x,
+                                    const Array<Vector *> &b,
+                                    SparseMatrix &A, Array<Vector *> &X,
+                                    Array<Vector *> &B, int copy_interior)
+{
+   const int nrhs = x.Size();
+   MFEM_VERIFY(b.Size() == nrhs && X.Size() == nrhs && B.Size() == nrhs,
+               "incompatible number of vectors");
+   if (static_cond || hybridization)
+   {
+      for (int i = 0; i < nrhs; i++)
+      {
+         FormLinearSystem(ess_tdof_list, *x[i], *b[i], A, *X[i], *B[i],
+                          copy_interior);
+      }
+      return;
+   }
+
+   const SparseMatrix *P = fes->GetConformingProlongation();
+
+   FormSystemMatrix(ess_tdof_list, A);
+
+   for (int i = 0; i < nrhs; i++)
+   {
+      if (!P) // conforming space
+      {
+         // X and B point to the same data as x and b
+         X[i]->NewDataAndSize(x[i]->GetData(), x[i]->Size());
+         B[i]->NewDataAndSize(b[i]->GetData(), b[i]->Size());
+      }
+      else // non-conforming space
+      {
+         // Variational restriction with P
+         const SparseMatrix *R = fes->GetConformingRestriction();
+         B[i]->SetSize(P->Width());
+         P->MultTranspose(*b[i], *B[i]);
+         X[i]->SetSize(R->Height());
+         R->Mult(*x[i], *X[i]);
+      }
+   }
+
+   // Eliminate the essential BC from all the right-hand sides, as in
+   // EliminateVDofsInRHS()
+   Array<const Vector *> cX(nrhs);
+   for (int i = 0; i < nrhs; i++) { cX[i] = X[i]; }
+   mat_e->ArrayAddMult(cX, B, -1.);
+   for (int i = 0; i < nrhs; i++)
+   {
+      mat->PartMult(ess_tdof_list, *X[i], *B[i]);
+      if (!copy_interior) { X[i]->SetSubVectorComplement(ess_tdof_list, 0.0); }
+   }
+}
+
 void BilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
                                     SparseMatrix &A)
 {
@@ -618,11 +1104,48 @@ void BilinearForm::FormSystemMatrix(const Array<int> &ess_tdof_list,
       }
       else
       {
+         // the entries of mat may have been reassembled
+         mat->ResetTranspose();
          A.MakeRef(*mat);
       }
    }
 }
 
+void BilinearForm::AssembleDiagonal(Vector &diag) const
+{
+   if (assembly != AssemblyLevel::PARTIAL)
+   {
+      MFEM_VERIFY(mat && mat->Finalized() && mat->Height() == height,
+                  "the matrix is not assembled and finalized");
+      mat->GetDiag(diag);
+      return;
+   }
+
+   diag.SetSize(height);
+   diag = 0.0;
+   DenseMatrix elmat, elmat_k;
+   Array<int> dofs;
+   for (int i = 0; i < fes->GetNE(); i++)
+   {
+      const FiniteElement &fe = *fes->GetFE(i);
+      ElementTransformation *eltrans = fes->GetElementTransformation(i);
+      fes->GetElementVDofs(i, dofs);
+      elmat.SetSize(dofs.Size());
+      elmat = 0.0;
+      for (int k = 0; k < dbfi.Size(); k++)
+      {
+         dbfi[k]->AssembleElementMatrix(fe, *eltrans, elmat_k);
+         elmat += elmat_k;
+      }
+      // the signs of the dofs cancel on the diagonal
+      for (int j = 0; j < dofs.Size(); j++)
+      {
+         const int d = dofs[j];
+         diag(d >= 0 ? d : -1-d) += elmat(j,j);
+      }
+   }
+}
+
 void BilinearForm::RecoverFEMSolution(const Vector &X,
                                       const Vector &b, Vector &x)
 {
@@ -872,11 +1395,14 @@ void BilinearForm::Update(FiniteElementSpace *nfes)
    FreeElementMatrices();
    delete static_cond;
    static_cond = NULL;
+   delete elem_restrict;
+   elem_restrict = NULL;
 
    if (full_update)
    {
       delete mat;
       mat = NULL;
+      ClearNonzeroMaps();
       delete hybridization;
       hybridization = NULL;
       sequence = fes->GetSequence();
@@ -897,6 +1423,7 @@ void BilinearForm::SetDiagonalPolicy(DiagonalPolicy policy)
 
 BilinearForm::~BilinearForm()
 {
+   delete elem_restrict;
    delete mat_e;
    delete mat;
    delete element_matrices;
@@ -922,6 +1449,9 @@ MixedBilinearForm::MixedBilinearForm (FiniteElementSpace *tr_fes,
    test_fes = te_fes;
    mat = NULL;
    extern_bfs = 0;
+   threaded_assembly = false;
+   precompute_sparsity = 0;
+   cached_sparsity = false;
 }
 
 MixedBilinearForm::MixedBilinearForm (FiniteElementSpace *tr_fes,
@@ -933,6 +1463,9 @@ MixedBilinearForm::MixedBilinearForm (FiniteElementSpace *tr_fes,
    test_fes = te_fes;
    mat = NULL;
    extern_bfs = 1;
+   threaded_assembly = false;
+   precompute_sparsity = 0;
+   cached_sparsity = false;
 
    // Copy the pointers to the integrators
    dom = mbf->dom;
@@ -972,6 +1505,51 @@ MatrixInverse * MixedBilinearForm::Inverse() const
    return mat -> Inverse ();
 }
 
+void MixedBilinearForm::AllocMat()
+{
+   ClearNonzeroMaps();
+
+   if (precompute_sparsity == 0 || skt.Size())
+   {
+      mat = new SparseMatrix(height, width);
+      return;
+   }
+
+   // the sparsity pattern is defined from the map: test vdof->element->trial
+   // vdof
+   Table te_elem_vdof, tr_elem_vdof, te_vdof_elem, dof_dof;
+   GetElementToVDofTable(*test_fes, te_elem_vdof);
+   GetElementToVDofTable(*trial_fes, tr_elem_vdof);
+   Transpose(te_elem_vdof, te_vdof_elem, height);
+   mfem::Mult(te_vdof_elem, tr_elem_vdof, dof_dof);
+
+   dof_dof.SortRows();
+
+   int *I = dof_dof.GetI();
+   int *J = dof_dof.GetJ();
+   double *data = new double[I[height]];
+
+   mat = new SparseMatrix(I, J, data, height, width, true, true, true);
+   *mat = 0.0;
+
+   dof_dof.LoseData();
+}
+
+bool MixedBilinearForm::PrepareNonzeroMaps()
+{
+   if (!cached_sparsity || !mat->Finalized()) { return false; }
+
+   if (dom.Size() && elem_nz_map.Size() != test_fes->GetNE())
+   {
+      GetElementMatrixMap(*mat, *test_fes, *trial_fes, false, elem_nz_map);
+   }
+   if (bdr.Size() && bdr_elem_nz_map.Size() != test_fes->GetNBE())
+   {
+      GetElementMatrixMap(*mat, *test_fes, *trial_fes, true, bdr_elem_nz_map);
+   }
+   return true;
+}
+
 void MixedBilinearForm::Finalize (int skip_zeros)
 {
    mat -> Finalize (skip_zeros);
@@ -1015,8 +1593,18 @@ void MixedBilinearForm::Assemble (int skip_zeros)
 
    if (mat == NULL)
    {
-      mat = new SparseMatrix(height, width);
+      AllocMat();
    }
+   // see BilinearForm::Assemble()
+   mat->ResetTranspose();
+
+   if (threaded_assembly)
+   {
+      ColoredAssemble(skip_zeros);
+      return;
+   }
+
+   const bool nz_maps = PrepareNonzeroMaps();
 
    if (dom.Size())
    {
@@ -1030,7 +1618,14 @@ void MixedBilinearForm::Assemble (int skip_zeros)
             dom[k] -> AssembleElementMatrix2 (*trial_fes -> GetFE(i),
                                               *test_fes  -> GetFE(i),
                                               *eltrans, elemmat);
-            mat -> AddSubMatrix (te_vdofs, tr_vdofs, elemmat, skip_zeros);
+            if (nz_maps)
+            {
+               mat -> AddSubMatrixByMap (elem_nz_map.GetRow(i), elemmat);
+            }
+            else
+            {
+               mat -> AddSubMatrix (te_vdofs, tr_vdofs, elemmat, skip_zeros);
+            }
          }
       }
    }
@@ -1047,7 +1642,14 @@ void MixedBilinearForm::Assemble (int skip_zeros)
             bdr[k] -> AssembleElementMatrix2 (*trial_fes -> GetBE(i),
                                               *test_fes  -> GetBE(i),
                                               *eltrans, elemmat);
-            mat -> AddSubMatrix (te_vdofs, tr_vdofs, elemmat, skip_zeros);
+            if (nz_maps)
+            {
+               mat -> AddSubMatrixByMap (bdr_elem_nz_map.GetRow(i), elemmat);
+            }
+            else
+            {
+               mat -> AddSubMatrix (te_vdofs, tr_vdofs, elemmat, skip_zeros);
+            }
          }
       }
    }
@@ -1089,9 +1691,162 @@ void MixedBilinearForm::Assemble (int skip_zeros)
    }
 }
 
+void MixedBilinearForm::ColoredAssemble(int skip_zeros)
+{
+   Mesh *mesh = test_fes->GetMesh();
+
+   // The rows of the matrix are given by the test space, so its colorings are
+   // used. Threads can only add concurrently to a matrix in CSR format and
+   // only use the integrators that are thread-safe.
+   const bool mat_concurrent = mat->Finalized();
+   const bool nz_maps = PrepareNonzeroMaps();
+
+   if (dom.Size())
+   {
+      const bool concurrent =
+         mat_concurrent && internal::IntegratorsAreThreadSafe(dom);
+      const Table &colors = test_fes->GetElementColoring();
+      for (int c = 0; c < colors.Size(); c++)
+      {
+         const int *elems = colors.GetRow(c);
+         const int num_elems = colors.RowSize(c);
+#ifdef MFEM_USE_OPENMP
+         #pragma omp parallel if (concurrent)
+#endif
+         {
+            DenseMatrix elmat;
+            Array<int> tr_vdofs, te_vdofs;
+            IsoparametricTransformation eltrans;
+#ifdef MFEM_USE_OPENMP
+            #pragma omp for
+#endif
+            for (int j = 0; j < num_elems; j++)
+            {
+               const int i = elems[j];
+               trial_fes->GetElementVDofs(i, tr_vdofs);
+               test_fes->GetElementVDofs(i, te_vdofs);
+               test_fes->GetElementTransformation(i, &eltrans);
+               for (int k = 0; k < dom.Size(); k++)
+               {
+                  dom[k]->AssembleElementMatrix2(*trial_fes->GetFE(i),
+                                                 *test_fes->GetFE(i),
+                                                 eltrans, elmat);
+                  if (nz_maps)
+                  {
+                     mat->AddSubMatrixByMap(elem_nz_map.GetRow(i), elmat);
+                  }
+                  else
+                  {
+                     AddLocalMatrix(*mat, concurrent, te_vdofs, tr_vdofs,
+                                    elmat, skip_zeros);
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   if (bdr.Size())
+   {
+      const bool concurrent =
+         mat_concurrent && internal::IntegratorsAreThreadSafe(bdr);
+      const Table &colors = test_fes->GetBdrElementColoring();
+      for (int c = 0; c < colors.Size(); c++)
+      {
+         const int *belems = colors.GetRow(c);
+         const int num_belems = colors.RowSize(c);
+#ifdef MFEM_USE_OPENMP
+         #pragma omp parallel if (concurrent)
+#endif
+         {
+            DenseMatrix elmat;
+            Array<int> tr_vdofs, te_vdofs;
+            IsoparametricTransformation eltrans;
+#ifdef MFEM_USE_OPENMP
+            #pragma omp for
+#endif
+            for (int j = 0; j < num_belems; j++)
+            {
+               const int i = belems[j];
+               trial_fes->GetBdrElementVDofs(i, tr_vdofs);
+               test_fes->GetBdrElementVDofs(i, te_vdofs);
+               mesh->GetBdrElementTransformation(i, &eltrans);
+               for (int k = 0; k < bdr.Size(); k++)
+               {
+                  bdr[k]->AssembleElementMatrix2(*trial_fes->GetBE(i),
+                                                 *test_fes->GetBE(i),
+                                                 eltrans, elmat);
+                  if (nz_maps)
+                  {
+                     mat->AddSubMatrixByMap(bdr_elem_nz_map.GetRow(i), elmat);
+                  }
+                  else
+                  {
+                     AddLocalMatrix(*mat, concurrent, te_vdofs, tr_vdofs,
+                                    elmat, skip_zeros);
+                  }
+               }
+            }
+         }
+      }
+   }
+
+   if (skt.Size())
+   {
+      const bool concurrent =
+         mat_concurrent && internal::IntegratorsAreThreadSafe(skt);
+      const Table &colors = test_fes->GetFaceColoring();
+      for (int c = 0; c < colors.Size(); c++)
+      {
+         const int *faces = colors.GetRow(c);
+         const int num_faces = colors.RowSize(c);
+#ifdef MFEM_USE_OPENMP
+         #pragma omp parallel if (concurrent)
+#endif
+         {
+            DenseMatrix elmat;
+            Array<int> tr_vdofs, te_vdofs, te_vdofs2;
+            FaceElementTransformations ftr;
+            IsoparametricTransformation eltrans1, eltrans2, ftrans;
+#ifdef MFEM_USE_OPENMP
+            #pragma omp for
+#endif
+            for (int j = 0; j < num_faces; j++)
+            {
+               const int f = faces[j];
+               mesh->GetFaceElementTransformations(f, ftr, eltrans1, eltrans2,
+                                                   ftrans);
+               trial_fes->GetFaceVDofs(f, tr_vdofs);
+               test_fes->GetElementVDofs(ftr.Elem1No, te_vdofs);
+               const FiniteElement *trial_face_fe =
+                  trial_fes->GetFaceElement(f);
+               const FiniteElement *test_fe1 = test_fes->GetFE(ftr.Elem1No);
+               // As in Assemble(), test_fe1 is the dummy test_fe2 on the
+               // boundary.
+               const FiniteElement *test_fe2 = test_fe1;
+               if (ftr.Elem2No >= 0)
+               {
+                  test_fes->GetElementVDofs(ftr.Elem2No, te_vdofs2);
+                  te_vdofs.Append(te_vdofs2);
+                  test_fe2 = test_fes->GetFE(ftr.Elem2No);
+               }
+               for (int k = 0; k < skt.Size(); k++)
+               {
+                  skt[k]->AssembleFaceMatrix(*trial_face_fe, *test_fe1,
+                                             *test_fe2, ftr, elmat);
+                  AddLocalMatrix(*mat, concurrent, te_vdofs, tr_vdofs, elmat,
+                                 skip_zeros);
+               }
+            }
+         }
+      }
+   }
+}
+
 void MixedBilinearForm::ConformingAssemble()
 {
    Finalize();
+   ClearNonzeroMaps();
 
    const SparseMatrix *P2 = test_fes->GetConformingProlongation();
    if (P2)
@@ -1168,6 +1923,7 @@ void MixedBilinearForm::Update()
 {
    delete mat;
    mat = NULL;
+   ClearNonzeroMaps();
    height = test_fes->GetVSize();
    width = trial_fes->GetVSize();
 }
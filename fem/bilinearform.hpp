@@ -24,6 +24,18 @@
 namespace mfem
 {
 
+/** @brief Compute the positions, in the finalized matrix @a A, of the entries
+    of the element matrices, or of the boundary element matrices if @a bdr is
+    true, with rows in @a test_fes and columns in @a trial_fes. */
+/** Row i of @a elem_map stores the positions for the i-th (boundary) element,
+    as computed by SparseMatrix::GetSubMatrixMap(); they are used with
+    SparseMatrix::AddSubMatrixByMap() to reassemble the forms without
+    searching, see BilinearForm::UseCachedSparsity(). */
+void GetElementMatrixMap(const SparseMatrix &A,
+                         const FiniteElementSpace &test_fes,
+                         const FiniteElementSpace &trial_fes, bool bdr,
+                         Table &elem_map);
+
 /** Class for bilinear form - "Matrix" with associated FE space and
     BLFIntegrators. */
 class BilinearForm : public Matrix
@@ -79,6 +91,38 @@ protected:
    // Allocate appropriate SparseMatrix and assign it to mat
    void AllocMat();
 
+   /// Use colored (threaded) assembly, see EnableThreadedAssembly().
+   bool threaded_assembly;
+
+   /// Assemble the matrix in COO format, see UseCOOAssembly().
+   bool coo_assembly;
+
+   /// Reassemble with the maps below, see UseCachedSparsity().
+   bool cached_sparsity;
+   /** @brief Positions of the entries of the element and boundary element
+       matrices in the finalized #mat, see GetElementMatrixMap(). */
+   Table elem_nz_map, bdr_elem_nz_map;
+
+   // Compute the maps if needed; return true if they can be used
+   bool PrepareNonzeroMaps();
+   // Invalidate the maps; used when #mat is reallocated
+   void ClearNonzeroMaps() { elem_nz_map.Clear(); bdr_elem_nz_map.Clear(); }
+
+   // Assemble color by color; used by Assemble() when threaded_assembly is set
+   void ColoredAssemble(int skip_zeros);
+
+   /// The assembly level, see SetAssemblyLevel().
+   AssemblyLevel::Type assembly;
+   /// Map to the element dofs, used with partial assembly. Owned.
+   ElementRestriction *elem_restrict;
+   /// E-vectors used by the partial assembly action.
+   mutable Vector pa_x, pa_y;
+
+   // Partial assembly: set up the integrators; used by Assemble()
+   void AssemblePA();
+   // Partial assembly: y += a A x, or y += a A^t x if 'transpose' is true
+   void AddMultPA(const Vector &x, Vector &y, double a, bool transpose) const;
+
    void ConformingAssemble();
 
    // may be used in the construction of derived classes
@@ -88,6 +132,11 @@ protected:
       mat = mat_e = NULL; extern_bfs = 0; element_matrices = NULL;
       static_cond = NULL; hybridization = NULL;
       precompute_sparsity = 0;
+      threaded_assembly = false;
+      coo_assembly = false;
+      cached_sparsity = false;
+      assembly = AssemblyLevel::FULL;
+      elem_restrict = NULL;
       diag_policy = DIAG_KEEP;
    }
 
@@ -139,11 +188,23 @@ public:
                             BilinearFormIntegrator *constr_integ,
                             const Array<int> &ess_tdof_list);
 
-   /** For scalar FE spaces, precompute the sparsity pattern of the matrix
-       (assuming dense element matrices) based on the types of integrators
-       present in the bilinear form. */
+   /** Precompute the sparsity pattern of the matrix (assuming dense element
+       matrices) based on the types of integrators present in the bilinear
+       form. For vector FE spaces, all the components of the dofs of an element
+       are coupled. */
    void UsePrecomputedSparsity(int ps = 1) { precompute_sparsity = ps; }
 
+   /** @brief Cache the positions of the entries of the element and boundary
+       element matrices in the finalized matrix, so that the following
+       assemblies add the values without searching. */
+   /** The positions are computed at the first assembly into a finalized
+       matrix, i.e. on reassembly or with UsePrecomputedSparsity(), and are kept
+       until the matrix is reallocated, e.g. by Update() after a change of the
+       space. They use one int per entry of the element matrices. The face
+       integrators still search for their entries. */
+   void UseCachedSparsity(bool use = true)
+   { cached_sparsity = use; if (!use) { ClearNonzeroMaps(); } }
+
    /** @brief Use the given CSR sparsity pattern to allocate the internal
        SparseMatrix.
 
@@ -163,6 +224,50 @@ public:
        finalized) and the entries are initialized with zeros. */
    void AllocateMatrix() { if (mat == NULL) { AllocMat(); } }
 
+   /** @brief Assemble the form color by color, using the colorings of
+       FiniteElementSpace::GetElementColoring(), GetBdrElementColoring(), and
+       GetFaceColoring(). */
+   /** With MFEM_USE_OPENMP, the elements (or faces) of one color, which share
+       no dofs, are assembled concurrently directly into the matrix, so the
+       coefficients must be thread-safe. The integrators of one kind (domain,
+       boundary, face, ...) are used concurrently only when they all report
+       BilinearFormIntegrator::IsThreadSafe(), which requires building with
+       MFEM_THREAD_SAFE; otherwise they are assembled serially. This requires a
+       matrix in CSR format: this method also enables the precomputed sparsity
+       (see UsePrecomputedSparsity()). The colored assembly is not used with
+       static condensation, hybridization, or stored element matrices. */
+   void EnableThreadedAssembly(bool enable = true)
+   {
+      threaded_assembly = enable;
+      if (enable) { precompute_sparsity = 1; }
+   }
+
+   /** @brief Allocate the matrix in the COO assembly mode of SparseMatrix,
+       instead of the LIL format or the precomputed sparsity; this method
+       should be called before the first assembly. */
+   /** See SparseMatrix::UseCOOAssembly(). With EnableThreadedAssembly(), the
+       first assembly is then threaded without precomputing the sparsity.
+       Assemble() finalizes the matrix in this mode, so all the integrators
+       must be added before the call to Assemble(). Without threads, the
+       assembly in this mode is about 2x slower than in the LIL format, with
+       the same peak memory. */
+   void UseCOOAssembly(bool use = true) { coo_assembly = use; }
+
+   /** @brief Set the assembly level of the form; this method should be called
+       before assembly. */
+   /** With AssemblyLevel::PARTIAL, Assemble() does not create a matrix:
+       instead, the integrators store their quadrature point data (see
+       BilinearFormIntegrator::AssemblePA()) and Mult() computes the action of
+       the form element by element, with sum-factorized kernels. This is
+       supported only for domain integrators on quadrilateral and hexahedral
+       meshes with tensor product elements, without static condensation or
+       hybridization. Use the FormLinearSystem() variant returning an Operator
+       to eliminate essential boundary conditions. */
+   void SetAssemblyLevel(AssemblyLevel::Type level) { assembly = level; }
+
+   /// Return the assembly level, see SetAssemblyLevel().
+   AssemblyLevel::Type GetAssemblyLevel() const { return assembly; }
+
    /// Access all integrators added with AddDomainIntegrator().
    Array<BilinearFormIntegrator*> *GetDBFI() { return &dbfi; }
 
@@ -192,20 +297,18 @@ public:
    virtual const double &Elem(int i, int j) const;
 
    /// Matrix vector multiplication.
-   virtual void Mult(const Vector &x, Vector &y) const { mat->Mult(x, y); }
+   virtual void Mult(const Vector &x, Vector &y) const;
 
    void FullMult(const Vector &x, Vector &y) const
    { mat->Mult(x, y); mat_e->AddMult(x, y); }
 
-   virtual void AddMult(const Vector &x, Vector &y, const double a = 1.0) const
-   { mat -> AddMult (x, y, a); }
+   virtual void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
 
    void FullAddMult(const Vector &x, Vector &y) const
    { mat->AddMult(x, y); mat_e->AddMult(x, y); }
 
    virtual void AddMultTranspose(const Vector & x, Vector & y,
-                                 const double a = 1.0) const
-   { mat->AddMultTranspose(x, y, a); }
+                                 const double a = 1.0) const;
 
    void FullAddMultTranspose(const Vector & x, Vector & y) const
    { mat->AddMultTranspose(x, y); mat_e->AddMultTranspose(x, y); }
@@ -320,9 +423,40 @@ public:
                          SparseMatrix &A, Vector &X, Vector &B,
                          int copy_interior = 0);
 
+   /** @brief Form the linear systems A X[i] = B[i] for several right-hand
+       sides @a b[i] and b.c. values @a x[i], see FormLinearSystem(). */
+   /** The matrix is formed once, and the b.c. are eliminated from all the
+       right-hand sides with one pass over the eliminated part of the matrix.
+       The vectors of @a X and @a B are set as in FormLinearSystem(), and the
+       solutions are recovered with RecoverFEMSolution(). The systems can then
+       be solved together, e.g. with BlockCGSolver::ArrayMult(). */
+   void FormLinearSystem(const Array<int> &ess_tdof_list,
+                         const Array<Vector *> &x, const Array<Vector *> &b,
+                         SparseMatrix &A, Array<Vector *> &X,
+                         Array<Vector *> &B, int copy_interior = 0);
+
+   /** @brief Form a linear system A X = B with the matrix-free operator A,
+       see Operator::FormLinearSystem(). */
+   /** The operator @a A, which must be destroyed by the caller, applies the
+       form through Mult(), so this method can be used with both assembly
+       levels, see SetAssemblyLevel(). Static condensation and hybridization
+       are not supported. */
+   using Operator::FormLinearSystem;
+
    /// Form the linear system matrix A, see FormLinearSystem() for details.
    void FormSystemMatrix(const Array<int> &ess_tdof_list, SparseMatrix &A);
 
+   /** @brief Compute the diagonal of the form as a GridFunction-size vector,
+       e.g. for Jacobi smoothing with OperatorJacobiSmoother. */
+   /** With AssemblyLevel::FULL, this is the diagonal of the finalized matrix,
+       so for non-conforming spaces the method must be called before
+       FormSystemMatrix(). With AssemblyLevel::PARTIAL, the full element
+       matrices of the domain integrators are computed one element at a time
+       and their diagonals are summed: there are no diagonal kernels, so this
+       costs as much as the element assembly with AssemblyLevel::FULL, but the
+       matrices are not stored. */
+   void AssembleDiagonal(Vector &diag) const;
+
    /// Recover the solution of a linear system formed with FormLinearSystem().
    /** Call this method after solving a linear system constructed using the
        FormLinearSystem() method to recover the solution as a GridFunction-size
@@ -447,6 +581,28 @@ protected:
    /// Trace face (skeleton) integrators.
    Array<BilinearFormIntegrator*> skt;
 
+   /// Use colored (threaded) assembly, see EnableThreadedAssembly().
+   bool threaded_assembly;
+
+   /// Precompute the sparsity, see UsePrecomputedSparsity().
+   int precompute_sparsity;
+   // Allocate appropriate SparseMatrix and assign it to mat
+   void AllocMat();
+
+   /// Reassemble with the maps below, see UseCachedSparsity().
+   bool cached_sparsity;
+   /** @brief Positions of the entries of the element and boundary element
+       matrices in the finalized #mat, see GetElementMatrixMap(). */
+   Table elem_nz_map, bdr_elem_nz_map;
+
+   // Compute the maps if needed; return true if they can be used
+   bool PrepareNonzeroMaps();
+   // Invalidate the maps; used when #mat is reallocated
+   void ClearNonzeroMaps() { elem_nz_map.Clear(); bdr_elem_nz_map.Clear(); }
+
+   // Assemble color by color; used by Assemble() when threaded_assembly is set
+   void ColoredAssemble(int skip_zeros);
+
 private:
    /// Copy construction is not supported; body is undefined.
    MixedBilinearForm(const MixedBilinearForm &);
@@ -527,6 +683,26 @@ public:
 
    void operator=(const double a) { *mat = a; }
 
+   /** @brief Assemble the form color by color, using the colorings of the
+       test space, see BilinearForm::EnableThreadedAssembly(). */
+   /** The elements of one color are assembled concurrently only when the
+       matrix is finalized, i.e. on reassembly or with
+       UsePrecomputedSparsity(), and when the integrators are thread-safe. */
+   void EnableThreadedAssembly(bool enable = true)
+   { threaded_assembly = enable; }
+
+   /** @brief Precompute the sparsity pattern of the matrix from the coupling
+       of the test and trial dofs of each element, assuming dense element
+       matrices; ignored when trace face integrators are present. */
+   void UsePrecomputedSparsity(int ps = 1) { precompute_sparsity = ps; }
+
+   /** @brief Cache the positions of the entries of the element and boundary
+       element matrices in the finalized matrix, so that the following
+       assemblies add the values without searching, see
+       BilinearForm::UseCachedSparsity(). */
+   void UseCachedSparsity(bool use = true)
+   { cached_sparsity = use; if (!use) { ClearNonzeroMaps(); } }
+
    void Assemble(int skip_zeros = 1);
 
    /** For partially conforming trial and/or test FE spaces, complete the
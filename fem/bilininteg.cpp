@@ -361,24 +361,131 @@ void MixedScalarVectorIntegrator::AssembleElementMatrix2(
    }
 }
 
+// Return true if the element matrices of 'el' with the rule 'ir' can be
+// computed with sum factorization: 'el' is a quadrilateral or hexahedral tensor
+// product element and 'ir' is a tensor product rule, with the same 1D rule on
+// all axes, and with the points ordered as in DofToQuad::Setup().
+static bool UseSumFactorization(const FiniteElement &el,
+                                const IntegrationRule &ir)
+{
+   const int dim = el.GetDim();
+   if ((dim != 2 && dim != 3) ||
+       !dynamic_cast<const TensorBasisElement*>(&el) ||
+       el.GetGeomType() != TensorBasisElement::GetTensorProductGeometry(dim) ||
+       el.GetMapType() != FiniteElement::VALUE || el.GetOrder() < 2 ||
+       el.GetDof() != TensorBasisElement::Pow(el.GetOrder() + 1, dim))
+   {
+      return false;
+   }
+   const int nq = ir.GetNPoints();
+   const int n1 = (int) floor(pow(double(nq), 1.0/dim) + 0.5);
+   if (TensorBasisElement::Pow(n1, dim) != nq) { return false; }
+   // the point q = i + n1*(j + n1*k) must be (x_i, y_j, z_k), where the 1D
+   // rule is given by the x coordinates of the first n1 points
+   for (int q = 0; q < nq; q++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(q);
+      const int i = q%n1, j = (q/n1)%n1, k = q/(n1*n1);
+      if (ip.x != ir.IntPoint(i).x || ip.y != ir.IntPoint(j).x ||
+          (dim == 3 && ip.z != ir.IntPoint(k).x))
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+// Compute element matrices A(i,j) = sum_q sum_{k,l} dshape_q(i,k) D_q(k,l)
+// dshape_q(j,l), where dshape_q are the reference gradients of the basis of
+// 'el' at the point q of 'ir', and D_q(k,l) is stored in D at index
+// (k + dim*l)*nq + q. The matrices are computed with sum factorization, see
+// TensorGradElementMatrix(), for tensor product elements. Otherwise, the
+// gradients at all the points are gathered in one matrix, G, and A = (G D) G^t
+// is a single matrix product. The 1D maps, or G, are computed once by the
+// constructor, so that several matrices with the same 'el' and 'ir', e.g. the
+// blocks of the elasticity matrix, share them.
+class GradGradAssembler
+{
+private:
+   const FiniteElement &el;
+   const int dim, nd, nq;
+   const bool sum_fact;
+   DofToQuad maps;
+   // G(i,k + dim*q) = dshape_q(i,k) and GD(i,l + dim*q) = (dshape_q D_q)(i,l)
+   DenseMatrix G, GD, A_lex;
+
+public:
+   GradGradAssembler(const FiniteElement &el_, const IntegrationRule &ir)
+      : el(el_), dim(el.GetDim()), nd(el.GetDof()), nq(ir.GetNPoints()),
+        sum_fact(UseSumFactorization(el, ir))
+   {
+      if (sum_fact)
+      {
+         maps.Setup(el, ir, dim);
+         return;
+      }
+      G.SetSize(nd, dim*nq);
+      GD.SetSize(nd, dim*nq);
+      for (int q = 0; q < nq; q++)
+      {
+         DenseMatrix G_q(G.Data() + q*nd*dim, nd, dim);
+         el.CalcDShape(ir.IntPoint(q), G_q);
+      }
+   }
+
+   void Assemble(const Vector &D, DenseMatrix &A)
+   {
+      A.SetSize(nd);
+      if (sum_fact)
+      {
+         TensorGradElementMatrix(dim, maps, D, A_lex);
+         const Array<int> &dof_map =
+            dynamic_cast<const TensorBasisElement&>(el).GetDofMap();
+         for (int j = 0; j < nd; j++)
+         {
+            const int nj = dof_map.Size() ? dof_map[j] : j;
+            for (int i = 0; i < nd; i++)
+            {
+               A(dof_map.Size() ? dof_map[i] : i, nj) = A_lex(i,j);
+            }
+         }
+         return;
+      }
+
+      for (int q = 0; q < nq; q++)
+      {
+         const double *G_q = G.Data() + q*nd*dim;
+         for (int l = 0; l < dim; l++)
+         {
+            double *gd = GD.Data() + (l + dim*q)*nd;
+            for (int i = 0; i < nd; i++) { gd[i] = 0.0; }
+            for (int k = 0; k < dim; k++)
+            {
+               const double d = D((k + dim*l)*nq + q);
+               const double *g = G_q + k*nd;
+               for (int i = 0; i < nd; i++) { gd[i] += g[i]*d; }
+            }
+         }
+      }
+      MultABt(GD, G, A);
+   }
+};
+
 void DiffusionIntegrator::AssembleElementMatrix
 ( const FiniteElement &el, ElementTransformation &Trans,
   DenseMatrix &elmat )
 {
-   int nd = el.GetDof();
    int dim = el.GetDim();
    int spaceDim = Trans.GetSpaceDim();
    bool square = (dim == spaceDim);
    double w;
 
 #ifdef MFEM_THREAD_SAFE
-   DenseMatrix dshape(nd,dim), dshapedxt(nd,spaceDim), invdfdx(dim,spaceDim);
+   DenseMatrix invdfdx(dim,spaceDim);
+   Vector Q_ir;
 #else
-   dshape.SetSize(nd,dim);
-   dshapedxt.SetSize(nd,spaceDim);
    invdfdx.SetSize(dim,spaceDim);
 #endif
-   elmat.SetSize(nd);
 
    const IntegrationRule *ir = IntRule;
    if (ir == NULL)
@@ -404,34 +511,55 @@ void DiffusionIntegrator::AssembleElementMatrix
       }
    }
 
-   elmat = 0.0;
-   for (int i = 0; i < ir->GetNPoints(); i++)
+   const GeometricFactors *gf = Trans.GetGeometricFactors(
+                                   *ir, GeometricFactors::JACOBIANS |
+                                   GeometricFactors::DETERMINANTS);
+   if (!MQ && Q) { Q->Eval(Q_ir, Trans, *ir); }
+
+   // The reference coefficient at the points, D = w adj(J) Q adj(J)^t, with
+   // elmat = sum_q dshape_q D_q dshape_q^t.
+   const int nq = ir->GetNPoints();
+   Vector D(dim*dim*nq);
+   for (int i = 0; i < nq; i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-      el.CalcDShape(ip, dshape);
-
-      Trans.SetIntPoint(&ip);
+      Trans.SetIntPoint(&ip, gf, i);
       w = Trans.Weight();
       w = ip.weight / (square ? w : w*w*w);
+      if (MQ)
+      {
+         MQ->Eval(invdfdx, Trans, ip);
+         invdfdx *= w;
+      }
+      else if (Q)
+      {
+         w *= Q_ir(i);
+      }
       // AdjugateJacobian = / adj(J),         if J is square
       //                    \ adj(J^t.J).J^t, otherwise
-      Mult(dshape, Trans.AdjugateJacobian(), dshapedxt);
-      if (!MQ)
+      const DenseMatrix &adjJ = Trans.AdjugateJacobian();
+      for (int l = 0; l < dim; l++)
       {
-         if (Q)
+         for (int k = 0; k < dim; k++)
          {
-            w *= Q->Eval(Trans, ip);
+            double d = 0.0;
+            for (int a = 0; a < spaceDim; a++)
+            {
+               if (!MQ)
+               {
+                  d += adjJ(k,a)*adjJ(l,a);
+                  continue;
+               }
+               for (int b = 0; b < spaceDim; b++)
+               {
+                  d += adjJ(k,a)*invdfdx(a,b)*adjJ(l,b);
+               }
+            }
+            D((k + dim*l)*nq + i) = MQ ? d : w*d;
          }
-         AddMult_a_AAt(w, dshapedxt, elmat);
-      }
-      else
-      {
-         MQ->Eval(invdfdx, Trans, ip);
-         invdfdx *= w;
-         Mult(dshapedxt, invdfdx, dshape);
-         AddMultABt(dshape, dshapedxt, elmat);
       }
    }
+   GradGradAssembler(el, *ir).Assemble(D, elmat);
 }
 
 void DiffusionIntegrator::AssembleElementMatrix2(
@@ -726,7 +854,7 @@ void MassIntegrator::AssembleElementMatrix
    double w;
 
 #ifdef MFEM_THREAD_SAFE
-   Vector shape;
+   Vector shape, Q_ir;
 #endif
    elmat.SetSize(nd);
    shape.SetSize(nd);
@@ -747,17 +875,20 @@ void MassIntegrator::AssembleElementMatrix
       }
    }
 
+   const GeometricFactors *gf =
+      Trans.GetGeometricFactors(*ir, GeometricFactors::DETERMINANTS);
+   if (Q) { Q->Eval(Q_ir, Trans, *ir); }
    elmat = 0.0;
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
       el.CalcShape(ip, shape);
 
-      Trans.SetIntPoint (&ip);
+      Trans.SetIntPoint(&ip, gf, i);
       w = Trans.Weight() * ip.weight;
       if (Q)
       {
-         w *= Q -> Eval(Trans, ip);
+         w *= Q_ir(i);
       }
 
       AddMult_a_VVt(w, shape, elmat);
@@ -880,6 +1011,8 @@ void ConvectionIntegrator::AssembleElementMatrix(
 
    Q.Eval(Q_ir, Trans, *ir);
 
+   const GeometricFactors *gf =
+      Trans.GetGeometricFactors(*ir, GeometricFactors::JACOBIANS);
    elmat = 0.0;
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
@@ -887,7 +1020,7 @@ void ConvectionIntegrator::AssembleElementMatrix(
       el.CalcDShape(ip, dshape);
       el.CalcShape(ip, shape);
 
-      Trans.SetIntPoint(&ip);
+      Trans.SetIntPoint(&ip, gf, i);
       CalcAdjugate(Trans.Jacobian(), adjJ);
       Q_ir.GetColumnReference(i, vec1);
       vec1 *= alpha * ip.weight;
@@ -962,19 +1095,24 @@ void VectorMassIntegrator::AssembleElementMatrix
 
    double norm;
 
-   // If vdim is not set, set it to the space dimension
-   vdim = (vdim == -1) ? spaceDim : vdim;
+#ifdef MFEM_THREAD_SAFE
+   Vector shape, vec, Q_ir;
+   DenseMatrix partelmat, mcoeff;
+#endif
+   // If vdim is not set, use the space dimension; the member is not modified,
+   // so that the integrator can be used by several threads
+   const int vd = (vdim == -1) ? spaceDim : vdim;
 
-   elmat.SetSize(nd*vdim);
+   elmat.SetSize(nd*vd);
    shape.SetSize(nd);
    partelmat.SetSize(nd);
    if (VQ)
    {
-      vec.SetSize(vdim);
+      vec.SetSize(vd);
    }
    else if (MQ)
    {
-      mcoeff.SetSize(vdim);
+      mcoeff.SetSize(vd);
    }
 
    const IntegrationRule *ir = IntRule;
@@ -992,13 +1130,16 @@ void VectorMassIntegrator::AssembleElementMatrix
       }
    }
 
+   const GeometricFactors *gf =
+      Trans.GetGeometricFactors(*ir, GeometricFactors::DETERMINANTS);
+   if (!VQ && !MQ && Q) { Q->Eval(Q_ir, Trans, *ir); }
    elmat = 0.0;
    for (int s = 0; s < ir->GetNPoints(); s++)
    {
       const IntegrationPoint &ip = ir->IntPoint(s);
       el.CalcShape(ip, shape);
 
-      Trans.SetIntPoint (&ip);
+      Trans.SetIntPoint(&ip, gf, s);
       norm = ip.weight * Trans.Weight();
 
       MultVVt(shape, partelmat);
@@ -1006,7 +1147,7 @@ void VectorMassIntegrator::AssembleElementMatrix
       if (VQ)
       {
          VQ->Eval(vec, Trans, ip);
-         for (int k = 0; k < vdim; k++)
+         for (int k = 0; k < vd; k++)
          {
             elmat.AddMatrix(norm*vec(k), partelmat, nd*k, nd*k);
          }
@@ -1014,8 +1155,8 @@ void VectorMassIntegrator::AssembleElementMatrix
       else if (MQ)
       {
          MQ->Eval(mcoeff, Trans, ip);
-         for (int i = 0; i < vdim; i++)
-            for (int j = 0; j < vdim; j++)
+         for (int i = 0; i < vd; i++)
+            for (int j = 0; j < vd; j++)
             {
                elmat.AddMatrix(norm*mcoeff(i,j), partelmat, nd*i, nd*j);
             }
@@ -1024,10 +1165,10 @@ void VectorMassIntegrator::AssembleElementMatrix
       {
          if (Q)
          {
-            norm *= Q->Eval(Trans, ip);
+            norm *= Q_ir(s);
          }
          partelmat *= norm;
-         for (int k = 0; k < vdim; k++)
+         for (int k = 0; k < vd; k++)
          {
             elmat.AddMatrix(partelmat, nd*k, nd*k);
          }
@@ -1044,20 +1185,25 @@ void VectorMassIntegrator::AssembleElementMatrix2(
 
    double norm;
 
-   // If vdim is not set, set it to the space dimension
-   vdim = (vdim == -1) ? Trans.GetSpaceDim() : vdim;
+#ifdef MFEM_THREAD_SAFE
+   Vector shape, te_shape, vec;
+   DenseMatrix partelmat, mcoeff;
+#endif
+   // If vdim is not set, use the space dimension; the member is not modified,
+   // so that the integrator can be used by several threads
+   const int vd = (vdim == -1) ? Trans.GetSpaceDim() : vdim;
 
-   elmat.SetSize(te_nd*vdim, tr_nd*vdim);
+   elmat.SetSize(te_nd*vd, tr_nd*vd);
    shape.SetSize(tr_nd);
    te_shape.SetSize(te_nd);
    partelmat.SetSize(te_nd, tr_nd);
    if (VQ)
    {
-      vec.SetSize(vdim);
+      vec.SetSize(vd);
    }
    else if (MQ)
    {
-      mcoeff.SetSize(vdim);
+      mcoeff.SetSize(vd);
    }
 
    const IntegrationRule *ir = IntRule;
@@ -1091,7 +1237,7 @@ void VectorMassIntegrator::AssembleElementMatrix2(
       if (VQ)
       {
          VQ->Eval(vec, Trans, ip);
-         for (int k = 0; k < vdim; k++)
+         for (int k = 0; k < vd; k++)
          {
             elmat.AddMatrix(norm*vec(k), partelmat, te_nd*k, tr_nd*k);
          }
@@ -1099,8 +1245,8 @@ void VectorMassIntegrator::AssembleElementMatrix2(
       else if (MQ)
       {
          MQ->Eval(mcoeff, Trans, ip);
-         for (int i = 0; i < vdim; i++)
-            for (int j = 0; j < vdim; j++)
+         for (int i = 0; i < vd; i++)
+            for (int j = 0; j < vd; j++)
             {
                elmat.AddMatrix(norm*mcoeff(i,j), partelmat, te_nd*i, tr_nd*j);
             }
@@ -1112,7 +1258,7 @@ void VectorMassIntegrator::AssembleElementMatrix2(
             norm *= Q->Eval(Trans, ip);
          }
          partelmat *= norm;
-         for (int k = 0; k < vdim; k++)
+         for (int k = 0; k < vd; k++)
          {
             elmat.AddMatrix(partelmat, te_nd*k, tr_nd*k);
          }
@@ -2181,13 +2327,10 @@ void ElasticityIntegrator::AssembleElementMatrix(
    MFEM_ASSERT(dim == Trans.GetSpaceDim(), "");
 
 #ifdef MFEM_THREAD_SAFE
-   DenseMatrix dshape(dof, dim), gshape(dof, dim), pelmat(dof);
-   Vector divshape(dim*dof);
+   DenseMatrix pelmat(dof);
+   Vector mu_ir, lambda_ir;
 #else
-   dshape.SetSize(dof, dim);
-   gshape.SetSize(dof, dim);
    pelmat.SetSize(dof);
-   divshape.SetSize(dim*dof);
 #endif
 
    elmat.SetSize(dof * dim);
@@ -2199,56 +2342,70 @@ void ElasticityIntegrator::AssembleElementMatrix(
       ir = &IntRules.Get(el.GetGeomType(), order);
    }
 
-   elmat = 0.0;
+   const GeometricFactors *gf = Trans.GetGeometricFactors(
+                                   *ir, GeometricFactors::DETERMINANTS |
+                                   GeometricFactors::INVERSES);
+   mu->Eval(mu_ir, Trans, *ir);
+   if (lambda) { lambda->Eval(lambda_ir, Trans, *ir); }
 
-   for (int i = 0; i < ir -> GetNPoints(); i++)
+   // The weighted Lame coefficients and the inverse Jacobians at the points
+   const int nq = ir->GetNPoints();
+   Vector Lw(nq), Mw(nq);
+   DenseTensor Jinv(dim, dim, nq);
+   for (int i = 0; i < nq; i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
-
-      el.CalcDShape(ip, dshape);
-
-      Trans.SetIntPoint(&ip);
+      Trans.SetIntPoint(&ip, gf, i);
       w = ip.weight * Trans.Weight();
-      Mult(dshape, Trans.InverseJacobian(), gshape);
-      MultAAt(gshape, pelmat);
-      gshape.GradToDiv (divshape);
+      Jinv(i) = Trans.InverseJacobian();
 
-      M = mu->Eval(Trans, ip);
+      M = mu_ir(i);
       if (lambda)
       {
-         L = lambda->Eval(Trans, ip);
+         L = lambda_ir(i);
       }
       else
       {
          L = q_lambda * M;
          M = q_mu * M;
       }
+      Lw(i) = L * w;
+      Mw(i) = M * w;
+   }
 
-      if (L != 0.0)
-      {
-         AddMult_a_VVt(L * w, divshape, elmat);
-      }
-
-      if (M != 0.0)
+   // The block (a,b) of elmat, coupling the displacement components a and b,
+   // is sum_q dshape_q D_q dshape_q^t, where, with gshape = dshape Jinv,
+   // gshape D gshape^t = L grad_a grad_b^t + M grad_b grad_a^t
+   //                     + M delta_ab sum_c grad_c grad_c^t.
+   // The matrix is symmetric, so only the blocks a <= b are computed.
+   GradGradAssembler grad_grad(el, *ir);
+   Vector D(dim*dim*nq);
+   for (int a = 0; a < dim; a++)
+   {
+      for (int b = a; b < dim; b++)
       {
-         for (int d = 0; d < dim; d++)
+         for (int i = 0; i < nq; i++)
          {
-            for (int k = 0; k < dof; k++)
-               for (int l = 0; l < dof; l++)
-               {
-                  elmat (dof*d+k, dof*d+l) += (M * w) * pelmat(k, l);
-               }
-         }
-         for (int i = 0; i < dim; i++)
-            for (int j = 0; j < dim; j++)
+            const DenseMatrix &Ji = Jinv(i);
+            for (int l = 0; l < dim; l++)
             {
-               for (int k = 0; k < dof; k++)
-                  for (int l = 0; l < dof; l++)
+               for (int k = 0; k < dim; k++)
+               {
+                  double d = Lw(i)*Ji(k,a)*Ji(l,b) + Mw(i)*Ji(k,b)*Ji(l,a);
+                  if (a == b)
                   {
-                     elmat(dof*i+k, dof*j+l) +=
-                        (M * w) * gshape(k, j) * gshape(l, i);
+                     for (int c = 0; c < dim; c++)
+                     {
+                        d += Mw(i)*Ji(k,c)*Ji(l,c);
+                     }
                   }
+                  D((k + dim*l)*nq + i) = d;
+               }
             }
+         }
+         grad_grad.Assemble(D, pelmat);
+         elmat.CopyMN(pelmat, dof*a, dof*b);
+         if (a != b) { elmat.CopyMNt(pelmat, dof*b, dof*a); }
       }
    }
 }
@@ -2564,6 +2721,11 @@ void DGDiffusionIntegrator::AssembleFaceMatrix(
    bool kappa_is_nonzero = (kappa != 0.);
    double w, wq = 0.0;
 
+#ifdef MFEM_THREAD_SAFE
+   Vector shape1, shape2, dshape1dn, dshape2dn, nor, nh, ni;
+   DenseMatrix jmat, dshape1, dshape2, mq, adjJ;
+#endif
+
    dim = el1.GetDim();
    ndof1 = el1.GetDof();
 
@@ -14,16 +14,30 @@
 
 #include "../config/config.hpp"
 #include "nonlininteg.hpp"
+#include "pa.hpp"
 
 namespace mfem
 {
 
+class FiniteElementSpace;
+
 /// Abstract base class BilinearFormIntegrator
 class BilinearFormIntegrator : public NonlinearFormIntegrator
 {
 protected:
+   /// @name Partial assembly data, set by AssemblePA()
+   ///@{
+   int pa_dim, pa_ne;
+   DofToQuad pa_maps;
+   Vector pa_data; ///< quadrature point data of all elements
+   ///@}
+
    BilinearFormIntegrator(const IntegrationRule *ir = NULL) :
-      NonlinearFormIntegrator(ir) { }
+      NonlinearFormIntegrator(ir), pa_dim(0), pa_ne(0) { }
+
+   /** @brief Set #pa_dim and #pa_ne, and check that the space @a fes is
+       supported by partial assembly; return false if the mesh is empty. */
+   bool InitPA(const FiniteElementSpace &fes);
 
 public:
    /// Given a particular Finite Element computes the element matrix elmat.
@@ -128,6 +142,23 @@ public:
                                     Vector &flux, Vector *d_energy = NULL)
    { return 0.0; }
 
+   /** @brief Compute and store the quadrature point data used by AddMultPA()
+       for all elements of the space @a fes. */
+   /** Partial assembly is supported on quadrilateral and hexahedral meshes
+       with tensor product elements (see TensorBasisElement); the action of the
+       element matrices is computed with sum factorization. */
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+
+   /** @brief Add the action of the element matrices to the E-vector @a y,
+       given the E-vector @a x, see ElementRestriction. */
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+
+   /// Add the action of the transposed element matrices, see AddMultPA().
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const;
+
+   /// Return the quadrature point data computed by AssemblePA().
+   const Vector &GetPAData() const { return pa_data; }
+
    virtual ~BilinearFormIntegrator() { }
 };
 
@@ -234,6 +265,8 @@ public:
                                       DenseMatrix &elmat)
    { AssembleElementMatrix2(fe, fe, Trans, elmat); }
 
+   virtual bool IsThreadSafe() const { return true; }
+
 protected:
    /// This parameter can be set by derived methods to enable single shape
    /// evaluation in case CalcTestShape() and CalcTrialShape() return the same
@@ -1629,6 +1662,7 @@ class DiffusionIntegrator: public BilinearFormIntegrator
 private:
    Vector vec, pointflux, shape;
 #ifndef MFEM_THREAD_SAFE
+   Vector Q_ir;
    DenseMatrix dshape, dshapedxt, invdfdx, mq;
    DenseMatrix te_dshape, te_dshapedxt;
 #endif
@@ -1657,6 +1691,8 @@ public:
                                        ElementTransformation &Trans,
                                        DenseMatrix &elmat);
 
+   virtual bool IsThreadSafe() const { return true; }
+
    /// Perform the local action of the BilinearFormIntegrator
    virtual void AssembleElementVector(const FiniteElement &el,
                                       ElementTransformation &Tr,
@@ -1670,6 +1706,11 @@ public:
    virtual double ComputeFluxEnergy(const FiniteElement &fluxelem,
                                     ElementTransformation &Trans,
                                     Vector &flux, Vector *d_energy = NULL);
+
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const
+   { AddMultPA(x, y); }
 };
 
 /** Class for local mass matrix assembling a(u,v) := (Q u, v) */
@@ -1677,7 +1718,7 @@ class MassIntegrator: public BilinearFormIntegrator
 {
 protected:
 #ifndef MFEM_THREAD_SAFE
-   Vector shape, te_shape;
+   Vector shape, te_shape, Q_ir;
 #endif
    Coefficient *Q;
 
@@ -1697,6 +1738,13 @@ public:
                                        const FiniteElement &test_fe,
                                        ElementTransformation &Trans,
                                        DenseMatrix &elmat);
+
+   virtual bool IsThreadSafe() const { return true; }
+
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const
+   { AddMultPA(x, y); }
 };
 
 class BoundaryMassIntegrator : public MassIntegrator
@@ -1729,6 +1777,12 @@ public:
    virtual void AssembleElementMatrix(const FiniteElement &,
                                       ElementTransformation &,
                                       DenseMatrix &);
+
+   virtual bool IsThreadSafe() const { return true; }
+
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const;
 };
 
 /// alpha (q . grad u, v) using the "group" FE discretization
@@ -1755,9 +1809,11 @@ class VectorMassIntegrator: public BilinearFormIntegrator
 {
 private:
    int vdim;
-   Vector shape, te_shape, vec;
+#ifndef MFEM_THREAD_SAFE
+   Vector shape, te_shape, vec, Q_ir;
    DenseMatrix partelmat;
    DenseMatrix mcoeff;
+#endif
    Coefficient *Q;
    VectorCoefficient *VQ;
    MatrixCoefficient *MQ;
@@ -1794,6 +1850,14 @@ public:
                                        const FiniteElement &test_fe,
                                        ElementTransformation &Trans,
                                        DenseMatrix &elmat);
+
+   virtual bool IsThreadSafe() const { return true; }
+
+   /// Partial assembly supports only a scalar coefficient, if any.
+   virtual void AssemblePA(const FiniteElementSpace &fes);
+   virtual void AddMultPA(const Vector &x, Vector &y) const;
+   virtual void AddMultTransposePA(const Vector &x, Vector &y) const
+   { AddMultPA(x, y); }
 };
 
 
@@ -2071,8 +2135,8 @@ private:
 
 #ifndef MFEM_THREAD_SAFE
    Vector shape;
-   DenseMatrix dshape, gshape, pelmat;
-   Vector divshape;
+   DenseMatrix dshape, pelmat;
+   Vector mu_ir, lambda_ir;
 #endif
 
 public:
@@ -2087,6 +2151,8 @@ public:
                                       ElementTransformation &,
                                       DenseMatrix &);
 
+   virtual bool IsThreadSafe() const { return true; }
+
    /** Compute the stress corresponding to the local displacement @a u and
        interpolate it at the nodes of the given @a fluxelem. Only the symmetric
        part of the stress is stored, so that the size of @a flux is equal to
@@ -2167,9 +2233,10 @@ protected:
    MatrixCoefficient *MQ;
    double sigma, kappa;
 
-   // these are not thread-safe!
+#ifndef MFEM_THREAD_SAFE
    Vector shape1, shape2, dshape1dn, dshape2dn, nor, nh, ni;
    DenseMatrix jmat, dshape1, dshape2, mq, adjJ;
+#endif
 
 public:
    DGDiffusionIntegrator(const double s, const double k)
@@ -2183,6 +2250,8 @@ public:
                                    const FiniteElement &el2,
                                    FaceElementTransformations &Trans,
                                    DenseMatrix &elmat);
+
+   virtual bool IsThreadSafe() const { return true; }
 };
 
 /** Integrator for the DG elasticity form, for the formulations see:
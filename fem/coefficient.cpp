@@ -21,6 +21,18 @@ namespace mfem
 
 using namespace std;
 
+void Coefficient::Eval(Vector &V, ElementTransformation &T,
+                       const IntegrationRule &ir)
+{
+   V.SetSize(ir.GetNPoints());
+   for (int i = 0; i < ir.GetNPoints(); i++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(i);
+      T.SetIntPoint(&ip);
+      V(i) = Eval(T, ip);
+   }
+}
+
 double PWConstCoefficient::Eval(ElementTransformation & T,
                                 const IntegrationPoint & ip)
 {
@@ -46,12 +58,32 @@ double FunctionCoefficient::Eval(ElementTransformation & T,
    }
 }
 
+void FunctionCoefficient::Eval(Vector &V, ElementTransformation &T,
+                               const IntegrationRule &ir)
+{
+   DenseMatrix X;
+   Vector x;
+   T.Transform(ir, X);
+   V.SetSize(ir.GetNPoints());
+   for (int i = 0; i < ir.GetNPoints(); i++)
+   {
+      X.GetColumnReference(i, x);
+      V(i) = Function ? (*Function)(x) : (*TDFunction)(x, GetTime());
+   }
+}
+
 double GridFunctionCoefficient::Eval (ElementTransformation &T,
                                       const IntegrationPoint &ip)
 {
    return GridF -> GetValue (T.ElementNo, ip, Component);
 }
 
+void GridFunctionCoefficient::Eval(Vector &V, ElementTransformation &T,
+                                   const IntegrationRule &ir)
+{
+   GridF->GetValues(T.ElementNo, ir, V, Component);
+}
+
 double TransformedCoefficient::Eval(ElementTransformation &T,
                                     const IntegrationPoint &ip)
 {
@@ -350,6 +382,30 @@ void MatrixRestrictedCoefficient::Eval(DenseMatrix &K, ElementTransformation &T,
    }
 }
 
+void SumCoefficient::Eval(Vector &V, ElementTransformation &T,
+                          const IntegrationRule &ir)
+{
+   Vector Vb;
+   a->Eval(V, T, ir);
+   b->Eval(Vb, T, ir);
+   for (int i = 0; i < V.Size(); i++)
+   {
+      V(i) = alpha * V(i) + beta * Vb(i);
+   }
+}
+
+void ProductCoefficient::Eval(Vector &V, ElementTransformation &T,
+                              const IntegrationRule &ir)
+{
+   Vector Vb;
+   a->Eval(V, T, ir);
+   b->Eval(Vb, T, ir);
+   for (int i = 0; i < V.Size(); i++)
+   {
+      V(i) *= Vb(i);
+   }
+}
+
 InnerProductCoefficient::InnerProductCoefficient(VectorCoefficient &A,
                                                  VectorCoefficient &B)
    : a(&A), b(&B)
@@ -59,6 +59,18 @@ public:
       return Eval(T, ip);
    }
 
+   /** @brief Evaluate the coefficient in the element described by @a T at all
+       points of @a ir, storing the values in @a V. */
+   /** The default implementation calls Eval(T, ip) for every point. Derived
+       classes override it when the values at all points can be computed at
+       once more efficiently, e.g. by transforming all points together.
+
+       @note The IntegrationPoint associated with @a T is not used, and this
+       method will generally modify this IntegrationPoint associated with @a T.
+   */
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationRule &ir);
+
    virtual ~Coefficient() { }
 };
 
@@ -76,6 +88,11 @@ public:
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip)
    { return (constant); }
+
+   /// Evaluate the coefficient at all points of @a ir.
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationRule &ir)
+   { V.SetSize(ir.GetNPoints()); V = constant; }
 };
 
 /// class for piecewise constant coefficient
@@ -110,6 +127,11 @@ public:
    /// Evaluate the coefficient function
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip);
+
+   /// Evaluate the coefficient at all points of @a ir.
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationRule &ir)
+   { V.SetSize(ir.GetNPoints()); V = constants(T.Attribute-1); }
 };
 
 /// class for C-function coefficient
@@ -155,6 +177,11 @@ public:
    /// Evaluate coefficient
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip);
+
+   /** @brief Evaluate the coefficient at all points of @a ir, transforming
+       the points with a single call to ElementTransformation::Transform(). */
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationRule &ir);
 };
 
 class GridFunction;
@@ -178,6 +205,11 @@ public:
 
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip);
+
+   /** @brief Evaluate the coefficient at all points of @a ir, extracting the
+       element dofs only once, see GridFunction::GetValues(). */
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationRule &ir);
 };
 
 class TransformedCoefficient : public Coefficient
@@ -682,6 +714,10 @@ public:
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip)
    { return alpha * a->Eval(T, ip) + beta * b->Eval(T, ip); }
+
+   /// Evaluate the coefficient at all points of @a ir.
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationRule &ir);
 };
 
 /// Scalar coefficient defined as the product of two scalar coefficients
@@ -699,6 +735,10 @@ public:
    virtual double Eval(ElementTransformation &T,
                        const IntegrationPoint &ip)
    { return a->Eval(T, ip) * b->Eval(T, ip); }
+
+   /// Evaluate the coefficient at all points of @a ir.
+   virtual void Eval(Vector &V, ElementTransformation &T,
+                     const IntegrationRule &ir);
 };
 
 /// Scalar coefficient defined as a scalar raised to a power
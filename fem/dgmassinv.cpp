@@ -0,0 +1,63 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class DGMassInverse
+
+#include "fem.hpp"
+
+namespace mfem
+{
+
+DGMassInverse::DGMassInverse(FiniteElementSpace &fes_, Coefficient *Q)
+   : Operator(fes_.GetVSize()), fes(fes_)
+{
+   const int NE = fes.GetNE();
+   const int nd = NE ? fes.GetFE(0)->GetDof() : 0;
+   MFEM_VERIFY(fes.GetNDofs() == NE*nd,
+               "the space is not discontinuous or the elements have different"
+               " numbers of dofs");
+
+   ConstantCoefficient one(1.0);
+   MassIntegrator mass(Q ? *Q : one);
+   L.SetSize(nd, nd, NE);
+   DenseMatrix M_e;
+   for (int e = 0; e < NE; e++)
+   {
+      mass.AssembleElementMatrix(*fes.GetFE(e),
+                                 *fes.GetElementTransformation(e), M_e);
+      MFEM_VERIFY(M_e.Height() == nd, "the elements have different numbers of"
+                  " dofs");
+      L(e) = M_e;
+   }
+   BatchCholeskyFactor(L);
+}
+
+void DGMassInverse::Mult(const Vector &x, Vector &y) const
+{
+   const int NE = fes.GetNE(), nd = L.SizeI();
+   xe.SetSize(nd*NE);
+   for (int c = 0; c < fes.GetVDim(); c++)
+   {
+      for (int e = 0; e < NE; e++)
+      {
+         fes.GetElementVDofs(e, vdofs);
+         for (int i = 0; i < nd; i++) { xe(e*nd+i) = x(vdofs[c*nd+i]); }
+      }
+      BatchCholeskySolve(L, xe);
+      for (int e = 0; e < NE; e++)
+      {
+         fes.GetElementVDofs(e, vdofs);
+         for (int i = 0; i < nd; i++) { y(vdofs[c*nd+i]) = xe(e*nd+i); }
+      }
+   }
+}
+
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_DGMASSINV
+#define MFEM_DGMASSINV
+
+#include "../config/config.hpp"
+#include "../linalg/operator.hpp"
+#include "../linalg/densemat.hpp"
+#include "fespace.hpp"
+#include "coefficient.hpp"
+
+namespace mfem
+{
+
+/** @brief Inverse of the block diagonal mass matrix of a discontinuous (L2)
+    finite element space. */
+/** The element mass matrices, with an optional coefficient, are assembled
+    with MassIntegrator in the constructor and factored with
+    BatchCholeskyFactor(); Mult() solves with all the element factors with
+    BatchCholeskySolve(), component by component for vector spaces. All the
+    elements must have the same number of dofs, e.g. meshes with a single
+    element type. */
+class DGMassInverse : public Operator
+{
+protected:
+   FiniteElementSpace &fes;
+   /// Cholesky factors of the element mass matrices.
+   DenseTensor L;
+   mutable Array<int> vdofs;
+   mutable Vector xe;
+
+public:
+   /** @brief Construct the inverse mass matrix of the L2 space @a fes_, with
+       the coefficient @a Q, if not NULL. */
+   DGMassInverse(FiniteElementSpace &fes_, Coefficient *Q = NULL);
+
+   /// Compute y = M^{-1} x.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// Same as Mult(), since the mass matrix is symmetric.
+   virtual void MultTranspose(const Vector &x, Vector &y) const
+   { Mult(x, y); }
+};
+
+}
+
+#endif
@@ -20,9 +20,46 @@ ElementTransformation::ElementTransformation()
    : IntPoint(static_cast<IntegrationPoint *>(NULL)),
      EvalState(0),
      Attribute(-1),
-     ElementNo(-1)
+     ElementNo(-1),
+     mesh(NULL)
 { }
 
+void ElementTransformation::SetIntPoint(const IntegrationPoint *ip,
+                                        const GeometricFactors *gf, int q)
+{
+   IntPoint = ip;
+   EvalState = 0;
+   if (!gf) { return; }
+   MFEM_ASSERT(gf->geom == geom && ElementNo >= 0 && ElementNo < gf->NE,
+               "invalid geometric factors");
+   MFEM_ASSERT(&gf->IntRule.IntPoint(q) == ip ||
+               (ip->x == gf->IntRule.IntPoint(q).x &&
+                ip->y == gf->IntRule.IntPoint(q).y &&
+                ip->z == gf->IntRule.IntPoint(q).z), "invalid point index");
+   if (gf->computed_factors & GeometricFactors::JACOBIANS)
+   {
+      gf->GetJacobian(ElementNo, q, dFdx);
+      EvalState |= JACOBIAN_MASK;
+   }
+   if (gf->computed_factors & GeometricFactors::DETERMINANTS)
+   {
+      Wght = gf->GetWeight(ElementNo, q);
+      EvalState |= WEIGHT_MASK;
+   }
+   if (gf->computed_factors & GeometricFactors::INVERSES)
+   {
+      gf->GetInverseJacobian(ElementNo, q, invJ);
+      EvalState |= INVERSE_MASK;
+   }
+}
+
+const GeometricFactors *ElementTransformation::GetGeometricFactors(
+   const IntegrationRule &ir, int flags)
+{
+   if (!mesh || !mesh->GetGeometricFactorsCaching()) { return NULL; }
+   return mesh->GetGeometricFactors(ir, flags, geom);
+}
+
 double ElementTransformation::EvalWeight()
 {
    MFEM_ASSERT((EvalState & WEIGHT_MASK) == 0, "");
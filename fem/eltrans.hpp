@@ -20,6 +20,9 @@
 namespace mfem
 {
 
+class Mesh;
+class GeometricFactors;
+
 class ElementTransformation
 {
 protected:
@@ -48,10 +51,31 @@ protected:
 public:
    int Attribute, ElementNo;
 
+   /** @brief The Mesh containing the element #ElementNo, set only by the
+       Mesh::GetElementTransformation() methods that use the mesh nodes, and
+       NULL otherwise. */
+   Mesh *mesh;
+
    ElementTransformation();
 
    void SetIntPoint(const IntegrationPoint *ip)
    { IntPoint = ip; EvalState = 0; }
+
+   /** @brief Set the IntegrationPoint @a ip, which is the point with index
+       @a q of the rule used to compute @a gf, taking the available Jacobian,
+       weight and inverse Jacobian from @a gf instead of evaluating them. */
+   /** If @a gf is NULL, this is the same as SetIntPoint(ip). */
+   void SetIntPoint(const IntegrationPoint *ip, const GeometricFactors *gf,
+                    int q);
+
+   /** @brief Return the cached geometric factors @a flags of the element at
+       the points of @a ir, or NULL if the cache is not used. */
+   /** The cache is used if #mesh is set and its caching is enabled, see
+       Mesh::SetGeometricFactorsCaching(). The returned factors are passed to
+       SetIntPoint(const IntegrationPoint *, const GeometricFactors *, int)
+       for the points of @a ir. */
+   const GeometricFactors *GetGeometricFactors(const IntegrationRule &ir,
+                                               int flags);
    const IntegrationPoint &GetIntPoint() { return *IntPoint; }
 
    virtual void Transform(const IntegrationPoint &, Vector &) = 0;
@@ -20,6 +20,7 @@
 #include "coefficient.hpp"
 #include "lininteg.hpp"
 #include "nonlininteg.hpp"
+#include "pa.hpp"
 #include "bilininteg.hpp"
 #include "fespace.hpp"
 #include "gridfunc.hpp"
@@ -30,6 +31,8 @@
 #include "datacollection.hpp"
 #include "estimators.hpp"
 #include "staticcond.hpp"
+#include "multigrid.hpp"
+#include "dgmassinv.hpp"
 #include "tmop.hpp"
 
 #ifdef MFEM_USE_MPI
@@ -60,6 +60,7 @@ FiniteElementSpace::FiniteElementSpace()
      ndofs(0), nvdofs(0), nedofs(0), nfdofs(0), nbdofs(0),
      fdofs(NULL), bdofs(NULL),
      elem_dof(NULL), bdrElem_dof(NULL),
+     elem_colors(NULL), bdr_elem_colors(NULL), face_colors(NULL),
      NURBSext(NULL), own_ext(false),
      cP(NULL), cR(NULL), cP_is_set(false),
      Th(Operator::ANY_TYPE),
@@ -232,6 +233,93 @@ void FiniteElementSpace::BuildElementToDofTable() const
    elem_dof = el_dof;
 }
 
+void FiniteElementSpace::DeleteColorings()
+{
+   delete elem_colors;
+   delete bdr_elem_colors;
+   delete face_colors;
+   elem_colors = bdr_elem_colors = face_colors = NULL;
+}
+
+const Table &FiniteElementSpace::GetElementColoring() const
+{
+   if (elem_colors) { return *elem_colors; }
+
+   Table el_dof;
+   Array<int> dofs;
+   el_dof.MakeI(GetNE());
+   for (int i = 0; i < GetNE(); i++)
+   {
+      GetElementDofs(i, dofs);
+      el_dof.AddColumnsInRow(i, dofs.Size());
+   }
+   el_dof.MakeJ();
+   for (int i = 0; i < GetNE(); i++)
+   {
+      GetElementDofs(i, dofs);
+      el_dof.AddConnections(i, dofs.GetData(), dofs.Size());
+   }
+   el_dof.ShiftUpI();
+   elem_colors = new Table;
+   ColorTableRows(el_dof, *elem_colors);
+   return *elem_colors;
+}
+
+const Table &FiniteElementSpace::GetBdrElementColoring() const
+{
+   if (bdr_elem_colors) { return *bdr_elem_colors; }
+
+   Table be_dof;
+   Array<int> dofs;
+   be_dof.MakeI(GetNBE());
+   for (int i = 0; i < GetNBE(); i++)
+   {
+      GetBdrElementDofs(i, dofs);
+      be_dof.AddColumnsInRow(i, dofs.Size());
+   }
+   be_dof.MakeJ();
+   for (int i = 0; i < GetNBE(); i++)
+   {
+      GetBdrElementDofs(i, dofs);
+      be_dof.AddConnections(i, dofs.GetData(), dofs.Size());
+   }
+   be_dof.ShiftUpI();
+   bdr_elem_colors = new Table;
+   ColorTableRows(be_dof, *bdr_elem_colors);
+   return *bdr_elem_colors;
+}
+
+const Table &FiniteElementSpace::GetFaceColoring() const
+{
+   if (face_colors) { return *face_colors; }
+
+   // Faces with a neighbor element on another processor (Elem2No < 0) are
+   // colored using their local element only.
+   Table face_dof;
+   Array<int> dofs;
+   int el[2];
+   face_dof.MakeI(GetNF());
+   for (int pass = 0; pass < 2; pass++)
+   {
+      for (int f = 0; f < GetNF(); f++)
+      {
+         mesh->GetFaceElements(f, &el[0], &el[1]);
+         for (int k = 0; k < 2; k++)
+         {
+            if (el[k] < 0) { continue; }
+            GetElementDofs(el[k], dofs);
+            if (pass == 0) { face_dof.AddColumnsInRow(f, dofs.Size()); }
+            else { face_dof.AddConnections(f, dofs.GetData(), dofs.Size()); }
+         }
+      }
+      if (pass == 0) { face_dof.MakeJ(); }
+   }
+   face_dof.ShiftUpI();
+   face_colors = new Table;
+   ColorTableRows(face_dof, *face_colors);
+   return *face_colors;
+}
+
 void FiniteElementSpace::RebuildElementToDofTable()
 {
    delete elem_dof;
@@ -1114,6 +1202,7 @@ void FiniteElementSpace::Constructor(Mesh *mesh, NURBSExtension *NURBSext,
    this->ordering = (Ordering::Type) ordering;
 
    elem_dof = NULL;
+   elem_colors = bdr_elem_colors = face_colors = NULL;
    sequence = mesh->GetSequence();
    Th.SetType(Operator::ANY_TYPE);
 
@@ -1175,6 +1264,8 @@ void FiniteElementSpace::UpdateNURBS()
    ndofs = NURBSext->GetNDof();
    elem_dof = NURBSext->GetElementDofTable();
    bdrElem_dof = NURBSext->GetBdrElementDofTable();
+
+   DeleteColorings();
 }
 
 void FiniteElementSpace::Construct()
@@ -1660,6 +1751,8 @@ void FiniteElementSpace::Destroy()
    dof_elem_array.DeleteAll();
    dof_ldof_array.DeleteAll();
 
+   DeleteColorings();
+
    if (NURBSext)
    {
       if (own_ext) { delete NURBSext; }
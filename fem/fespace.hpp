@@ -89,6 +89,9 @@ protected:
    mutable Table *elem_dof; // if NURBS FE space, not owned; otherwise, owned.
    Table *bdrElem_dof; // used only with NURBS FE spaces; not owned.
 
+   /// Colorings of the elements, boundary elements, and faces; owned.
+   mutable Table *elem_colors, *bdr_elem_colors, *face_colors;
+
    Array<int> dof_elem_array, dof_ldof_array;
 
    NURBSExtension *NURBSext;
@@ -114,6 +117,8 @@ protected:
 
    void BuildElementToDofTable() const;
 
+   void DeleteColorings();
+
    /// Helper to remove encoded sign from a DOF
    static inline int DecodeDof(int dof, double& sign)
    { return (dof >= 0) ? (sign = 1, dof) : (sign = -1, (-1 - dof)); }
@@ -390,6 +395,22 @@ public:
    const Table &GetElementToDofTable() const { return *elem_dof; }
    const Table &GetBdrElementToDofTable() const { return *bdrElem_dof; }
 
+   /** @brief Return a coloring of the elements such that elements with the
+       same color share no dofs: row c of the Table lists the elements with
+       color c. */
+   /** The coloring is computed on first use and reset when the space is
+       updated. It is used by the threaded assembly in BilinearForm,
+       MixedBilinearForm, and LinearForm. */
+   const Table &GetElementColoring() const;
+
+   /** @brief Coloring of the boundary elements by their dofs, see
+       GetElementColoring(). */
+   const Table &GetBdrElementColoring() const;
+
+   /** @brief Coloring of the faces such that faces with the same color share no
+       dofs of their adjacent elements, see GetElementColoring(). */
+   const Table &GetFaceColoring() const;
+
    int GetElementForDof(int i) const { return dof_elem_array[i]; }
    int GetLocalDofForDof(int i) const { return dof_ldof_array[i]; }
 
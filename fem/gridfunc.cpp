@@ -1887,6 +1887,7 @@ double GridFunction::ComputeL2Error(
    Array<int> vdofs;
    int fdof, d, i, intorder, j, k;
 
+   fes->GetMesh()->CheckGeometricFactors();
    for (i = 0; i < fes->GetNE(); i++)
    {
       fe = fes->GetFE(i);
@@ -1904,6 +1905,8 @@ double GridFunction::ComputeL2Error(
          ir = &(IntRules.Get(fe->GetGeomType(), intorder));
       }
       fes->GetElementVDofs(i, vdofs);
+      const GeometricFactors *gf =
+         transf->GetGeometricFactors(*ir, GeometricFactors::DETERMINANTS);
       for (j = 0; j < ir->GetNPoints(); j++)
       {
          const IntegrationPoint &ip = ir->IntPoint(j);
@@ -1920,7 +1923,7 @@ double GridFunction::ComputeL2Error(
                {
                   a -= (*this)(-1-vdofs[fdof*d+k]) * shape(k);
                }
-            transf->SetIntPoint(&ip);
+            transf->SetIntPoint(&ip, gf, j);
             a -= exsol[d]->Eval(*transf, ip);
             error += ip.weight * transf->Weight() * a * a;
          }
@@ -1944,6 +1947,7 @@ double GridFunction::ComputeL2Error(
    DenseMatrix vals, exact_vals;
    Vector loc_errs;
 
+   fes->GetMesh()->CheckGeometricFactors();
    for (int i = 0; i < fes->GetNE(); i++)
    {
       if (elems != NULL && (*elems)[i] == 0) { continue; }
@@ -1964,10 +1968,12 @@ double GridFunction::ComputeL2Error(
       vals -= exact_vals;
       loc_errs.SetSize(vals.Width());
       vals.Norm2(loc_errs);
+      const GeometricFactors *gf =
+         T->GetGeometricFactors(*ir, GeometricFactors::DETERMINANTS);
       for (int j = 0; j < ir->GetNPoints(); j++)
       {
          const IntegrationPoint &ip = ir->IntPoint(j);
-         T->SetIntPoint(&ip);
+         T->SetIntPoint(&ip, gf, j);
          error += ip.weight * T->Weight() * (loc_errs(j) * loc_errs(j));
       }
    }
@@ -2297,8 +2303,9 @@ double GridFunction::ComputeLpError(const double p, Coefficient &exsol,
    double error = 0.0;
    const FiniteElement *fe;
    ElementTransformation *T;
-   Vector vals;
+   Vector vals, exact_vals, weight_vals;
 
+   fes->GetMesh()->CheckGeometricFactors();
    for (int i = 0; i < fes->GetNE(); i++)
    {
       fe = fes->GetFE(i);
@@ -2314,17 +2321,21 @@ double GridFunction::ComputeLpError(const double p, Coefficient &exsol,
       }
       GetValues(i, *ir, vals);
       T = fes->GetElementTransformation(i);
+      exsol.Eval(exact_vals, *T, *ir);
+      if (weight) { weight->Eval(weight_vals, *T, *ir); }
+      const GeometricFactors *gf =
+         T->GetGeometricFactors(*ir, GeometricFactors::DETERMINANTS);
       for (int j = 0; j < ir->GetNPoints(); j++)
       {
          const IntegrationPoint &ip = ir->IntPoint(j);
-         T->SetIntPoint(&ip);
-         double err = fabs(vals(j) - exsol.Eval(*T, ip));
+         T->SetIntPoint(&ip, gf, j);
+         double err = fabs(vals(j) - exact_vals(j));
          if (p < infinity())
          {
             err = pow(err, p);
             if (weight)
             {
-               err *= weight->Eval(*T, ip);
+               err *= weight_vals(j);
             }
             error += ip.weight * T->Weight() * err;
          }
@@ -2332,7 +2343,7 @@ double GridFunction::ComputeLpError(const double p, Coefficient &exsol,
          {
             if (weight)
             {
-               err *= weight->Eval(*T, ip);
+               err *= weight_vals(j);
             }
             error = std::max(error, err);
          }
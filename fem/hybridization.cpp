@@ -581,6 +581,33 @@ void Hybridization::ComputeH()
    SparseMatrix *V = pC ? new SparseMatrix(Ct->Height(), Ct->Width()) : NULL;
 #endif
 
+   // Factor the blocks A_ii of all the elements, then the Schur complements
+   // S_b = A_bb - A_bi A_ii^{-1} A_ib, with the batched LU factorization.
+   {
+      Array<int> i_sizes(NE), b_sizes(NE);
+      Array<double *> A_ii(NE), S_b(NE);
+      Array<int *> P_ii(NE), P_b(NE);
+      for (int el = 0; el < NE; el++)
+      {
+         GetBDofs(el, i_sizes[el], b_dofs);
+         const int i_size = i_sizes[el], b_size = b_sizes[el] = b_dofs.Size();
+         A_ii[el] = Af_data + Af_offsets[el];
+         P_ii[el] = Af_ipiv + Af_f_offsets[el];
+         S_b[el] = A_ii[el] + i_size*i_size + 2*i_size*b_size;
+         P_b[el] = P_ii[el] + i_size;
+      }
+      BatchLUFactor(i_sizes, A_ii, P_ii);
+      for (int el = 0; el < NE; el++)
+      {
+         const int i_size = i_sizes[el];
+         double *A_ib_data = A_ii[el] + i_size*i_size;
+         LUFactors(A_ii[el], P_ii[el]).BlockFactor(
+            i_size, b_sizes[el], A_ib_data, A_ib_data + i_size*b_sizes[el],
+            S_b[el]);
+      }
+      BatchLUFactor(b_sizes, S_b, P_b);
+   }
+
    c_dof_marker = -1;
    int c_mark_start = 0;
    for (int el = 0; el < NE; el++)
@@ -588,16 +615,9 @@ void Hybridization::ComputeH()
       int i_dofs_size;
       GetBDofs(el, i_dofs_size, b_dofs);
 
-      LUFactors LU_ii(Af_data + Af_offsets[el], Af_ipiv + Af_f_offsets[el]);
-      double *A_ib_data = LU_ii.data + i_dofs_size*i_dofs_size;
-      double *A_bi_data = A_ib_data + i_dofs_size*b_dofs.Size();
-      LUFactors LU_bb(A_bi_data + i_dofs_size*b_dofs.Size(),
-                      LU_ii.ipiv + i_dofs_size);
-
-      LU_ii.Factor(i_dofs_size);
-      LU_ii.BlockFactor(i_dofs_size, b_dofs.Size(),
-                        A_ib_data, A_bi_data, LU_bb.data);
-      LU_bb.Factor(b_dofs.Size());
+      double *A_ib_data = Af_data + Af_offsets[el] + i_dofs_size*i_dofs_size;
+      LUFactors LU_bb(A_ib_data + 2*i_dofs_size*b_dofs.Size(),
+                      Af_ipiv + Af_f_offsets[el] + i_dofs_size);
 
       // Extract Cb_t from Ct, define c_dofs
       c_dofs.SetSize(0);
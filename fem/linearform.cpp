@@ -21,6 +21,7 @@ LinearForm::LinearForm(FiniteElementSpace *f, LinearForm *lf)
 {
    fes = f;
    extern_lfs = 1;
+   threaded_assembly = false;
 
    // Copy the pointers to the integrators
    dlfi = lf->dlfi;
@@ -81,8 +82,15 @@ void LinearForm::Assemble()
 
    int i;
 
+   fes->GetMesh()->CheckGeometricFactors();
    Vector::operator=(0.0);
 
+   if (threaded_assembly)
+   {
+      ColoredAssemble();
+      return;
+   }
+
    if (dlfi.Size())
    {
       for (i = 0; i < fes -> GetNE(); i++)
@@ -185,6 +193,175 @@ void LinearForm::Assemble()
    }
 }
 
+namespace internal
+{
+
+void MarkBdrAttributes(const Mesh &mesh, const Array<Array<int>*> &markers,
+                       Array<int> &bdr_attr_marker)
+{
+   bdr_attr_marker.SetSize(mesh.bdr_attributes.Size() ?
+                           mesh.bdr_attributes.Max() : 0);
+   bdr_attr_marker = 0;
+   for (int k = 0; k < markers.Size(); k++)
+   {
+      if (markers[k] == NULL)
+      {
+         bdr_attr_marker = 1;
+         break;
+      }
+      const Array<int> &bdr_marker = *markers[k];
+      MFEM_ASSERT(bdr_marker.Size() == bdr_attr_marker.Size(),
+                  "invalid boundary marker for integrator #"
+                  << k << ", counting from zero");
+      for (int i = 0; i < bdr_attr_marker.Size(); i++)
+      {
+         bdr_attr_marker[i] |= bdr_marker[i];
+      }
+   }
+}
+
+}
+
+void LinearForm::ColoredAssemble()
+{
+   Mesh *mesh = fes->GetMesh();
+
+   if (dlfi.Size())
+   {
+      // The integrators that are not thread-safe are used serially.
+#ifdef MFEM_USE_OPENMP
+      const bool concurrent = internal::IntegratorsAreThreadSafe(dlfi);
+#endif
+      const Table &colors = fes->GetElementColoring();
+      for (int c = 0; c < colors.Size(); c++)
+      {
+         const int *elems = colors.GetRow(c);
+         const int num_elems = colors.RowSize(c);
+#ifdef MFEM_USE_OPENMP
+         #pragma omp parallel if (concurrent)
+#endif
+         {
+            Vector elemvect;
+            Array<int> el_vdofs;
+            IsoparametricTransformation eltrans;
+#ifdef MFEM_USE_OPENMP
+            #pragma omp for
+#endif
+            for (int j = 0; j < num_elems; j++)
+            {
+               const int i = elems[j];
+               fes->GetElementVDofs(i, el_vdofs);
+               fes->GetElementTransformation(i, &eltrans);
+               for (int k = 0; k < dlfi.Size(); k++)
+               {
+                  dlfi[k]->AssembleRHSElementVect(*fes->GetFE(i), eltrans,
+                                                  elemvect);
+                  AddElementVector(el_vdofs, elemvect);
+               }
+            }
+         }
+      }
+   }
+   AssembleDelta();
+
+   if (blfi.Size())
+   {
+#ifdef MFEM_USE_OPENMP
+      const bool concurrent = internal::IntegratorsAreThreadSafe(blfi);
+#endif
+      Array<int> bdr_attr_marker;
+      internal::MarkBdrAttributes(*mesh, blfi_marker, bdr_attr_marker);
+
+      const Table &colors = fes->GetBdrElementColoring();
+      for (int c = 0; c < colors.Size(); c++)
+      {
+         const int *belems = colors.GetRow(c);
+         const int num_belems = colors.RowSize(c);
+#ifdef MFEM_USE_OPENMP
+         #pragma omp parallel if (concurrent)
+#endif
+         {
+            Vector elemvect;
+            Array<int> be_vdofs;
+            IsoparametricTransformation eltrans;
+#ifdef MFEM_USE_OPENMP
+            #pragma omp for
+#endif
+            for (int j = 0; j < num_belems; j++)
+            {
+               const int i = belems[j];
+               const int bdr_attr = mesh->GetBdrAttribute(i);
+               if (bdr_attr_marker[bdr_attr-1] == 0) { continue; }
+               fes->GetBdrElementVDofs(i, be_vdofs);
+               mesh->GetBdrElementTransformation(i, &eltrans);
+               for (int k = 0; k < blfi.Size(); k++)
+               {
+                  blfi[k]->AssembleRHSElementVect(*fes->GetBE(i), eltrans,
+                                                  elemvect);
+                  AddElementVector(be_vdofs, elemvect);
+               }
+            }
+         }
+      }
+   }
+
+   if (flfi.Size())
+   {
+#ifdef MFEM_USE_OPENMP
+      const bool concurrent = internal::IntegratorsAreThreadSafe(flfi);
+#endif
+      Array<int> bdr_attr_marker;
+      internal::MarkBdrAttributes(*mesh, flfi_marker, bdr_attr_marker);
+
+      // The boundary faces are processed using the face coloring.
+      Array<int> face_bdr(mesh->GetNumFaces());
+      face_bdr = -1;
+      for (int i = 0; i < mesh->GetNBE(); i++)
+      {
+         face_bdr[mesh->GetBdrElementEdgeIndex(i)] = i;
+      }
+
+      const Table &colors = fes->GetFaceColoring();
+      for (int c = 0; c < colors.Size(); c++)
+      {
+         const int *faces = colors.GetRow(c);
+         const int num_faces = colors.RowSize(c);
+#ifdef MFEM_USE_OPENMP
+         #pragma omp parallel if (concurrent)
+#endif
+         {
+            Vector elemvect;
+            Array<int> face_vdofs;
+            FaceElementTransformations tr;
+            IsoparametricTransformation eltrans1, eltrans2, ftrans;
+#ifdef MFEM_USE_OPENMP
+            #pragma omp for
+#endif
+            for (int j = 0; j < num_faces; j++)
+            {
+               const int i = face_bdr[faces[j]];
+               if (i < 0) { continue; }
+               const int bdr_attr = mesh->GetBdrAttribute(i);
+               if (bdr_attr_marker[bdr_attr-1] == 0) { continue; }
+
+               if (!mesh->GetBdrFaceTransformations(i, tr, eltrans1, eltrans2,
+                                                    ftrans)) { continue; }
+               fes->GetElementVDofs(tr.Elem1No, face_vdofs);
+               for (int k = 0; k < flfi.Size(); k++)
+               {
+                  if (flfi_marker[k] &&
+                      (*flfi_marker[k])[bdr_attr-1] == 0) { continue; }
+
+                  flfi[k]->AssembleRHSElementVect(*fes->GetFE(tr.Elem1No), tr,
+                                                  elemvect);
+                  AddElementVector(face_vdofs, elemvect);
+               }
+            }
+         }
+      }
+   }
+}
+
 void LinearForm::Update(FiniteElementSpace *f, Vector &v, int v_offset)
 {
    fes = f;
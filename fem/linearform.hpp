@@ -19,6 +19,28 @@
 namespace mfem
 {
 
+namespace internal
+{
+
+// Return true if all integrators in 'integs' can be used by several threads,
+// see the threaded assembly of LinearForm and BilinearForm.
+template <class Integrator>
+bool IntegratorsAreThreadSafe(const Array<Integrator*> &integs)
+{
+   for (int k = 0; k < integs.Size(); k++)
+   {
+      if (!integs[k]->IsThreadSafe()) { return false; }
+   }
+   return true;
+}
+
+// Mark the boundary attributes used by at least one of the integrators with
+// the given boundary markers; a NULL marker means all attributes.
+void MarkBdrAttributes(const Mesh &mesh, const Array<Array<int>*> &markers,
+                       Array<int> &bdr_attr_marker);
+
+}
+
 /// Class for linear form - Vector with associated FE space and LFIntegrators.
 class LinearForm : public Vector
 {
@@ -56,6 +78,12 @@ protected:
    /// Force (re)computation of delta locations.
    void ResetDeltaLocations() { dlfi_delta_elem_id.SetSize(0); }
 
+   /// Use colored (threaded) assembly, see EnableThreadedAssembly().
+   bool threaded_assembly;
+
+   // Assemble color by color; used by Assemble() when threaded_assembly is set
+   void ColoredAssemble();
+
 private:
    /// Copy construction is not supported; body is undefined.
    LinearForm(const LinearForm &);
@@ -64,7 +92,7 @@ public:
    /// Creates linear form associated with FE space @a *f.
    /** The pointer @a f is not owned by the newly constructed object. */
    LinearForm(FiniteElementSpace *f) : Vector(f->GetVSize())
-   { fes = f; extern_lfs = 0; }
+   { fes = f; extern_lfs = 0; threaded_assembly = false; }
 
    /** @brief Create a LinearForm on the FiniteElementSpace @a f, using the
        same integrators as the LinearForm @a lf.
@@ -79,7 +107,7 @@ public:
    /** The associated FiniteElementSpace can be set later using one of the
        methods: Update(FiniteElementSpace *) or
        Update(FiniteElementSpace *, Vector &, int). */
-   LinearForm() { fes = NULL; extern_lfs = 0; }
+   LinearForm() { fes = NULL; extern_lfs = 0; threaded_assembly = false; }
 
    /// Copy assignment. Only the data of the base class Vector is copied.
    /** It is assumed that this object and @a rhs use FiniteElementSpace%s that
@@ -144,6 +172,18 @@ public:
        corresponding pointer (to Array<int>) will be NULL. */
    Array<Array<int>*> *GetFLFI_Marker() { return &flfi_marker; }
 
+   /** @brief Assemble the form color by color, using the colorings of
+       FiniteElementSpace::GetElementColoring(), GetBdrElementColoring(), and
+       GetFaceColoring(). */
+   /** With MFEM_USE_OPENMP, the elements (or faces) of one color, which share
+       no dofs, are assembled concurrently, so the coefficients must be
+       thread-safe. The integrators are used concurrently only when they all
+       report LinearFormIntegrator::IsThreadSafe(), which requires building
+       with MFEM_THREAD_SAFE; otherwise, and for the integrators with delta
+       coefficients, the assembly is serial. */
+   void EnableThreadedAssembly(bool enable = true)
+   { threaded_assembly = enable; }
+
    /// Assembles the linear form i.e. sums over all domain/bdr integrators.
    void Assemble();
 
@@ -29,6 +29,9 @@ void DomainLFIntegrator::AssembleRHSElementVect(const FiniteElement &el,
 {
    int dof = el.GetDof();
 
+#ifdef MFEM_THREAD_SAFE
+   Vector shape, Q_ir;
+#endif
    shape.SetSize(dof);       // vector of size dof
    elvect.SetSize(dof);
    elvect = 0.0;
@@ -41,12 +44,15 @@ void DomainLFIntegrator::AssembleRHSElementVect(const FiniteElement &el,
       ir = &IntRules.Get(el.GetGeomType(), oa * el.GetOrder() + ob);
    }
 
+   const GeometricFactors *gf =
+      Tr.GetGeometricFactors(*ir, GeometricFactors::DETERMINANTS);
+   Q.Eval(Q_ir, Tr, *ir);
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
 
-      Tr.SetIntPoint (&ip);
-      double val = Tr.Weight() * Q.Eval(Tr, ip);
+      Tr.SetIntPoint(&ip, gf, i);
+      double val = Tr.Weight() * Q_ir(i);
 
       el.CalcShape(ip, shape);
 
@@ -69,6 +75,9 @@ void BoundaryLFIntegrator::AssembleRHSElementVect(
 {
    int dof = el.GetDof();
 
+#ifdef MFEM_THREAD_SAFE
+   Vector shape, Q_ir;
+#endif
    shape.SetSize(dof);        // vector of size dof
    elvect.SetSize(dof);
    elvect = 0.0;
@@ -80,12 +89,13 @@ void BoundaryLFIntegrator::AssembleRHSElementVect(
       ir = &IntRules.Get(el.GetGeomType(), intorder);
    }
 
+   Q.Eval(Q_ir, Tr, *ir);
    for (int i = 0; i < ir->GetNPoints(); i++)
    {
       const IntegrationPoint &ip = ir->IntPoint(i);
 
       Tr.SetIntPoint (&ip);
-      double val = Tr.Weight() * Q.Eval(Tr, ip);
+      double val = Tr.Weight() * Q_ir(i);
 
       el.CalcShape(ip, shape);
 
@@ -525,6 +535,11 @@ void DGDirichletLFIntegrator::AssembleRHSElementVect(
    bool kappa_is_nonzero = (kappa != 0.);
    double w;
 
+#ifdef MFEM_THREAD_SAFE
+   Vector shape, dshape_dn, nor, nh, ni;
+   DenseMatrix dshape, mq, adjJ;
+#endif
+
    dim = el.GetDim();
    ndof = el.GetDof();
 
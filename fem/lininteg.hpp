@@ -39,6 +39,13 @@ public:
    void SetIntRule(const IntegrationRule *ir) { IntRule = ir; }
    const IntegrationRule* GetIntRule() { return IntRule; }
 
+   /** @brief Return true if AssembleRHSElementVect() can be called by several
+       threads at the same time, see LinearForm::EnableThreadedAssembly(). */
+   /** This is the case if the integrator keeps no scratch data in its members
+       when MFEM is built with MFEM_THREAD_SAFE, which MFEM_USE_OPENMP
+       requires. The default is false. */
+   virtual bool IsThreadSafe() const { return false; }
+
    virtual ~LinearFormIntegrator() { }
 };
 
@@ -92,7 +99,9 @@ public:
 /// Class for domain integration L(v) := (f, v)
 class DomainLFIntegrator : public DeltaLFIntegrator
 {
-   Vector shape;
+#ifndef MFEM_THREAD_SAFE
+   Vector shape, Q_ir;
+#endif
    Coefficient &Q;
    int oa, ob;
 public:
@@ -116,13 +125,17 @@ public:
                                          ElementTransformation &Trans,
                                          Vector &elvect);
 
+   virtual bool IsThreadSafe() const { return true; }
+
    using LinearFormIntegrator::AssembleRHSElementVect;
 };
 
 /// Class for boundary integration L(v) := (g, v)
 class BoundaryLFIntegrator : public LinearFormIntegrator
 {
-   Vector shape;
+#ifndef MFEM_THREAD_SAFE
+   Vector shape, Q_ir;
+#endif
    Coefficient &Q;
    int oa, ob;
 public:
@@ -136,6 +149,8 @@ public:
                                        ElementTransformation &Tr,
                                        Vector &elvect);
 
+   virtual bool IsThreadSafe() const { return true; }
+
    using LinearFormIntegrator::AssembleRHSElementVect;
 };
 
@@ -352,9 +367,10 @@ protected:
    MatrixCoefficient *MQ;
    double sigma, kappa;
 
-   // these are not thread-safe!
+#ifndef MFEM_THREAD_SAFE
    Vector shape, dshape_dn, nor, nh, ni;
    DenseMatrix dshape, mq, adjJ;
+#endif
 
 public:
    DGDirichletLFIntegrator(Coefficient &u, const double s, const double k)
@@ -372,6 +388,8 @@ public:
    virtual void AssembleRHSElementVect(const FiniteElement &el,
                                        FaceElementTransformations &Tr,
                                        Vector &elvect);
+
+   virtual bool IsThreadSafe() const { return true; }
 };
 
 
@@ -0,0 +1,258 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of classes FiniteElementSpaceHierarchy and GeometricMultigrid
+
+#include "fem.hpp"
+
+namespace mfem
+{
+
+FiniteElementSpaceHierarchy::FiniteElementSpaceHierarchy(
+   Mesh *mesh, FiniteElementSpace *fespace, bool own_mesh, bool own_fespace)
+{
+   MFEM_VERIFY(fespace->GetMesh() == mesh, "the space is not on the mesh");
+   AddLevel(mesh, fespace, NULL, own_mesh, own_fespace);
+}
+
+void FiniteElementSpaceHierarchy::AddLevel(Mesh *mesh, FiniteElementSpace *fes,
+                                           const SparseMatrix *P,
+                                           bool own_mesh, bool own_fes)
+{
+   meshes.Append(mesh);
+   fespaces.Append(fes);
+   prolongations.Append(P);
+   own_meshes.Append(own_mesh);
+   own_fespaces.Append(own_fes);
+}
+
+const SparseMatrix *FiniteElementSpaceHierarchy::TrueProlongation(
+   const FiniteElementSpace &fine_fes, const SparseMatrix *P) const
+{
+   const SparseMatrix *R = fine_fes.GetConformingRestriction();
+   const SparseMatrix *cP = fespaces.Last()->GetConformingProlongation();
+   if (R)
+   {
+      const SparseMatrix *RP = mfem::Mult(*R, *P);
+      delete P;
+      P = RP;
+   }
+   if (cP)
+   {
+      const SparseMatrix *PcP = mfem::Mult(*P, *cP);
+      delete P;
+      P = PcP;
+   }
+   return P;
+}
+
+void FiniteElementSpaceHierarchy::AddUniformlyRefinedLevel()
+{
+   const FiniteElementSpace &coarse_fes = *fespaces.Last();
+
+   // The space on the copy of the finest mesh has the dofs of the finest
+   // space; its update operator after the refinement is the prolongation.
+   Mesh *mesh = new Mesh(*meshes.Last(), true);
+   FiniteElementSpace *fes =
+      new FiniteElementSpace(mesh, coarse_fes.FEColl(), coarse_fes.GetVDim(),
+                             coarse_fes.GetOrdering());
+   fes->SetUpdateOperatorType(Operator::MFEM_SPARSEMAT);
+   mesh->UniformRefinement();
+   fes->Update();
+   const SparseMatrix *P =
+      dynamic_cast<const SparseMatrix *>(fes->GetUpdateOperator());
+   MFEM_VERIFY(P, "the update operator is not a SparseMatrix");
+   fes->SetUpdateOperatorOwner(false);
+   fes->UpdatesFinished();
+
+   AddLevel(mesh, fes, TrueProlongation(*fes, P), true, true);
+}
+
+void FiniteElementSpaceHierarchy::AddOrderRefinedLevel(
+   FiniteElementCollection *fec)
+{
+   const FiniteElementSpace &coarse_fes = *fespaces.Last();
+   Mesh *mesh = meshes.Last();
+   FiniteElementSpace *fes =
+      new FiniteElementSpace(mesh, fec, coarse_fes.GetVDim(),
+                             coarse_fes.GetOrdering());
+   fecs.Append(fec);
+
+   // Interpolate the coarse basis functions element by element; the shared
+   // dofs get the same rows from all their elements.
+   SparseMatrix *P = new SparseMatrix(fes->GetVSize(), coarse_fes.GetVSize());
+   DenseMatrix I;
+   Array<int> fdofs, cdofs;
+   for (int e = 0; e < mesh->GetNE(); e++)
+   {
+      const FiniteElement &fine_fe = *fes->GetFE(e);
+      fine_fe.Project(*coarse_fes.GetFE(e),
+                      *mesh->GetElementTransformation(e), I);
+      fes->GetElementVDofs(e, fdofs);
+      coarse_fes.GetElementVDofs(e, cdofs);
+      const int vdim = fes->GetVDim();
+      const int nfd = fdofs.Size()/vdim, ncd = cdofs.Size()/vdim;
+      for (int vd = 0; vd < vdim; vd++)
+      {
+         for (int i = 0; i < nfd; i++)
+         {
+            const int fi = fdofs[vd*nfd + i];
+            const int row = (fi >= 0) ? fi : -1-fi;
+            for (int j = 0; j < ncd; j++)
+            {
+               if (I(i,j) == 0.0) { continue; }
+               const int cj = cdofs[vd*ncd + j];
+               const int col = (cj >= 0) ? cj : -1-cj;
+               const double s = ((fi >= 0) == (cj >= 0)) ? 1.0 : -1.0;
+               P->Set(row, col, s*I(i,j));
+            }
+         }
+      }
+   }
+   P->Finalize();
+
+   AddLevel(mesh, fes, TrueProlongation(*fes, P), false, true);
+}
+
+FiniteElementSpaceHierarchy::~FiniteElementSpaceHierarchy()
+{
+   for (int l = fespaces.Size()-1; l >= 0; l--)
+   {
+      delete prolongations[l];
+      if (own_fespaces[l]) { delete fespaces[l]; }
+      if (own_meshes[l]) { delete meshes[l]; }
+   }
+   for (int i = 0; i < fecs.Size(); i++) { delete fecs[i]; }
+}
+
+
+GeometricMultigrid::GeometricMultigrid(
+   const FiniteElementSpaceHierarchy &fespaces_, const Array<int> &ess_bdr_)
+   : fespaces(fespaces_), coarse_prec(NULL)
+{
+   ess_bdr_.Copy(ess_bdr);
+}
+
+Solver *GeometricMultigrid::ConstructSmoother(int level, const Operator &op,
+                                              const Vector &diag)
+{
+   // the essential dofs are already accounted for in the diagonal
+   Array<int> no_ess;
+   return new OperatorJacobiSmoother(op, diag, no_ess);
+}
+
+Solver *GeometricMultigrid::ConstructCoarseSolver(const Operator &op,
+                                                  const Vector &diag)
+{
+   const SparseMatrix *mat = dynamic_cast<const SparseMatrix *>(&op);
+   if (mat) { coarse_prec = new AMGSolver(*mat); }
+   else
+   {
+      Array<int> no_ess;
+      coarse_prec = new OperatorJacobiSmoother(op, diag, no_ess);
+   }
+   CGSolver *cg = new CGSolver;
+   cg->SetOperator(op);
+   cg->SetPreconditioner(*coarse_prec);
+   cg->SetRelTol(1e-12);
+   cg->SetAbsTol(0.0);
+   cg->SetMaxIter(1000);
+   cg->SetPrintLevel(-1);
+   return cg;
+}
+
+void GeometricMultigrid::AddForm(BilinearForm *form)
+{
+   const int l = forms.Size();
+   MFEM_VERIFY(l < fespaces.GetNumLevels(), "all the forms are set");
+   MFEM_VERIFY(form->FESpace() == &fespaces.GetFESpaceAtLevel(l),
+               "the form is not defined on the space of level " << l);
+   forms.Append(form);
+   ess_tdofs.Append(new Array<int>);
+   if (ess_bdr.Size())
+   {
+      form->FESpace()->GetEssentialTrueDofs(ess_bdr, *ess_tdofs.Last());
+   }
+
+   Operator *op;
+   Vector diag;
+   if (form->GetAssemblyLevel() == AssemblyLevel::PARTIAL)
+   {
+      // the diagonal of P^t A P is not P^t diag(A) for the non-boolean P of a
+      // non-conforming mesh
+      MFEM_VERIFY(!form->GetProlongation(), "AssemblyLevel::PARTIAL is not "
+                  "supported on non-conforming meshes");
+      op = new ConstrainedOperator(form, *ess_tdofs.Last(), false);
+      form->AssembleDiagonal(diag);
+      // the constrained operator is the identity on the essential dofs
+      for (int i = 0; i < ess_tdofs.Last()->Size(); i++)
+      {
+         diag((*ess_tdofs.Last())[i]) = 1.0;
+      }
+   }
+   else
+   {
+      SparseMatrix *A = new SparseMatrix;
+      form->FormSystemMatrix(*ess_tdofs.Last(), *A);
+      A->GetDiag(diag);
+      op = A;
+   }
+
+   if (l == 0)
+   {
+      AddLevel(op, ConstructCoarseSolver(*op, diag), NULL, true, true, false);
+   }
+   else
+   {
+      AddLevel(op, ConstructSmoother(l, *op, diag),
+               &fespaces.GetProlongationAtLevel(l), true, true, false);
+   }
+}
+
+void GeometricMultigrid::FormFineLinearSystem(Vector &x, Vector &b,
+                                              OperatorHandle &A,
+                                              Vector &X, Vector &B)
+{
+   MFEM_VERIFY(forms.Size() == fespaces.GetNumLevels(),
+               "the forms of all the levels must be set");
+   BilinearForm &form = *forms.Last();
+   if (form.GetAssemblyLevel() == AssemblyLevel::PARTIAL)
+   {
+      Operator *Af;
+      form.FormLinearSystem(*ess_tdofs.Last(), x, b, Af, X, B);
+      delete Af;
+   }
+   else
+   {
+      // the matrix is already eliminated, only b is updated
+      SparseMatrix Af;
+      form.FormLinearSystem(*ess_tdofs.Last(), x, b, Af, X, B);
+   }
+   A.Reset(const_cast<Operator *>(operators.Last()), false);
+}
+
+void GeometricMultigrid::RecoverFineFEMSolution(const Vector &X,
+                                                const Vector &b, Vector &x)
+{
+   forms.Last()->RecoverFEMSolution(X, b, x);
+}
+
+GeometricMultigrid::~GeometricMultigrid()
+{
+   for (int l = 0; l < forms.Size(); l++)
+   {
+      delete forms[l];
+      delete ess_tdofs[l];
+   }
+   delete coarse_prec;
+}
+
+}
@@ -0,0 +1,168 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_FEM_MULTIGRID
+#define MFEM_FEM_MULTIGRID
+
+#include "../config/config.hpp"
+#include "../linalg/multigrid.hpp"
+#include "fespace.hpp"
+#include "bilinearform.hpp"
+
+namespace mfem
+{
+
+/** @brief Hierarchy of finite element spaces, from the coarsest to the finest
+    one, with the prolongations between consecutive levels. */
+/** The levels are added by refining the finest one, either with a uniform
+    refinement of its mesh (h-refinement) or with a higher order collection on
+    the same mesh (p-refinement). For h-refinement, the finest mesh is copied
+    and refined with Mesh::UniformRefinement(), and the prolongation is the
+    update operator of the space, see FiniteElementSpace::GetUpdateOperator().
+    For p-refinement, the prolongation interpolates the coarse basis functions
+    in the fine space element by element. The prolongations act on true dofs,
+    i.e. they include the conforming constraints of non-conforming meshes. */
+class FiniteElementSpaceHierarchy
+{
+protected:
+   Array<Mesh *> meshes;
+   Array<FiniteElementSpace *> fespaces;
+   /// Prolongations from level l-1 to level l; the first entry is NULL.
+   Array<const SparseMatrix *> prolongations;
+   Array<bool> own_meshes, own_fespaces;
+   /// Collections of the p-refined levels (owned).
+   Array<FiniteElementCollection *> fecs;
+
+   // Add the true dof constraints to the L-vector prolongation P, which is
+   // replaced by the result, from the finest space to 'fine_fes'.
+   const SparseMatrix *TrueProlongation(const FiniteElementSpace &fine_fes,
+                                        const SparseMatrix *P) const;
+
+   void AddLevel(Mesh *mesh, FiniteElementSpace *fes, const SparseMatrix *P,
+                 bool own_mesh, bool own_fes);
+
+public:
+   /** @brief Construct a hierarchy with the coarse space @a fespace on the
+       mesh @a mesh; the flags specify if they are destroyed with the
+       hierarchy. */
+   FiniteElementSpaceHierarchy(Mesh *mesh, FiniteElementSpace *fespace,
+                               bool own_mesh, bool own_fespace);
+
+   /** @brief Add a level with a uniform refinement of the finest mesh, and
+       the collection, vector dimension and ordering of the finest space. */
+   void AddUniformlyRefinedLevel();
+
+   /** @brief Add a level with the collection @a fec on the finest mesh, e.g.
+       a higher order one; the hierarchy takes ownership of @a fec. */
+   /** The finite elements of the finest space must be representable in the
+       new space, so that the prolongation is an interpolation. */
+   void AddOrderRefinedLevel(FiniteElementCollection *fec);
+
+   /// Return the number of levels.
+   int GetNumLevels() const { return fespaces.Size(); }
+
+   /// Return the index of the finest level.
+   int GetFinestLevelIndex() const { return fespaces.Size() - 1; }
+
+   /// Return the mesh of level @a l, where level 0 is the coarsest one.
+   Mesh &GetMeshAtLevel(int l) const { return *meshes[l]; }
+
+   /// Return the space of level @a l, where level 0 is the coarsest one.
+   FiniteElementSpace &GetFESpaceAtLevel(int l) const { return *fespaces[l]; }
+
+   /// Return the space of the finest level.
+   FiniteElementSpace &GetFinestFESpace() const { return *fespaces.Last(); }
+
+   /** @brief Return the prolongation of the true dofs from level l-1 to level
+       @a l, for l > 0. */
+   const SparseMatrix &GetProlongationAtLevel(int l) const
+   { return *prolongations[l]; }
+
+   virtual ~FiniteElementSpaceHierarchy();
+};
+
+
+/** @brief Geometric multigrid solver for the bilinear forms of the levels of
+    a FiniteElementSpaceHierarchy. */
+/** The forms are added with AddForm(), from the coarsest to the finest level,
+    and can use either assembly level, see BilinearForm::SetAssemblyLevel():
+    with AssemblyLevel::FULL the level operators are the eliminated matrices
+    of FormSystemMatrix(), and with AssemblyLevel::PARTIAL they are applied
+    matrix-free, with the essential dofs constrained as in
+    Operator::FormLinearSystem(). AssemblyLevel::PARTIAL is not supported on
+    non-conforming meshes, where the Jacobi smoothers would need the diagonal
+    of P^t A P. The transfer operators are the prolongations of the hierarchy
+    and their transposes.
+
+    By default, the smoothers are damped Jacobi smoothers, with the damping
+    estimated from the largest eigenvalue of D^{-1} A, and the coarse problem
+    is solved with CG to a relative tolerance of 1e-12, preconditioned by an
+    AMGSolver for assembled matrices and by Jacobi otherwise. Derived classes
+    can change them by overriding ConstructSmoother() and
+    ConstructCoarseSolver(). */
+class GeometricMultigrid : public MultigridSolver
+{
+protected:
+   const FiniteElementSpaceHierarchy &fespaces;
+   Array<int> ess_bdr;
+   Array<BilinearForm *> forms;
+   Array<Array<int> *> ess_tdofs;
+   /// Preconditioner of the default coarse solver (owned).
+   Solver *coarse_prec;
+
+   /** @brief Return a new smoother for the operator @a op of level @a level,
+       where @a diag is its diagonal, including the essential dofs. */
+   virtual Solver *ConstructSmoother(int level, const Operator &op,
+                                     const Vector &diag);
+
+   /** @brief Return a new solver for the coarsest operator @a op, where
+       @a diag is its diagonal. */
+   virtual Solver *ConstructCoarseSolver(const Operator &op,
+                                         const Vector &diag);
+
+public:
+   /** @brief Construct the solver for the spaces of @a fespaces, which must
+       remain valid, with the essential boundary attributes marked in
+       @a ess_bdr. */
+   GeometricMultigrid(const FiniteElementSpaceHierarchy &fespaces_,
+                      const Array<int> &ess_bdr_);
+
+   /** @brief Add the form of the next level, from the coarsest to the finest
+       one; the solver takes ownership of @a form. */
+   /** The form must be defined on the space of the level and assembled. The
+       operator, the smoother and the prolongation of the level are set up
+       here. */
+   void AddForm(BilinearForm *form);
+
+   /// Return the form of level @a l.
+   BilinearForm &GetFormAtLevel(int l) const { return *forms[l]; }
+
+   /// Return the essential true dofs of level @a l.
+   const Array<int> &GetEssentialTrueDofsAtLevel(int l) const
+   { return *ess_tdofs[l]; }
+
+   /** @brief Form the linear system A X = B of the finest level, as in
+       BilinearForm::FormLinearSystem(). */
+   /** The operator @a A is the finest level operator, which is not owned by
+       @a A. The vectors are set as in FormLinearSystem() and the solution is
+       recovered with RecoverFineFEMSolution(). */
+   void FormFineLinearSystem(Vector &x, Vector &b, OperatorHandle &A,
+                             Vector &X, Vector &B);
+
+   /// Recover the solution of the system from FormFineLinearSystem().
+   void RecoverFineFEMSolution(const Vector &X, const Vector &b, Vector &x);
+
+   virtual ~GeometricMultigrid();
+};
+
+}
+
+#endif
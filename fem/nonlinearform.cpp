@@ -250,6 +250,12 @@ Operator &NonlinearForm::GetGradient(const Vector &x) const
       *Grad = 0.0;
    }
 
+   const bool nz_map = cached_sparsity && Grad->Finalized();
+   if (nz_map && dnfi.Size() && elem_nz_map.Size() != fes->GetNE())
+   {
+      GetElementMatrixMap(*Grad, *fes, *fes, false, elem_nz_map);
+   }
+
    if (dnfi.Size())
    {
       for (int i = 0; i < fes->GetNE(); i++)
@@ -261,7 +267,14 @@ Operator &NonlinearForm::GetGradient(const Vector &x) const
          for (int k = 0; k < dnfi.Size(); k++)
          {
             dnfi[k]->AssembleElementGrad(*fe, *T, el_x, elmat);
-            Grad->AddSubMatrix(vdofs, vdofs, elmat, skip_zeros);
+            if (nz_map)
+            {
+               Grad->AddSubMatrixByMap(elem_nz_map.GetRow(i), elmat);
+            }
+            else
+            {
+               Grad->AddSubMatrix(vdofs, vdofs, elmat, skip_zeros);
+            }
             // Grad->AddSubMatrix(vdofs, vdofs, elmat, 1);
          }
       }
@@ -360,8 +373,9 @@ Operator &NonlinearForm::GetGradient(const Vector &x) const
    {
       if (cP)
       {
-         delete cGrad;
-         cGrad = RAP(*cP, *Grad, *cP);
+         if (cGrad_rap == NULL) { cGrad_rap = new SparseRAP(*cP, *cP); }
+         if (cGrad) { cGrad_rap->Mult(*Grad, *cGrad); }
+         else { cGrad = cGrad_rap->Mult(*Grad); }
          mGrad = cGrad;
       }
       for (int i = 0; i < ess_tdof_list.Size(); i++)
@@ -378,8 +392,10 @@ void NonlinearForm::Update()
    if (sequence == fes->GetSequence()) { return; }
 
    height = width = fes->GetTrueVSize();
+   delete cGrad_rap; cGrad_rap = NULL;
    delete cGrad; cGrad = NULL;
    delete Grad; Grad = NULL;
+   elem_nz_map.Clear();
    ess_tdof_list.SetSize(0); // essential b.c. will need to be set again
    sequence = fes->GetSequence();
    // Do not modify aux1 and aux2, their size will be set before use.
@@ -389,6 +405,7 @@ void NonlinearForm::Update()
 
 NonlinearForm::~NonlinearForm()
 {
+   delete cGrad_rap;
    delete cGrad;
    delete Grad;
    for (int i = 0; i <  dnfi.Size(); i++) { delete  dnfi[i]; }
@@ -36,6 +36,14 @@ protected:
    Array<Array<int>*>              bfnfi_marker; // not owned
 
    mutable SparseMatrix *Grad, *cGrad; // owned
+   /// Computes #cGrad, reusing the sparsity of the RAP product of #Grad.
+   mutable SparseRAP *cGrad_rap; // owned
+
+   /// Reassemble #Grad with the map below, see UseCachedSparsity().
+   bool cached_sparsity;
+   /** @brief Positions of the entries of the element gradient matrices in the
+       finalized #Grad, see GetElementMatrixMap(). */
+   mutable Table elem_nz_map;
 
    /// A list of all essential true dofs
    Array<int> ess_tdof_list;
@@ -60,7 +68,8 @@ public:
        number of true degrees of freedom, i.e. f->GetTrueVSize(). */
    NonlinearForm(FiniteElementSpace *f)
       : Operator(f->GetTrueVSize()), fes(f), Grad(NULL), cGrad(NULL),
-        sequence(f->GetSequence()), P(f->GetProlongationMatrix()),
+        cGrad_rap(NULL), cached_sparsity(false), sequence(f->GetSequence()),
+        P(f->GetProlongationMatrix()),
         cP(dynamic_cast<const SparseMatrix*>(P))
    { }
 
@@ -139,6 +148,16 @@ public:
        The state @a x must be a true-dof vector. */
    virtual Operator &GetGradient(const Vector &x) const;
 
+   /** @brief Cache the positions of the entries of the element gradient
+       matrices in the gradient matrix, so that the following calls to
+       GetGradient() add the values without searching. */
+   /** The sparsity of the gradient matrix is fixed by the first call to
+       GetGradient(); the positions are computed at the second call and kept
+       until the space is updated, see BilinearForm::UseCachedSparsity(). The
+       face integrators still search for their entries. */
+   void UseCachedSparsity(bool use = true)
+   { cached_sparsity = use; if (!use) { elem_nz_map.Clear(); } }
+
    /// Update the NonlinearForm to propagate updates of the associated FE space.
    /** After calling this method, the essential boundary conditions need to be
        set again. */
@@ -39,6 +39,13 @@ public:
    /// Prescribe a fixed IntegrationRule to use.
    void SetIntegrationRule(const IntegrationRule &irule) { IntRule = &irule; }
 
+   /** @brief Return true if the assembly methods can be called by several
+       threads at the same time, see BilinearForm::EnableThreadedAssembly(). */
+   /** This is the case if the integrator keeps no scratch data in its members
+       when MFEM is built with MFEM_THREAD_SAFE, which MFEM_USE_OPENMP
+       requires. The default is false. */
+   virtual bool IsThreadSafe() const { return false; }
+
    /// Perform the local action of the NonlinearFormIntegrator
    virtual void AssembleElementVector(const FiniteElement &el,
                                       ElementTransformation &Tr,
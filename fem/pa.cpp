@@ -0,0 +1,882 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of partial assembly: element restriction, 1D basis maps, and
+// the sum-factorized kernels of the bilinear form integrators.
+
+#include "fem.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace mfem
+{
+
+void DofToQuad::Setup(const FiniteElement &el, const IntegrationRule &ir,
+                      int dim)
+{
+   const TensorBasisElement *tel = dynamic_cast<const TensorBasisElement*>(&el);
+   MFEM_VERIFY(tel, "partial assembly requires tensor product elements");
+
+   const int nq = ir.GetNPoints();
+   nqpt1D = (int) floor(pow(double(nq), 1.0/dim) + 0.5);
+   MFEM_VERIFY(TensorBasisElement::Pow(nqpt1D, dim) == nq,
+               "the IntegrationRule is not a tensor product rule");
+   ndof1D = el.GetOrder() + 1;
+   MFEM_VERIFY(TensorBasisElement::Pow(ndof1D, dim) == el.GetDof(),
+               "unexpected number of element dofs: " << el.GetDof());
+
+   B.SetSize(nqpt1D, ndof1D);
+   G.SetSize(nqpt1D, ndof1D);
+   Bt.SetSize(ndof1D, nqpt1D);
+   Gt.SetSize(ndof1D, nqpt1D);
+   Vector u(ndof1D), d(ndof1D);
+   for (int q = 0; q < nqpt1D; q++)
+   {
+      // the first coordinate varies fastest in the tensor product rules
+      tel->GetBasis1D().Eval(ir.IntPoint(q).x, u, d);
+      for (int j = 0; j < ndof1D; j++)
+      {
+         B(q,j) = Bt(j,q) = u(j);
+         G(q,j) = Gt(j,q) = d(j);
+      }
+   }
+}
+
+void TensorGradElementMatrix(int dim, const DofToQuad &maps, const Vector &D,
+                             DenseMatrix &A)
+{
+   const int p = maps.ndof1D, q1 = maps.nqpt1D, p2 = p*p;
+   const int nq = TensorBasisElement::Pow(q1, dim);
+   MFEM_VERIFY(dim == 2 || dim == 3, "invalid dimension: " << dim);
+   MFEM_VERIFY(D.Size() == dim*dim*nq, "invalid size of D");
+
+   // The 1D factors along one axis: C[a + 2*b](i + p*j,q) = M_a(q,i) M_b(q,j),
+   // where M_0 = B and M_1 = G. For the term (k,l) of the sum, the factor of
+   // axis c is C[(k == c) + 2*(l == c)].
+   DenseMatrix C[4];
+   for (int ab = 0; ab < 4; ab++)
+   {
+      const DenseMatrix &Ma = (ab%2) ? maps.G : maps.B;
+      const DenseMatrix &Mb = (ab/2) ? maps.G : maps.B;
+      C[ab].SetSize(p2, q1);
+      for (int q = 0; q < q1; q++)
+      {
+         for (int j = 0; j < p; j++)
+         {
+            for (int i = 0; i < p; i++) { C[ab](i + p*j, q) = Ma(q,i)*Mb(q,j); }
+         }
+      }
+   }
+
+   // The matrix with rows (i1,j1) in 2D and (i1,j1,i2,j2) in 3D, and columns
+   // (i_dim,j_dim), i.e. with the entries of A, reordered.
+   DenseMatrix AR((dim == 2) ? p2 : p2*p2, p2);
+   AR = 0.0;
+   double *D_data = D.GetData();
+   if (dim == 2)
+   {
+      DenseMatrix T1(p2, q1);
+      for (int l = 0; l < 2; l++)
+      {
+         for (int k = 0; k < 2; k++)
+         {
+            // contract qx, then qy
+            DenseMatrix Dkl(D_data + (k + 2*l)*nq, q1, q1);
+            Mult(C[(k == 0) + 2*(l == 0)], Dkl, T1);
+            AddMultABt(T1, C[(k == 1) + 2*(l == 1)], AR);
+         }
+      }
+   }
+   else
+   {
+      // T2[g] gathers the terms (k,l) with the same factor g along z
+      DenseMatrix T1(p2, q1*q1), T2[4];
+      for (int g = 0; g < 4; g++)
+      {
+         T2[g].SetSize(p2*p2, q1);
+         T2[g] = 0.0;
+      }
+      for (int l = 0; l < 3; l++)
+      {
+         for (int k = 0; k < 3; k++)
+         {
+            // contract qx, then qy for each qz
+            DenseMatrix Dkl(D_data + (k + 3*l)*nq, q1, q1*q1);
+            Mult(C[(k == 0) + 2*(l == 0)], Dkl, T1);
+            const DenseMatrix &Cy = C[(k == 1) + 2*(l == 1)];
+            DenseMatrix &T2g = T2[(k == 2) + 2*(l == 2)];
+            for (int qz = 0; qz < q1; qz++)
+            {
+               DenseMatrix T1z(T1.Data() + qz*p2*q1, p2, q1);
+               DenseMatrix T2z(T2g.Data() + qz*p2*p2, p2, p2);
+               AddMultABt(T1z, Cy, T2z);
+            }
+         }
+      }
+      // contract qz
+      for (int g = 0; g < 4; g++) { AddMultABt(T2[g], C[g], AR); }
+   }
+
+   const int nd = TensorBasisElement::Pow(p, dim);
+   A.SetSize(nd);
+   if (dim == 2)
+   {
+      for (int j2 = 0; j2 < p; j2++)
+         for (int i2 = 0; i2 < p; i2++)
+            for (int j1 = 0; j1 < p; j1++)
+               for (int i1 = 0; i1 < p; i1++)
+               {
+                  A(i1 + p*i2, j1 + p*j2) = AR(i1 + p*j1, i2 + p*j2);
+               }
+   }
+   else
+   {
+      for (int j3 = 0; j3 < p; j3++)
+         for (int i3 = 0; i3 < p; i3++)
+            for (int j2 = 0; j2 < p; j2++)
+               for (int i2 = 0; i2 < p; i2++)
+                  for (int j1 = 0; j1 < p; j1++)
+                     for (int i1 = 0; i1 < p; i1++)
+                     {
+                        A(i1 + p*i2 + p2*i3, j1 + p*j2 + p2*j3) =
+                           AR(i1 + p*j1 + p2*(i2 + p*j2), i3 + p*j3);
+                     }
+   }
+}
+
+
+ElementRestriction::ElementRestriction(const FiniteElementSpace &fes)
+   : Operator(0, fes.GetVSize())
+{
+   ne = fes.GetNE();
+   vdim = fes.GetVDim();
+   nd = (ne > 0) ? fes.GetFE(0)->GetDof() : 0;
+   height = ne*vdim*nd;
+   indices.SetSize(height);
+
+   Array<int> vdofs;
+   for (int e = 0; e < ne; e++)
+   {
+      const FiniteElement *fe = fes.GetFE(e);
+      const TensorBasisElement *tel =
+         dynamic_cast<const TensorBasisElement*>(fe);
+      MFEM_VERIFY(tel && fe->GetGeomType() == fes.GetFE(0)->GetGeomType() &&
+                  fe->GetDof() == nd, "element " << e << ": partial assembly "
+                  "requires tensor product elements of the same type");
+      const Array<int> &dof_map = tel->GetDofMap();
+
+      // vdofs are ordered by components, then by native element dofs
+      fes.GetElementVDofs(e, vdofs);
+      int *ind = indices.GetData() + e*vdim*nd;
+      for (int c = 0; c < vdim; c++)
+      {
+         for (int j = 0; j < nd; j++)
+         {
+            const int nj = dof_map.Size() ? dof_map[j] : j;
+            ind[c*nd + j] = vdofs[c*nd + nj];
+         }
+      }
+   }
+}
+
+void ElementRestriction::Mult(const Vector &x, Vector &y) const
+{
+   y.SetSize(height);
+   const int *ind = indices.GetData();
+   const double *xp = x.GetData();
+   double *yp = y.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < height; i++)
+   {
+      const int j = ind[i];
+      yp[i] = (j >= 0) ? xp[j] : -xp[-1-j];
+   }
+}
+
+void ElementRestriction::MultTranspose(const Vector &x, Vector &y) const
+{
+   y.SetSize(width);
+   y = 0.0;
+   AddMultTranspose(x, y);
+}
+
+void ElementRestriction::AddMultTranspose(const Vector &x, Vector &y,
+                                          double a) const
+{
+   // The elements share dofs, so this loop is not threaded.
+   const int *ind = indices.GetData();
+   const double *xp = x.GetData();
+   double *yp = y.GetData();
+   for (int i = 0; i < height; i++)
+   {
+      const int j = ind[i];
+      if (j >= 0) { yp[j] += a*xp[i]; }
+      else { yp[-1-j] -= a*xp[i]; }
+   }
+}
+
+
+namespace internal
+{
+
+/* Apply the 1D matrix A (m x n) along the middle axis of the tensor
+   X(pre,n,post), writing the result in Y(pre,m,post). The innermost loops run
+   over contiguous entries of A, X, and Y. */
+static void Contract(const DenseMatrix &A, int pre, int n, int post,
+                     const double *X, double *Y)
+{
+   const int m = A.Height();
+   const double *a = A.Data();
+   for (int k = 0; k < post; k++)
+   {
+      const double *Xk = X + pre*n*k;
+      double *Yk = Y + pre*m*k;
+      for (int i = 0; i < pre*m; i++) { Yk[i] = 0.0; }
+      if (pre == 1)
+      {
+         for (int j = 0; j < n; j++)
+         {
+            const double xj = Xk[j];
+            const double *aj = a + m*j;
+            for (int i = 0; i < m; i++) { Yk[i] += aj[i]*xj; }
+         }
+         continue;
+      }
+      for (int j = 0; j < n; j++)
+      {
+         const double *Xj = Xk + pre*j;
+         for (int i = 0; i < m; i++)
+         {
+            const double aij = a[i + m*j];
+            double *Yi = Yk + pre*i;
+            for (int p = 0; p < pre; p++) { Yi[p] += aij*Xj[p]; }
+         }
+      }
+   }
+}
+
+/* Apply the tensor product of the 1D matrices M[dim-1] x ... x M[0], all of
+   the same size m x n, to the dim-dimensional tensor X, writing the result in
+   Y. The array 'work' must have room for 2*max(m,n)^dim entries. */
+static void TensorContract(int dim, const DenseMatrix * const M[],
+                           const double *X, double *Y, double *work)
+{
+   const int in = M[0]->Width(), out = M[0]->Height();
+   const int wsize = TensorBasisElement::Pow(std::max(in, out), dim);
+
+   int n[3] = { in, in, in };
+   const double *src = X;
+   for (int a = 0; a < dim; a++)
+   {
+      double *dst = (a == dim-1) ? Y : work + (a%2)*wsize;
+      int pre = 1, post = 1;
+      for (int b = 0; b < a; b++) { pre *= n[b]; }
+      for (int b = a+1; b < dim; b++) { post *= n[b]; }
+      Contract(*M[a], pre, n[a], post, src, dst);
+      n[a] = out;
+      src = dst;
+   }
+}
+
+// Index of the entry (i,j), i <= j, of a symmetric dim x dim matrix stored by
+// its upper triangle, row by row.
+static inline int SymIndex(int i, int j, int dim)
+{
+   if (i > j) { std::swap(i, j); }
+   return i*dim - i*(i-1)/2 + j - i;
+}
+
+/* The following kernels add to the E-vector y the action of the element
+   operators on the E-vector x; the quadrature point data of element e is
+   stored at op + e*nc*nq, with nc entries per point, stored point-fastest. */
+
+// Mass: y += B^t D B x, for each of the 'ncomp' vector components.
+static void MassApply(int dim, int ne, int ncomp, const DofToQuad &maps,
+                      const Vector &op, const Vector &x, Vector &y)
+{
+   const int nd = TensorBasisElement::Pow(maps.ndof1D, dim);
+   const int nq = TensorBasisElement::Pow(maps.nqpt1D, dim);
+   const int m = TensorBasisElement::Pow(std::max(maps.ndof1D, maps.nqpt1D),
+                                         dim);
+   const DenseMatrix *B[3] = { &maps.B, &maps.B, &maps.B };
+   const DenseMatrix *Bt[3] = { &maps.Bt, &maps.Bt, &maps.Bt };
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      Vector buf(2*m + nq + nd);
+      double *work = buf.GetData(), *qval = work + 2*m, *dval = qval + nq;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int e = 0; e < ne; e++)
+      {
+         const double *D = op.GetData() + e*nq;
+         for (int c = 0; c < ncomp; c++)
+         {
+            const double *X = x.GetData() + (c + ncomp*e)*nd;
+            double *Y = y.GetData() + (c + ncomp*e)*nd;
+            TensorContract(dim, B, X, qval, work);
+            for (int q = 0; q < nq; q++) { qval[q] *= D[q]; }
+            TensorContract(dim, Bt, qval, dval, work);
+            for (int i = 0; i < nd; i++) { Y[i] += dval[i]; }
+         }
+      }
+   }
+}
+
+/* Set M and Mt to the 1D maps of the reference gradient component 'k' and to
+   their transposes, respectively. */
+static inline void GradMaps(int k, const DofToQuad &maps,
+                            const DenseMatrix *M[3], const DenseMatrix *Mt[3])
+{
+   for (int a = 0; a < 3; a++)
+   {
+      M[a] = (a == k) ? &maps.G : &maps.B;
+      Mt[a] = (a == k) ? &maps.Gt : &maps.Bt;
+   }
+}
+
+/* Diffusion in 2D: y += sum_{k,l} G_k^t D_kl G_l x, with D symmetric. The
+   partial contractions are shared by the two gradient components. */
+static void Diffusion2D(int ne, const DofToQuad &maps, const Vector &op,
+                        const Vector &x, Vector &y)
+{
+   const int D1D = maps.ndof1D, Q1D = maps.nqpt1D;
+   const int nd = D1D*D1D, nq = Q1D*Q1D;
+   const double *B = maps.B.Data(), *G = maps.G.Data();
+   const double *Bt = maps.Bt.Data(), *Gt = maps.Gt.Data();
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      // BX(qx,dy), GX(qx,dy), F0(qx,qy), F1(qx,qy)
+      Vector buf(2*Q1D*D1D + 2*nq);
+      double *BX = buf.GetData(), *GX = BX + Q1D*D1D;
+      double *F0 = GX + Q1D*D1D, *F1 = F0 + nq;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int e = 0; e < ne; e++)
+      {
+         const double *D = op.GetData() + 3*nq*e;
+         const double *X = x.GetData() + nd*e;
+         double *Y = y.GetData() + nd*e;
+
+         for (int dy = 0; dy < D1D; dy++)
+         {
+            double *bx = BX + Q1D*dy, *gx = GX + Q1D*dy;
+            for (int qx = 0; qx < Q1D; qx++) { bx[qx] = gx[qx] = 0.0; }
+            for (int dx = 0; dx < D1D; dx++)
+            {
+               const double s = X[dx + D1D*dy];
+               for (int qx = 0; qx < Q1D; qx++)
+               {
+                  bx[qx] += B[qx + Q1D*dx]*s;
+                  gx[qx] += G[qx + Q1D*dx]*s;
+               }
+            }
+         }
+         for (int q = 0; q < nq; q++) { F0[q] = F1[q] = 0.0; }
+         for (int qy = 0; qy < Q1D; qy++)
+         {
+            double *g0 = F0 + Q1D*qy, *g1 = F1 + Q1D*qy;
+            for (int dy = 0; dy < D1D; dy++)
+            {
+               const double b = B[qy + Q1D*dy], g = G[qy + Q1D*dy];
+               const double *bx = BX + Q1D*dy, *gx = GX + Q1D*dy;
+               for (int qx = 0; qx < Q1D; qx++)
+               {
+                  g0[qx] += b*gx[qx];
+                  g1[qx] += g*bx[qx];
+               }
+            }
+         }
+         for (int q = 0; q < nq; q++)
+         {
+            const double g0 = F0[q], g1 = F1[q];
+            F0[q] = D[q]*g0 + D[nq + q]*g1;
+            F1[q] = D[nq + q]*g0 + D[2*nq + q]*g1;
+         }
+         // reuse BX and GX as the transposed partial contractions
+         for (int dy = 0; dy < D1D; dy++)
+         {
+            double *cg = GX + Q1D*dy, *cb = BX + Q1D*dy;
+            for (int qx = 0; qx < Q1D; qx++) { cg[qx] = cb[qx] = 0.0; }
+            for (int qy = 0; qy < Q1D; qy++)
+            {
+               const double b = Bt[dy + D1D*qy], g = Gt[dy + D1D*qy];
+               const double *f0 = F0 + Q1D*qy, *f1 = F1 + Q1D*qy;
+               for (int qx = 0; qx < Q1D; qx++)
+               {
+                  cg[qx] += b*f0[qx];
+                  cb[qx] += g*f1[qx];
+               }
+            }
+         }
+         for (int dy = 0; dy < D1D; dy++)
+         {
+            const double *cg = GX + Q1D*dy, *cb = BX + Q1D*dy;
+            double *Yy = Y + D1D*dy;
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               const double sg = cg[qx], sb = cb[qx];
+               for (int dx = 0; dx < D1D; dx++)
+               {
+                  Yy[dx] += Gt[dx + D1D*qx]*sg + Bt[dx + D1D*qx]*sb;
+               }
+            }
+         }
+      }
+   }
+}
+
+/* Diffusion in 3D: y += sum_{k,l} G_k^t D_kl G_l x, with D symmetric. The
+   partial contractions are shared by the three gradient components. */
+static void Diffusion3D(int ne, const DofToQuad &maps, const Vector &op,
+                        const Vector &x, Vector &y)
+{
+   const int D1D = maps.ndof1D, Q1D = maps.nqpt1D;
+   const int nd = D1D*D1D*D1D, nq = Q1D*Q1D*Q1D;
+   const int s1 = Q1D*D1D*D1D, s2 = Q1D*Q1D*D1D;
+   const double *B = maps.B.Data(), *G = maps.G.Data();
+   const double *Bt = maps.Bt.Data(), *Gt = maps.Gt.Data();
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      // stage 1: BX, GX (qx,dy,dz); stage 2: BBX, GBX, BGX (qx,qy,dz);
+      // stage 3: F0, F1, F2 (qx,qy,qz)
+      Vector buf(2*s1 + 3*s2 + 3*nq);
+      double *BX = buf.GetData(), *GX = BX + s1;
+      double *BBX = GX + s1, *GBX = BBX + s2, *BGX = GBX + s2;
+      double *F0 = BGX + s2, *F1 = F0 + nq, *F2 = F1 + nq;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int e = 0; e < ne; e++)
+      {
+         const double *D = op.GetData() + 6*nq*e;
+         const double *X = x.GetData() + nd*e;
+         double *Y = y.GetData() + nd*e;
+
+         // contract in x
+         for (int i = 0; i < s1; i++) { BX[i] = GX[i] = 0.0; }
+         for (int dyz = 0; dyz < D1D*D1D; dyz++)
+         {
+            double *bx = BX + Q1D*dyz, *gx = GX + Q1D*dyz;
+            for (int dx = 0; dx < D1D; dx++)
+            {
+               const double s = X[dx + D1D*dyz];
+               for (int qx = 0; qx < Q1D; qx++)
+               {
+                  bx[qx] += B[qx + Q1D*dx]*s;
+                  gx[qx] += G[qx + Q1D*dx]*s;
+               }
+            }
+         }
+         // contract in y
+         for (int i = 0; i < s2; i++) { BBX[i] = GBX[i] = BGX[i] = 0.0; }
+         for (int dz = 0; dz < D1D; dz++)
+         {
+            for (int qy = 0; qy < Q1D; qy++)
+            {
+               const int o2 = Q1D*(qy + Q1D*dz);
+               for (int dy = 0; dy < D1D; dy++)
+               {
+                  const double b = B[qy + Q1D*dy], g = G[qy + Q1D*dy];
+                  const int o1 = Q1D*(dy + D1D*dz);
+                  for (int qx = 0; qx < Q1D; qx++)
+                  {
+                     BBX[o2 + qx] += b*BX[o1 + qx];
+                     GBX[o2 + qx] += g*BX[o1 + qx];
+                     BGX[o2 + qx] += b*GX[o1 + qx];
+                  }
+               }
+            }
+         }
+         // contract in z and apply D
+         for (int q = 0; q < nq; q++) { F0[q] = F1[q] = F2[q] = 0.0; }
+         for (int qz = 0; qz < Q1D; qz++)
+         {
+            const int o3 = Q1D*Q1D*qz;
+            for (int dz = 0; dz < D1D; dz++)
+            {
+               const double b = B[qz + Q1D*dz], g = G[qz + Q1D*dz];
+               const int o2 = Q1D*Q1D*dz;
+               for (int qxy = 0; qxy < Q1D*Q1D; qxy++)
+               {
+                  F0[o3 + qxy] += b*BGX[o2 + qxy];
+                  F1[o3 + qxy] += b*GBX[o2 + qxy];
+                  F2[o3 + qxy] += g*BBX[o2 + qxy];
+               }
+            }
+         }
+         for (int q = 0; q < nq; q++)
+         {
+            const double g0 = F0[q], g1 = F1[q], g2 = F2[q];
+            const double *d = D + q;
+            F0[q] = d[0]*g0 + d[nq]*g1 + d[2*nq]*g2;
+            F1[q] = d[nq]*g0 + d[3*nq]*g1 + d[4*nq]*g2;
+            F2[q] = d[2*nq]*g0 + d[4*nq]*g1 + d[5*nq]*g2;
+         }
+         // transposed contraction in z: A0 = Bz^t F0, A1 = Bz^t F1,
+         // A2 = Gz^t F2, stored in BGX, GBX, BBX
+         for (int i = 0; i < s2; i++) { BBX[i] = GBX[i] = BGX[i] = 0.0; }
+         for (int dz = 0; dz < D1D; dz++)
+         {
+            const int o2 = Q1D*Q1D*dz;
+            for (int qz = 0; qz < Q1D; qz++)
+            {
+               const double b = Bt[dz + D1D*qz], g = Gt[dz + D1D*qz];
+               const int o3 = Q1D*Q1D*qz;
+               for (int qxy = 0; qxy < Q1D*Q1D; qxy++)
+               {
+                  BGX[o2 + qxy] += b*F0[o3 + qxy];
+                  GBX[o2 + qxy] += b*F1[o3 + qxy];
+                  BBX[o2 + qxy] += g*F2[o3 + qxy];
+               }
+            }
+         }
+         // transposed contraction in y: CG = By^t A0 (in GX),
+         // CB = Gy^t A1 + By^t A2 (in BX)
+         for (int i = 0; i < s1; i++) { BX[i] = GX[i] = 0.0; }
+         for (int dz = 0; dz < D1D; dz++)
+         {
+            for (int dy = 0; dy < D1D; dy++)
+            {
+               const int o1 = Q1D*(dy + D1D*dz);
+               for (int qy = 0; qy < Q1D; qy++)
+               {
+                  const double b = Bt[dy + D1D*qy], g = Gt[dy + D1D*qy];
+                  const int o2 = Q1D*(qy + Q1D*dz);
+                  for (int qx = 0; qx < Q1D; qx++)
+                  {
+                     GX[o1 + qx] += b*BGX[o2 + qx];
+                     BX[o1 + qx] += g*GBX[o2 + qx] + b*BBX[o2 + qx];
+                  }
+               }
+            }
+         }
+         // transposed contraction in x: Y += Gx^t CG + Bx^t CB
+         for (int dyz = 0; dyz < D1D*D1D; dyz++)
+         {
+            const double *cg = GX + Q1D*dyz, *cb = BX + Q1D*dyz;
+            double *Yyz = Y + D1D*dyz;
+            for (int qx = 0; qx < Q1D; qx++)
+            {
+               const double sg = cg[qx], sb = cb[qx];
+               for (int dx = 0; dx < D1D; dx++)
+               {
+                  Yyz[dx] += Gt[dx + D1D*qx]*sg + Bt[dx + D1D*qx]*sb;
+               }
+            }
+         }
+      }
+   }
+}
+
+/* Convection: y += B^t sum_k C_k G_k x, or, with 'trans', the transpose
+   y += sum_k G_k^t C_k B x. */
+static void ConvectionApply(int dim, int ne, const DofToQuad &maps,
+                            const Vector &op, bool trans, const Vector &x,
+                            Vector &y)
+{
+   const int nd = TensorBasisElement::Pow(maps.ndof1D, dim);
+   const int nq = TensorBasisElement::Pow(maps.nqpt1D, dim);
+   const int m = TensorBasisElement::Pow(std::max(maps.ndof1D, maps.nqpt1D),
+                                         dim);
+   const DenseMatrix *B[3] = { &maps.B, &maps.B, &maps.B };
+   const DenseMatrix *Bt[3] = { &maps.Bt, &maps.Bt, &maps.Bt };
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      Vector buf(2*m + 2*nq + nd);
+      double *work = buf.GetData(), *qval = work + 2*m, *qtmp = qval + nq;
+      double *dval = qtmp + nq;
+      const DenseMatrix *M[3], *Mt[3];
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int e = 0; e < ne; e++)
+      {
+         const double *C = op.GetData() + e*dim*nq;
+         const double *X = x.GetData() + e*nd;
+         double *Y = y.GetData() + e*nd;
+         if (!trans)
+         {
+            for (int q = 0; q < nq; q++) { qval[q] = 0.0; }
+            for (int k = 0; k < dim; k++)
+            {
+               GradMaps(k, maps, M, Mt);
+               TensorContract(dim, M, X, qtmp, work);
+               for (int q = 0; q < nq; q++) { qval[q] += C[k*nq + q]*qtmp[q]; }
+            }
+            TensorContract(dim, Bt, qval, dval, work);
+            for (int i = 0; i < nd; i++) { Y[i] += dval[i]; }
+         }
+         else
+         {
+            TensorContract(dim, B, X, qval, work);
+            for (int k = 0; k < dim; k++)
+            {
+               for (int q = 0; q < nq; q++) { qtmp[q] = C[k*nq + q]*qval[q]; }
+               GradMaps(k, maps, M, Mt);
+               TensorContract(dim, Mt, qtmp, dval, work);
+               for (int i = 0; i < nd; i++) { Y[i] += dval[i]; }
+            }
+         }
+      }
+   }
+}
+
+}
+
+
+bool BilinearFormIntegrator::InitPA(const FiniteElementSpace &fes)
+{
+   pa_ne = fes.GetNE();
+   pa_dim = fes.GetMesh()->Dimension();
+   if (pa_ne == 0) { return false; }
+
+   const FiniteElement &el = *fes.GetFE(0);
+   MFEM_VERIFY(el.GetGeomType() ==
+               TensorBasisElement::GetTensorProductGeometry(pa_dim) &&
+               pa_dim >= 2, "partial assembly is supported only on "
+               "quadrilateral and hexahedral meshes");
+   MFEM_VERIFY(fes.GetMesh()->SpaceDimension() == pa_dim,
+               "partial assembly is not supported on surface meshes");
+   MFEM_VERIFY(el.Space() != FunctionSpace::rQk,
+               "partial assembly does not support refined elements");
+   return true;
+}
+
+void BilinearFormIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   MFEM_ABORT("partial assembly is not implemented for this integrator");
+}
+
+void BilinearFormIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   MFEM_ABORT("partial assembly is not implemented for this integrator");
+}
+
+void BilinearFormIntegrator::AddMultTransposePA(const Vector &x,
+                                                Vector &y) const
+{
+   MFEM_ABORT("partial assembly is not implemented for this integrator");
+}
+
+
+void MassIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   if (!InitPA(fes)) { return; }
+   const FiniteElement &el = *fes.GetFE(0);
+   const IntegrationRule *ir = IntRule;
+   if (ir == NULL)
+   {
+      ElementTransformation &T = *fes.GetElementTransformation(0);
+      ir = &IntRules.Get(el.GetGeomType(), 2*el.GetOrder() + T.OrderW());
+   }
+   pa_maps.Setup(el, *ir, pa_dim);
+
+   // D = w det(J) Q
+   const int nq = ir->GetNPoints();
+   pa_data.SetSize(nq*pa_ne);
+   Vector qv;
+   for (int e = 0; e < pa_ne; e++)
+   {
+      ElementTransformation &T = *fes.GetElementTransformation(e);
+      const GeometricFactors *gf =
+         T.GetGeometricFactors(*ir, GeometricFactors::DETERMINANTS);
+      if (Q) { Q->Eval(qv, T, *ir); }
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = ir->IntPoint(q);
+         T.SetIntPoint(&ip, gf, q);
+         double w = ip.weight*T.Weight();
+         if (Q) { w *= qv(q); }
+         pa_data(e*nq + q) = w;
+      }
+   }
+}
+
+void MassIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   internal::MassApply(pa_dim, pa_ne, 1, pa_maps, pa_data, x, y);
+}
+
+
+void DiffusionIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   MFEM_VERIFY(MQ == NULL, "partial assembly supports only scalar "
+               "diffusion coefficients");
+   if (!InitPA(fes)) { return; }
+   const FiniteElement &el = *fes.GetFE(0);
+   const IntegrationRule *ir = IntRule;
+   if (ir == NULL)
+   {
+      ir = &IntRules.Get(el.GetGeomType(), 2*el.GetOrder() + pa_dim - 1);
+   }
+   pa_maps.Setup(el, *ir, pa_dim);
+
+   // D = w Q adj(J) adj(J)^t / det(J), symmetric
+   const int dim = pa_dim, nq = ir->GetNPoints();
+   const int nsym = (dim*(dim+1))/2;
+   pa_data.SetSize(nsym*nq*pa_ne);
+   DenseMatrix adjJ(dim);
+   Vector qv;
+   for (int e = 0; e < pa_ne; e++)
+   {
+      ElementTransformation &T = *fes.GetElementTransformation(e);
+      const GeometricFactors *gf = T.GetGeometricFactors(
+                                      *ir, GeometricFactors::JACOBIANS |
+                                      GeometricFactors::DETERMINANTS);
+      if (Q) { Q->Eval(qv, T, *ir); }
+      double *D = pa_data.GetData() + e*nsym*nq;
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = ir->IntPoint(q);
+         T.SetIntPoint(&ip, gf, q);
+         CalcAdjugate(T.Jacobian(), adjJ);
+         double w = ip.weight/T.Weight();
+         if (Q) { w *= qv(q); }
+         for (int i = 0; i < dim; i++)
+         {
+            for (int j = i; j < dim; j++)
+            {
+               double s = 0.0;
+               for (int k = 0; k < dim; k++) { s += adjJ(i,k)*adjJ(j,k); }
+               D[internal::SymIndex(i,j,dim)*nq + q] = w*s;
+            }
+         }
+      }
+   }
+}
+
+void DiffusionIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   if (pa_dim == 2)
+   {
+      internal::Diffusion2D(pa_ne, pa_maps, pa_data, x, y);
+   }
+   else
+   {
+      internal::Diffusion3D(pa_ne, pa_maps, pa_data, x, y);
+   }
+}
+
+
+void ConvectionIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   if (!InitPA(fes)) { return; }
+   const FiniteElement &el = *fes.GetFE(0);
+   const IntegrationRule *ir = IntRule;
+   if (ir == NULL)
+   {
+      ElementTransformation &T = *fes.GetElementTransformation(0);
+      const int order = T.OrderGrad(&el) + T.Order() + el.GetOrder();
+      ir = &IntRules.Get(el.GetGeomType(), order);
+   }
+   pa_maps.Setup(el, *ir, pa_dim);
+
+   // C = alpha w adj(J) Q
+   const int dim = pa_dim, nq = ir->GetNPoints();
+   pa_data.SetSize(dim*nq*pa_ne);
+   DenseMatrix adjJ(dim);
+   Vector qv(dim);
+   for (int e = 0; e < pa_ne; e++)
+   {
+      ElementTransformation &T = *fes.GetElementTransformation(e);
+      const GeometricFactors *gf =
+         T.GetGeometricFactors(*ir, GeometricFactors::JACOBIANS);
+      double *C = pa_data.GetData() + e*dim*nq;
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = ir->IntPoint(q);
+         T.SetIntPoint(&ip, gf, q);
+         CalcAdjugate(T.Jacobian(), adjJ);
+         Q.Eval(qv, T, ip);
+         for (int i = 0; i < dim; i++)
+         {
+            double s = 0.0;
+            for (int k = 0; k < dim; k++) { s += adjJ(i,k)*qv(k); }
+            C[i*nq + q] = alpha*ip.weight*s;
+         }
+      }
+   }
+}
+
+void ConvectionIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   internal::ConvectionApply(pa_dim, pa_ne, pa_maps, pa_data, false, x, y);
+}
+
+void ConvectionIntegrator::AddMultTransposePA(const Vector &x,
+                                              Vector &y) const
+{
+   internal::ConvectionApply(pa_dim, pa_ne, pa_maps, pa_data, true, x, y);
+}
+
+
+void VectorMassIntegrator::AssemblePA(const FiniteElementSpace &fes)
+{
+   MFEM_VERIFY(VQ == NULL && MQ == NULL, "partial assembly supports only "
+               "scalar vector mass coefficients");
+   vdim = (vdim == -1) ? fes.GetMesh()->SpaceDimension() : vdim;
+   MFEM_VERIFY(vdim == fes.GetVDim(), "invalid vector dimension of the "
+               "space: " << fes.GetVDim());
+   if (!InitPA(fes)) { return; }
+   const FiniteElement &el = *fes.GetFE(0);
+   const IntegrationRule *ir = IntRule;
+   if (ir == NULL)
+   {
+      ElementTransformation &T = *fes.GetElementTransformation(0);
+      const int order = 2*el.GetOrder() + T.OrderW() + Q_order;
+      ir = &IntRules.Get(el.GetGeomType(), order);
+   }
+   pa_maps.Setup(el, *ir, pa_dim);
+
+   // D = w det(J) Q, the same for all components
+   const int nq = ir->GetNPoints();
+   pa_data.SetSize(nq*pa_ne);
+   Vector qv;
+   for (int e = 0; e < pa_ne; e++)
+   {
+      ElementTransformation &T = *fes.GetElementTransformation(e);
+      const GeometricFactors *gf =
+         T.GetGeometricFactors(*ir, GeometricFactors::DETERMINANTS);
+      if (Q) { Q->Eval(qv, T, *ir); }
+      for (int q = 0; q < nq; q++)
+      {
+         const IntegrationPoint &ip = ir->IntPoint(q);
+         T.SetIntPoint(&ip, gf, q);
+         double w = ip.weight*T.Weight();
+         if (Q) { w *= qv(q); }
+         pa_data(e*nq + q) = w;
+      }
+   }
+}
+
+void VectorMassIntegrator::AddMultPA(const Vector &x, Vector &y) const
+{
+   internal::MassApply(pa_dim, pa_ne, vdim, pa_maps, pa_data, x, y);
+}
+
+}
@@ -0,0 +1,116 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_PA
+#define MFEM_PA
+
+#include "../config/config.hpp"
+#include "../linalg/operator.hpp"
+#include "../linalg/densemat.hpp"
+#include "fe.hpp"
+
+namespace mfem
+{
+
+class FiniteElementSpace;
+
+/// Enumeration defining the assembly level of a BilinearForm.
+struct AssemblyLevel
+{
+   enum Type
+   {
+      /// Assemble the global SparseMatrix (default).
+      FULL,
+      /** @brief Store only the quadrature point data of the integrators and
+          apply the operator with sum-factorized kernels, see
+          BilinearFormIntegrator::AssemblePA(). */
+      PARTIAL
+   };
+};
+
+/** @brief One-dimensional values and derivatives of the basis of a tensor
+    product element at the 1D points of a tensor product IntegrationRule. */
+/** The 1D maps are used by the sum-factorized partial assembly kernels: the
+    values of a function at the points of the D-dimensional rule are obtained
+    by applying the matrix #B along each of the D axes of the tensor of the
+    lexicographically ordered element dofs. */
+class DofToQuad
+{
+public:
+   int ndof1D; ///< number of 1D basis functions, i.e. order + 1
+   int nqpt1D; ///< number of 1D quadrature points
+
+   /// Basis values, B(q,d) = phi_d(x_q), size nqpt1D x ndof1D.
+   DenseMatrix B;
+   /// Basis derivatives, G(q,d) = phi_d'(x_q), size nqpt1D x ndof1D.
+   DenseMatrix G;
+   /// The transposes of #B and #G, stored for contiguous access.
+   DenseMatrix Bt, Gt;
+
+   DofToQuad() : ndof1D(0), nqpt1D(0) { }
+
+   /** @brief Compute the maps for the TensorBasisElement @a el and the tensor
+       product rule @a ir in dimension @a dim. */
+   /** The points of @a ir must be ordered lexicographically, with the first
+       coordinate varying fastest, as in the rules of IntRules. */
+   void Setup(const FiniteElement &el, const IntegrationRule &ir, int dim);
+};
+
+/** @brief Compute with sum factorization the matrix A of a tensor product
+    element with entries A(i,j) = sum_q sum_{k,l} G_k(q,i) D_kl(q) G_l(q,j),
+    where G_k(q,i) is the derivative along the reference axis k of basis
+    function i at point q. */
+/** The maps @a maps are set up with DofToQuad::Setup() in dimension @a dim, 2
+    or 3, and D_kl(q) is stored in @a D at index (k + dim*l)*nq + q, where nq
+    is the number of points. The dofs of @a A are ordered lexicographically.
+    The contractions are computed axis by axis with dense matrix products, in
+    O(p^(2 dim + 1)) operations for order p, instead of the O(p^(3 dim)) of a
+    product of the gradients at all the points. */
+void TensorGradElementMatrix(int dim, const DofToQuad &maps, const Vector &D,
+                             DenseMatrix &A);
+
+/** @brief Operator mapping an L-vector, i.e. a GridFunction-size vector, of a
+    FiniteElementSpace to E-vectors, i.e. the element-local dof values. */
+/** All elements must be tensor product elements of the same type. The E-vector
+    of element e and vector component c is stored at offset (c + vdim*e)*nd,
+    where nd is the number of element dofs, with the dofs of the element in
+    lexicographic order, see TensorBasisElement::GetDofMap(). The transpose
+    operator adds the E-vector values to the shared dofs. */
+class ElementRestriction : public Operator
+{
+protected:
+   int ne, vdim, nd;
+   /// L-vector index of each E-vector entry, encoded as -1-i for negative dofs
+   Array<int> indices;
+
+public:
+   ElementRestriction(const FiniteElementSpace &fes);
+
+   /// Return the number of elements.
+   int GetNE() const { return ne; }
+   /// Return the number of vector components.
+   int GetVDim() const { return vdim; }
+   /// Return the number of dofs per element and vector component.
+   int GetNDofs() const { return nd; }
+
+   /// Gather the element values @a y from the L-vector @a x.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// Set @a y to zero and add the element values @a x to it.
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /// Add @a a times the element values @a x to the L-vector @a y.
+   void AddMultTranspose(const Vector &x, Vector &y, double a = 1.0) const;
+};
+
+}
+
+#endif
@@ -42,6 +42,7 @@ StaticCondensation::StaticCondensation(FiniteElementSpace *fespace)
    symm = false;
    A_data = NULL;
    A_ipiv = NULL;
+   A_ee_data = NULL;
 
    Array<int> vdofs;
    const int NE = fes->GetNE();
@@ -109,6 +110,7 @@ StaticCondensation::~StaticCondensation()
 #endif
    delete S_e;
    delete S;
+   delete [] A_ee_data;
    delete [] A_data;
    delete [] A_ipiv;
    delete tr_fes;
@@ -137,7 +139,8 @@ void StaticCondensation::Init(bool symmetric, bool block_diagonal)
    // symm = symmetric; // TODO: handle the symmetric case
    A_offsets.SetSize(NE+1);
    A_ipiv_offsets.SetSize(NE+1);
-   A_offsets[0] = A_ipiv_offsets[0] = 0;
+   A_ee_offsets.SetSize(NE+1);
+   A_offsets[0] = A_ipiv_offsets[0] = A_ee_offsets[0] = 0;
    Array<int> rvdofs;
    for (int i = 0; i < NE; i++)
    {
@@ -146,6 +149,7 @@ void StaticCondensation::Init(bool symmetric, bool block_diagonal)
       const int npd = elem_pdof.RowSize(i);
       A_offsets[i+1] = A_offsets[i] + npd*(npd + (symm ? 1 : 2)*ned);
       A_ipiv_offsets[i+1] = A_ipiv_offsets[i] + npd;
+      A_ee_offsets[i+1] = A_ee_offsets[i] + ned*(ned + (symm ? npd : 0));
    }
    A_data = new double[A_offsets[NE]];
    A_ipiv = new int[A_ipiv_offsets[NE]];
@@ -188,17 +192,26 @@ void StaticCondensation::Init(bool symmetric, bool block_diagonal)
 
 void StaticCondensation::AssembleMatrix(int el, const DenseMatrix &elmat)
 {
+   // A second matrix for el must not overwrite the saved blocks of the first
+   if (A_ee_data && assembled_marker[el]) { FactorAssembledElements(); }
+
    Array<int> rvdofs;
    tr_fes->GetElementVDofs(el, rvdofs);
    const int vdim = fes->GetVDim();
    const int nvpd = elem_pdof.RowSize(el);
    const int nved = rvdofs.Size();
+   if (!A_ee_data)
+   {
+      A_ee_data = new double[A_ee_offsets[fes->GetNE()]];
+      assembled_marker.SetSize(fes->GetNE());
+      assembled_marker = 0;
+   }
    DenseMatrix A_pp(A_data + A_offsets[el], nvpd, nvpd);
    DenseMatrix A_pe(A_pp.Data() + nvpd*nvpd, nvpd, nved);
+   DenseMatrix A_ee(A_ee_data + A_ee_offsets[el], nved, nved);
    DenseMatrix A_ep;
-   if (symm) { A_ep.SetSize(nved, nvpd); }
+   if (symm) { A_ep.UseExternalData(A_ee.Data() + nved*nved, nved, nvpd); }
    else      { A_ep.UseExternalData(A_pe.Data() + nvpd*nved, nved, nvpd); }
-   DenseMatrix A_ee(nved, nved);
 
    const int npd = nvpd/vdim;
    const int ned = nved/vdim;
@@ -214,14 +227,47 @@ void StaticCondensation::AssembleMatrix(int el, const DenseMatrix &elmat)
          A_ee.CopyMN(elmat, ned, ned, i*nd,     j*nd,     i*ned, j*ned);
       }
    }
-   // Compute the Schur complement
-   LUFactors lu(A_pp.Data(), A_ipiv + A_ipiv_offsets[el]);
-   lu.Factor(nvpd);
-   lu.BlockFactor(nvpd, nved, A_pe.Data(), A_ep.Data(), A_ee.Data());
+   assembled_elems.Append(el);
+   assembled_marker[el] = 1;
+}
+
+void StaticCondensation::FactorAssembledElements()
+{
+   const int num_elems = assembled_elems.Size();
+   if (num_elems == 0) { return; }
+
+   Array<int> sizes(num_elems);
+   Array<double *> A_pp(num_elems);
+   Array<int *> P_pp(num_elems);
+   for (int k = 0; k < num_elems; k++)
+   {
+      const int el = assembled_elems[k];
+      sizes[k] = elem_pdof.RowSize(el);
+      A_pp[k] = A_data + A_offsets[el];
+      P_pp[k] = A_ipiv + A_ipiv_offsets[el];
+   }
+   BatchLUFactor(sizes, A_pp, P_pp);
 
-   // Assemble the Schur complement
+   // Compute and assemble the Schur complements
+   Array<int> rvdofs;
    const int skip_zeros = 0;
-   S->AddSubMatrix(rvdofs, rvdofs, A_ee, skip_zeros);
+   for (int k = 0; k < num_elems; k++)
+   {
+      const int el = assembled_elems[k];
+      tr_fes->GetElementVDofs(el, rvdofs);
+      const int nvpd = sizes[k];
+      const int nved = rvdofs.Size();
+      DenseMatrix A_ee(A_ee_data + A_ee_offsets[el], nved, nved);
+      double *A_pe = A_pp[k] + nvpd*nvpd;
+      double *A_ep = symm ? A_ee.Data() + nved*nved : A_pe + nvpd*nved;
+      LUFactors(A_pp[k], P_pp[k]).BlockFactor(nvpd, nved, A_pe, A_ep,
+                                              A_ee.Data());
+      S->AddSubMatrix(rvdofs, rvdofs, A_ee, skip_zeros);
+   }
+   assembled_elems.SetSize(0);
+   assembled_marker.DeleteAll();
+   delete [] A_ee_data;
+   A_ee_data = NULL;
 }
 
 void StaticCondensation::AssembleBdrMatrix(int el, const DenseMatrix &elmat)
@@ -237,6 +283,7 @@ void StaticCondensation::Finalize()
    const int skip_zeros = 0;
    if (!Parallel())
    {
+      FactorAssembledElements();
       S->Finalize(skip_zeros);
       if (S_e) { S_e->Finalize(skip_zeros); }
       const SparseMatrix *cP = tr_fes->GetConformingProlongation();
@@ -260,6 +307,7 @@ void StaticCondensation::Finalize()
    {
 #ifdef MFEM_USE_MPI
       if (!S) { return; } // already finalized
+      FactorAssembledElements();
       S->Finalize(skip_zeros);
       if (S_e) { S_e->Finalize(skip_zeros); }
       OperatorHandle dS(pS.Type()), pP(pS.Type());
@@ -84,6 +84,16 @@ class StaticCondensation
    Array<int> A_offsets, A_ipiv_offsets;
    double *A_data;
    int *A_ipiv;
+   // Blocks A_ee (and A_ep, if symm) of the elements assembled since the last
+   // call to Finalize(), which factors them all at once. The storage for all
+   // the elements is allocated on the first call to AssembleMatrix() and freed
+   // by Finalize(); assembled_marker[el] is 1 if el is in assembled_elems.
+   Array<int> A_ee_offsets, assembled_elems, assembled_marker;
+   double *A_ee_data;
+
+   // Factor the blocks A_pp of the assembled elements with the batched LU
+   // factorization, and add their Schur complements to S.
+   void FactorAssembledElements();
 
    Array<int> ess_rtdof_list;
 
@@ -112,9 +122,14 @@ public:
    /// Return a pointer to the parallel reduced/trace FE space.
    ParFiniteElementSpace *GetParTraceFESpace() { return tr_pfes; }
 #endif
-   /** Assemble the contribution to the Schur complement from the given
-       element matrix 'elmat'; save the other blocks internally: A_pp_inv, A_pe,
-       and A_ep. */
+   /** Save the blocks of the given element matrix 'elmat' internally. The
+       blocks A_pp are factored, A_pp_inv, and the contributions to the Schur
+       complement are assembled in Finalize(), for all the elements at once.
+       Until then, the blocks A_ee of all the elements of the space are kept,
+       i.e. the memory is that of the element matrices. Calling this method
+       again for the same element before Finalize() first factors the saved
+       elements, so that both contributions are added to the Schur complement,
+       as with an immediate factorization. */
    void AssembleMatrix(int el, const DenseMatrix &elmat);
 
    /** Assemble the contribution to the Schur complement from the given boundary
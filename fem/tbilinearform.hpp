@@ -14,6 +14,7 @@
 
 #include "../config/tconfig.hpp"
 #include "../linalg/ttensor.hpp"
+#include "../linalg/simd.hpp"
 #include "bilinearform.hpp"
 #include "tevaluator.hpp"
 #include "teltrans.hpp"
@@ -27,15 +28,20 @@ namespace mfem
 
 // complex_t - sol dof data type
 // real_t - mesh nodes, sol basis, mesh basis data type
+// impl_traits_t - implementation traits, see AutoSIMDTraits: the partially
+//                 assembled action processes the elements in batches of
+//                 impl_traits_t::simd_size, one element per SIMD lane
 template <typename meshType, typename solFESpace,
           typename IR, typename IntegratorType,
           typename solVecLayout_t = ScalarLayout,
-          typename complex_t = double, typename real_t = double>
+          typename complex_t = double, typename real_t = double,
+          typename impl_traits_t = AutoSIMDTraits<complex_t,real_t> >
 class TBilinearForm : public Operator
 {
 protected:
    typedef complex_t complex_type;
    typedef real_t    real_type;
+   typedef typename impl_traits_t::vcomplex_t vcomplex_t;
 
    typedef typename meshType::FE_type            meshFE_type;
    typedef ShapeEvaluator<meshFE_type,IR,real_t> meshShapeEval;
@@ -48,12 +54,16 @@ protected:
    static const int dofs = solFE_type::dofs;
    static const int vdim = solVecLayout_t::vec_dim;
    static const int qpts = IR::qpts;
+   static const int SS   = impl_traits_t::simd_size; // elements per batch
 
    typedef IntegratorType integ_t;
    typedef typename integ_t::coefficient_type coeff_t;
    typedef typename integ_t::template kernel<sdim,dim,complex_t>::type kernel_t;
    typedef typename kernel_t::template p_asm_data<qpts>::type p_assembled_t;
    typedef typename kernel_t::template f_asm_data<qpts>::type f_assembled_t;
+   typedef typename integ_t::template kernel<sdim,dim,vcomplex_t>::type
+   vkernel_t;
+   typedef typename vkernel_t::template p_asm_data<qpts>::type vp_assembled_t;
 
    typedef TElementTransformation<meshType,IR,real_t> Trans_t;
    template <int NE> struct T_result
@@ -72,6 +82,14 @@ protected:
       typedef typename Spec::ElementMatrix ElementMatrix;
    };
 
+   typedef FieldEvaluator<solFESpace,solVecLayout_t,IR,
+           complex_t,real_t,vcomplex_t> vsolFieldEval;
+   template <int BE> struct VS_spec
+   {
+      typedef typename vsolFieldEval::template Spec<vkernel_t,BE> Spec;
+      typedef typename Spec::DataType DataType;
+   };
+
    // Data members
 
    meshType      mesh;
@@ -86,7 +104,10 @@ protected:
 
    coeff_t coeff;
 
-   p_assembled_t *assembled_data;
+   // Partially assembled data of the batches of SS elements: lane s of entry b
+   // holds the data of element b*SS+s; the unused lanes of the last entry are
+   // zero. Allocated with AlignedNew().
+   vp_assembled_t *assembled_data;
 
    const FiniteElementSpace &in_fes;
 
@@ -107,7 +128,7 @@ public:
 
    virtual ~TBilinearForm()
    {
-      delete [] assembled_data;
+      AlignedDelete(assembled_data);
    }
 
    /// Get the input finite element space prolongation matrix
@@ -187,7 +208,7 @@ public:
       const int NE = mesh.GetNE();
       if (!assembled_data)
       {
-         assembled_data = new p_assembled_t[NE];
+         NewAssembledData(NE);
       }
       for (int el = 0; el < NE; el++) // BE == 1
       {
@@ -197,46 +218,99 @@ public:
          typename coeff_eval_t::result_t res;
          wQ.Eval(F, res);
 
-         for (int k = 0; k < BE; k++)
-         {
-            kernel_t::Assemble(k, F, wQ, res, assembled_data[el+k]);
-         }
+         p_assembled_t el_data;
+         kernel_t::Assemble(0, F, wQ, res, el_data);
+         SetAssembledData(el, el_data);
+      }
+   }
+
+   // Allocate and zero the partially assembled data for NE elements.
+   void NewAssembledData(int NE)
+   {
+      const int NB = (NE + SS - 1)/SS;
+      assembled_data = AlignedNew<vp_assembled_t>(NB);
+      vcomplex_t zero;
+      zero = 0.0;
+      for (int b = 0; b < NB; b++)
+      {
+         assembled_data[b].Set(zero);
+      }
+   }
+
+   // Copy the partially assembled data of element el into its SIMD lane.
+   inline MFEM_ALWAYS_INLINE
+   void SetAssembledData(int el, const p_assembled_t &el_data)
+   {
+      vp_assembled_t &b_data = assembled_data[el/SS];
+      for (int i = 0; i < p_assembled_t::size; i++)
+      {
+         internal::SIMDLane(b_data.data[i], el%SS) = el_data.data[i];
       }
    }
 
+   // Copy the partially assembled data of element el from its SIMD lane.
+   inline MFEM_ALWAYS_INLINE
+   void GetAssembledData(int el, p_assembled_t &el_data) const
+   {
+      const vp_assembled_t &b_data = assembled_data[el/SS];
+      for (int i = 0; i < p_assembled_t::size; i++)
+      {
+         el_data.data[i] = internal::SIMDLane(b_data.data[i], el%SS);
+      }
+   }
+
+   // Action on num_elem batches of SS elements starting with element el,
+   // which must be a multiple of SS.
    template <int num_elem>
    inline MFEM_ALWAYS_INLINE
-   void ElementAddMultAssembled(int el, solFieldEval &solFEval) const
+   void ElementAddMultAssembled(int el, vsolFieldEval &solFEval) const
    {
-      typename S_spec<num_elem>::DataType R;
+      typename VS_spec<num_elem>::DataType R;
       solFEval.Eval(el, R);
 
       for (int k = 0; k < num_elem; k++)
       {
-         kernel_t::MultAssembled(k, assembled_data[el+k], R);
+         vkernel_t::MultAssembled(k, assembled_data[el/SS+k], R);
       }
 
       solFEval.template Assemble<true>(R);
    }
 
    // complex_t = double
+   // The elements are processed in groups of num_elem batches of SS elements;
+   // the elements after the last full batch are processed one by one.
    template <int num_elem>
    void MultAssembled(const Vector &x, Vector &y) const
    {
       y = 0.0;
 
-      solFieldEval solFEval(solFES, solEval, solVecLayout,
-                            x.GetData(), y.GetData());
+      vsolFieldEval vsolFEval(solFES, solEval, solVecLayout,
+                              x.GetData(), y.GetData());
 
       const int NE = mesh.GetNE();
-      const int bNE = NE-NE%num_elem;
-      for (int el = 0; el < bNE; el += num_elem)
+      const int bNE = NE-NE%(num_elem*SS);
+      const int sNE = NE-NE%SS;
+      for (int el = 0; el < bNE; el += num_elem*SS)
+      {
+         ElementAddMultAssembled<num_elem>(el, vsolFEval);
+      }
+      for (int el = bNE; el < sNE; el += SS)
       {
-         ElementAddMultAssembled<num_elem>(el, solFEval);
+         ElementAddMultAssembled<1>(el, vsolFEval);
       }
-      for (int el = bNE; el < NE; el++)
+      if (sNE == NE) { return; }
+
+      solFieldEval solFEval(solFES, solEval, solVecLayout,
+                            x.GetData(), y.GetData());
+      for (int el = sNE; el < NE; el++)
       {
-         ElementAddMultAssembled<1>(el, solFEval);
+         p_assembled_t el_data;
+         GetAssembledData(el, el_data);
+
+         typename S_spec<1>::DataType R;
+         solFEval.Eval(el, R);
+         kernel_t::MultAssembled(0, el_data, R);
+         solFEval.template Assemble<true>(R);
       }
    }
 
@@ -294,7 +368,7 @@ public:
       const int NE = mesh.GetNE();
       if (!assembled_data)
       {
-         assembled_data = new p_assembled_t[NE];
+         NewAssembledData(NE);
       }
       for (int el = 0; el < NE; el++)
       {
@@ -304,7 +378,9 @@ public:
          typename coeff_eval_t::result_t res;
          wQ.Eval(F, res);
 
-         kernel_t::Assemble(0, F, wQ, res, assembled_data[el]);
+         p_assembled_t el_data;
+         kernel_t::Assemble(0, F, wQ, res, el_data);
+         SetAssembledData(el, el_data);
       }
    }
 
@@ -337,10 +413,13 @@ public:
       complex_t *loc_sy = sy.GetData();
       for (int el = 0; el < NE; el++)
       {
+         p_assembled_t el_data;
+         GetAssembledData(el, el_data);
+
          typename S_spec<1>::DataType R;
          solFEval.EvalSerialized(loc_sx, R);
 
-         kernel_t::MultAssembled(0, assembled_data[el], R);
+         kernel_t::MultAssembled(0, el_data, R);
 
          solFEval.template AssembleSerialized<false>(R, loc_sy);
 
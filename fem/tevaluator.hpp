@@ -14,6 +14,7 @@
 
 #include "../config/tconfig.hpp"
 #include "../linalg/ttensor.hpp"
+#include "../linalg/simd.hpp"
 #include "../general/error.hpp"
 #include "fespace.hpp"
 
@@ -352,9 +353,10 @@ public:
    void Calc(const dof_layout_t &dof_layout, const dof_data_t &dof_data,
              const qpt_layout_t &qpt_layout, qpt_data_t &qpt_data) const
    {
+      typedef typename internal::EntryType<qpt_data_t>::type entry_t;
       const int NC = dof_layout_t::dim_2;
       // DOF x DOF x NC --> NIP x DOF x NC --> NIP x NIP x NC
-      TTensor3<NIP,DOF,NC> A;
+      TTensor3<NIP,DOF,NC,entry_t> A;
 
       // (1) A_{i,j,k} = \sum_s B_1d_{i,s} dof_data_{s,j,k}
       Mult_2_1<false>(B_1d.layout, Dx ? G_1d : B_1d,
@@ -384,9 +386,10 @@ public:
    void CalcT(const qpt_layout_t &qpt_layout, const qpt_data_t &qpt_data,
               const dof_layout_t &dof_layout, dof_data_t &dof_data) const
    {
+      typedef typename internal::EntryType<dof_data_t>::type entry_t;
       const int NC = dof_layout_t::dim_2;
       // NIP x NIP X NC --> NIP x DOF x NC --> DOF x DOF x NC
-      TTensor3<NIP,DOF,NC> A;
+      TTensor3<NIP,DOF,NC,entry_t> A;
 
       // (1) A_{i,j,k} = \sum_s B_1d_{s,j} qpt_data_{i,s,k}
       Mult_1_2<false>(B_1d.layout, Dy ? G_1d : B_1d,
@@ -628,9 +631,10 @@ public:
    void Calc(const dof_layout_t &dof_layout, const dof_data_t &dof_data,
              const qpt_layout_t &qpt_layout, qpt_data_t &qpt_data) const
    {
+      typedef typename internal::EntryType<qpt_data_t>::type entry_t;
       const int NC = dof_layout_t::dim_2;
-      TVector<NIP*DOF*DOF*NC> QDD;
-      TVector<NIP*NIP*DOF*NC> QQD;
+      TVector<NIP*DOF*DOF*NC,entry_t> QDD;
+      TVector<NIP*NIP*DOF*NC,entry_t> QQD;
 
       // QDD_{i,jj,k} = \sum_s B_1d_{i,s} dof_data_{s,jj,k}
       Mult_2_1<false>(B_1d.layout, Dx ? G_1d : B_1d,
@@ -664,9 +668,10 @@ public:
    void CalcT(const qpt_layout_t &qpt_layout, const qpt_data_t &qpt_data,
               const dof_layout_t &dof_layout, dof_data_t &dof_data) const
    {
+      typedef typename internal::EntryType<dof_data_t>::type entry_t;
       const int NC = dof_layout_t::dim_2;
-      TVector<NIP*DOF*DOF*NC> QDD;
-      TVector<NIP*NIP*DOF*NC> QQD;
+      TVector<NIP*DOF*DOF*NC,entry_t> QDD;
+      TVector<NIP*NIP*DOF*NC,entry_t> QQD;
 
       // QQD_{ii,j,k} = \sum_s B_1d_{s,j} qpt_data_{ii,s,k}
       Mult_1_2<false>(B_1d.layout, Dz ? G_1d : B_1d,
@@ -977,20 +982,27 @@ protected:
 };
 
 // complex_t - dof/qpt data type, real_t - ShapeEvaluator (FE basis) data type
+// vcomplex_t - dof/qpt data type of the element batches in the Eval() and
+//              Assemble() methods: either complex_t, or a SIMD type (AutoSIMD)
+//              whose lanes hold consecutive elements; the global data is always
+//              of type complex_t.
 template <typename FESpace_t, typename VecLayout_t, typename IR,
-          typename complex_t = double, typename real_t = double>
+          typename complex_t = double, typename real_t = double,
+          typename vcomplex_t = complex_t>
 class FieldEvaluator
    : public FieldEvaluator_base<FESpace_t,VecLayout_t,IR,complex_t,real_t>
 {
 public:
    typedef complex_t                         complex_type;
+   typedef vcomplex_t                        vcomplex_type;
    typedef FESpace_t                         FESpace_type;
    typedef typename FESpace_t::FE_type       FE_type;
    typedef ShapeEvaluator<FE_type,IR,real_t> ShapeEval_type;
    typedef VecLayout_t                       VecLayout_type;
 
    // this type
-   typedef FieldEvaluator<FESpace_t,VecLayout_t,IR,complex_t,real_t> T_type;
+   typedef FieldEvaluator<FESpace_t,VecLayout_t,IR,complex_t,real_t,vcomplex_t>
+   T_type;
 
    static const int dofs = FE_type::dofs;
    static const int dim  = FE_type::dim;
@@ -1055,7 +1067,7 @@ public:
    void GetValues(int el, const val_layout_t &l, val_data_t &vals)
    {
       const int ne = val_layout_t::dim_3;
-      TTensor3<dofs,vdim,ne,complex_type> val_dofs;
+      TTensor3<dofs,vdim,ne,vcomplex_type> val_dofs;
       SetElement(el);
       fespace.VectorExtract(vec_layout, data_in, val_dofs.layout, val_dofs);
       shapeEval.Calc(val_dofs.layout.merge_23(), val_dofs, l.merge_23(), vals);
@@ -1067,7 +1079,7 @@ public:
    void GetGradients(int el, const grad_layout_t &l, grad_data_t &grad)
    {
       const int ne = grad_layout_t::dim_4;
-      TTensor3<dofs,vdim,ne,complex_type> val_dofs;
+      TTensor3<dofs,vdim,ne,vcomplex_type> val_dofs;
       SetElement(el);
       fespace.VectorExtract(vec_layout, data_in, val_dofs.layout, val_dofs);
       shapeEval.CalcGrad(val_dofs.layout.merge_23(), val_dofs,
@@ -1150,35 +1162,35 @@ public:
    template <int NE> struct AData<1,NE> // 1 = Values
    {
 #ifdef MFEM_TEMPLATE_FIELD_EVAL_DATA_HAS_DOFS
-      typedef TTensor3<dofs,vdim,NE,complex_t,true> val_dofs_t;
+      typedef TTensor3<dofs,vdim,NE,vcomplex_t,true> val_dofs_t;
       val_dofs_t val_dofs;
 #else
-      typedef TTensor3<dofs,vdim,NE,complex_t> val_dofs_t;
+      typedef TTensor3<dofs,vdim,NE,vcomplex_t> val_dofs_t;
 #endif
-      TTensor3<qpts,vdim,NE,complex_t>      val_qpts;
+      TTensor3<qpts,vdim,NE,vcomplex_t>     val_qpts;
    };
 
    template <int NE> struct AData<2,NE> // 2 = Gradients
    {
 #ifdef MFEM_TEMPLATE_FIELD_EVAL_DATA_HAS_DOFS
-      typedef TTensor3<dofs,vdim,NE,complex_t,true> val_dofs_t;
+      typedef TTensor3<dofs,vdim,NE,vcomplex_t,true> val_dofs_t;
       val_dofs_t val_dofs;
 #else
-      typedef TTensor3<dofs,vdim,NE,complex_t> val_dofs_t;
+      typedef TTensor3<dofs,vdim,NE,vcomplex_t> val_dofs_t;
 #endif
-      TTensor4<qpts,dim,vdim,NE,complex_t>      grad_qpts;
+      TTensor4<qpts,dim,vdim,NE,vcomplex_t>     grad_qpts;
    };
 
    template <int NE> struct AData<3,NE> // 3 = Values+Gradients
    {
 #ifdef MFEM_TEMPLATE_FIELD_EVAL_DATA_HAS_DOFS
-      typedef TTensor3<dofs,vdim,NE,complex_t,true> val_dofs_t;
+      typedef TTensor3<dofs,vdim,NE,vcomplex_t,true> val_dofs_t;
       val_dofs_t val_dofs;
 #else
-      typedef TTensor3<dofs,vdim,NE,complex_t> val_dofs_t;
+      typedef TTensor3<dofs,vdim,NE,vcomplex_t> val_dofs_t;
 #endif
-      TTensor3<qpts,    vdim,NE,complex_t,true>  val_qpts;
-      TTensor4<qpts,dim,vdim,NE,complex_t>      grad_qpts;
+      TTensor3<qpts,    vdim,NE,vcomplex_t,true> val_qpts;
+      TTensor4<qpts,dim,vdim,NE,vcomplex_t>     grad_qpts;
    };
 
    // This struct is similar to struct AData, adding separate static data
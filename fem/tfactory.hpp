@@ -0,0 +1,294 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_TEMPLATE_FACTORY
+#define MFEM_TEMPLATE_FACTORY
+
+#include "../config/tconfig.hpp"
+#include "../mesh/tmesh.hpp"
+#include "tfe.hpp"
+#include "tfespace.hpp"
+#include "tintrules.hpp"
+#include "tcoefficient.hpp"
+#include "tbilininteg.hpp"
+#include "tbilinearform.hpp"
+#include "bilinearform.hpp"
+
+namespace mfem
+{
+
+// Runtime selection of explicitly instantiated templated bilinear forms.
+
+/// The kernels supported by TBilinearFormFactory, see tbilininteg.hpp.
+struct TKernelType
+{
+   enum Type
+   {
+      MASS,     ///< TMassKernel, cf. MassIntegrator
+      DIFFUSION ///< TDiffusionKernel, cf. DiffusionIntegrator
+   };
+};
+
+namespace internal
+{
+
+// Map a templated kernel to its TKernelType and the order of the quadrature
+// rule used by the corresponding BilinearFormIntegrator.
+template <template <int,int,typename> class kernel_t> struct TKernelTraits;
+
+template <> struct TKernelTraits<TMassKernel>
+{
+   static const TKernelType::Type type = TKernelType::MASS;
+   template <int dim, int mesh_p, int sol_p> struct IntRuleOrder
+   { static const int value = 2*sol_p + dim*mesh_p - 1; };
+};
+
+template <> struct TKernelTraits<TDiffusionKernel>
+{
+   static const TKernelType::Type type = TKernelType::DIFFUSION;
+   template <int dim, int mesh_p, int sol_p> struct IntRuleOrder
+   { static const int value = 2*sol_p + dim - 1; };
+};
+
+}
+
+/** @brief The TBilinearForm instantiation for H1 elements of order @a sol_p on
+    a mesh with @a geom elements and H1 nodes of order @a mesh_p, with the
+    templated kernel @a kernel_t and a constant coefficient. */
+template <Geometry::Type geom, int mesh_p, int sol_p,
+          template <int,int,typename> class kernel_t>
+struct TBilinearFormInstance
+{
+   static const int dim = Geometry::Constants<geom>::Dimension;
+   static const int ir_order = internal::TKernelTraits<kernel_t>::
+                               template IntRuleOrder<dim,mesh_p,sol_p>::value;
+
+   typedef H1_FiniteElement<geom,mesh_p>    mesh_fe_t;
+   typedef H1_FiniteElementSpace<mesh_fe_t> mesh_fes_t;
+   typedef TMesh<mesh_fes_t>                mesh_t;
+   typedef H1_FiniteElement<geom,sol_p>     sol_fe_t;
+   typedef H1_FiniteElementSpace<sol_fe_t>  sol_fes_t;
+   typedef TIntegrationRule<geom,ir_order>  int_rule_t;
+   typedef TConstantCoefficient<>           coeff_t;
+   typedef TIntegrator<coeff_t,kernel_t>    integ_t;
+   typedef TBilinearForm<mesh_t,sol_fes_t,int_rule_t,integ_t> form_t;
+
+   /** @brief Check if the instantiation can be used with the space @a fes: the
+       mesh must have nodes of the matching order, see TMesh::Matches(). */
+   static bool Matches(const FiniteElementSpace &fes)
+   {
+      return (fes.GetVDim() == 1 && mesh_t::Matches(*fes.GetMesh()) &&
+              sol_fes_t::Matches(fes));
+   }
+
+   /// Create the form and compute its quadrature point data.
+   static Operator *Create(const FiniteElementSpace &fes, double coeff)
+   {
+      form_t *form = new form_t(integ_t(coeff_t(coeff)), fes);
+      form->Assemble();
+      return form;
+   }
+};
+
+/** @brief Runtime dispatch table of TBilinearForm instantiations.
+
+    The combinations of (geometry, mesh order, solution order, kernel) added
+    with Add() or AddRange() are compiled into the translation unit calling
+    these methods; Create() then selects, at runtime, the instantiation matching
+    a given FiniteElementSpace. This allows the mesh and the solution order to
+    be chosen, e.g., from an input file, without recompiling. See also
+    DispatchedBilinearForm, which falls back to the generic BilinearForm when
+    no instantiation matches. */
+class TBilinearFormFactory
+{
+public:
+   typedef bool (*MatchFunction)(const FiniteElementSpace &fes);
+   typedef Operator *(*CreateFunction)(const FiniteElementSpace &fes,
+                                       double coeff);
+
+protected:
+   struct Entry
+   {
+      TKernelType::Type kernel;
+      Geometry::Type geom;
+      int mesh_p, sol_p;
+      MatchFunction matches;
+      CreateFunction create;
+   };
+   Array<Entry> entries;
+
+public:
+   TBilinearFormFactory() { }
+
+   /// Add the TBilinearFormInstance with the given template parameters.
+   template <Geometry::Type geom, int mesh_p, int sol_p,
+             template <int,int,typename> class kernel_t>
+   void Add()
+   {
+      typedef TBilinearFormInstance<geom,mesh_p,sol_p,kernel_t> inst_t;
+      Entry e;
+      e.kernel = internal::TKernelTraits<kernel_t>::type;
+      e.geom = geom;
+      e.mesh_p = mesh_p;
+      e.sol_p = sol_p;
+      e.matches = inst_t::Matches;
+      e.create = inst_t::Create;
+      entries.Append(e);
+   }
+
+   /// Add the instances with solution orders 1, ..., @a max_sol_p.
+   template <Geometry::Type geom, int mesh_p, int max_sol_p,
+             template <int,int,typename> class kernel_t>
+   void AddRange();
+
+   /// Return the number of instances in the table.
+   int Size() const { return entries.Size(); }
+
+   /** @brief Return the index of the first instance of @a kernel matching the
+       space @a fes, or -1 if there is none, e.g. if the mesh has no
+       elements. */
+   int Find(TKernelType::Type kernel, const FiniteElementSpace &fes) const
+   {
+      const Mesh *mesh = fes.GetMesh();
+      if (mesh->GetNE() == 0) { return -1; }
+      const int geom = mesh->GetElementBaseGeometry(0);
+      const int sol_p = fes.GetOrder(0);
+      for (int i = 0; i < entries.Size(); i++)
+      {
+         const Entry &e = entries[i];
+         // the cheap checks first
+         if (e.kernel != kernel || e.geom != geom || e.sol_p != sol_p)
+         {
+            continue;
+         }
+         if (e.matches(fes)) { return i; }
+      }
+      return -1;
+   }
+
+   /** @brief Create and assemble the matching templated form for the space
+       @a fes, with the constant coefficient @a coeff; return NULL if there is
+       no matching instance. */
+   Operator *Create(TKernelType::Type kernel, const FiniteElementSpace &fes,
+                    double coeff = 1.0) const
+   {
+      const int i = Find(kernel, fes);
+      return (i >= 0) ? entries[i].create(fes, coeff) : NULL;
+   }
+};
+
+/// Helper for TBilinearFormFactory::AddRange().
+template <Geometry::Type geom, int mesh_p, int sol_p,
+          template <int,int,typename> class kernel_t>
+struct TBilinearFormFactoryRange
+{
+   static void Add(TBilinearFormFactory &factory)
+   {
+      TBilinearFormFactoryRange<geom,mesh_p,sol_p-1,kernel_t>::Add(factory);
+      factory.template Add<geom,mesh_p,sol_p,kernel_t>();
+   }
+};
+
+template <Geometry::Type geom, int mesh_p,
+          template <int,int,typename> class kernel_t>
+struct TBilinearFormFactoryRange<geom,mesh_p,0,kernel_t>
+{
+   static void Add(TBilinearFormFactory &factory) { }
+};
+
+template <Geometry::Type geom, int mesh_p, int max_sol_p,
+          template <int,int,typename> class kernel_t>
+inline void TBilinearFormFactory::AddRange()
+{
+   TBilinearFormFactoryRange<geom,mesh_p,max_sol_p,kernel_t>::Add(*this);
+}
+
+/** @brief Bilinear form operator using a TBilinearForm from a
+    TBilinearFormFactory when one matches the space, and the generic
+    BilinearForm otherwise. */
+/** The fallback BilinearForm uses partial assembly when the space supports it
+    (see BilinearForm::SetAssemblyLevel()) and a sparse matrix otherwise. On
+    tensor product elements, the templated forms use Gauss-Legendre rules of
+    the default order of MassIntegrator and DiffusionIntegrator, so both paths
+    give the same operator up to round-off. On simplices, the rules differ:
+    e.g., DiffusionIntegrator uses the order 2p-2 and the templated form uses
+    2p+dim-1. The operator can be used with Operator::FormLinearSystem(). */
+class DispatchedBilinearForm : public Operator
+{
+protected:
+   FiniteElementSpace &fes;
+   ConstantCoefficient coeff;
+   Operator *oper;     ///< The templated or the generic form. Owned.
+   BilinearForm *form; ///< The generic form, if used, i.e. #oper, or NULL.
+
+   static bool SupportsPartialAssembly(const FiniteElementSpace &fes)
+   {
+      const Mesh *mesh = fes.GetMesh();
+      const int dim = mesh->Dimension();
+      if (dim < 2 || mesh->SpaceDimension() != dim) { return false; }
+      const Geometry::Type geom =
+         TensorBasisElement::GetTensorProductGeometry(dim);
+      for (int i = 0; i < mesh->GetNE(); i++)
+      {
+         if (mesh->GetElementBaseGeometry(i) != geom) { return false; }
+      }
+      return (mesh->GetNE() > 0 &&
+              dynamic_cast<const TensorBasisElement*>(fes.GetFE(0)));
+   }
+
+public:
+   /** @brief Construct and assemble the form with the kernel @a kernel and
+       the constant coefficient @a c on the space @a fes. */
+   DispatchedBilinearForm(const TBilinearFormFactory &factory,
+                          TKernelType::Type kernel, FiniteElementSpace &f,
+                          double c = 1.0)
+      : Operator(f.GetVSize()), fes(f), coeff(c), form(NULL)
+   {
+      oper = factory.Create(kernel, fes, c);
+      if (oper) { return; }
+
+      form = new BilinearForm(&fes);
+      if (kernel == TKernelType::MASS)
+      {
+         form->AddDomainIntegrator(new MassIntegrator(coeff));
+      }
+      else
+      {
+         form->AddDomainIntegrator(new DiffusionIntegrator(coeff));
+      }
+      if (SupportsPartialAssembly(fes))
+      {
+         form->SetAssemblyLevel(AssemblyLevel::PARTIAL);
+      }
+      form->Assemble();
+      form->Finalize();
+      oper = form;
+   }
+
+   /// Return true if a templated form from the factory is used.
+   bool UsesTemplatedForm() const { return form == NULL; }
+
+   /// Return the generic form used as fallback, or NULL.
+   BilinearForm *GetFallbackForm() const { return form; }
+
+   virtual void Mult(const Vector &x, Vector &y) const { oper->Mult(x, y); }
+
+   virtual const Operator *GetProlongation() const
+   { return fes.GetConformingProlongation(); }
+   virtual const Operator *GetRestriction() const
+   { return fes.GetConformingRestriction(); }
+
+   virtual ~DispatchedBilinearForm() { delete oper; }
+};
+
+} // namespace mfem
+
+#endif // MFEM_TEMPLATE_FACTORY
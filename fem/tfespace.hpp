@@ -15,6 +15,7 @@
 #include "../config/tconfig.hpp"
 #include "../general/tassign.hpp"
 #include "../linalg/ttensor.hpp"
+#include "../linalg/simd.hpp"
 #include "tfe.hpp" // for TFiniteElementSpace_simple
 #include "fespace.hpp"
 
@@ -193,6 +194,9 @@ public:
    }
 
    // Multi-element VectorExtract: vdof_layout is (DOFS x NumComp x NumElems).
+   // When the entries of vdof_data are SIMD values (see AutoSIMD) with SS
+   // lanes, the lanes hold SS consecutive elements, so that NumElems*SS
+   // elements are extracted.
    template <AssignOp::Type Op,
              typename vec_layout_t, typename glob_vdof_data_t,
              typename vdof_layout_t, typename vdof_data_t>
@@ -202,8 +206,10 @@ public:
                       const vdof_layout_t    &vdof_layout,
                       vdof_data_t            &vdof_data) const
    {
+      typedef typename internal::EntryType<vdof_data_t>::type entry_t;
       const int NC = vdof_layout_t::dim_2;
       const int NE = vdof_layout_t::dim_3;
+      const int SS = internal::SIMDSize<entry_t>::value;
       MFEM_STATIC_ASSERT(FE::dofs == vdof_layout_t::dim_1,
                          "invalid number of dofs");
       MFEM_ASSERT(NC == vl.NumComponents(), "invalid number of components");
@@ -213,8 +219,12 @@ public:
          {
             for (int i = 0; i < FE::dofs; i++)
             {
-               Assign<Op>(vdof_data[vdof_layout.ind(i,k,j)],
-                          glob_vdof_data[vl.ind(ind.map(i,j), k)]);
+               entry_t &v = vdof_data[vdof_layout.ind(i,k,j)];
+               for (int s = 0; s < SS; s++)
+               {
+                  Assign<Op>(internal::SIMDLane(v, s),
+                             glob_vdof_data[vl.ind(ind.map(i,s+SS*j), k)]);
+               }
             }
          }
       }
@@ -232,6 +242,8 @@ public:
    }
 
    // Multi-element VectorAssemble: vdof_layout is (DOFS x NumComp x NumElems).
+   // SIMD entries of vdof_data are handled as in VectorExtract(); the lanes
+   // are assembled one at a time.
    template <AssignOp::Type Op,
              typename vdof_layout_t, typename vdof_data_t,
              typename vec_layout_t, typename glob_vdof_data_t>
@@ -241,8 +253,10 @@ public:
                        const vec_layout_t  &vl,
                        glob_vdof_data_t    &glob_vdof_data) const
    {
+      typedef typename internal::EntryType<vdof_data_t>::type entry_t;
       const int NC = vdof_layout_t::dim_2;
       const int NE = vdof_layout_t::dim_3;
+      const int SS = internal::SIMDSize<entry_t>::value;
       MFEM_STATIC_ASSERT(FE::dofs == vdof_layout_t::dim_1,
                          "invalid number of dofs");
       MFEM_ASSERT(NC == vl.NumComponents(), "invalid number of components");
@@ -252,8 +266,12 @@ public:
          {
             for (int i = 0; i < FE::dofs; i++)
             {
-               Assign<Op>(glob_vdof_data[vl.ind(ind.map(i,j), k)],
-                          vdof_data[vdof_layout.ind(i,k,j)]);
+               const entry_t &v = vdof_data[vdof_layout.ind(i,k,j)];
+               for (int s = 0; s < SS; s++)
+               {
+                  Assign<Op>(glob_vdof_data[vl.ind(ind.map(i,s+SS*j), k)],
+                             internal::SIMDLane(v, s));
+               }
             }
          }
       }
@@ -22,6 +22,12 @@ namespace mfem
 OutStream out(std::cout);
 OutStream err(std::cerr);
 
+namespace internal
+{
+// The flop counter of config/tconfig.hpp.
+long long flop_count = 0;
+}
+
 
 std::string MakeParFilename(const std::string &prefix, const int myid,
                             const std::string suffix, const int width)
@@ -17,6 +17,7 @@
 
 #include <iostream>
 #include <iomanip>
+#include <algorithm>
 
 namespace mfem
 {
@@ -475,6 +476,64 @@ void Transpose(const Array<int> &A, Table &At, int _ncols_A)
    At.ShiftUpI();
 }
 
+int ColorTableRows(const Table &A, Table &color_rows, int _ncols_A)
+{
+   const int nrows = A.Size();
+   const int *i_A = A.GetI(), *j_A = A.GetJ();
+   const int nnz = (nrows > 0) ? i_A[nrows] : 0;
+
+   int ncols = _ncols_A;
+   if (ncols < 0)
+   {
+      ncols = 0;
+      for (int k = 0; k < nnz; k++)
+      {
+         const int j = (j_A[k] >= 0) ? j_A[k] : -1-j_A[k];
+         ncols = std::max(ncols, j + 1);
+      }
+   }
+
+   // column -> rows
+   Table col_row;
+   col_row.MakeI(ncols);
+   for (int k = 0; k < nnz; k++)
+   {
+      col_row.AddAColumnInRow((j_A[k] >= 0) ? j_A[k] : -1-j_A[k]);
+   }
+   col_row.MakeJ();
+   for (int i = 0; i < nrows; i++)
+   {
+      for (int k = i_A[i]; k < i_A[i+1]; k++)
+      {
+         col_row.AddConnection((j_A[k] >= 0) ? j_A[k] : -1-j_A[k], i);
+      }
+   }
+   col_row.ShiftUpI();
+
+   // color_marker[c] == i marks color c as used by a neighbor of row i
+   Array<int> colors(nrows), color_marker;
+   colors = -1;
+   for (int i = 0; i < nrows; i++)
+   {
+      for (int k = i_A[i]; k < i_A[i+1]; k++)
+      {
+         const int j = (j_A[k] >= 0) ? j_A[k] : -1-j_A[k];
+         const int *rows = col_row.GetRow(j);
+         for (int l = 0; l < col_row.RowSize(j); l++)
+         {
+            if (colors[rows[l]] >= 0) { color_marker[colors[rows[l]]] = i; }
+         }
+      }
+      int c = 0;
+      while (c < color_marker.Size() && color_marker[c] == i) { c++; }
+      if (c == color_marker.Size()) { color_marker.Append(-1); }
+      colors[i] = c;
+   }
+
+   Transpose(colors, color_rows, color_marker.Size());
+   return color_marker.Size();
+}
+
 void Mult (const Table &A, const Table &B, Table &C)
 {
    int  i, j, k, l, m;
@@ -181,6 +181,14 @@ void Transpose(const Array<int> &A, Table &At, int _ncols_A = -1);
 void Mult (const Table &A, const Table &B, Table &C);
 Table * Mult (const Table &A, const Table &B);
 
+/** @brief Greedy coloring of the rows of @a A such that rows with the same
+    color have no common column, e.g. elements with the same color in an
+    element-to-dof Table share no dofs. */
+/** Negative column indices j (signed dofs) are interpreted as -1-j. On return,
+    the row i of @a color_rows lists the rows of @a A with color i. Returns the
+    number of colors. */
+int ColorTableRows(const Table &A, Table &color_rows, int _ncols_A = -1);
+
 
 /** Data type STable. STable is similar to Table, but it's for symmetric
     connectivity, i.e. TYPE I is equivalent to TYPE II. In the first
@@ -0,0 +1,625 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class AMGSolver
+
+#include "linalg.hpp"
+#include "../fem/fem.hpp"
+
+#include <cmath>
+
+namespace mfem
+{
+
+namespace internal
+{
+
+// Return the inverse of the diagonal of A.
+static void InverseDiagonal(const SparseMatrix &A, Vector &dinv)
+{
+   A.GetDiag(dinv);
+   for (int i = 0; i < dinv.Size(); i++)
+   {
+      MFEM_VERIFY(dinv(i) != 0.0, "AMGSolver: zero diagonal in row " << i);
+      dinv(i) = 1.0/dinv(i);
+   }
+}
+
+// Orthonormalize the columns of Q in place, computing the upper triangular
+// Rm with Q_in = Q_out Rm. A column which depends on the previous ones, e.g.
+// a rotation restricted to a thin aggregate, is replaced by the unit vector
+// with the largest component orthogonal to the previous columns, so that Q
+// has orthonormal columns and the rank of the coarse space does not depend
+// on the aggregate.
+static void AggregateQR(DenseMatrix &Q, DenseMatrix &Rm)
+{
+   const int m = Q.Height(), k = Q.Width();
+   MFEM_ASSERT(m >= k, "aggregate too small");
+   Rm.SetSize(k);
+   Rm = 0.0;
+   for (int j = 0; j < k; j++)
+   {
+      double *qj = Q.GetColumn(j);
+      double norm0 = 0.0;
+      for (int r = 0; r < m; r++) { norm0 += qj[r]*qj[r]; }
+      // modified Gram-Schmidt, with a second pass for stability
+      for (int pass = 0; pass < 2; pass++)
+      {
+         for (int i = 0; i < j; i++)
+         {
+            const double *qi = Q.GetColumn(i);
+            double rij = 0.0;
+            for (int r = 0; r < m; r++) { rij += qi[r]*qj[r]; }
+            for (int r = 0; r < m; r++) { qj[r] -= rij*qi[r]; }
+            Rm(i,j) += rij;
+         }
+      }
+      double norm = 0.0;
+      for (int r = 0; r < m; r++) { norm += qj[r]*qj[r]; }
+      if (norm <= 1e-20*norm0 || norm == 0.0)
+      {
+         // ||(I - Q Q^t) e_r||^2 = 1 - sum_i Q(r,i)^2
+         int rmax = 0;
+         double cmax = -1.0;
+         for (int r = 0; r < m; r++)
+         {
+            double c = 1.0;
+            for (int i = 0; i < j; i++) { c -= Q(r,i)*Q(r,i); }
+            if (c > cmax) { cmax = c; rmax = r; }
+         }
+         for (int r = 0; r < m; r++) { qj[r] = (r == rmax) ? 1.0 : 0.0; }
+         for (int pass = 0; pass < 2; pass++)
+         {
+            for (int i = 0; i < j; i++)
+            {
+               const double *qi = Q.GetColumn(i);
+               double rij = 0.0;
+               for (int r = 0; r < m; r++) { rij += qi[r]*qj[r]; }
+               for (int r = 0; r < m; r++) { qj[r] -= rij*qi[r]; }
+            }
+         }
+         norm = 0.0;
+         for (int r = 0; r < m; r++) { norm += qj[r]*qj[r]; }
+      }
+      else
+      {
+         Rm(j,j) = std::sqrt(norm);
+      }
+      norm = std::sqrt(norm);
+      for (int r = 0; r < m; r++) { qj[r] /= norm; }
+   }
+}
+
+static void RigidRotationXY(const Vector &x, Vector &y)
+{
+   y = 0.0; y(0) = -x(1); y(1) = x(0);
+}
+
+static void RigidRotationYZ(const Vector &x, Vector &y)
+{
+   y = 0.0; y(1) = -x(2); y(2) = x(1);
+}
+
+static void RigidRotationZX(const Vector &x, Vector &y)
+{
+   y = 0.0; y(0) = x(2); y(2) = -x(0);
+}
+
+}
+
+AMGSolver::AMGSolver()
+   : Solver(0, false)
+{
+   theta = 0.0;
+   num_comp = 1;
+   order_bynodes = false;
+   fespace = NULL;
+   smoother_type = JACOBI;
+   smoother_steps = 1;
+   cycle_type = V_CYCLE;
+   max_levels = 10;
+   coarse_size = 500;
+   print_level = 0;
+   coarse_inv = NULL;
+}
+
+AMGSolver::AMGSolver(const SparseMatrix &A_)
+   : Solver(0, false)
+{
+   theta = 0.0;
+   num_comp = 1;
+   order_bynodes = false;
+   fespace = NULL;
+   smoother_type = JACOBI;
+   smoother_steps = 1;
+   cycle_type = V_CYCLE;
+   max_levels = 10;
+   coarse_size = 500;
+   print_level = 0;
+   coarse_inv = NULL;
+   SetOperator(A_);
+}
+
+void AMGSolver::SetSystemsOptions(int num_components, bool order_bynodes_)
+{
+   MFEM_VERIFY(num_components > 0, "invalid number of components");
+   num_comp = num_components;
+   order_bynodes = order_bynodes_;
+}
+
+void AMGSolver::SetNearNullspace(const DenseMatrix &ns)
+{
+   nullspace = ns;
+   fespace = NULL;
+}
+
+void AMGSolver::SetElasticityOptions(FiniteElementSpace *fes)
+{
+   fespace = fes;
+   SetSystemsOptions(fes->GetVDim(), fes->GetOrdering() == Ordering::byNODES);
+}
+
+void AMGSolver::SetSmoother(SmootherType type, int steps)
+{
+   MFEM_VERIFY(steps > 0, "invalid number of smoothing steps");
+   smoother_type = type;
+   smoother_steps = steps;
+}
+
+void AMGSolver::ComputeRigidBodyModes()
+{
+   const int dim = fespace->GetVDim();
+   MFEM_VERIFY(dim == fespace->GetMesh()->SpaceDimension(),
+               "the space must have one component per space dimension");
+   const int nmodes = (dim == 1) ? 1 : ((dim == 2) ? 3 : 6);
+   const int n = fespace->GetTrueVSize();
+   nullspace.SetSize(n, nmodes);
+
+   GridFunction mode(fespace);
+   const SparseMatrix *Rm = fespace->GetRestrictionMatrix();
+   for (int m = 0; m < nmodes; m++)
+   {
+      if (m < dim)
+      {
+         Vector e(dim);
+         e = 0.0;
+         e(m) = 1.0;
+         VectorConstantCoefficient translation(e);
+         mode.ProjectCoefficient(translation);
+      }
+      else
+      {
+         void (*rotations[3])(const Vector &, Vector &) =
+         {
+            internal::RigidRotationXY, internal::RigidRotationYZ,
+            internal::RigidRotationZX
+         };
+         VectorFunctionCoefficient rotation(dim, rotations[m - dim]);
+         mode.ProjectCoefficient(rotation);
+      }
+      Vector col(nullspace.GetColumn(m), n);
+      if (Rm) { Rm->Mult(mode, col); }
+      else { col = mode; }
+   }
+}
+
+int AMGSolver::Aggregate(int l, int bs, Array<int> &agg) const
+{
+   const SparseMatrix &Al = *A[l];
+   const int *Ai = Al.GetI(), *Aj = Al.GetJ();
+   const double *Aa = Al.GetData();
+   const int nn = Al.Height()/bs;
+   const bool bynodes = (l == 0 && order_bynodes);
+
+   // Node graph with the squared Frobenius norms of the blocks, then the
+   // strong connections, S, with their strengths.
+   Array<int> Sp(nn+1), Sj, marker(nn), cols;
+   Array<double> Sv;
+   Vector s(nn), dnorm(nn);
+   Array<int> Gp(nn+1), Gj;
+   Array<double> Gv;
+   marker = -1;
+   Gp[0] = 0;
+   for (int i = 0; i < nn; i++)
+   {
+      cols.SetSize(0);
+      for (int c = 0; c < bs; c++)
+      {
+         const int row = bynodes ? c*nn + i : i*bs + c;
+         for (int p = Ai[row]; p < Ai[row+1]; p++)
+         {
+            const int jn = bynodes ? Aj[p] % nn : Aj[p]/bs;
+            if (marker[jn] != i)
+            {
+               marker[jn] = i;
+               s(jn) = 0.0;
+               cols.Append(jn);
+            }
+            s(jn) += Aa[p]*Aa[p];
+         }
+      }
+      dnorm(i) = (marker[i] == i) ? std::sqrt(s(i)) : 0.0;
+      for (int p = 0; p < cols.Size(); p++)
+      {
+         Gj.Append(cols[p]);
+         Gv.Append(s(cols[p]));
+      }
+      Gp[i+1] = Gj.Size();
+   }
+   Sp[0] = 0;
+   for (int i = 0; i < nn; i++)
+   {
+      for (int p = Gp[i]; p < Gp[i+1]; p++)
+      {
+         const int j = Gj[p];
+         if (j != i && Gv[p] > theta*theta*dnorm(i)*dnorm(j))
+         {
+            Sj.Append(j);
+            Sv.Append(Gv[p]);
+         }
+      }
+      Sp[i+1] = Sj.Size();
+   }
+
+   // Phase 1: aggregates of the nodes whose strong neighbors are all free.
+   int na = 0;
+   agg.SetSize(nn);
+   agg = -1;
+   for (int i = 0; i < nn; i++)
+   {
+      if (agg[i] >= 0 || Sp[i] == Sp[i+1]) { continue; }
+      bool free = true;
+      for (int p = Sp[i]; p < Sp[i+1] && free; p++)
+      {
+         free = (agg[Sj[p]] < 0);
+      }
+      if (!free) { continue; }
+      agg[i] = na;
+      for (int p = Sp[i]; p < Sp[i+1]; p++) { agg[Sj[p]] = na; }
+      na++;
+   }
+
+   // Phase 2: join the phase 1 aggregate of the strongest neighbor.
+   Array<int> agg1;
+   agg.Copy(agg1);
+   for (int i = 0; i < nn; i++)
+   {
+      if (agg[i] >= 0) { continue; }
+      double smax = 0.0;
+      for (int p = Sp[i]; p < Sp[i+1]; p++)
+      {
+         if (agg1[Sj[p]] >= 0 && Sv[p] > smax)
+         {
+            smax = Sv[p];
+            agg[i] = agg1[Sj[p]];
+         }
+      }
+   }
+
+   // Phase 3: aggregates of the remaining nodes and their free strong
+   // neighbors; a node without free neighbors joins the aggregate of its
+   // strongest neighbor.
+   for (int i = 0; i < nn; i++)
+   {
+      if (agg[i] >= 0 || Sp[i] == Sp[i+1]) { continue; }
+      int nfree = 0;
+      for (int p = Sp[i]; p < Sp[i+1]; p++)
+      {
+         if (agg[Sj[p]] < 0) { agg[Sj[p]] = na; nfree++; }
+      }
+      if (nfree > 0)
+      {
+         agg[i] = na++;
+         continue;
+      }
+      double smax = 0.0;
+      for (int p = Sp[i]; p < Sp[i+1]; p++)
+      {
+         if (Sv[p] > smax) { smax = Sv[p]; agg[i] = agg[Sj[p]]; }
+      }
+   }
+   return na;
+}
+
+SparseMatrix *AMGSolver::Prolongation(int l, int bs, const DenseMatrix &Bl,
+                                      DenseMatrix &Bc) const
+{
+   const SparseMatrix &Al = *A[l];
+   const int n = Al.Height(), nn = n/bs, k = Bl.Width();
+   const bool bynodes = (l == 0 && order_bynodes);
+
+   // Aggregates with fewer unknowns than near-nullspace vectors are dropped.
+   Array<int> agg, agg_ptr;
+   int na = Aggregate(l, bs, agg);
+   agg_ptr.SetSize(na+1);
+   agg_ptr = 0;
+   for (int i = 0; i < nn; i++)
+   {
+      if (agg[i] >= 0) { agg_ptr[agg[i]+1]++; }
+   }
+   Array<int> renum(na);
+   int nkept = 0;
+   for (int a = 0; a < na; a++)
+   {
+      renum[a] = (agg_ptr[a+1]*bs >= k) ? nkept++ : -1;
+   }
+   for (int i = 0; i < nn; i++)
+   {
+      if (agg[i] >= 0) { agg[i] = renum[agg[i]]; }
+   }
+   na = nkept;
+   const int nc = na*k;
+   if (na == 0 || nc > 0.8*n) { return NULL; }
+
+   // Nodes of the aggregates.
+   Array<int> agg_nodes(nn);
+   agg_ptr.SetSize(na+1);
+   agg_ptr = 0;
+   for (int i = 0; i < nn; i++)
+   {
+      if (agg[i] >= 0) { agg_ptr[agg[i]+1]++; }
+   }
+   agg_ptr.PartialSum();
+   for (int i = 0; i < nn; i++)
+   {
+      if (agg[i] >= 0) { agg_nodes[agg_ptr[agg[i]]++] = i; }
+   }
+   for (int a = na; a > 0; a--) { agg_ptr[a] = agg_ptr[a-1]; }
+   agg_ptr[0] = 0;
+
+   // Tentative prolongation: the rows of the unknowns of the aggregate a
+   // contain the orthonormal basis of the near nullspace in the aggregate,
+   // in the columns a*k, ..., a*k+k-1.
+   int *Pi = new int[n+1];
+   Pi[0] = 0;
+   for (int d = 0; d < n; d++)
+   {
+      const int node = bynodes ? d % nn : d/bs;
+      Pi[d+1] = Pi[d] + ((agg[node] >= 0) ? k : 0);
+   }
+   int *Pj = new int[Pi[n]];
+   double *Pa = new double[Pi[n]];
+   Bc.SetSize(nc, k);
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int a = 0; a < na; a++)
+   {
+      const int m = (agg_ptr[a+1] - agg_ptr[a])*bs;
+      DenseMatrix Q(m, k), Rm;
+      Array<int> rows(m);
+      for (int p = agg_ptr[a], r = 0; p < agg_ptr[a+1]; p++)
+      {
+         for (int c = 0; c < bs; c++, r++)
+         {
+            const int i = agg_nodes[p];
+            rows[r] = bynodes ? c*nn + i : i*bs + c;
+         }
+      }
+      for (int j = 0; j < k; j++)
+      {
+         for (int r = 0; r < m; r++) { Q(r,j) = Bl(rows[r],j); }
+      }
+      internal::AggregateQR(Q, Rm);
+      for (int r = 0; r < m; r++)
+      {
+         for (int j = 0; j < k; j++)
+         {
+            Pj[Pi[rows[r]] + j] = a*k + j;
+            Pa[Pi[rows[r]] + j] = Q(r,j);
+         }
+      }
+      for (int i = 0; i < k; i++)
+      {
+         for (int j = 0; j < k; j++) { Bc(a*k + i,j) = Rm(i,j); }
+      }
+   }
+   SparseMatrix Pt(Pi, Pj, Pa, n, nc);
+
+   // Smoothed prolongation, P = Pt - omega D^{-1} A Pt.
+   Vector dinv;
+   internal::InverseDiagonal(Al, dinv);
+   const double omega =
+      4.0/(3.0*PowerMethod().EstimateLargestEigenvalue(Al, dinv));
+   SparseMatrix *APt = mfem::Mult(Al, Pt);
+   dinv *= omega;
+   APt->ScaleRows(dinv);
+   SparseMatrix *Pl = Add(1.0, Pt, -1.0, *APt);
+   delete APt;
+   return Pl;
+}
+
+Solver *AMGSolver::MakeSmoother(const SparseMatrix &Al, double lambda) const
+{
+   Solver *smoother;
+   if (smoother_type == CHEBYSHEV)
+   {
+      Vector diag;
+      Al.GetDiag(diag);
+      Array<int> no_ess;
+      smoother = new OperatorChebyshevSmoother(Al, diag, no_ess,
+                                               smoother_steps, lambda);
+   }
+   else
+   {
+      smoother = new DSmoother(Al, 0, 4.0/(3.0*lambda), smoother_steps);
+   }
+   smoother->iterative_mode = true;
+   return smoother;
+}
+
+void AMGSolver::Setup()
+{
+   MFEM_VERIFY(height % num_comp == 0, "the size of the matrix, " << height
+               << ", is not a multiple of the number of components, "
+               << num_comp);
+
+   // Near nullspace of the finest level.
+   DenseMatrix Bl, Bc;
+   if (nullspace.Width() > 0)
+   {
+      MFEM_VERIFY(nullspace.Height() == height,
+                  "the near nullspace does not match the matrix");
+      Bl = nullspace;
+   }
+   else
+   {
+      const int nn = height/num_comp;
+      Bl.SetSize(height, num_comp);
+      Bl = 0.0;
+      for (int d = 0; d < height; d++)
+      {
+         Bl(d, order_bynodes ? d/nn : d % num_comp) = 1.0;
+      }
+   }
+
+   int bs = num_comp;
+   while (A.Size() < max_levels && A.Last()->Height() > coarse_size)
+   {
+      const int l = A.Size() - 1;
+      SparseMatrix *Pl = Prolongation(l, bs, Bl, Bc);
+      if (!Pl) { break; }
+      SparseMatrix *Rl = Transpose(*Pl);
+      SparseMatrix *RA = mfem::Mult(*Rl, *A[l]);
+      A.Append(mfem::Mult(*RA, *Pl));
+      delete RA;
+      P.Append(Pl);
+      R.Append(Rl);
+      Bl = Bc;
+      bs = Bl.Width();
+   }
+
+   const int nl = A.Size();
+   S.SetSize(nl);
+   S = NULL;
+   for (int l = 0; l < nl; l++)
+   {
+      if (l == nl-1 && A[l]->Height() <= coarse_size) { break; }
+      Vector dinv;
+      internal::InverseDiagonal(*A[l], dinv);
+      const double lambda =
+         PowerMethod().EstimateLargestEigenvalue(*A[l], dinv);
+      S[l] = MakeSmoother(*A[l], lambda);
+   }
+   if (!S[nl-1])
+   {
+      A[nl-1]->ToDenseMatrix(coarse_mat);
+      coarse_inv = new DenseMatrixInverse(coarse_mat);
+   }
+
+   B.SetSize(nl);
+   X.SetSize(nl);
+   Res.SetSize(nl);
+   for (int l = 0; l < nl; l++)
+   {
+      const int n = A[l]->Height();
+      B[l] = (l > 0) ? new Vector(n) : NULL;
+      X[l] = (l > 0) ? new Vector(n) : NULL;
+      Res[l] = (l < nl-1) ? new Vector(n) : NULL;
+   }
+
+   if (print_level > 0)
+   {
+      mfem::out << "AMGSolver: " << nl << " levels, operator complexity "
+                << GetOperatorComplexity() << '\n';
+      for (int l = 0; l < nl; l++)
+      {
+         mfem::out << "   level " << l << ": " << A[l]->Height() << " rows, "
+                   << A[l]->NumNonZeroElems() << " nonzeros\n";
+      }
+   }
+}
+
+void AMGSolver::SetOperator(const Operator &op)
+{
+   const SparseMatrix *mat = dynamic_cast<const SparseMatrix *>(&op);
+   MFEM_VERIFY(mat != NULL && mat->Finalized(),
+               "AMGSolver: the operator must be a finalized SparseMatrix");
+   MFEM_VERIFY(mat->Height() == mat->Width(),
+               "AMGSolver: the matrix must be square");
+   Clear();
+   height = width = mat->Height();
+   A.Append(mat);
+   if (fespace) { ComputeRigidBodyModes(); }
+   Setup();
+}
+
+double AMGSolver::GetOperatorComplexity() const
+{
+   double nnz = 0.0;
+   for (int l = 0; l < A.Size(); l++) { nnz += A[l]->NumNonZeroElems(); }
+   return A.Size() ? nnz/A[0]->NumNonZeroElems() : 0.0;
+}
+
+void AMGSolver::Cycle(int l, const Vector &b, Vector &x) const
+{
+   const int nl = A.Size();
+   if (l == nl-1)
+   {
+      if (coarse_inv) { coarse_inv->Mult(b, x); }
+      else { S[l]->Mult(b, x); }
+      return;
+   }
+
+   S[l]->Mult(b, x);
+   Vector &r = *Res[l];
+   A[l]->Mult(x, r);
+   subtract(b, r, r);
+   R[l]->Mult(r, *B[l+1]);
+   *X[l+1] = 0.0;
+   const int visits = (l+1 == nl-1 && coarse_inv) ? 1 : cycle_type;
+   for (int v = 0; v < visits; v++)
+   {
+      Cycle(l+1, *B[l+1], *X[l+1]);
+   }
+   P[l]->AddMult(*X[l+1], x);
+   S[l]->Mult(b, x);
+}
+
+void AMGSolver::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_VERIFY(A.Size() > 0, "AMGSolver: the operator is not set");
+   if (!iterative_mode) { x = 0.0; }
+   Cycle(0, b, x);
+}
+
+void AMGSolver::Clear()
+{
+   for (int l = 0; l < P.Size(); l++)
+   {
+      delete A[l+1];
+      delete P[l];
+      delete R[l];
+   }
+   for (int l = 0; l < S.Size(); l++)
+   {
+      delete S[l];
+      delete B[l];
+      delete X[l];
+      delete Res[l];
+   }
+   delete coarse_inv;
+   coarse_inv = NULL;
+   A.SetSize(0);
+   P.SetSize(0);
+   R.SetSize(0);
+   S.SetSize(0);
+   B.SetSize(0);
+   X.SetSize(0);
+   Res.SetSize(0);
+}
+
+AMGSolver::~AMGSolver()
+{
+   Clear();
+}
+
+}
@@ -0,0 +1,173 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_AMG
+#define MFEM_AMG
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "operator.hpp"
+#include "sparsemat.hpp"
+#include "densemat.hpp"
+
+namespace mfem
+{
+
+class FiniteElementSpace;
+
+/** @brief Smoothed aggregation algebraic multigrid (AMG) preconditioner for a
+    symmetric positive definite SparseMatrix. */
+/** The hierarchy is built in SetOperator(). On each level, the nodes are
+    grouped in aggregates of strongly connected nodes: nodes i and j are
+    strongly connected when |a_ij| > theta sqrt(|a_ii a_jj|), where for systems
+    the entries are replaced by the Frobenius norms of the node blocks. The
+    tentative prolongation interpolates the near-nullspace vectors exactly
+    within each aggregate (from a QR factorization of their restriction to the
+    aggregate) and is smoothed with one damped Jacobi step,
+    P = (I - 4/(3 rho) D^{-1} A) P_tent, where rho estimates the largest
+    eigenvalue of D^{-1} A. The coarse matrices are the Galerkin products
+    R A P with R = P^T, computed with the threaded sparse matrix products.
+
+    By default, the near nullspace is the constant vector, or the constant
+    vectors of the components for systems, see SetSystemsOptions(). For linear
+    elasticity, the rigid body modes can be used instead, see
+    SetElasticityOptions(). Nodes without strong connections, e.g. the rows of
+    eliminated essential dofs, are not aggregated and are only relaxed.
+
+    The multigrid cycle uses the same number of pre- and post-smoothing steps
+    with damped Jacobi or Chebyshev smoothers, so that the preconditioner is
+    symmetric and can be used with CG. The coarsest matrix is factored with a
+    dense LU factorization, see SetCoarseSize(). Mult() applies one cycle; in
+    iterative mode, the cycle starts from the given vector. */
+class AMGSolver : public Solver
+{
+public:
+   /// Smoothers, see SetSmoother().
+   enum SmootherType { JACOBI, CHEBYSHEV };
+
+   /// Multigrid cycles, see SetCycleType().
+   enum CycleType { V_CYCLE = 1, W_CYCLE = 2 };
+
+protected:
+   double theta;
+   int num_comp;
+   bool order_bynodes;
+   DenseMatrix nullspace;
+   FiniteElementSpace *fespace;
+   SmootherType smoother_type;
+   int smoother_steps;
+   int cycle_type;
+   int max_levels, coarse_size;
+   int print_level;
+
+   /// Level matrices; A[0] is the matrix given to SetOperator() (not owned).
+   Array<const SparseMatrix *> A;
+   /// Prolongations and restrictions from level l+1 to level l.
+   Array<SparseMatrix *> P, R;
+   /// Smoothers of the levels, except the coarsest one when it is factored.
+   Array<Solver *> S;
+   DenseMatrix coarse_mat;
+   DenseMatrixInverse *coarse_inv;
+   /// Right-hand sides, solutions and residuals of the levels.
+   mutable Array<Vector *> B, X, Res;
+
+   /// Compute the rigid body modes of #fespace into #nullspace.
+   void ComputeRigidBodyModes();
+
+   /** @brief Aggregate the nodes of level @a l, which have @a bs unknowns
+       each, into @a agg, returning the number of aggregates. */
+   int Aggregate(int l, int bs, Array<int> &agg) const;
+
+   /** @brief Build the prolongation from level l+1 to level @a l, given the
+       near nullspace @a Bl of level l; return the coarse near nullspace in
+       @a Bc. Return NULL if the level can not be coarsened. */
+   SparseMatrix *Prolongation(int l, int bs, const DenseMatrix &Bl,
+                              DenseMatrix &Bc) const;
+
+   Solver *MakeSmoother(const SparseMatrix &Al, double lambda) const;
+
+   void Setup();
+   void Cycle(int l, const Vector &b, Vector &x) const;
+   void Clear();
+
+public:
+   AMGSolver();
+
+   AMGSolver(const SparseMatrix &A);
+
+   /** @brief Build the hierarchy for @a op, which must be a finalized
+       SparseMatrix. */
+   virtual void SetOperator(const Operator &op);
+
+   /** @brief Set the strength of connection threshold, see the class
+       description; the default is 0, i.e. all nonzero couplings are strong.
+       Larger values, e.g. 0.08, follow the strong directions of anisotropic
+       problems. */
+   void SetStrengthThreshold(double theta_) { theta = theta_; }
+
+   /** @brief Treat the matrix as a system with @a num_components unknowns per
+       node, aggregating the nodes rather than the individual unknowns. */
+   /** The unknowns are ordered by nodes (all the values of the first
+       component, then the second one, ...) if @a order_bynodes is true and
+       by components otherwise, see Ordering. */
+   void SetSystemsOptions(int num_components, bool order_bynodes = false);
+
+   /** @brief Use the columns of @a ns as the near-nullspace vectors, i.e. the
+       vectors interpolated exactly by the tentative prolongation. */
+   /** The number of rows of @a ns must be the size of the matrix. */
+   void SetNearNullspace(const DenseMatrix &ns);
+
+   /** @brief Use the rigid body modes of @a fes as the near nullspace for
+       linear elasticity, with the systems options of the vector space. */
+   /** The modes are recomputed in each call to SetOperator(), so the space
+       must remain valid and its true dofs must match the matrix. */
+   void SetElasticityOptions(FiniteElementSpace *fes);
+
+   /** @brief Use @a steps Jacobi sweeps, or Chebyshev polynomials of degree
+       @a steps, as the pre- and post-smoothers. The default is one Jacobi
+       sweep. */
+   void SetSmoother(SmootherType type, int steps = 1);
+
+   /// Set the cycle, V_CYCLE (default) or W_CYCLE.
+   void SetCycleType(CycleType type) { cycle_type = type; }
+
+   /// Set the maximum number of levels, 10 by default.
+   void SetMaxLevels(int levels) { max_levels = levels; }
+
+   /** @brief Stop the coarsening when the matrix has at most @a size rows,
+       500 by default. */
+   /** The coarsest matrix is factored with a dense LU factorization when it
+       has at most @a size rows; otherwise, when the coarsening stops at the
+       maximum number of levels or stalls, it is relaxed with the smoother. */
+   void SetCoarseSize(int size) { coarse_size = size; }
+
+   /// Print the hierarchy in SetOperator() if @a print_lvl > 0.
+   void SetPrintLevel(int print_lvl) { print_level = print_lvl; }
+
+   /// Return the number of levels of the hierarchy.
+   int GetNumLevels() const { return A.Size(); }
+
+   /// Return the matrix of level @a l, where level 0 is the finest one.
+   const SparseMatrix &GetLevelMatrix(int l) const { return *A[l]; }
+
+   /** @brief Return the operator complexity, the total number of nonzeros of
+       the level matrices divided by the one of the finest matrix. */
+   double GetOperatorComplexity() const;
+
+   /// Apply one multigrid cycle to approximate the solution of A x = b.
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   virtual ~AMGSolver();
+};
+
+}
+
+#endif
@@ -0,0 +1,211 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class BSRMatrix
+
+#include "bsrmat.hpp"
+
+#include <algorithm>
+
+namespace mfem
+{
+
+BSRMatrix::BSRMatrix(const SparseMatrix &A, int block_size)
+   : Operator(A.Height(), A.Width()), bs(block_size)
+{
+   MFEM_VERIFY(A.Finalized(), "the matrix must be finalized");
+   MFEM_VERIFY(bs > 0 && height % bs == 0 && width % bs == 0,
+               "invalid block size " << bs << " for a " << height << " x "
+               << width << " matrix");
+   nbrows = height/bs;
+   nbcols = width/bs;
+
+   const int *Ap = A.GetI(), *Aj = A.GetJ();
+   Array<int> marker(nbcols);
+   marker = -1;
+   I.SetSize(nbrows+1);
+   I[0] = 0;
+   for (int ib = 0; ib < nbrows; ib++)
+   {
+      int nb = 0;
+      for (int r = ib*bs; r < (ib+1)*bs; r++)
+      {
+         for (int k = Ap[r]; k < Ap[r+1]; k++)
+         {
+            const int jb = Aj[k]/bs;
+            if (marker[jb] != ib) { marker[jb] = ib; nb++; }
+         }
+      }
+      I[ib+1] = I[ib] + nb;
+   }
+
+   marker = -1;
+   J.SetSize(I[nbrows]);
+   for (int ib = 0; ib < nbrows; ib++)
+   {
+      int pos = I[ib];
+      for (int r = ib*bs; r < (ib+1)*bs; r++)
+      {
+         for (int k = Ap[r]; k < Ap[r+1]; k++)
+         {
+            const int jb = Aj[k]/bs;
+            if (marker[jb] != ib) { marker[jb] = ib; J[pos++] = jb; }
+         }
+      }
+      std::sort(J.GetData() + I[ib], J.GetData() + I[ib+1]);
+   }
+
+   data.SetSize(I[nbrows]*bs*bs);
+   Update(A);
+}
+
+void BSRMatrix::Update(const SparseMatrix &A)
+{
+   MFEM_VERIFY(A.Finalized() && A.Height() == height && A.Width() == width,
+               "incompatible matrix");
+   const int *Ap = A.GetI(), *Aj = A.GetJ();
+   const double *Aa = A.GetData();
+   const int bs2 = bs*bs;
+   data = 0.0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int ib = 0; ib < nbrows; ib++)
+   {
+      const int *Jb = J.GetData() + I[ib], *Je = J.GetData() + I[ib+1];
+      for (int r = ib*bs; r < (ib+1)*bs; r++)
+      {
+         for (int k = Ap[r]; k < Ap[r+1]; k++)
+         {
+            const int c = Aj[k];
+            const int *jp = std::lower_bound(Jb, Je, c/bs);
+            MFEM_ASSERT(jp != Je && *jp == c/bs,
+                        "the sparsity of the matrix has changed");
+            data((jp - J.GetData())*bs2 + (r - ib*bs) + (c % bs)*bs) += Aa[k];
+         }
+      }
+   }
+}
+
+namespace internal
+{
+
+// y(ib) += a sum_k B_k x(J[k]) for the block rows ib in [0, nbrows), with
+// blocks of the compile-time size BS; the block loops are fully unrolled.
+template <int BS>
+static void BSRAddMult(int nbrows, const int *I, const int *J, const double *B,
+                       const double *x, double *y, const double a)
+{
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int ib = 0; ib < nbrows; ib++)
+   {
+      double yb[BS];
+      for (int i = 0; i < BS; i++) { yb[i] = 0.0; }
+      for (int k = I[ib]; k < I[ib+1]; k++)
+      {
+         const double *Bk = B + k*BS*BS, *xb = x + J[k]*BS;
+         for (int j = 0; j < BS; j++)
+         {
+            const double xj = xb[j];
+            for (int i = 0; i < BS; i++)
+            {
+               yb[i] += Bk[i + j*BS]*xj;
+            }
+         }
+      }
+      for (int i = 0; i < BS; i++) { y[ib*BS + i] += a*yb[i]; }
+   }
+}
+
+// Same as BSRAddMult() with a runtime block size.
+static void BSRAddMult(int bs, int nbrows, const int *I, const int *J,
+                       const double *B, const double *x, double *y,
+                       const double a)
+{
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int ib = 0; ib < nbrows; ib++)
+   {
+      double *yb = y + ib*bs;
+      for (int k = I[ib]; k < I[ib+1]; k++)
+      {
+         const double *Bk = B + k*bs*bs, *xb = x + J[k]*bs;
+         for (int j = 0; j < bs; j++)
+         {
+            const double xj = a*xb[j];
+            for (int i = 0; i < bs; i++)
+            {
+               yb[i] += Bk[i + j*bs]*xj;
+            }
+         }
+      }
+   }
+}
+
+}
+
+void BSRMatrix::Mult(const Vector &x, Vector &y) const
+{
+   y = 0.0;
+   AddMult(x, y);
+}
+
+void BSRMatrix::AddMult(const Vector &x, Vector &y, const double a) const
+{
+   MFEM_ASSERT(x.Size() == width && y.Size() == height,
+               "incompatible vector sizes");
+   const int *Ip = I.GetData(), *Jp = J.GetData();
+   const double *B = data.GetData(), *xp = x.GetData();
+   double *yp = y.GetData();
+   switch (bs)
+   {
+      case 1: internal::BSRAddMult<1>(nbrows, Ip, Jp, B, xp, yp, a); break;
+      case 2: internal::BSRAddMult<2>(nbrows, Ip, Jp, B, xp, yp, a); break;
+      case 3: internal::BSRAddMult<3>(nbrows, Ip, Jp, B, xp, yp, a); break;
+      case 4: internal::BSRAddMult<4>(nbrows, Ip, Jp, B, xp, yp, a); break;
+      default: internal::BSRAddMult(bs, nbrows, Ip, Jp, B, xp, yp, a);
+   }
+}
+
+void BSRMatrix::MultTranspose(const Vector &x, Vector &y) const
+{
+   MFEM_ASSERT(x.Size() == height && y.Size() == width,
+               "incompatible vector sizes");
+   y = 0.0;
+   for (int ib = 0; ib < nbrows; ib++)
+   {
+      const double *xb = x.GetData() + ib*bs;
+      for (int k = I[ib]; k < I[ib+1]; k++)
+      {
+         const double *Bk = data.GetData() + k*bs*bs;
+         double *yb = y.GetData() + J[k]*bs;
+         for (int j = 0; j < bs; j++)
+         {
+            double d = 0.0;
+            for (int i = 0; i < bs; i++)
+            {
+               d += Bk[i + j*bs]*xb[i];
+            }
+            yb[j] += d;
+         }
+      }
+   }
+}
+
+long BSRMatrix::MemoryUsage() const
+{
+   return sizeof(int)*(I.Size() + J.Size()) + sizeof(double)*data.Size();
+}
+
+}
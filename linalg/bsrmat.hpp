@@ -0,0 +1,84 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_BSRMAT
+#define MFEM_BSRMAT
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "vector.hpp"
+#include "operator.hpp"
+#include "sparsemat.hpp"
+
+namespace mfem
+{
+
+/** @brief Sparse matrix in block compressed sparse row (BSR) format: a CSR
+    matrix of dense square blocks of a fixed size. */
+/** The BSR format suits the matrices of vector finite element spaces with
+    Ordering::byVDIM, e.g. in elasticity, where the vdim x vdim coupling of two
+    nodes is a dense block: one column index is stored per block instead of
+    one per entry, and the products with the blocks have a fixed size. The
+    blocks are stored column-major, one after the other, in the order given by
+    the block CSR arrays #I and #J.
+
+    A BSRMatrix is created from a finalized SparseMatrix and can be used as an
+    Operator, e.g. in the iterative solvers or through an OperatorHandle. */
+class BSRMatrix : public Operator
+{
+protected:
+   int bs;            ///< Block size.
+   int nbrows;        ///< Number of block rows, height/bs.
+   int nbcols;        ///< Number of block columns, width/bs.
+   Array<int> I;      ///< Block row offsets, size nbrows+1.
+   Array<int> J;      ///< Block column indices, size I[nbrows].
+   Vector data;       ///< Block entries, size I[nbrows]*bs*bs.
+
+public:
+   /** @brief Convert the finalized SparseMatrix @a A to BSR format with blocks
+       of size @a block_size. */
+   /** The height and the width of @a A must be multiples of @a block_size. A
+       block is stored if any of its entries is in the sparsity of @a A. */
+   BSRMatrix(const SparseMatrix &A, int block_size);
+
+   /// Return the block size.
+   int GetBlockSize() const { return bs; }
+
+   /// Return the number of stored blocks.
+   int NumBlocks() const { return I[nbrows]; }
+
+   /// Return the block row offsets.
+   const Array<int> &GetI() const { return I; }
+   /// Return the block column indices.
+   const Array<int> &GetJ() const { return J; }
+   /// Return the block entries.
+   const Vector &GetData() const { return data; }
+
+   /** @brief Copy the entries of @a A, which must have the same sparsity as the
+       matrix used in the constructor, into the stored blocks. */
+   void Update(const SparseMatrix &A);
+
+   /// y = A x; the block rows are processed in parallel with OpenMP.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// y += a A x
+   void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
+
+   /// y = A^t x
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /// Return the size of the stored data in bytes.
+   long MemoryUsage() const;
+};
+
+}
+
+#endif
@@ -16,6 +16,7 @@
 #include "vector.hpp"
 #include "matrix.hpp"
 #include "densemat.hpp"
+#include "simd.hpp"
 #include "../general/table.hpp"
 #include "../general/globals.hpp"
 
@@ -3042,6 +3043,119 @@ void Add(double alpha, const DenseMatrix &A,
 }
 
 
+#ifndef MFEM_USE_LAPACK
+// Register- and cache-blocked matrix product used by the DenseMatrix products
+// below without LAPACK. The operands are packed, block by block, into panels
+// of gemm_mr rows of op(A) and gemm_nr columns of op(B), and the micro-kernel
+// accumulates a gemm_mr x gemm_nr block of C in registers. A block of
+// gemm_mc x gemm_kc entries of op(A) is meant to fit in the L2 cache.
+static const int gemm_mr = 8, gemm_nr = 4;
+static const int gemm_mc = 96, gemm_kc = 256;
+
+// Use BlockedGemm() for products of these sizes; smaller ones are faster with
+// simple loops.
+static inline bool UseBlockedGemm(int m, int n, int k)
+{
+   return (m >= 16 && n >= 16 && k >= 16);
+}
+
+// C(0:mr,0:nr) += a b, where a and b are the packed panels of kc columns of
+// op(A) and kc rows of op(B).
+static inline void GemmMicroKernel(int kc, const double *a, const double *b,
+                                   double *C, int ldc, int mr, int nr)
+{
+   double c[gemm_nr][gemm_mr];
+   for (int j = 0; j < gemm_nr; j++)
+   {
+      for (int i = 0; i < gemm_mr; i++) { c[j][i] = 0.0; }
+   }
+   for (int p = 0; p < kc; p++)
+   {
+      for (int j = 0; j < gemm_nr; j++)
+      {
+         const double b_pj = b[p*gemm_nr+j];
+         for (int i = 0; i < gemm_mr; i++) { c[j][i] += a[p*gemm_mr+i]*b_pj; }
+      }
+   }
+   for (int j = 0; j < nr; j++)
+   {
+      for (int i = 0; i < mr; i++) { C[i+j*ldc] += c[j][i]; }
+   }
+}
+
+// C += alpha op(A) op(B), where op(A) is m x k, op(B) is k x n, op(X) is X or
+// X^t for trans 'N' or 'T', and the matrices are column-major with leading
+// dimensions lda, ldb and ldc, as in the BLAS routine dgemm. With lower =
+// true, the gemm_mr x gemm_nr blocks of C above its diagonal are skipped.
+static void BlockedGemm(char transa, char transb, int m, int n, int k,
+                        double alpha, const double *A, int lda,
+                        const double *B, int ldb, double *C, int ldc,
+                        bool lower = false)
+{
+   const int kb = std::min(gemm_kc, k);
+   const int n_panels = (n + gemm_nr - 1)/gemm_nr;
+   const int m_panels = (std::min(gemm_mc, m) + gemm_mr - 1)/gemm_mr;
+   const int work_size = kb*(m_panels*gemm_mr + n_panels*gemm_nr);
+   // storage for the packed panels; its allocation is negligible compared to
+   // the products of the sizes that use BlockedGemm()
+   Array<double> work(work_size);
+   double *a_pack = work.GetData();
+   double *b_pack = a_pack + kb*m_panels*gemm_mr;
+
+   for (int p0 = 0; p0 < k; p0 += gemm_kc)
+   {
+      const int kc = std::min(gemm_kc, k - p0);
+      // pack rows p0, ..., p0+kc-1 of op(B), zero padded
+      for (int jp = 0; jp < n_panels; jp++)
+      {
+         double *b = b_pack + jp*kc*gemm_nr;
+         for (int p = 0; p < kc; p++)
+         {
+            for (int j = 0; j < gemm_nr; j++)
+            {
+               const int jj = jp*gemm_nr + j, pp = p0 + p;
+               b[p*gemm_nr+j] = (jj >= n) ? 0.0 :
+                                (transb == 'N') ? B[pp+jj*ldb] : B[jj+pp*ldb];
+            }
+         }
+      }
+      for (int i0 = 0; i0 < m; i0 += gemm_mc)
+      {
+         const int mc = std::min(gemm_mc, m - i0);
+         const int mp = (mc + gemm_mr - 1)/gemm_mr;
+         // pack alpha op(A)(i0:i0+mc, p0:p0+kc), zero padded
+         for (int ip = 0; ip < mp; ip++)
+         {
+            double *a = a_pack + ip*kc*gemm_mr;
+            for (int p = 0; p < kc; p++)
+            {
+               for (int i = 0; i < gemm_mr; i++)
+               {
+                  const int ii = i0 + ip*gemm_mr + i, pp = p0 + p;
+                  if (ii >= i0 + mc) { a[p*gemm_mr+i] = 0.0; continue; }
+                  a[p*gemm_mr+i] =
+                     alpha*((transa == 'N') ? A[ii+pp*lda] : A[pp+ii*lda]);
+               }
+            }
+         }
+         for (int jp = 0; jp < n_panels; jp++)
+         {
+            const int j0 = jp*gemm_nr;
+            for (int ip = 0; ip < mp; ip++)
+            {
+               const int ii = i0 + ip*gemm_mr;
+               if (lower && ii + gemm_mr <= j0) { continue; }
+               GemmMicroKernel(kc, a_pack + ip*kc*gemm_mr,
+                               b_pack + jp*kc*gemm_nr, C + ii + j0*ldc, ldc,
+                               std::min(gemm_mr, m - ii),
+                               std::min(gemm_nr, n - j0));
+            }
+         }
+      }
+   }
+}
+#endif
+
 void Mult(const DenseMatrix &b, const DenseMatrix &c, DenseMatrix &a)
 {
    MFEM_ASSERT(a.Height() == b.Height() && a.Width() == c.Width() &&
@@ -3065,6 +3179,11 @@ void Mult(const DenseMatrix &b, const DenseMatrix &c, DenseMatrix &a)
    {
       ad[i] = 0.0;
    }
+   if (UseBlockedGemm(ah, aw, bw))
+   {
+      BlockedGemm('N', 'N', ah, aw, bw, 1.0, bd, ah, cd, bw, ad, ah);
+      return;
+   }
    for (int j = 0; j < aw; j++)
    {
       for (int k = 0; k < bw; k++)
@@ -3097,6 +3216,11 @@ void AddMult(const DenseMatrix &b, const DenseMatrix &c, DenseMatrix &a)
    double *ad = a.Data();
    const double *bd = b.Data();
    const double *cd = c.Data();
+   if (UseBlockedGemm(ah, aw, bw))
+   {
+      BlockedGemm('N', 'N', ah, aw, bw, 1.0, bd, ah, cd, bw, ad, ah);
+      return;
+   }
    for (int j = 0; j < aw; j++)
    {
       for (int k = 0; k < bw; k++)
@@ -3453,6 +3577,11 @@ void MultABt(const DenseMatrix &A, const DenseMatrix &B, DenseMatrix &ABt)
    {
       cd[i] = 0.0;
    }
+   if (UseBlockedGemm(ah, bh, aw))
+   {
+      BlockedGemm('N', 'T', ah, bh, aw, 1.0, ad, ah, bd, bh, cd, ah);
+      return;
+   }
    for (int k = 0; k < aw; k++)
    {
       double *cp = cd;
@@ -3572,6 +3701,11 @@ void AddMultABt(const DenseMatrix &A, const DenseMatrix &B, DenseMatrix &ABt)
    const double *bd = B.Data();
    double *cd = ABt.Data();
 
+   if (UseBlockedGemm(ah, bh, aw))
+   {
+      BlockedGemm('N', 'T', ah, bh, aw, 1.0, ad, ah, bd, bh, cd, ah);
+      return;
+   }
    for (int k = 0; k < aw; k++)
    {
       double *cp = cd;
@@ -3667,6 +3801,11 @@ void AddMult_a_ABt(double a, const DenseMatrix &A, const DenseMatrix &B,
    const double *bd = B.Data();
    double *cd = ABt.Data();
 
+   if (UseBlockedGemm(ah, bh, aw))
+   {
+      BlockedGemm('N', 'T', ah, bh, aw, a, ad, ah, bd, bh, cd, ah);
+      return;
+   }
    for (int k = 0; k < aw; k++)
    {
       double *cp = cd;
@@ -3724,6 +3863,15 @@ void MultAtB(const DenseMatrix &A, const DenseMatrix &B, DenseMatrix &AtB)
    const double *bd = B.Data();
    double *cd = AtB.Data();
 
+   if (UseBlockedGemm(aw, bw, ah))
+   {
+      for (int i = 0; i < aw*bw; i++)
+      {
+         cd[i] = 0.0;
+      }
+      BlockedGemm('T', 'N', aw, bw, ah, 1.0, ad, ah, bd, ah, cd, aw);
+      return;
+   }
    for (int j = 0; j < bw; j++)
    {
       const double *ap = ad;
@@ -3758,6 +3906,32 @@ void MultAtB(const DenseMatrix &A, const DenseMatrix &B, DenseMatrix &AtB)
 
 void AddMult_a_AAt(double a, const DenseMatrix &A, DenseMatrix &AAt)
 {
+#ifndef MFEM_USE_LAPACK
+   const int ah = A.Height(), aw = A.Width();
+   if (UseBlockedGemm(ah, ah, aw))
+   {
+      // Add the blocks of a A A^t on and below the diagonal to AAt; the entries
+      // above the diagonal outside of these blocks, (i,j) with i < j, get the
+      // symmetric entry (j,i) of the product: they are first reduced by the
+      // entry (j,i) of AAt, and then increased by its updated value. For a
+      // symmetric AAt, the first step sets them to zero.
+      double *d = AAt.Data();
+      for (int j = 0; j < ah; j++)
+      {
+         // the rows of the skipped blocks in column j, see BlockedGemm()
+         const int i_end = ((j/gemm_nr)*gemm_nr/gemm_mr)*gemm_mr;
+         for (int i = 0; i < i_end; i++) { d[i+j*ah] -= d[j+i*ah]; }
+      }
+      BlockedGemm('N', 'T', ah, ah, aw, a, A.Data(), ah, A.Data(), ah, d, ah,
+                  true);
+      for (int j = 0; j < ah; j++)
+      {
+         const int i_end = ((j/gemm_nr)*gemm_nr/gemm_mr)*gemm_mr;
+         for (int i = 0; i < i_end; i++) { d[i+j*ah] += d[j+i*ah]; }
+      }
+      return;
+   }
+#endif
    double d;
 
    for (int i = 0; i < A.Height(); i++)
@@ -4487,4 +4661,315 @@ DenseTensor &DenseTensor::operator=(double c)
    return *this;
 }
 
+// Number of matrices interleaved by the batched factorizations: the doubles of
+// one SIMD register of MFEM_SIMD_SIZE bytes, and at least 4, as in
+// SELLMatrix::DefaultChunkSize().
+static const int batch_lanes = (MFEM_SIMD_SIZE/sizeof(double) > 4) ?
+                               int(MFEM_SIMD_SIZE/sizeof(double)) : 4;
+
+// Largest size of the matrices interleaved by BatchLUFactor(); the columns of
+// larger matrices are long enough for the factorization of single matrices,
+// LUFactors::Factor(), to vectorize well.
+static const int batch_lu_max_size = 32;
+
+// LU factorization with partial pivoting, as in LUFactors::Factor(), of the L
+// interleaved m x m matrices a[(i+j*m)*L+l], l = 0,...,L-1. The pivot of row i
+// of matrix l is stored in piv[i*L+l]. The loops over the matrices, l, are the
+// innermost ones and have no branches, so that they vectorize.
+template <int L>
+static void InterleavedLUFactor(int m, double *a, int *piv)
+{
+   for (int i = 0; i < m; i++)
+   {
+      // pivot search
+      double a_max[L];
+      int p[L];
+      for (int l = 0; l < L; l++)
+      {
+         a_max[l] = std::abs(a[(i+i*m)*L+l]);
+         p[l] = i;
+      }
+      for (int j = i+1; j < m; j++)
+      {
+         const double *a_ji = a + (j+i*m)*L;
+         for (int l = 0; l < L; l++)
+         {
+            const double b = std::abs(a_ji[l]);
+            p[l] = (b > a_max[l]) ? j : p[l];
+            a_max[l] = (b > a_max[l]) ? b : a_max[l];
+         }
+      }
+      bool swap = false;
+      for (int l = 0; l < L; l++)
+      {
+         piv[i*L+l] = p[l];
+         swap = swap || (p[l] != i);
+      }
+      if (swap)
+      {
+         for (int k = 0; k < m; k++)
+         {
+            double *a_k = a + k*m*L;
+            for (int l = 0; l < L; l++)
+            {
+               const double t = a_k[i*L+l];
+               a_k[i*L+l] = a_k[p[l]*L+l];
+               a_k[p[l]*L+l] = t;
+            }
+         }
+      }
+      for (int l = 0; l < L; l++)
+      {
+         MFEM_ASSERT(a[(i+i*m)*L+l] != 0.0, "division by zero");
+      }
+
+      // elimination; the rows below i of column k are contiguous
+      double a_ii_inv[L];
+      for (int l = 0; l < L; l++) { a_ii_inv[l] = 1.0/a[(i+i*m)*L+l]; }
+      const int r = m-i-1;
+      double *col_i = a + (i+1+i*m)*L;
+      for (int j = 0; j < r; j++)
+      {
+         for (int l = 0; l < L; l++) { col_i[j*L+l] *= a_ii_inv[l]; }
+      }
+      for (int k = i+1; k < m; k++)
+      {
+         double a_ik[L];
+         for (int l = 0; l < L; l++) { a_ik[l] = a[(i+k*m)*L+l]; }
+         double *col_k = a + (i+1+k*m)*L;
+         for (int j = 0; j < r; j++)
+         {
+            for (int l = 0; l < L; l++)
+            {
+               col_k[j*L+l] -= a_ik[l]*col_i[j*L+l];
+            }
+         }
+      }
+   }
+}
+
+// Cholesky factorization of the L interleaved m x m matrices of a, see
+// InterleavedLUFactor(); only the lower triangles are used and overwritten.
+template <int L>
+static void InterleavedCholeskyFactor(int m, double *a)
+{
+   for (int j = 0; j < m; j++)
+   {
+      double *a_jj = a + (j+j*m)*L;
+      double a_jj_inv[L];
+      int pos_def = 1;
+      for (int l = 0; l < L; l++)
+      {
+         pos_def &= (a_jj[l] > 0.0);
+         a_jj[l] = std::sqrt(a_jj[l]);
+         a_jj_inv[l] = 1.0/a_jj[l];
+      }
+      MFEM_VERIFY(pos_def, "the matrix is not positive definite");
+      const int r = m-j-1;
+      double *col_j = a_jj + L;
+      for (int i = 0; i < r; i++)
+      {
+         for (int l = 0; l < L; l++) { col_j[i*L+l] *= a_jj_inv[l]; }
+      }
+      for (int k = j+1; k < m; k++)
+      {
+         double a_kj[L];
+         for (int l = 0; l < L; l++) { a_kj[l] = a[(k+j*m)*L+l]; }
+         // rows k, ..., m-1 of columns k and j
+         double *col_k = a + (k+k*m)*L;
+         const double *col_jk = a + (k+j*m)*L;
+         for (int i = 0; i < m-k; i++)
+         {
+            for (int l = 0; l < L; l++)
+            {
+               col_k[i*L+l] -= a_kj[l]*col_jk[i*L+l];
+            }
+         }
+      }
+   }
+}
+
+// Copy the matrices A[k0], ..., A[k0+nl-1] into the interleaved array a, and
+// the identity into the remaining lanes.
+static void InterleaveMatrices(int m, const Array<double *> &A, int k0, int nl,
+                               double *a)
+{
+   const int L = batch_lanes;
+   for (int l = 0; l < L; l++)
+   {
+      if (l < nl)
+      {
+         const double *A_l = A[k0+l];
+         for (int p = 0; p < m*m; p++) { a[p*L+l] = A_l[p]; }
+      }
+      else
+      {
+         for (int p = 0; p < m*m; p++) { a[p*L+l] = 0.0; }
+         for (int i = 0; i < m; i++) { a[(i+i*m)*L+l] = 1.0; }
+      }
+   }
+}
+
+void BatchLUFactor(int m, const Array<double *> &A, const Array<int *> &P)
+{
+   MFEM_VERIFY(P.Size() == A.Size(), "invalid number of pivot arrays");
+   if (m > batch_lu_max_size)
+   {
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for
+#endif
+      for (int k = 0; k < A.Size(); k++)
+      {
+         LUFactors(A[k], P[k]).Factor(m);
+      }
+      return;
+   }
+   const int L = batch_lanes;
+   const int num_groups = (A.Size() + L - 1)/L;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      Array<double> a(m*m*L);
+      Array<int> piv(m*L);
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int g = 0; g < num_groups; g++)
+      {
+         const int k0 = g*L, nl = std::min(L, A.Size() - k0);
+         InterleaveMatrices(m, A, k0, nl, a);
+         InterleavedLUFactor<batch_lanes>(m, a, piv);
+         for (int l = 0; l < nl; l++)
+         {
+            double *A_l = A[k0+l];
+            int *P_l = P[k0+l];
+            for (int p = 0; p < m*m; p++) { A_l[p] = a[p*L+l]; }
+            for (int i = 0; i < m; i++)
+            {
+               P_l[i] = piv[i*L+l] + LUFactors::ipiv_base;
+            }
+         }
+      }
+   }
+}
+
+void BatchLUFactor(const Array<int> &m, const Array<double *> &A,
+                   const Array<int *> &P)
+{
+   MFEM_VERIFY(m.Size() == A.Size() && P.Size() == A.Size(),
+               "invalid number of sizes or pivot arrays");
+   Table size_to_mat;
+   Transpose(m, size_to_mat, m.Size() ? m.Max()+1 : 0);
+   Array<double *> A_m;
+   Array<int *> P_m;
+   for (int s = 1; s < size_to_mat.Size(); s++)
+   {
+      const int num_mat = size_to_mat.RowSize(s);
+      const int *mat = size_to_mat.GetRow(s);
+      A_m.SetSize(num_mat);
+      P_m.SetSize(num_mat);
+      for (int k = 0; k < num_mat; k++)
+      {
+         A_m[k] = A[mat[k]];
+         P_m[k] = P[mat[k]];
+      }
+      BatchLUFactor(s, A_m, P_m);
+   }
+}
+
+void BatchLUFactor(DenseTensor &A, Array<int> &P)
+{
+   const int m = A.SizeI(), nk = A.SizeK();
+   MFEM_VERIFY(A.SizeJ() == m, "the matrices are not square");
+   P.SetSize(m*nk);
+   Array<double *> A_k(nk);
+   Array<int *> P_k(nk);
+   for (int k = 0; k < nk; k++)
+   {
+      A_k[k] = A.GetData(k);
+      P_k[k] = P.GetData() + k*m;
+   }
+   BatchLUFactor(m, A_k, P_k);
+}
+
+void BatchLUSolve(const DenseTensor &LU, const Array<int> &P, Vector &X)
+{
+   const int m = LU.SizeI(), nk = LU.SizeK();
+   MFEM_VERIFY(X.Size() == m*nk && P.Size() == m*nk, "invalid sizes");
+   double *lu = const_cast<DenseTensor &>(LU).Data();
+   int *piv = const_cast<int *>(P.GetData());
+   double *x = X.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int k = 0; k < nk; k++)
+   {
+      LUFactors(lu + k*m*m, piv + k*m).Solve(m, 1, x + k*m);
+   }
+}
+
+void BatchCholeskyFactor(DenseTensor &A)
+{
+   const int m = A.SizeI(), nk = A.SizeK();
+   MFEM_VERIFY(A.SizeJ() == m, "the matrices are not square");
+   Array<double *> A_k(nk);
+   for (int k = 0; k < nk; k++) { A_k[k] = A.GetData(k); }
+   const int L = batch_lanes;
+   const int num_groups = (nk + L - 1)/L;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      Array<double> a(m*m*L);
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int g = 0; g < num_groups; g++)
+      {
+         const int k0 = g*L, nl = std::min(L, nk - k0);
+         InterleaveMatrices(m, A_k, k0, nl, a);
+         InterleavedCholeskyFactor<batch_lanes>(m, a);
+         for (int l = 0; l < nl; l++)
+         {
+            double *A_l = A_k[k0+l];
+            for (int j = 0; j < m; j++)
+            {
+               for (int i = 0; i < j; i++) { A_l[i+j*m] = 0.0; }
+               for (int i = j; i < m; i++) { A_l[i+j*m] = a[(i+j*m)*L+l]; }
+            }
+         }
+      }
+   }
+}
+
+void BatchCholeskySolve(const DenseTensor &L, Vector &X)
+{
+   const int m = L.SizeI(), nk = L.SizeK();
+   MFEM_VERIFY(X.Size() == m*nk, "invalid size");
+   const double *l_data = const_cast<DenseTensor &>(L).Data();
+   double *x_data = X.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int k = 0; k < nk; k++)
+   {
+      const double *l = l_data + k*m*m;
+      double *x = x_data + k*m;
+      // x <- L^{-1} x
+      for (int j = 0; j < m; j++)
+      {
+         const double x_j = (x[j] /= l[j+j*m]);
+         for (int i = j+1; i < m; i++) { x[i] -= l[i+j*m]*x_j; }
+      }
+      // x <- L^{-t} x
+      for (int j = m-1; j >= 0; j--)
+      {
+         double x_j = x[j];
+         for (int i = j+1; i < m; i++) { x_j -= l[i+j*m]*x[i]; }
+         x[j] = x_j/l[j+j*m];
+      }
+   }
+}
+
 }
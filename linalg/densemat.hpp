@@ -747,6 +747,49 @@ public:
    }
 };
 
+/** @brief Batched LU factorization with partial pivoting of the @a m x @a m
+    matrices at the addresses @a A, overwritten with their factors as in
+    LUFactors::Factor(); the pivots are written at the addresses @a P. */
+/** The matrices are copied in groups into an interleaved layout, where the
+    entry (i,j) of the matrices of a group is a short contiguous vector. The
+    elimination then updates all the matrices of a group at once, so it
+    vectorizes across the matrices even when @a m is small. The groups are
+    processed in parallel with OpenMP. Matrices with more than 32 rows are
+    factored one by one with LUFactors::Factor(), whose column operations
+    already vectorize. The factors can be used with LUFactors, e.g.
+    LUFactors::Solve(). */
+void BatchLUFactor(int m, const Array<double *> &A, const Array<int *> &P);
+
+/** @brief Batched LU factorization of matrices of different sizes: matrix k
+    has size @a m[k], see
+    BatchLUFactor(int, const Array<double *> &, const Array<int *> &). */
+/** The matrices are factored in groups of equal size. */
+void BatchLUFactor(const Array<int> &m, const Array<double *> &A,
+                   const Array<int *> &P);
+
+/** @brief Batched LU factorization of the matrices of @a A, see
+    BatchLUFactor(int, const Array<double *> &, const Array<int *> &). */
+/** The pivots of matrix k are stored in @a P, from index k*m, where m is the
+    size of the matrices. */
+void BatchLUFactor(DenseTensor &A, Array<int> &P);
+
+/** @brief Solve with the LU factors @a LU of BatchLUFactor(): the block
+    k of size m of @a X is overwritten with the solution of the system of
+    matrix k. */
+void BatchLUSolve(const DenseTensor &LU, const Array<int> &P, Vector &X);
+
+/** @brief Batched Cholesky factorization, A = L L^t, of the symmetric
+    positive definite matrices of @a A, with the interleaved layout of
+    BatchLUFactor(). */
+/** The lower triangles are overwritten with the factors L and the strict
+    upper triangles are set to zero. */
+void BatchCholeskyFactor(DenseTensor &A);
+
+/** @brief Solve with the Cholesky factors @a L of BatchCholeskyFactor(): the
+    block k of size m of @a X is overwritten with the solution of the system
+    of matrix k. */
+void BatchCholeskySolve(const DenseTensor &L, Vector &X);
+
 
 // Inline methods
 
@@ -0,0 +1,127 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class MultigridSolver
+
+#include "linalg.hpp"
+
+namespace mfem
+{
+
+MultigridSolver::MultigridSolver()
+   : Solver(0, false)
+{
+   pre_steps = post_steps = 1;
+   cycle_type = V_CYCLE;
+}
+
+void MultigridSolver::AddLevel(const Operator *op, Solver *smoother,
+                               const Operator *prolongation, bool own_op,
+                               bool own_smoother, bool own_prolongation)
+{
+   MFEM_VERIFY(op->Height() == op->Width(), "the operator must be square");
+   MFEM_VERIFY(smoother && smoother->Height() == op->Height(),
+               "the smoother does not match the operator");
+   if (operators.Size() == 0)
+   {
+      MFEM_VERIFY(prolongation == NULL,
+                  "the coarsest level has no prolongation");
+   }
+   else
+   {
+      MFEM_VERIFY(prolongation && prolongation->Height() == op->Height() &&
+                  prolongation->Width() == operators.Last()->Height(),
+                  "the prolongation does not match the levels");
+      smoother->iterative_mode = true;
+   }
+
+   operators.Append(op);
+   smoothers.Append(smoother);
+   prolongations.Append(prolongation);
+   own_operators.Append(own_op);
+   own_smoothers.Append(own_smoother);
+   own_prolongations.Append(own_prolongation);
+
+   // The previous finest level needs work vectors for the restricted
+   // residual, and the new one for its residual.
+   const int n = op->Height();
+   B.Append(NULL);
+   X.Append(NULL);
+   Res.Append(NULL);
+   if (operators.Size() > 1)
+   {
+      Res.Last() = new Vector(n);
+      const int nc = operators[operators.Size()-2]->Height();
+      B[B.Size()-2] = new Vector(nc);
+      X[X.Size()-2] = new Vector(nc);
+   }
+   height = width = n;
+}
+
+void MultigridSolver::SetSmoothingSteps(int pre, int post)
+{
+   MFEM_VERIFY(pre >= 0 && post >= 0, "invalid number of smoothing steps");
+   pre_steps = pre;
+   post_steps = post;
+}
+
+void MultigridSolver::Cycle(int l, const Vector &b, Vector &x) const
+{
+   if (l == 0)
+   {
+      smoothers[0]->Mult(b, x);
+      return;
+   }
+
+   for (int s = 0; s < pre_steps; s++) { smoothers[l]->Mult(b, x); }
+   Vector &r = *Res[l];
+   operators[l]->Mult(x, r);
+   subtract(b, r, r);
+   prolongations[l]->MultTranspose(r, *B[l-1]);
+   *X[l-1] = 0.0;
+   const int visits = (l == 1) ? 1 : cycle_type;
+   for (int v = 0; v < visits; v++)
+   {
+      Cycle(l-1, *B[l-1], *X[l-1]);
+   }
+   prolongations[l]->Mult(*X[l-1], r);
+   x += r;
+   for (int s = 0; s < post_steps; s++) { smoothers[l]->Mult(b, x); }
+}
+
+void MultigridSolver::Mult(const Vector &b, Vector &x) const
+{
+   MFEM_VERIFY(operators.Size() > 0, "MultigridSolver: no levels");
+   const int l = operators.Size() - 1;
+   if (l > 0 && !iterative_mode) { x = 0.0; }
+   Cycle(l, b, x);
+}
+
+void MultigridSolver::SetOperator(const Operator &op)
+{
+   mfem_error("MultigridSolver::SetOperator() : not supported, "
+              "use AddLevel()");
+}
+
+MultigridSolver::~MultigridSolver()
+{
+   for (int l = 0; l < operators.Size(); l++)
+   {
+      if (own_operators[l]) { delete operators[l]; }
+      if (own_smoothers[l]) { delete smoothers[l]; }
+      if (own_prolongations[l]) { delete prolongations[l]; }
+      delete B[l];
+      delete X[l];
+      delete Res[l];
+   }
+}
+
+}
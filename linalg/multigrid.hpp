@@ -0,0 +1,100 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_MULTIGRID
+#define MFEM_MULTIGRID
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "operator.hpp"
+
+namespace mfem
+{
+
+/** @brief Multigrid solver defined by a hierarchy of level operators,
+    smoothers and prolongations. */
+/** The levels are added from the coarsest to the finest one with AddLevel().
+    Each level, except the coarsest one, has a prolongation from the previous
+    level, and the restriction is its transpose, applied with MultTranspose().
+    The operators and the prolongations can be assembled matrices or
+    matrix-free operators.
+
+    The solver of the coarsest level is applied once, from a zero initial
+    guess. The smoothers of the other levels are applied in iterative mode,
+    SetSmoothingSteps() times before and after the coarse grid correction.
+    With the same number of pre- and post-smoothing steps of a symmetric
+    smoother, e.g. OperatorJacobiSmoother, and a symmetric coarse solver, the
+    cycle is a symmetric preconditioner which can be used with CG. Mult()
+    applies one cycle on the finest level; in iterative mode, the cycle starts
+    from the given vector. */
+class MultigridSolver : public Solver
+{
+public:
+   /// Multigrid cycles, see SetCycleType().
+   enum CycleType { V_CYCLE = 1, W_CYCLE = 2 };
+
+protected:
+   Array<const Operator *> operators;
+   Array<Solver *> smoothers;
+   /// Prolongations from level l-1 to level l; the first entry is NULL.
+   Array<const Operator *> prolongations;
+   Array<bool> own_operators, own_smoothers, own_prolongations;
+   int pre_steps, post_steps;
+   int cycle_type;
+   /// Right-hand sides, solutions and residuals of the levels.
+   mutable Array<Vector *> B, X, Res;
+
+   void Cycle(int l, const Vector &b, Vector &x) const;
+
+public:
+   MultigridSolver();
+
+   /** @brief Add a level finer than the current ones, with operator @a op and
+       smoother @a smoother, or coarse solver for the first level. */
+   /** The @a prolongation maps the previous level to this one, and must be
+       NULL for the first level. The ownership flags specify which objects are
+       destroyed with this solver. The smoothers, except the coarse solver,
+       are switched to iterative mode. */
+   void AddLevel(const Operator *op, Solver *smoother,
+                 const Operator *prolongation, bool own_op,
+                 bool own_smoother, bool own_prolongation);
+
+   /// Set the number of pre- and post-smoothing steps, 1 by default.
+   void SetSmoothingSteps(int pre, int post);
+
+   /// Set the cycle, V_CYCLE (default) or W_CYCLE.
+   void SetCycleType(CycleType type) { cycle_type = type; }
+
+   /// Return the number of levels.
+   int GetNumLevels() const { return operators.Size(); }
+
+   /// Return the operator of level @a l, where level 0 is the coarsest one.
+   const Operator *GetOperatorAtLevel(int l) const { return operators[l]; }
+
+   /// Return the smoother of level @a l, or the coarse solver for l = 0.
+   Solver *GetSmootherAtLevel(int l) const { return smoothers[l]; }
+
+   /// Return the prolongation from level l-1 to level @a l.
+   const Operator *GetProlongationAtLevel(int l) const
+   { return prolongations[l]; }
+
+   /// Apply one multigrid cycle to approximate the solution of A x = b.
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /// Not supported; the operators are set with AddLevel().
+   virtual void SetOperator(const Operator &op);
+
+   virtual ~MultigridSolver();
+};
+
+}
+
+#endif
@@ -54,6 +54,16 @@ void Operator::FormLinearSystem(const Array<int> &ess_tdof_list,
    Aout = A;
 }
 
+void Operator::ArrayMult(const Array<const Vector *> &X,
+                         Array<Vector *> &Y) const
+{
+   MFEM_VERIFY(X.Size() == Y.Size(), "incompatible number of vectors");
+   for (int i = 0; i < X.Size(); i++)
+   {
+      Mult(*X[i], *Y[i]);
+   }
+}
+
 void Operator::RecoverFEMSolution(const Vector &X, const Vector &b, Vector &x)
 {
    const Operator *P = this->GetProlongation();
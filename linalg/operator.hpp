@@ -47,6 +47,14 @@ public:
    /// Operator application: `y=A(x)`.
    virtual void Mult(const Vector &x, Vector &y) const = 0;
 
+   /** @brief Operator application to several vectors: `Y[i]=A(X[i])` for all
+       i in [0, X.Size()). */
+   /** The default behavior in class Operator is to call Mult() for each
+       vector; derived classes can apply the operator to all the vectors at
+       once, e.g. reading the entries of a matrix only once. */
+   virtual void ArrayMult(const Array<const Vector *> &X,
+                          Array<Vector *> &Y) const;
+
    /** @brief Action of the transpose operator: `y=A^t(x)`. The default behavior
        in class Operator is to generate an error. */
    virtual void MultTranspose(const Vector &x, Vector &y) const
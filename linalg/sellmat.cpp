@@ -0,0 +1,262 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class SELLMatrix
+
+#include "sellmat.hpp"
+#include "simd.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace mfem
+{
+
+namespace internal
+{
+
+// Order rows by decreasing length in the CSR matrix with row offsets I.
+struct RowLengthGreater
+{
+   const int *I;
+   RowLengthGreater(const int *I_) : I(I_) { }
+   bool operator()(int a, int b) const
+   { return (I[a+1] - I[a] > I[b+1] - I[b]); }
+};
+
+}
+
+int SELLMatrix::DefaultChunkSize()
+{
+   const int lanes = MFEM_SIMD_SIZE/sizeof(double);
+   return (lanes > 4) ? lanes : 4;
+}
+
+SELLMatrix::SELLMatrix(const SparseMatrix &A, int chunk_size, int sort_window)
+   : Operator(A.Height(), A.Width())
+{
+   MFEM_VERIFY(A.Finalized(), "the matrix must be finalized");
+   C = (chunk_size > 0) ? chunk_size : DefaultChunkSize();
+   MFEM_VERIFY(sort_window >= 1, "invalid sorting window: " << sort_window);
+   sigma = (sort_window == 1) ? 1 : C*((sort_window + C - 1)/C);
+   Init(A);
+}
+
+SELLMatrix::SELLMatrix(const SELLMatrix &other)
+   : Operator(other.height, other.width), C(other.C), sigma(other.sigma),
+     nchunks(other.nchunks)
+{
+   other.row_perm.Copy(row_perm);
+   other.chunk_ptr.Copy(chunk_ptr);
+   other.col.Copy(col);
+   val = AlignedNew<double>(col.Size());
+   std::memcpy(val, other.val, sizeof(double)*col.Size());
+}
+
+void SELLMatrix::Init(const SparseMatrix &A)
+{
+   const int *Ap = A.GetI(), *Aj = A.GetJ();
+   nchunks = (height + C - 1)/C;
+
+   // Sort the rows by decreasing length within each window of sigma rows.
+   row_perm.SetSize(nchunks*C);
+   row_perm = -1;
+   for (int r = 0; r < height; r++) { row_perm[r] = r; }
+   if (sigma > 1)
+   {
+      internal::RowLengthGreater longer(Ap);
+      for (int w = 0; w < height; w += sigma)
+      {
+         const int w_end = std::min(w + sigma, height);
+         // stable, so that rows of equal length keep their order
+         std::stable_sort(row_perm.GetData() + w, row_perm.GetData() + w_end,
+                          longer);
+      }
+   }
+
+   // Chunk lengths and offsets.
+   chunk_ptr.SetSize(nchunks+1);
+   chunk_ptr[0] = 0;
+   for (int c = 0; c < nchunks; c++)
+   {
+      int len = 0;
+      for (int l = 0; l < C; l++)
+      {
+         const int r = row_perm[c*C + l];
+         if (r >= 0) { len = std::max(len, Ap[r+1] - Ap[r]); }
+      }
+      chunk_ptr[c+1] = chunk_ptr[c] + len*C;
+   }
+
+   // Column indices; the padding entries repeat the last column of their row,
+   // or use column 0 for empty rows, and have zero values.
+   col.SetSize(chunk_ptr[nchunks]);
+   for (int c = 0; c < nchunks; c++)
+   {
+      const int len = (chunk_ptr[c+1] - chunk_ptr[c])/C;
+      for (int l = 0; l < C; l++)
+      {
+         const int r = row_perm[c*C + l];
+         const int rlen = (r >= 0) ? Ap[r+1] - Ap[r] : 0;
+         for (int j = 0; j < len; j++)
+         {
+            col[chunk_ptr[c] + j*C + l] =
+               (j < rlen) ? Aj[Ap[r] + j] : ((rlen > 0) ? Aj[Ap[r+1]-1] : 0);
+         }
+      }
+   }
+
+   val = AlignedNew<double>(col.Size());
+   Update(A);
+}
+
+void SELLMatrix::Update(const SparseMatrix &A)
+{
+   MFEM_VERIFY(A.Finalized() && A.Height() == height && A.Width() == width,
+               "incompatible matrix");
+   const int *Ap = A.GetI();
+   const double *Aa = A.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int c = 0; c < nchunks; c++)
+   {
+      const int len = (chunk_ptr[c+1] - chunk_ptr[c])/C;
+      for (int l = 0; l < C; l++)
+      {
+         const int r = row_perm[c*C + l];
+         const int rlen = (r >= 0) ? Ap[r+1] - Ap[r] : 0;
+         MFEM_ASSERT(rlen <= len, "the sparsity of the matrix has changed");
+         for (int j = 0; j < len; j++)
+         {
+            val[chunk_ptr[c] + j*C + l] = (j < rlen) ? Aa[Ap[r] + j] : 0.0;
+         }
+      }
+   }
+}
+
+namespace internal
+{
+
+// y += a A x for a SELL matrix with the compile-time chunk size C; the lane
+// loops have a fixed length and are vectorized by the compiler.
+template <int C>
+static void SELLAddMult(int nchunks, const int *chunk_ptr, const int *col,
+                        const double *val, const int *row_perm,
+                        const double *x, double *y, const double a)
+{
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int c = 0; c < nchunks; c++)
+   {
+      double sum[C];
+      for (int l = 0; l < C; l++) { sum[l] = 0.0; }
+      for (int k = chunk_ptr[c]; k < chunk_ptr[c+1]; k += C)
+      {
+         for (int l = 0; l < C; l++)
+         {
+            sum[l] += val[k + l]*x[col[k + l]];
+         }
+      }
+      for (int l = 0; l < C; l++)
+      {
+         const int r = row_perm[c*C + l];
+         if (r >= 0) { y[r] += a*sum[l]; }
+      }
+   }
+}
+
+// Same as SELLAddMult() with a runtime chunk size.
+static void SELLAddMult(int C, int nchunks, const int *chunk_ptr,
+                        const int *col, const double *val,
+                        const int *row_perm, const double *x, double *y,
+                        const double a)
+{
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int c = 0; c < nchunks; c++)
+   {
+      for (int l = 0; l < C; l++)
+      {
+         const int r = row_perm[c*C + l];
+         if (r < 0) { continue; }
+         double d = 0.0;
+         for (int k = chunk_ptr[c] + l; k < chunk_ptr[c+1]; k += C)
+         {
+            d += val[k]*x[col[k]];
+         }
+         y[r] += a*d;
+      }
+   }
+}
+
+}
+
+void SELLMatrix::Mult(const Vector &x, Vector &y) const
+{
+   y = 0.0;
+   AddMult(x, y);
+}
+
+void SELLMatrix::AddMult(const Vector &x, Vector &y, const double a) const
+{
+   MFEM_ASSERT(x.Size() == width && y.Size() == height,
+               "incompatible vector sizes");
+   const int *cp = chunk_ptr.GetData(), *cj = col.GetData();
+   const int *rp = row_perm.GetData();
+   const double *xp = x.GetData();
+   double *yp = y.GetData();
+   switch (C)
+   {
+      case 4: internal::SELLAddMult<4>(nchunks, cp, cj, val, rp, xp, yp, a);
+         break;
+      case 8: internal::SELLAddMult<8>(nchunks, cp, cj, val, rp, xp, yp, a);
+         break;
+      case 16: internal::SELLAddMult<16>(nchunks, cp, cj, val, rp, xp, yp, a);
+         break;
+      default: internal::SELLAddMult(C, nchunks, cp, cj, val, rp, xp, yp, a);
+   }
+}
+
+void SELLMatrix::MultTranspose(const Vector &x, Vector &y) const
+{
+   MFEM_ASSERT(x.Size() == height && y.Size() == width,
+               "incompatible vector sizes");
+   y = 0.0;
+   for (int c = 0; c < nchunks; c++)
+   {
+      for (int l = 0; l < C; l++)
+      {
+         const int r = row_perm[c*C + l];
+         if (r < 0) { continue; }
+         const double xr = x(r);
+         for (int k = chunk_ptr[c] + l; k < chunk_ptr[c+1]; k += C)
+         {
+            y(col[k]) += val[k]*xr;
+         }
+      }
+   }
+}
+
+long SELLMatrix::MemoryUsage() const
+{
+   return sizeof(int)*(row_perm.Size() + chunk_ptr.Size() + col.Size()) +
+          sizeof(double)*col.Size();
+}
+
+SELLMatrix::~SELLMatrix()
+{
+   AlignedDelete(val);
+}
+
+}
@@ -0,0 +1,98 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_SELLMAT
+#define MFEM_SELLMAT
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "operator.hpp"
+#include "sparsemat.hpp"
+
+namespace mfem
+{
+
+/** @brief Sparse matrix in SELL-C-sigma format: the rows are grouped in chunks
+    of C rows stored column by column, so that the product with a vector
+    processes the C rows of a chunk in the lanes of the SIMD registers. */
+/** Within each window of sigma consecutive rows, the rows are sorted by
+    decreasing length, so that the rows of a chunk have similar lengths; each
+    chunk is padded with zeros to the length of its longest row. Entry @a j of
+    the @a r-th row of chunk @a c is stored at offset chunk_ptr[c] + j*C + r of
+    the arrays #col and #val. The default chunk size, C, fills one SIMD
+    register of MFEM_SIMD_SIZE bytes with doubles (at least 4); sigma = 1
+    disables the sorting.
+
+    A SELLMatrix is created from a finalized SparseMatrix and can be used as an
+    Operator, e.g. in the iterative solvers or through an OperatorHandle. */
+class SELLMatrix : public Operator
+{
+protected:
+   int C;                ///< Chunk size.
+   int sigma;            ///< Sorting window size.
+   int nchunks;          ///< Number of chunks, ceil(height/C).
+   Array<int> row_perm;  ///< Original row of each chunk row; -1 for padding.
+   Array<int> chunk_ptr; ///< Offsets of the chunks, size nchunks+1.
+   Array<int> col;       ///< Column indices, size chunk_ptr[nchunks].
+   double *val;          ///< Entries, aligned for SIMD access.
+
+   void Init(const SparseMatrix &A);
+
+public:
+   /** @brief Convert the finalized SparseMatrix @a A to SELL-C-sigma format
+       with chunk size @a chunk_size and sorting window @a sort_window. */
+   /** A value of 0 for @a chunk_size selects the default chunk size, see the
+       class description; @a sort_window is rounded up to a multiple of the
+       chunk size. */
+   SELLMatrix(const SparseMatrix &A, int chunk_size = 0, int sort_window = 32);
+
+   /// Copy constructor (deep copy).
+   SELLMatrix(const SELLMatrix &other);
+
+   /// Return the default chunk size, see the class description.
+   static int DefaultChunkSize();
+
+   /// Return the chunk size, C.
+   int GetChunkSize() const { return C; }
+
+   /// Return the sorting window size, sigma.
+   int GetSortWindow() const { return sigma; }
+
+   /** @brief Return the number of stored entries, including the padding; the
+       ratio of the number of nonzeros to this number measures the efficiency
+       of the format for the matrix. */
+   int NumStoredEntries() const { return chunk_ptr[nchunks]; }
+
+   /** @brief Copy the entries of @a A, which must have the same sparsity as the
+       matrix used in the constructor, into the stored chunks. */
+   void Update(const SparseMatrix &A);
+
+   /// y = A x; the chunks are processed in parallel with OpenMP.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   /// y += a A x
+   void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
+
+   /// y = A^t x
+   virtual void MultTranspose(const Vector &x, Vector &y) const;
+
+   /// Return the size of the stored data in bytes.
+   long MemoryUsage() const;
+
+   virtual ~SELLMatrix();
+
+private:
+   SELLMatrix &operator=(const SELLMatrix &);
+};
+
+}
+
+#endif
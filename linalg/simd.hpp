@@ -0,0 +1,417 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_SIMD
+#define MFEM_SIMD
+
+#include "../config/tconfig.hpp"
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(__AVX__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+// --- MFEM_ALIGN_AS
+#if defined(__GNUC__) || defined(__clang__)
+#define MFEM_ALIGN_AS(bytes) __attribute__((aligned(bytes)))
+#else
+#define MFEM_ALIGN_AS(bytes)
+#endif
+
+namespace mfem
+{
+
+// Templated SIMD value types used by the templated classes (tevaluator.hpp,
+// tbilininteg.hpp, tbilinearform.hpp) to process batches of elements, one
+// element per lane.
+
+/** @brief A short vector of @a S values of type @a scalar_t supporting the
+    arithmetic operations of @a scalar_t, lane-wise.
+
+    The generic version relies on the compiler to vectorize the lane loops; it
+    is also the scalar fallback when no SIMD instruction set is available.
+    Specializations using SSE2, AVX and AVX-512 intrinsics are defined for
+    double values when the respective instruction set is enabled. The data is
+    aligned to @a align_S values; @a align_S times sizeof(scalar_t) must be a
+    power of two. */
+template <typename scalar_t, int S, int align_S = S>
+struct AutoSIMD
+{
+   typedef scalar_t scalar_type;
+   static const int size = S;
+   static const int align_size = align_S;
+
+   scalar_t vec[size] MFEM_ALIGN_AS(align_S*sizeof(scalar_t));
+
+   inline MFEM_ALWAYS_INLINE scalar_t &operator[](int i) { return vec[i]; }
+   inline MFEM_ALWAYS_INLINE const scalar_t &operator[](int i) const
+   { return vec[i]; }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator=(const scalar_t &e)
+   {
+      for (int i = 0; i < size; i++) { vec[i] = e; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator+=(const AutoSIMD &v)
+   {
+      for (int i = 0; i < size; i++) { vec[i] += v[i]; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator+=(const scalar_t &e)
+   {
+      for (int i = 0; i < size; i++) { vec[i] += e; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator-=(const AutoSIMD &v)
+   {
+      for (int i = 0; i < size; i++) { vec[i] -= v[i]; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator-=(const scalar_t &e)
+   {
+      for (int i = 0; i < size; i++) { vec[i] -= e; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator*=(const AutoSIMD &v)
+   {
+      for (int i = 0; i < size; i++) { vec[i] *= v[i]; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator*=(const scalar_t &e)
+   {
+      for (int i = 0; i < size; i++) { vec[i] *= e; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator/=(const AutoSIMD &v)
+   {
+      for (int i = 0; i < size; i++) { vec[i] /= v[i]; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator/=(const scalar_t &e)
+   {
+      for (int i = 0; i < size; i++) { vec[i] /= e; }
+      return *this;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-() const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = -vec[i]; }
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator+(const AutoSIMD &v) const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = vec[i] + v[i]; }
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator+(const scalar_t &e) const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = vec[i] + e; }
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-(const AutoSIMD &v) const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = vec[i] - v[i]; }
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-(const scalar_t &e) const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = vec[i] - e; }
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator*(const AutoSIMD &v) const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = vec[i] * v[i]; }
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator*(const scalar_t &e) const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = vec[i] * e; }
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator/(const AutoSIMD &v) const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = vec[i] / v[i]; }
+      return r;
+   }
+
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator/(const scalar_t &e) const
+   {
+      AutoSIMD r;
+      for (int i = 0; i < size; i++) { r[i] = vec[i] / e; }
+      return r;
+   }
+};
+
+template <typename scalar_t, int S, int A>
+inline MFEM_ALWAYS_INLINE
+AutoSIMD<scalar_t,S,A> operator+(const scalar_t &e,
+                                 const AutoSIMD<scalar_t,S,A> &v)
+{
+   return v + e;
+}
+
+template <typename scalar_t, int S, int A>
+inline MFEM_ALWAYS_INLINE
+AutoSIMD<scalar_t,S,A> operator-(const scalar_t &e,
+                                 const AutoSIMD<scalar_t,S,A> &v)
+{
+   AutoSIMD<scalar_t,S,A> r;
+   r = e;
+   return r -= v;
+}
+
+template <typename scalar_t, int S, int A>
+inline MFEM_ALWAYS_INLINE
+AutoSIMD<scalar_t,S,A> operator*(const scalar_t &e,
+                                 const AutoSIMD<scalar_t,S,A> &v)
+{
+   return v * e;
+}
+
+template <typename scalar_t, int S, int A>
+inline MFEM_ALWAYS_INLINE
+AutoSIMD<scalar_t,S,A> operator/(const scalar_t &e,
+                                 const AutoSIMD<scalar_t,S,A> &v)
+{
+   AutoSIMD<scalar_t,S,A> r;
+   r = e;
+   return r /= v;
+}
+
+
+// Explicit specializations for double values, x86 instruction sets. The
+// intrinsic type and the lane values share storage, so that single lanes can
+// be accessed with operator[].
+
+// Define the arithmetic operators of a specialization, given the intrinsic
+// member 'm' and the intrinsics for set1, add, sub, mul and div.
+#define MFEM_SIMD_X86_OPERATORS(set1, add, sub, mul, div)                      \
+   inline MFEM_ALWAYS_INLINE double &operator[](int i) { return vec[i]; }      \
+   inline MFEM_ALWAYS_INLINE const double &operator[](int i) const             \
+   { return vec[i]; }                                                          \
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator=(const double &e)              \
+   { m = set1(e); return *this; }                                              \
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator+=(const AutoSIMD &v)           \
+   { m = add(m, v.m); return *this; }                                          \
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator+=(const double &e)             \
+   { m = add(m, set1(e)); return *this; }                                      \
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator-=(const AutoSIMD &v)           \
+   { m = sub(m, v.m); return *this; }                                          \
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator-=(const double &e)             \
+   { m = sub(m, set1(e)); return *this; }                                      \
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator*=(const AutoSIMD &v)           \
+   { m = mul(m, v.m); return *this; }                                          \
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator*=(const double &e)             \
+   { m = mul(m, set1(e)); return *this; }                                      \
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator/=(const AutoSIMD &v)           \
+   { m = div(m, v.m); return *this; }                                          \
+   inline MFEM_ALWAYS_INLINE AutoSIMD &operator/=(const double &e)             \
+   { m = div(m, set1(e)); return *this; }                                      \
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-() const                        \
+   { AutoSIMD r; r.m = sub(set1(0.0), m); return r; }                          \
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator+(const AutoSIMD &v) const       \
+   { AutoSIMD r; r.m = add(m, v.m); return r; }                                \
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator+(const double &e) const         \
+   { AutoSIMD r; r.m = add(m, set1(e)); return r; }                            \
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-(const AutoSIMD &v) const       \
+   { AutoSIMD r; r.m = sub(m, v.m); return r; }                                \
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator-(const double &e) const         \
+   { AutoSIMD r; r.m = sub(m, set1(e)); return r; }                            \
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator*(const AutoSIMD &v) const       \
+   { AutoSIMD r; r.m = mul(m, v.m); return r; }                                \
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator*(const double &e) const         \
+   { AutoSIMD r; r.m = mul(m, set1(e)); return r; }                            \
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator/(const AutoSIMD &v) const       \
+   { AutoSIMD r; r.m = div(m, v.m); return r; }                                \
+   inline MFEM_ALWAYS_INLINE AutoSIMD operator/(const double &e) const         \
+   { AutoSIMD r; r.m = div(m, set1(e)); return r; }
+
+#ifdef __SSE2__
+template <>
+struct AutoSIMD<double,2,2>
+{
+   typedef double scalar_type;
+   static const int size = 2;
+   static const int align_size = 2;
+
+   union
+   {
+      __m128d m;
+      double vec[size];
+   };
+
+   MFEM_SIMD_X86_OPERATORS(_mm_set1_pd, _mm_add_pd, _mm_sub_pd, _mm_mul_pd,
+                           _mm_div_pd)
+};
+#endif // __SSE2__
+
+#ifdef __AVX__
+template <>
+struct AutoSIMD<double,4,4>
+{
+   typedef double scalar_type;
+   static const int size = 4;
+   static const int align_size = 4;
+
+   union
+   {
+      __m256d m;
+      double vec[size];
+   };
+
+   MFEM_SIMD_X86_OPERATORS(_mm256_set1_pd, _mm256_add_pd, _mm256_sub_pd,
+                           _mm256_mul_pd, _mm256_div_pd)
+};
+#endif // __AVX__
+
+#ifdef __AVX512F__
+template <>
+struct AutoSIMD<double,8,8>
+{
+   typedef double scalar_type;
+   static const int size = 8;
+   static const int align_size = 8;
+
+   union
+   {
+      __m512d m;
+      double vec[size];
+   };
+
+   MFEM_SIMD_X86_OPERATORS(_mm512_set1_pd, _mm512_add_pd, _mm512_sub_pd,
+                           _mm512_mul_pd, _mm512_div_pd)
+};
+#endif // __AVX512F__
+
+#undef MFEM_SIMD_X86_OPERATORS
+
+
+/** @brief Implementation traits of the templated classes: the data type of a
+    batch of elements, processed in the lanes of one SIMD value. */
+/** The default number of lanes fills one SIMD register of MFEM_SIMD_SIZE
+    bytes, see tconfig.hpp. */
+template <typename complex_t, typename real_t,
+          int simd_lanes = MFEM_SIMD_SIZE/sizeof(complex_t)>
+struct AutoSIMDTraits
+{
+   typedef complex_t complex_type;
+   typedef real_t    real_type;
+
+   /// Number of elements processed together, one per lane.
+   static const int simd_size = (simd_lanes > 0) ? simd_lanes : 1;
+
+   typedef AutoSIMD<complex_t,simd_size,simd_size> vcomplex_t;
+};
+
+/// Implementation traits disabling the SIMD processing of element batches.
+template <typename complex_t, typename real_t>
+struct NoSIMDTraits
+{
+   typedef complex_t complex_type;
+   typedef real_t    real_type;
+
+   static const int simd_size = 1;
+
+   typedef complex_t vcomplex_t;
+};
+
+
+/** @brief Allocate an array of @a n objects of the trivial type @a T aligned
+    for SIMD access; the array must be freed with AlignedDelete(). */
+/** Operator new[] does not guarantee the alignment of SIMD types before C++17.
+    The objects are not initialized. */
+template <typename T>
+inline T *AlignedNew(int n)
+{
+   const size_t align = (MFEM_SIMD_SIZE > 16) ? MFEM_SIMD_SIZE : 16;
+   char *buf = new char[n*sizeof(T) + align + sizeof(char*)];
+   size_t addr = reinterpret_cast<size_t>(buf + sizeof(char*));
+   addr = ((addr + align - 1)/align)*align;
+   char *ptr = reinterpret_cast<char*>(addr);
+   reinterpret_cast<char**>(ptr)[-1] = buf;
+   return reinterpret_cast<T*>(ptr);
+}
+
+/// Free an array allocated with AlignedNew().
+template <typename T>
+inline void AlignedDelete(T *ptr)
+{
+   if (ptr) { delete [] reinterpret_cast<char**>(ptr)[-1]; }
+}
+
+
+namespace internal
+{
+
+// The number of lanes of a scalar or SIMD data type.
+template <typename data_t>
+struct SIMDSize { static const int value = 1; };
+
+template <typename scalar_t, int S, int A>
+struct SIMDSize<AutoSIMD<scalar_t,S,A> > { static const int value = S; };
+
+// Access to the lane 'i' of a scalar or SIMD value; a scalar has one lane.
+template <typename data_t>
+inline MFEM_ALWAYS_INLINE data_t &SIMDLane(data_t &a, int)
+{ return a; }
+
+template <typename data_t>
+inline MFEM_ALWAYS_INLINE const data_t &SIMDLane(const data_t &a, int)
+{ return a; }
+
+template <typename scalar_t, int S, int A>
+inline MFEM_ALWAYS_INLINE scalar_t &SIMDLane(AutoSIMD<scalar_t,S,A> &a, int i)
+{ return a[i]; }
+
+template <typename scalar_t, int S, int A>
+inline MFEM_ALWAYS_INLINE
+const scalar_t &SIMDLane(const AutoSIMD<scalar_t,S,A> &a, int i)
+{ return a[i]; }
+
+// The entry type of the data arguments of the templated functions: either a
+// pointer or a class with a data_type, e.g. TVector.
+template <typename data_t>
+struct EntryType { typedef typename data_t::data_type type; };
+
+template <typename data_t>
+struct EntryType<data_t*> { typedef data_t type; };
+
+template <typename data_t>
+struct EntryType<const data_t*> { typedef data_t type; };
+
+} // namespace mfem::internal
+
+} // namespace mfem
+
+#endif // MFEM_SIMD
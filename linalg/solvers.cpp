@@ -21,6 +21,57 @@ namespace mfem
 
 using namespace std;
 
+PowerMethod::PowerMethod()
+{
+#ifdef MFEM_USE_MPI
+   comm = MPI_COMM_NULL;
+#endif
+}
+
+double PowerMethod::Dot(const Vector &x, const Vector &y) const
+{
+#ifndef MFEM_USE_MPI
+   return (x * y);
+#else
+   if (comm == MPI_COMM_NULL)
+   {
+      return (x * y);
+   }
+   double local_dot = (x * y);
+   double global_dot;
+   MPI_Allreduce(&local_dot, &global_dot, 1, MPI_DOUBLE, MPI_SUM, comm);
+   return global_dot;
+#endif
+}
+
+double PowerMethod::Estimate(const Operator &A, const Operator *B,
+                             const Vector *dinv, int iterations) const
+{
+   const int n = A.Height();
+   Vector v(n), Av(n), z(n);
+   double lambda = 0.0;
+   v.Randomize(1);
+   v /= sqrt(Dot(v, v));
+   for (int it = 0; it < iterations; it++)
+   {
+      A.Mult(v, Av);
+      if (B) { B->Mult(Av, z); }
+      else if (dinv)
+      {
+         for (int i = 0; i < n; i++) { z(i) = (*dinv)(i)*Av(i); }
+      }
+      else { z = Av; }
+      // the Rayleigh quotient of B A in the A inner product
+      const double vAv = Dot(v, Av);
+      if (vAv <= 0.0) { break; }
+      lambda = Dot(z, Av)/vAv;
+      const double norm = sqrt(Dot(z, z));
+      if (norm == 0.0) { break; }
+      add(1.0/norm, z, 0.0, z, v);
+   }
+   return lambda;
+}
+
 IterativeSolver::IterativeSolver()
    : Solver(0, true)
 {
@@ -31,6 +82,7 @@ IterativeSolver::IterativeSolver()
    rel_tol = abs_tol = 0.0;
 #ifdef MFEM_USE_MPI
    dot_prod_type = 0;
+   dots_request = MPI_REQUEST_NULL;
 #endif
 }
 
@@ -45,26 +97,54 @@ IterativeSolver::IterativeSolver(MPI_Comm _comm)
    rel_tol = abs_tol = 0.0;
    dot_prod_type = 1;
    comm = _comm;
+   dots_request = MPI_REQUEST_NULL;
 }
 #endif
 
 double IterativeSolver::Dot(const Vector &x, const Vector &y) const
 {
-#ifndef MFEM_USE_MPI
-   return (x * y);
-#else
-   if (dot_prod_type == 0)
+   double dot = (x * y);
+   SumDots(&dot, 1);
+   return dot;
+}
+
+void IterativeSolver::SumDots(double *dots, int n) const
+{
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type != 0)
    {
-      return (x * y);
+      MPI_Allreduce(MPI_IN_PLACE, dots, n, MPI_DOUBLE, MPI_SUM, comm);
    }
-   else
-   {
-      double local_dot = (x * y);
-      double global_dot;
+#else
+   MFEM_CONTRACT_VAR(dots);
+   MFEM_CONTRACT_VAR(n);
+#endif
+}
 
-      MPI_Allreduce(&local_dot, &global_dot, 1, MPI_DOUBLE, MPI_SUM, comm);
+void IterativeSolver::StartSumDots(double *dots, int n) const
+{
+#ifdef MFEM_USE_MPI
+   if (dot_prod_type != 0)
+   {
+#if MPI_VERSION >= 3
+      MPI_Iallreduce(MPI_IN_PLACE, dots, n, MPI_DOUBLE, MPI_SUM, comm,
+                     &dots_request);
+#else
+      MPI_Allreduce(MPI_IN_PLACE, dots, n, MPI_DOUBLE, MPI_SUM, comm);
+#endif
+   }
+#else
+   MFEM_CONTRACT_VAR(dots);
+   MFEM_CONTRACT_VAR(n);
+#endif
+}
 
-      return global_dot;
+void IterativeSolver::FinishSumDots() const
+{
+#if defined(MFEM_USE_MPI) && MPI_VERSION >= 3
+   if (dot_prod_type != 0)
+   {
+      MPI_Wait(&dots_request, MPI_STATUS_IGNORE);
    }
 #endif
 }
@@ -359,16 +439,18 @@ void CGSolver::Mult(const Vector &b, Vector &x) const
    {
       alpha = nom/den;
       add(x,  alpha, d, x);     //  x = x + alpha d
-      add(r, -alpha, z, r);     //  r = r - alpha A d
 
       if (prec)
       {
+         add(r, -alpha, z, r);  //  r = r - alpha A d
          prec->Mult(r, z);      //  z = B r
          betanom = Dot(r, z);
       }
       else
       {
-         betanom = Dot(r, r);
+         // r = r - alpha A d, fused with (r, r)
+         betanom = AddAndDot(r, -alpha, z, r, r);
+         SumDots(&betanom, 1);
       }
       MFEM_ASSERT(IsFinite(betanom), "betanom = " << betanom);
 
@@ -468,6 +550,637 @@ void PCG(const Operator &A, Solver &B, const Vector &b, Vector &x,
    pcg.Mult(b, x);
 }
 
+void PipelinedCGSolver::UpdateVectors()
+{
+   r.SetSize(width);
+   u.SetSize(width);
+   w.SetSize(width);
+   m.SetSize(width);
+   n.SetSize(width);
+   z.SetSize(width);
+   q.SetSize(width);
+   s.SetSize(width);
+   p.SetSize(width);
+}
+
+// The vector updates of an iteration of the pipelined CG, in one sweep:
+//    z = n + beta z,   q = m + beta q,   s = w + beta s,   p = u + beta p,
+//    x = x + alpha p,  r = r - alpha s,  u = u - alpha q,  w = w - alpha z,
+// returning the local inner products dots = { (r, u), (w, u) }. Without a
+// preconditioner, u = r, m = w, and q = s are not updated separately.
+static void PipelinedCGUpdate(const int size, const double alpha,
+                              const double beta, const double *n,
+                              const double *m, double *z, double *q,
+                              double *s, double *p, double *x, double *r,
+                              double *u, double *w, const bool prec,
+                              double dots[2])
+{
+   double ru = 0.0, wu = 0.0;
+   if (prec)
+   {
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for reduction(+:ru,wu)
+#endif
+      for (int i = 0; i < size; i++)
+      {
+         const double zi = n[i] + beta*z[i];
+         const double qi = m[i] + beta*q[i];
+         const double si = w[i] + beta*s[i];
+         const double pi = u[i] + beta*p[i];
+         z[i] = zi; q[i] = qi; s[i] = si; p[i] = pi;
+         x[i] += alpha*pi;
+         const double ri = r[i] - alpha*si;
+         const double ui = u[i] - alpha*qi;
+         const double wi = w[i] - alpha*zi;
+         r[i] = ri; u[i] = ui; w[i] = wi;
+         ru += ri*ui;
+         wu += wi*ui;
+      }
+   }
+   else
+   {
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for reduction(+:ru,wu)
+#endif
+      for (int i = 0; i < size; i++)
+      {
+         const double zi = n[i] + beta*z[i];
+         const double si = w[i] + beta*s[i];
+         const double pi = r[i] + beta*p[i];
+         z[i] = zi; s[i] = si; p[i] = pi;
+         x[i] += alpha*pi;
+         const double ri = r[i] - alpha*si;
+         const double wi = w[i] - alpha*zi;
+         r[i] = ri; w[i] = wi;
+         ru += ri*ri;
+         wu += wi*ri;
+      }
+   }
+   dots[0] = ru;
+   dots[1] = wu;
+}
+
+void PipelinedCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   // Without a preconditioner, u = r and m = w.
+   Vector &uu = prec ? u : r;
+   Vector &mm = prec ? m : w;
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+   if (prec)
+   {
+      prec->Mult(r, u); // u = B r
+   }
+   oper->Mult(uu, w);   // w = A u
+   // with beta = 0 in the first iteration
+   z = 0.0; q = 0.0; s = 0.0; p = 0.0;
+
+   double dots[2], gamma = 0.0, gamma_old = 0.0, alpha = 0.0, nom0 = 0.0;
+   double r0 = 0.0;
+   Dot2(uu, r, w, dots);
+
+   converged = 0;
+   final_iter = max_iter;
+   for (int i = 0; true; i++)
+   {
+      // the reduction of (r, u) and (w, u) is overlapped with m = B w and
+      // n = A m
+      StartSumDots(dots, 2);
+      if (prec)
+      {
+         prec->Mult(w, m);
+      }
+      oper->Mult(mm, n);
+      FinishSumDots();
+      gamma = dots[0];
+      const double delta = dots[1];
+      MFEM_ASSERT(IsFinite(gamma), "gamma = " << gamma);
+      MFEM_ASSERT(IsFinite(delta), "delta = " << delta);
+
+      if (i == 0)
+      {
+         nom0 = gamma;
+         r0 = std::max(gamma*rel_tol*rel_tol, abs_tol*abs_tol);
+      }
+      if (print_level == 1 || (print_level == 3 && i == 0))
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                   << gamma << (print_level == 3 ? " ...\n" : "\n");
+      }
+      if (gamma <= r0)
+      {
+         if (print_level == 2)
+         {
+            mfem::out << "Number of PipelinedCG iterations: " << i << '\n';
+         }
+         else if (print_level == 3 && i > 0)
+         {
+            mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                      << gamma << '\n';
+         }
+         converged = 1;
+         final_iter = i;
+         break;
+      }
+      if (i == max_iter)
+      {
+         break;
+      }
+
+      double beta, den;
+      if (i == 0)
+      {
+         beta = 0.0;
+         den = delta;
+      }
+      else
+      {
+         beta = gamma/gamma_old;
+         den = delta - beta*gamma/alpha;
+      }
+      if (den <= 0.0 && print_level >= 0)
+      {
+         mfem::out << "PipelinedCG: The operator is not positive definite. "
+                   << "(A p, p) = " << den << '\n';
+      }
+      if (den == 0.0)
+      {
+         final_iter = i;
+         break;
+      }
+      alpha = gamma/den;
+      gamma_old = gamma;
+
+      PipelinedCGUpdate(width, alpha, beta, n.GetData(), m.GetData(),
+                        z.GetData(), q.GetData(), s.GetData(), p.GetData(),
+                        x.GetData(), r.GetData(), u.GetData(), w.GetData(),
+                        prec != NULL, dots);
+
+      if (replace_period > 0 && (i+1) % replace_period == 0)
+      {
+         // replace the recurrences by the true residual and products
+         Vector &qq = prec ? q : s;
+         oper->Mult(x, r);
+         subtract(b, r, r);       // r = b - A x
+         if (prec) { prec->Mult(r, u); }
+         oper->Mult(uu, w);       // w = A u
+         oper->Mult(p, s);        // s = A p
+         if (prec) { prec->Mult(s, q); }
+         oper->Mult(qq, z);       // z = A q
+         Dot2(uu, r, w, dots);
+      }
+   }
+   final_norm = sqrt(gamma);
+   if (print_level >= 0 && !converged)
+   {
+      if (print_level != 1)
+      {
+         if (print_level != 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                      << nom0 << " ...\n";
+         }
+         mfem::out << "   Iteration : " << setw(3) << final_iter
+                   << "  (B r, r) = " << gamma << '\n';
+      }
+      mfem::out << "PipelinedCG: No convergence!" << '\n';
+   }
+}
+
+void SStepCGSolver::UpdateVectors()
+{
+   MFEM_VERIFY(s_steps >= 1, "invalid step size: " << s_steps);
+   lambda_max = 0.0;
+   V.SetSize(width, s_steps);
+   W.SetSize(width, s_steps);
+   P.SetSize(width, s_steps);
+   AP.SetSize(width, s_steps);
+   G.SetSize(s_steps);
+   C.SetSize(s_steps);
+   r.SetSize(width);
+   buf.SetSize(s_steps*s_steps + s_steps);
+}
+
+void SStepCGSolver::EstimateLargestEigenvalue() const
+{
+#ifndef MFEM_USE_MPI
+   PowerMethod power;
+#else
+   PowerMethod power(dot_prod_type ? comm : MPI_COMM_NULL);
+#endif
+   // margin for the lower bound given by the power iterations
+   lambda_max = 1.1*power.EstimateLargestEigenvalue(*oper, prec);
+}
+
+void SStepCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   const int st = s_steps, st2 = st*st;
+   DenseMatrix Beta(st);
+   Vector a(st), g(buf.GetData() + st2, st), col, prev;
+   // the basis of the current block and the previous block; swapped at the
+   // end of each outer iteration
+   DenseMatrix *Vp = &V, *Wp = &W, *Pp = &P, *APp = &AP;
+
+   if (lambda_max <= 0.0 && st > 1)
+   {
+      EstimateLargestEigenvalue();
+   }
+
+   if (iterative_mode)
+   {
+      oper->Mult(x, r);
+      subtract(b, r, r); // r = b - A x
+   }
+   else
+   {
+      r = b;
+      x = 0.0;
+   }
+
+   double gamma = 0.0, nom0 = 0.0, r0 = 0.0;
+   converged = 0;
+   int i;
+   for (i = 0; true; i += st)
+   {
+      // V = [T_0(B A) B r, ..., T_{s-1}(B A) B r], W = A V, with the
+      // Chebyshev polynomials T_j of [0, lambda_max]
+      for (int j = 0; j < st; j++)
+      {
+         Vp->GetColumnReference(j, col);
+         if (j == 0) { prev.SetDataAndSize(r.GetData(), r.Size()); }
+         else { Wp->GetColumnReference(j-1, prev); }
+         if (prec) { prec->Mult(prev, col); }
+         else { col = prev; }
+         if (j > 0)
+         {
+            // T_j = (2 (t - c) T_{j-1} - T_{j-2})/h, with the center c and
+            // the half-width h of the interval (the factor is 1/h for j = 1)
+            const double c = 0.5*lambda_max, f = (j == 1) ? 1.0/c : 2.0/c;
+            Vp->GetColumnReference(j-1, prev);
+            if (j == 1) { add(f, col, -f*c, prev, col); }
+            else
+            {
+               Vector prev2;
+               Vp->GetColumnReference(j-2, prev2);
+               add(f, col, -f*c, prev, -1.0, prev2, col);
+            }
+         }
+         Wp->GetColumnReference(j, prev);
+         oper->Mult(col, prev);
+      }
+
+      // first reduction: (B r, r) and C = (A P)^T V
+      Vp->GetColumnReference(0, col);
+      buf(0) = col * r;
+      if (i > 0)
+      {
+         MultAtB(*APp, *Vp, C);
+         for (int l = 0; l < st2; l++) { buf(1 + l) = C.GetData()[l]; }
+      }
+      SumDots(buf.GetData(), (i > 0) ? 1 + st2 : 1);
+      gamma = buf(0);
+      MFEM_ASSERT(IsFinite(gamma), "gamma = " << gamma);
+
+      if (i == 0)
+      {
+         nom0 = gamma;
+         r0 = std::max(gamma*rel_tol*rel_tol, abs_tol*abs_tol);
+      }
+      if (print_level == 1 || (print_level == 3 && i == 0))
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                   << gamma << (print_level == 3 ? " ...\n" : "\n");
+      }
+      if (gamma <= r0)
+      {
+         if (print_level == 2)
+         {
+            mfem::out << "Number of SStepCG iterations: " << i << '\n';
+         }
+         else if (print_level == 3 && i > 0)
+         {
+            mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                      << gamma << '\n';
+         }
+         converged = 1;
+         break;
+      }
+      if (i >= max_iter)
+      {
+         break;
+      }
+
+      if (i > 0)
+      {
+         // make the block A-conjugate to the previous one:
+         // V += P Beta, W += (A P) Beta, with Beta = -G^{-1} C
+         for (int l = 0; l < st2; l++) { C.GetData()[l] = buf(1 + l); }
+         DenseMatrixInverse Ginv(G);
+         Ginv.Mult(C, Beta);
+         Beta.Neg();
+         AddMult(*Pp, Beta, *Vp);
+         AddMult(*APp, Beta, *Wp);
+      }
+
+      // second reduction: G = V^T A V and g = V^T r
+      MultAtB(*Vp, *Wp, G);
+      Vp->MultTranspose(r, g);
+      for (int l = 0; l < st2; l++) { buf(l) = G.GetData()[l]; }
+      SumDots(buf.GetData(), st2 + st);
+      for (int l = 0; l < st2; l++) { G.GetData()[l] = buf(l); }
+
+      // x += V a, r -= W a, with a = G^{-1} g
+      DenseMatrixInverse Ginv(G);
+      Ginv.Mult(g, a);
+      MFEM_ASSERT(IsFinite(a.Norml2()), "singular s-step Gram matrix");
+      Vp->AddMult(a, x);
+      Wp->AddMult_a(-1.0, a, r);
+
+      std::swap(Vp, Pp);
+      std::swap(Wp, APp);
+   }
+   final_iter = converged ? i : max_iter;
+   final_norm = sqrt(gamma);
+   if (print_level >= 0 && !converged)
+   {
+      if (print_level != 1)
+      {
+         if (print_level != 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                      << nom0 << " ...\n";
+         }
+         mfem::out << "   Iteration : " << setw(3) << i
+                   << "  (B r, r) = " << gamma << '\n';
+      }
+      mfem::out << "SStepCG: No convergence!" << '\n';
+   }
+}
+
+
+namespace internal
+{
+
+// Vectors referencing the first n columns of a DenseMatrix, for the products
+// with several vectors, Operator::ArrayMult().
+class ColumnVectors
+{
+private:
+   Array<Vector *> cols;
+   Array<const Vector *> const_cols;
+
+public:
+   ColumnVectors(DenseMatrix &M, int n) : cols(n), const_cols(n)
+   {
+      for (int j = 0; j < n; j++)
+      {
+         cols[j] = new Vector(M.GetColumn(j), M.Height());
+         const_cols[j] = cols[j];
+      }
+   }
+
+   Array<Vector *> &Get() { return cols; }
+   const Array<const Vector *> &GetConst() const { return const_cols; }
+
+   ~ColumnVectors()
+   {
+      for (int j = 0; j < cols.Size(); j++) { delete cols[j]; }
+   }
+};
+
+}
+
+static void MakeConst(const Array<Vector *> &X, Array<const Vector *> &cX)
+{
+   cX.SetSize(X.Size());
+   for (int i = 0; i < X.Size(); i++) { cX[i] = X[i]; }
+}
+
+int BlockCGSolver::Orthonormalize(int k) const
+{
+   // relative size of the part of a vector orthogonal to the previous ones,
+   // below which it is dropped
+   const double drop_tol = 1e-6;
+   const int n = Z.Height();
+
+   // Gram matrix G = Z^T Z
+   G.SetSize(k);
+   MultAtB(Z, Z, G);
+   SumDots(G.Data(), k*k);
+
+   // Cholesky factorization U^T U of the Gram matrix of the kept vectors,
+   // stored in C; a vector is dropped when its pivot is too small.
+   Array<int> keep(k);
+   C.SetSize(k);
+   int s = 0;
+   for (int j = 0; j < k; j++)
+   {
+      double d = G(j,j);
+      for (int a = 0; a < s; a++)
+      {
+         double u = G(keep[a],j);
+         for (int b = 0; b < a; b++) { u -= C(b,a)*C(b,s); }
+         C(a,s) = u/C(a,a);
+         d -= C(a,s)*C(a,s);
+      }
+      if (d > drop_tol*drop_tol*G(j,j))
+      {
+         C(s,s) = sqrt(d);
+         keep[s++] = j;
+      }
+   }
+
+   // P = Z(:,keep) U^{-1}
+   DenseMatrix T(k, s), Ps(P.Data(), n, s);
+   T = 0.0;
+   for (int b = 0; b < s; b++)
+   {
+      T(keep[b],b) = 1.0/C(b,b);
+      for (int a = b-1; a >= 0; a--)
+      {
+         double t = 0.0;
+         for (int c = a+1; c <= b; c++) { t += C(a,c)*T(keep[c],b); }
+         T(keep[a],b) = -t/C(a,a);
+      }
+   }
+   mfem::Mult(Z, T, Ps);
+   return s;
+}
+
+void BlockCGSolver::Mult(const Vector &b, Vector &x) const
+{
+   Array<const Vector *> B(1);
+   Array<Vector *> X(1);
+   B[0] = &b;
+   X[0] = &x;
+   ArrayMult(B, X);
+}
+
+void BlockCGSolver::ArrayMult(const Array<const Vector *> &B,
+                              Array<Vector *> &X) const
+{
+   MFEM_VERIFY(B.Size() == X.Size(), "incompatible number of vectors");
+   const int n = width, k = B.Size();
+   R.SetSize(n, k);
+   Z.SetSize(n, k);
+   P.SetSize(n, k);
+   Q.SetSize(n, k);
+   buf.SetSize(2*k*k + k);
+   ipiv.SetSize(k);
+   internal::ColumnVectors Rc(R, k), Zc(Z, k);
+
+   if (iterative_mode)
+   {
+      Array<const Vector *> cX;
+      MakeConst(X, cX);
+      oper->ArrayMult(cX, Rc.Get());
+      for (int c = 0; c < k; c++)
+      {
+         subtract(*B[c], *Rc.Get()[c], *Rc.Get()[c]); // r = b - A x
+      }
+   }
+   else
+   {
+      for (int c = 0; c < k; c++)
+      {
+         *Rc.Get()[c] = *B[c];
+         *X[c] = 0.0;
+      }
+   }
+
+   if (prec)
+   {
+      prec->ArrayMult(Rc.GetConst(), Zc.Get()); // Z = B R
+   }
+   else
+   {
+      Z = R;
+   }
+
+   // (B r, r) and the stopping tolerance for each right-hand side
+   Vector nom(k), r0(k);
+   for (int c = 0; c < k; c++) { nom(c) = (*Zc.Get()[c]) * (*Rc.Get()[c]); }
+   SumDots(nom.GetData(), k);
+   bool done = true;
+   for (int c = 0; c < k; c++)
+   {
+      MFEM_ASSERT(IsFinite(nom(c)), "nom = " << nom(c));
+      r0(c) = std::max(nom(c)*rel_tol*rel_tol, abs_tol*abs_tol);
+      done = done && (nom(c) <= r0(c));
+   }
+   const double nom0 = (k > 0) ? nom.Max() : 0.0;
+   double betanom = nom0;
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                << nom0 << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   converged = done;
+   final_iter = 0;
+   int s = done ? 0 : Orthonormalize(k); // P = orth(Z)
+   for (int i = 1; !converged && s > 0 && i <= max_iter; i++)
+   {
+      DenseMatrix Ps(P.Data(), n, s), Qs(Q.Data(), n, s);
+      internal::ColumnVectors Pc(P, s), Qc(Q, s);
+      oper->ArrayMult(Pc.GetConst(), Qc.Get()); // Q = A P
+
+      // first reduction: G = P^T Q and C = P^T R
+      DenseMatrix PtQ(buf.GetData(), s, s), PtR(buf.GetData() + s*s, s, k);
+      MultAtB(Ps, Qs, PtQ);
+      MultAtB(Ps, R, PtR);
+      SumDots(buf.GetData(), s*s + s*k);
+      G = PtQ;
+      C = PtR;
+      LUFactors lu(G.Data(), ipiv.GetData());
+      lu.Factor(s);
+
+      // X += P alpha, R -= Q alpha, with alpha = G^{-1} C
+      lu.Solve(s, k, C.Data());
+      for (int c = 0; c < k; c++)
+      {
+         Vector alpha(C.GetColumn(c), s);
+         Ps.AddMult(alpha, *X[c]);
+      }
+      C.Neg();
+      AddMult(Qs, C, R);
+
+      if (prec)
+      {
+         prec->ArrayMult(Rc.GetConst(), Zc.Get()); // Z = B R
+      }
+      else
+      {
+         Z = R;
+      }
+
+      // second reduction: Q^T Z and (B r, r)
+      DenseMatrix QtZ(buf.GetData(), s, k);
+      MultAtB(Qs, Z, QtZ);
+      for (int c = 0; c < k; c++)
+      {
+         buf(s*k + c) = (*Zc.Get()[c]) * (*Rc.Get()[c]);
+      }
+      SumDots(buf.GetData(), s*k + k);
+      done = true;
+      for (int c = 0; c < k; c++)
+      {
+         nom(c) = buf(s*k + c);
+         MFEM_ASSERT(IsFinite(nom(c)), "betanom = " << nom(c));
+         done = done && (nom(c) <= r0(c));
+      }
+      betanom = nom.Max();
+      final_iter = i;
+
+      if (print_level == 1 || (print_level == 3 && done))
+      {
+         mfem::out << "   Iteration : " << setw(3) << i << "  (B r, r) = "
+                   << betanom << '\n';
+      }
+      if (done)
+      {
+         if (print_level == 2)
+         {
+            mfem::out << "BlockCG: Number of iterations: " << i << '\n';
+         }
+         converged = 1;
+         break;
+      }
+
+      // P = orth(Z + P beta), with beta = -G^{-1} Q^T Z
+      C = QtZ;
+      lu.Solve(s, k, C.Data());
+      C.Neg();
+      AddMult(Ps, C, Z);
+      s = Orthonormalize(k);
+   }
+   final_norm = sqrt(betanom);
+   if (print_level >= 0 && !converged)
+   {
+      if (print_level != 1)
+      {
+         if (print_level != 3)
+         {
+            mfem::out << "   Iteration : " << setw(3) << 0 << "  (B r, r) = "
+                      << nom0 << " ...\n";
+         }
+         mfem::out << "   Iteration : " << setw(3) << final_iter
+                   << "  (B r, r) = " << betanom << '\n';
+      }
+      mfem::out << "BlockCG: No convergence!" << '\n';
+   }
+}
+
 
 inline void GeneratePlaneRotation(double &dx, double &dy,
                                   double &cs, double &sn)
@@ -526,10 +1239,19 @@ void GMRESSolver::Mult(const Vector &b, Vector &x) const
 
    int n = width;
 
-   DenseMatrix H(m+1, m);
-   Vector s(m+1), cs(m+1), sn(m+1);
-   Vector r(n), w(n);
-   Array<Vector *> v;
+   // The workspace is reallocated only when the sizes change.
+   H.SetSize(m+1, m);
+   s.SetSize(m+1);
+   cs.SetSize(m+1);
+   sn.SetSize(m+1);
+   r.SetSize(n);
+   w.SetSize(n);
+   if (v.Size() != m+1 || (v[0] && v[0]->Size() != n))
+   {
+      for (int l = 0; l < v.Size(); l++) { delete v[l]; }
+      v.SetSize(m+1);
+      v = NULL;
+   }
 
    double resid;
    int i, j, k;
@@ -586,8 +1308,6 @@ void GMRESSolver::Mult(const Vector &b, Vector &x) const
                 << "  ||B r|| = " << beta << (print_level == 3 ? " ...\n" : "\n");
    }
 
-   v.SetSize(m+1, NULL);
-
    for (j = 1; j <= max_iter; )
    {
       if (v[0] == NULL) { v[0] = new Vector(n); }
@@ -606,13 +1326,17 @@ void GMRESSolver::Mult(const Vector &b, Vector &x) const
             oper->Mult(*v[i], w);
          }
 
+         // Modified Gram-Schmidt: the update of w with v[k] is fused with
+         // the inner product with v[k+1], or with ||w||^2 for k = i.
+         double h = Dot(w, *v[0]);
          for (k = 0; k <= i; k++)
          {
-            H(k,i) = Dot(w, *v[k]);  // H(k,i) = w * v[k]
-            w.Add(-H(k,i), *v[k]);   // w -= H(k,i) * v[k]
+            H(k,i) = h;              // H(k,i) = w * v[k]
+            h = AddAndDot(w, -H(k,i), *v[k], w, (k < i) ? *v[k+1] : w);
+            SumDots(&h, 1);          // w -= H(k,i) * v[k]
          }
 
-         H(i+1,i) = Norm(w);           // H(i+1,i) = ||w||
+         H(i+1,i) = sqrt(h);           // H(i+1,i) = ||w||
          MFEM_ASSERT(IsFinite(H(i+1,i)), "Norm(w) = " << H(i+1,i));
          if (v[i+1] == NULL) { v[i+1] = new Vector(n); }
          v[i+1]->Set(1.0/H(i+1,i), w); // v[i+1] = w / H(i+1,i)
@@ -693,7 +1417,11 @@ finish:
    {
       mfem::out << "GMRES: No convergence!\n";
    }
-   for (i = 0; i < v.Size(); i++)
+}
+
+GMRESSolver::~GMRESSolver()
+{
+   for (int i = 0; i < v.Size(); i++)
    {
       delete v[i];
    }
@@ -846,6 +1574,288 @@ void FGMRESSolver::Mult(const Vector &b, Vector &x) const
 }
 
 
+static void SetBlockSize(Array<Vector *> &V, int k, int n)
+{
+   if (V.Size() != k || (k > 0 && V[0]->Size() != n))
+   {
+      for (int l = 0; l < V.Size(); l++) { delete V[l]; }
+      V.SetSize(k);
+      for (int l = 0; l < k; l++) { V[l] = new Vector(n); }
+   }
+}
+
+double BlockGMRESSolver::Orthonormalize(int nb, Vector &w, double *hw) const
+{
+   // relative size of the part of w orthogonal to v[0..nb), below which w is
+   // considered to be in their span
+   const double drop_tol = 1e-10;
+   h.SetSize(nb+1);
+   for (int l = 0; l < nb; l++) { hw[l] = 0.0; }
+   double norm0 = 0.0, norm = 0.0;
+   bool replaced = false;
+   for (int attempt = 0; attempt < 2; attempt++)
+   {
+      // two passes of classical Gram-Schmidt, with one reduction each; the
+      // first one also computes ||w||
+      for (int pass = 0; pass < 2; pass++)
+      {
+         for (int l = 0; l < nb; l++) { h(l) = (*v[l]) * w; }
+         h(nb) = w * w;
+         SumDots(h.GetData(), nb+1);
+         if (pass == 0) { norm0 = sqrt(h(nb)); }
+         for (int l = 0; l < nb; l++)
+         {
+            w.Add(-h(l), *v[l]);
+            if (!replaced) { hw[l] += h(l); }
+         }
+      }
+      norm = Norm(w);
+      MFEM_ASSERT(IsFinite(norm), "Norm(w) = " << norm);
+      if (norm > drop_tol*norm0) { break; }
+      // w is numerically in the span of v[0..nb): extend the basis with a
+      // random vector instead, with a zero coefficient
+      MFEM_VERIFY(!replaced, "the Krylov basis spans the whole space");
+      w.Randomize(nb+1);
+      replaced = true;
+   }
+   if (v[nb] == NULL) { v[nb] = new Vector(w.Size()); }
+   v[nb]->Set(1.0/norm, w);
+   return replaced ? 0.0 : norm;
+}
+
+void BlockGMRESSolver::UpdateSolution(int nc, Array<Vector *> &X) const
+{
+   Vector y(nc);
+   for (int c = 0; c < X.Size(); c++)
+   {
+      // back-solve with the triangular H
+      for (int i = 0; i < nc; i++) { y(i) = S(i,c); }
+      for (int i = nc-1; i >= 0; i--)
+      {
+         y(i) /= H(i,i);
+         for (int l = i-1; l >= 0; l--) { y(l) -= H(l,i)*y(i); }
+      }
+      for (int i = 0; i < nc; i++) { X[c]->Add(y(i), *v[i]); }
+   }
+}
+
+void BlockGMRESSolver::Residual(const Array<const Vector *> &B,
+                                Array<Vector *> &X, bool zero_x) const
+{
+   const int k = B.Size();
+   if (zero_x)
+   {
+      for (int c = 0; c < k; c++)
+      {
+         *T[c] = *B[c];
+         *X[c] = 0.0;
+      }
+   }
+   else
+   {
+      Array<const Vector *> cX;
+      MakeConst(X, cX);
+      oper->ArrayMult(cX, T);
+      for (int c = 0; c < k; c++) { subtract(*B[c], *T[c], *T[c]); }
+   }
+   if (prec)
+   {
+      Array<const Vector *> cT;
+      MakeConst(T, cT);
+      prec->ArrayMult(cT, W); // W = M (B - A X)
+   }
+   else
+   {
+      for (int c = 0; c < k; c++) { *W[c] = *T[c]; }
+   }
+
+   // QR factorization of W: the first block of the basis and the right-hand
+   // side S of the least squares problems
+   S = 0.0;
+   for (int c = 0; c < k; c++)
+   {
+      S(c,c) = Orthonormalize(c, *W[c], &S(0,c));
+   }
+}
+
+void BlockGMRESSolver::Mult(const Vector &b, Vector &x) const
+{
+   Array<const Vector *> B(1);
+   Array<Vector *> X(1);
+   B[0] = &b;
+   X[0] = &x;
+   ArrayMult(B, X);
+}
+
+void BlockGMRESSolver::ArrayMult(const Array<const Vector *> &B,
+                                 Array<Vector *> &X) const
+{
+   // Block GMRES: iteration i adds the block v[(i+1)k, (i+2)k) to the basis,
+   // and column c of the block gives column i k + c of the band Hessenberg
+   // matrix H, with lower bandwidth k. The k subdiagonal entries of each
+   // column are eliminated with Givens rotations of adjacent rows, which are
+   // applied to the k columns of S; the residual norms of the least squares
+   // problems are then the norms of the last k rows of S.
+   MFEM_VERIFY(B.Size() == X.Size(), "incompatible number of vectors");
+   const int n = width, k = B.Size(), mk = m*k;
+
+   // The workspace is reallocated only when the sizes change.
+   H.SetSize(mk+k, mk);
+   S.SetSize(mk+k, k);
+   cs.SetSize(mk*k);
+   sn.SetSize(mk*k);
+   target.SetSize(k);
+   if (v.Size() != mk+k || (v[0] && v[0]->Size() != n))
+   {
+      for (int l = 0; l < v.Size(); l++) { delete v[l]; }
+      v.SetSize(mk+k);
+      v = NULL;
+   }
+   SetBlockSize(W, k, n);
+   SetBlockSize(T, k, n);
+   Array<const Vector *> Vi(k);
+   Vector resid(k);
+
+   Residual(B, X, !iterative_mode);
+   bool done = true;
+   for (int c = 0; c < k; c++)
+   {
+      // ||M r|| from the QR factors
+      double beta = 0.0;
+      for (int a = 0; a <= c; a++) { beta += S(a,c)*S(a,c); }
+      resid(c) = sqrt(beta);
+      target(c) = std::max(rel_tol*resid(c), abs_tol);
+      done = done && (resid(c) <= target(c));
+   }
+   final_norm = (k > 0) ? resid.Max() : 0.0;
+   final_iter = 0;
+   converged = done;
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << 1
+                << "   Iteration : " << setw(3) << 0
+                << "  ||B r|| = " << final_norm
+                << (print_level == 3 ? " ...\n" : "\n");
+   }
+
+   for (int j = 1; !converged && j <= max_iter; )
+   {
+      int i;
+      for (i = 0; i < m && j <= max_iter; i++, j++)
+      {
+         for (int c = 0; c < k; c++) { Vi[c] = v[i*k + c]; }
+         if (prec)
+         {
+            oper->ArrayMult(Vi, T);
+            Array<const Vector *> cT;
+            MakeConst(T, cT);
+            prec->ArrayMult(cT, W); // W = M A V_i
+         }
+         else
+         {
+            oper->ArrayMult(Vi, W);
+         }
+
+         for (int c = 0; c < k; c++)
+         {
+            const int col = i*k + c;
+            H(col+k,col) = Orthonormalize(col+k, *W[c], &H(0,col));
+
+            for (int p = 0; p < col; p++)
+            {
+               for (int l = k; l >= 1; l--)
+               {
+                  ApplyPlaneRotation(H(p+l-1,col), H(p+l,col),
+                                     cs(p*k+l-1), sn(p*k+l-1));
+               }
+            }
+            for (int l = k; l >= 1; l--)
+            {
+               const int rot = col*k + l-1;
+               GeneratePlaneRotation(H(col+l-1,col), H(col+l,col),
+                                     cs(rot), sn(rot));
+               ApplyPlaneRotation(H(col+l-1,col), H(col+l,col),
+                                  cs(rot), sn(rot));
+               for (int r = 0; r < k; r++)
+               {
+                  ApplyPlaneRotation(S(col+l-1,r), S(col+l,r),
+                                     cs(rot), sn(rot));
+               }
+            }
+         }
+
+         done = true;
+         for (int c = 0; c < k; c++)
+         {
+            double r2 = 0.0;
+            for (int a = (i+1)*k; a < (i+2)*k; a++) { r2 += S(a,c)*S(a,c); }
+            resid(c) = sqrt(r2);
+            MFEM_ASSERT(IsFinite(resid(c)), "resid = " << resid(c));
+            done = done && (resid(c) <= target(c));
+         }
+         final_norm = resid.Max();
+
+         if (done)
+         {
+            UpdateSolution((i+1)*k, X);
+            final_iter = j;
+            converged = 1;
+            break;
+         }
+
+         if (print_level == 1)
+         {
+            mfem::out << "   Pass : " << setw(2) << (j-1)/m+1
+                      << "   Iteration : " << setw(3) << j
+                      << "  ||B r|| = " << final_norm << '\n';
+         }
+      }
+      if (converged) { break; }
+
+      if (print_level == 1 && j <= max_iter)
+      {
+         mfem::out << "Restarting..." << '\n';
+      }
+
+      UpdateSolution(i*k, X);
+      Residual(B, X, false);
+      done = true;
+      for (int c = 0; c < k; c++)
+      {
+         double beta = 0.0;
+         for (int a = 0; a <= c; a++) { beta += S(a,c)*S(a,c); }
+         resid(c) = sqrt(beta);
+         done = done && (resid(c) <= target(c));
+      }
+      final_norm = resid.Max();
+      final_iter = j-1;
+      converged = done;
+   }
+
+   if (print_level == 1 || print_level == 3)
+   {
+      mfem::out << "   Pass : " << setw(2) << (final_iter-1)/m+1
+                << "   Iteration : " << setw(3) << final_iter
+                << "  ||B r|| = " << final_norm << '\n';
+   }
+   else if (print_level == 2)
+   {
+      mfem::out << "BlockGMRES: Number of iterations: " << final_iter << '\n';
+   }
+   if (print_level >= 0 && !converged)
+   {
+      mfem::out << "BlockGMRES: No convergence!\n";
+   }
+}
+
+BlockGMRESSolver::~BlockGMRESSolver()
+{
+   for (int l = 0; l < v.Size(); l++) { delete v[l]; }
+   for (int l = 0; l < W.Size(); l++) { delete W[l]; }
+   for (int l = 0; l < T.Size(); l++) { delete T[l]; }
+}
+
 int GMRES(const Operator &A, Vector &x, const Vector &b, Solver &M,
           int &max_iter, int m, double &tol, double atol, int printit)
 {
@@ -903,7 +1913,9 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
    }
    rtilde = r;
 
-   resid = Norm(r);
+   // (rtilde, r) is computed with ||r||, see below
+   rho_1 = Dot(r, r);
+   resid = sqrt(rho_1);
    MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
    if (print_level >= 0)
       mfem::out << "   Iteration : " << setw(3) << 0
@@ -921,7 +1933,6 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
 
    for (i = 1; i <= max_iter; i++)
    {
-      rho_1 = Dot(rtilde, r);
       if (rho_1 == 0)
       {
          if (print_level >= 0)
@@ -939,8 +1950,8 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
       else
       {
          beta = (rho_1/rho_2) * (alpha/omega);
-         add(p, -omega, v, p);  //  p = p - omega * v
-         add(r, beta, p, p);    //  p = r + beta * p
+         //  p = r + beta * (p - omega * v)
+         add(1.0, r, beta, p, -beta*omega, v, p);
       }
       if (prec)
       {
@@ -952,8 +1963,10 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
       }
       oper->Mult(phat, v);     //  v = A * phat
       alpha = rho_1 / Dot(rtilde, v);
-      add(r, -alpha, v, s); //  s = r - alpha * v
-      resid = Norm(s);
+      double dots[2];
+      dots[0] = AddAndDot(r, -alpha, v, s, s); //  s = r - alpha * v
+      SumDots(dots, 1);
+      resid = sqrt(dots[0]);
       MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
       if (resid < tol_goal)
       {
@@ -978,13 +1991,18 @@ void BiCGSTABSolver::Mult(const Vector &b, Vector &x) const
          shat = s;
       }
       oper->Mult(shat, t);     //  t = A * shat
-      omega = Dot(t, s) / Dot(t, t);
-      x.Add(alpha, phat);   //  x += alpha * phat
-      x.Add(omega, shat);   //  x += omega * shat
-      add(s, -omega, t, r); //  r = s - omega * t
+      Dot2(t, s, t, dots);
+      SumDots(dots, 2);
+      omega = dots[0] / dots[1];
+      //  x += alpha * phat + omega * shat
+      add(1.0, x, alpha, phat, omega, shat, x);
+      //  r = s - omega * t, fused with ||r||^2 and (r, rtilde)
+      AddAndDot2(s, -omega, t, r, rtilde, dots);
+      SumDots(dots, 2);
 
       rho_2 = rho_1;
-      resid = Norm(r);
+      rho_1 = dots[1];
+      resid = sqrt(dots[0]);
       MFEM_ASSERT(IsFinite(resid), "resid = " << resid);
       if (print_level >= 0)
       {
@@ -1503,6 +2521,124 @@ inline void SLBQPOptimizer::print_iteration(int it, double r, double l) const
                 << ", lambda = " << l << '\n';
 }
 
+OperatorJacobiSmoother::OperatorJacobiSmoother(const Operator &A,
+                                               const Vector &diag,
+                                               const Array<int> &ess_tdof_list,
+                                               double damping_)
+   : Solver(A.Height(), false), oper(&A), dinv(diag), damping(damping_),
+     r(A.Height())
+{
+   MFEM_VERIFY(dinv.Size() == height,
+               "the diagonal does not match the operator");
+   for (int i = 0; i < ess_tdof_list.Size(); i++)
+   {
+      dinv(ess_tdof_list[i]) = 1.0;
+   }
+   for (int i = 0; i < height; i++)
+   {
+      MFEM_VERIFY(dinv(i) != 0.0, "zero diagonal in row " << i);
+      dinv(i) = 1.0/dinv(i);
+   }
+   if (damping <= 0.0)
+   {
+      const double lambda = PowerMethod().EstimateLargestEigenvalue(A, dinv);
+      MFEM_VERIFY(lambda > 0.0,
+                  "the largest eigenvalue estimate is not positive");
+      damping = 4.0/(3.0*lambda);
+   }
+}
+
+void OperatorJacobiSmoother::Mult(const Vector &b, Vector &x) const
+{
+   if (!iterative_mode)
+   {
+      for (int i = 0; i < height; i++) { x(i) = damping*dinv(i)*b(i); }
+      return;
+   }
+   oper->Mult(x, r);
+   for (int i = 0; i < height; i++) { x(i) += damping*dinv(i)*(b(i) - r(i)); }
+}
+
+void OperatorJacobiSmoother::SetOperator(const Operator &op)
+{
+   mfem_error("OperatorJacobiSmoother::SetOperator() : not supported");
+}
+
+OperatorChebyshevSmoother::OperatorChebyshevSmoother(
+   const Operator &A, const Vector &diag, const Array<int> &ess_tdof_list,
+   int order_, double max_eig_estimate_, int power_iterations)
+   : Solver(A.Height(), false), oper(&A), dinv(diag), order(order_),
+     max_eig_estimate(max_eig_estimate_), r(A.Height()), d(A.Height()),
+     z(A.Height())
+{
+   MFEM_VERIFY(dinv.Size() == height,
+               "the diagonal does not match the operator");
+   MFEM_VERIFY(order > 0, "invalid polynomial order " << order);
+   for (int i = 0; i < ess_tdof_list.Size(); i++)
+   {
+      dinv(ess_tdof_list[i]) = 1.0;
+   }
+   for (int i = 0; i < height; i++)
+   {
+      MFEM_VERIFY(dinv(i) != 0.0, "zero diagonal in row " << i);
+      dinv(i) = 1.0/dinv(i);
+   }
+   if (max_eig_estimate <= 0.0)
+   {
+      max_eig_estimate =
+         PowerMethod().EstimateLargestEigenvalue(A, dinv, power_iterations);
+      MFEM_VERIFY(max_eig_estimate > 0.0,
+                  "the largest eigenvalue estimate is not positive");
+   }
+}
+
+void OperatorChebyshevSmoother::Mult(const Vector &b, Vector &x) const
+{
+   // The power iterations underestimate the largest eigenvalue.
+   const double lmax = 1.1*max_eig_estimate, lmin = 0.3*lmax;
+   const double theta = 0.5*(lmax + lmin), delta = 0.5*(lmax - lmin);
+   const double sigma = theta/delta;
+   double rho = 1.0/sigma;
+
+   // r = D^{-1} (b - A x), the first direction is d = r/theta
+   if (iterative_mode) { oper->Mult(x, r); }
+   else { x = 0.0; r = 0.0; }
+   const int n = height;
+   const double *B = b.GetData(), *Dinv = dinv.GetData();
+   double *X = x.GetData(), *R = r.GetData(), *Dir = d.GetData();
+   const double *Z = z.GetData();
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < n; i++)
+   {
+      R[i] = Dinv[i]*(B[i] - R[i]);
+      Dir[i] = R[i]/theta;
+      X[i] += Dir[i];
+   }
+   for (int k = 1; k < order; k++)
+   {
+      oper->Mult(d, z);
+      const double rho_new = 1.0/(2.0*sigma - rho);
+      const double c1 = rho_new*rho, c2 = 2.0*rho_new/delta;
+      rho = rho_new;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for
+#endif
+      for (int i = 0; i < n; i++)
+      {
+         R[i] -= Dinv[i]*Z[i];
+         Dir[i] = c1*Dir[i] + c2*R[i];
+         X[i] += Dir[i];
+      }
+   }
+}
+
+void OperatorChebyshevSmoother::SetOperator(const Operator &op)
+{
+   mfem_error("OperatorChebyshevSmoother::SetOperator() : not supported");
+}
+
 void SLBQPOptimizer::Mult(const Vector& xt, Vector& x) const
 {
    // Based on code provided by Denis Ridzal, dridzal@sandia.gov.
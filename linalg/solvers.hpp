@@ -14,6 +14,7 @@
 
 #include "../config/config.hpp"
 #include "operator.hpp"
+#include "densemat.hpp"
 
 #ifdef MFEM_USE_MPI
 #include <mpi.h>
@@ -28,11 +29,57 @@
 namespace mfem
 {
 
+/** @brief Estimate the largest eigenvalue of B A with power iterations, where
+    A is symmetric and B is symmetric positive definite. */
+/** The estimate after each iteration is the Rayleigh quotient of B A in the A
+    inner product, (B A v, A v)/(A v, v), which is a lower bound of the
+    largest eigenvalue for A positive definite. The power iterations start
+    from the same random vector on every call. This is shared by the
+    estimates of SStepCGSolver, OperatorJacobiSmoother,
+    OperatorChebyshevSmoother, and AMGSolver. */
+class PowerMethod
+{
+private:
+#ifdef MFEM_USE_MPI
+   MPI_Comm comm; // MPI_COMM_NULL for local inner products
+#endif
+
+   double Dot(const Vector &x, const Vector &y) const;
+   double Estimate(const Operator &A, const Operator *B, const Vector *dinv,
+                   int iterations) const;
+
+public:
+   /// Use local (serial) inner products.
+   PowerMethod();
+
+#ifdef MFEM_USE_MPI
+   /// Sum the inner products over @a comm, unless it is MPI_COMM_NULL.
+   PowerMethod(MPI_Comm comm_) : comm(comm_) { }
+#endif
+
+   /** @brief Return the estimate of the largest eigenvalue of @a B @a A, or
+       of @a A if @a B is NULL, after @a iterations power iterations. */
+   double EstimateLargestEigenvalue(const Operator &A, const Operator *B,
+                                    int iterations = 20) const
+   { return Estimate(A, B, NULL, iterations); }
+
+   /** @brief Return the estimate of the largest eigenvalue of D^{-1} @a A,
+       given the inverse of the diagonal D in @a dinv, after @a iterations
+       power iterations. */
+   double EstimateLargestEigenvalue(const Operator &A, const Vector &dinv,
+                                    int iterations = 20) const
+   { return Estimate(A, NULL, &dinv, iterations); }
+};
+
+
 /// Abstract base class for iterative solver
 class IterativeSolver : public Solver
 {
 #ifdef MFEM_USE_MPI
 private:
+   mutable MPI_Request dots_request; // see StartSumDots()
+
+protected:
    int dot_prod_type; // 0 - local, 1 - global over 'comm'
    MPI_Comm comm;
 #endif
@@ -50,6 +97,16 @@ protected:
 
    double Dot(const Vector &x, const Vector &y) const;
    double Norm(const Vector &x) const { return sqrt(Dot(x, x)); }
+   /** @brief Sum the @a n local inner products in @a dots over the processors,
+       as in Dot(), with a single reduction. */
+   void SumDots(double *dots, int n) const;
+   /** @brief Start summing the @a n local inner products in @a dots over the
+       processors with a non-blocking reduction; the sums are available in
+       @a dots after FinishSumDots(). */
+   /** With MPI versions before 3.0, the reduction is blocking. */
+   void StartSumDots(double *dots, int n) const;
+   /// Complete the reduction started by StartSumDots().
+   void FinishSumDots() const;
 
 public:
    IterativeSolver();
@@ -139,12 +196,147 @@ void PCG(const Operator &A, Solver &B, const Vector &b, Vector &x,
          double RTOLERANCE = 1e-12, double ATOLERANCE = 1e-24);
 
 
+/** @brief Pipelined conjugate gradient method of P. Ghysels and W. Vanroose,
+    "Hiding global synchronization latency in the preconditioned Conjugate
+    Gradient algorithm", Parallel Computing, 40 (2014). */
+/** The two inner products of an iteration are summed with a single
+    non-blocking reduction, which is overlapped with the application of the
+    preconditioner and the operator. All the vector updates of an iteration
+    are done in one sweep over memory. In exact arithmetic, the iterates are
+    those of CGSolver, with the same stopping criterion, at the cost of more
+    work vectors and one more application of the operator and of the
+    preconditioner at the last iteration. The recurrences accumulate rounding
+    errors faster than CG, which limits the attainable accuracy; this is
+    remedied by replacing them periodically with the true residual, see
+    SetReplacementPeriod(). */
+class PipelinedCGSolver : public IterativeSolver
+{
+protected:
+   int replace_period; // see SetReplacementPeriod()
+   mutable Vector r, u, w, m, n, z, q, s, p;
+
+   void UpdateVectors();
+
+public:
+   PipelinedCGSolver() { replace_period = 50; }
+
+#ifdef MFEM_USE_MPI
+   PipelinedCGSolver(MPI_Comm _comm) : IterativeSolver(_comm)
+   { replace_period = 50; }
+#endif
+
+   /** @brief Recompute the residual and the auxiliary vectors from their
+       definitions every @a period iterations, default is 50; 0 disables the
+       replacement. */
+   /** Each replacement costs four applications of the operator and two of the
+       preconditioner. */
+   void SetReplacementPeriod(int period) { replace_period = period; }
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+
+/** @brief s-step (communication-avoiding) conjugate gradient method of A. T.
+    Chronopoulos and C. W. Gear, "s-step iterative methods for symmetric
+    linear systems", J. Comput. Appl. Math., 25 (1989). */
+/** Each outer iteration builds a basis of the next s Krylov directions, makes
+    it A-conjugate to the previous block, and updates the solution with the s
+    directions at once. The inner products of the s steps are summed with two
+    reductions instead of 2s. The basis vectors T_j(B A) B r use the Chebyshev
+    polynomials T_j of an interval [0, lambda_max], where lambda_max is
+    estimated with power iterations in the first call to Mult() after
+    SetOperator(); its conditioning still degrades with s, and values of s up
+    to about 8 are recommended. The stopping criterion is the one of CGSolver,
+    checked every s steps. */
+class SStepCGSolver : public IterativeSolver
+{
+protected:
+   int s_steps; // see SetStepSize()
+
+   /// Workspace: the basis V, W = A V, and the previous block P and A P.
+   mutable DenseMatrix V, W, P, AP, G, C;
+   mutable Vector r, buf;
+   /// Upper bound of the spectrum of B A, for the Chebyshev basis.
+   mutable double lambda_max;
+
+   void UpdateVectors();
+   void EstimateLargestEigenvalue() const;
+
+public:
+   SStepCGSolver() { s_steps = 4; lambda_max = 0.0; }
+
+#ifdef MFEM_USE_MPI
+   SStepCGSolver(MPI_Comm _comm) : IterativeSolver(_comm)
+   { s_steps = 4; lambda_max = 0.0; }
+#endif
+
+   /// Set the number of steps per outer iteration, s, default is 4.
+   void SetStepSize(int s) { s_steps = s; if (oper) { UpdateVectors(); } }
+
+   virtual void SetOperator(const Operator &op)
+   { IterativeSolver::SetOperator(op); UpdateVectors(); }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+};
+
+
+/** @brief Block conjugate gradient method for several right-hand sides, in
+    the breakdown-free version of H. Ji and Y.-H. Li, "A breakdown-free block
+    conjugate gradient method", BIT Numer. Math., 57 (2017). */
+/** ArrayMult() solves A X[i] = B[i] for all the right-hand sides at once:
+    each iteration applies the operator and the preconditioner to a block of
+    search directions through Operator::ArrayMult(), and sums all the inner
+    products of the block with three reductions. The search space of an
+    iteration is spanned by the preconditioned residuals of all the
+    right-hand sides, so fewer iterations than with CGSolver are needed. The
+    search directions are orthonormalized and the numerically dependent ones
+    are dropped, which handles dependent or converged right-hand sides. The
+    stopping criterion of CGSolver must hold for each right-hand side, and
+    GetFinalNorm() returns the largest sqrt((B r, r)). Mult() solves a single
+    system with the same algorithm, i.e. with preconditioned CG. */
+class BlockCGSolver : public IterativeSolver
+{
+protected:
+   /** Workspace: the blocks R, Z = B R, P and Q = A P, with one column per
+       right-hand side, and small matrices. */
+   mutable DenseMatrix R, Z, P, Q, G, C;
+   mutable Vector buf;
+   mutable Array<int> ipiv;
+
+   /** @brief Orthonormalize the @a k vectors of Z into P, dropping the
+       numerically dependent ones; return the number of vectors in P. */
+   int Orthonormalize(int k) const;
+
+public:
+   BlockCGSolver() { }
+
+#ifdef MFEM_USE_MPI
+   BlockCGSolver(MPI_Comm _comm) : IterativeSolver(_comm) { }
+#endif
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /** @brief Solve A X[i] = B[i] for all i; with iterative_mode, X is the
+       initial guess. */
+   virtual void ArrayMult(const Array<const Vector *> &B,
+                          Array<Vector *> &X) const;
+};
+
+
 /// GMRES method
 class GMRESSolver : public IterativeSolver
 {
 protected:
    int m; // see SetKDim()
 
+   /// Workspace, kept between the calls to Mult().
+   mutable DenseMatrix H;
+   mutable Vector s, cs, sn, r, w;
+   mutable Array<Vector *> v; // owned
+
 public:
    GMRESSolver() { m = 50; }
 
@@ -156,6 +348,12 @@ public:
    void SetKDim(int dim) { m = dim; }
 
    virtual void Mult(const Vector &b, Vector &x) const;
+
+   virtual ~GMRESSolver();
+
+private:
+   GMRESSolver(const GMRESSolver &);            // Prevent object copy
+   GMRESSolver &operator=(const GMRESSolver &); // Prevent object assignment
 };
 
 /// FGMRES method
@@ -176,6 +374,65 @@ public:
    virtual void Mult(const Vector &b, Vector &x) const;
 };
 
+/** @brief Block GMRES method for several right-hand sides, with left
+    preconditioning as in GMRESSolver. */
+/** ArrayMult() solves A X[i] = B[i] for all the right-hand sides at once:
+    each iteration extends the Krylov basis with one block of vectors, the
+    products of the operator and the preconditioner with the previous block,
+    computed with Operator::ArrayMult(). The residual of each right-hand side
+    is minimized over the whole basis, which reduces the number of
+    iterations compared to GMRESSolver, unless the restarts are frequent. The
+    new vectors are orthonormalized with two passes of classical Gram-Schmidt;
+    a vector in the span of the basis is replaced by a random one, which
+    handles dependent or converged right-hand sides. The stopping criterion
+    of GMRESSolver must hold for each right-hand side, and GetFinalNorm()
+    returns the largest ||B r||. */
+class BlockGMRESSolver : public IterativeSolver
+{
+protected:
+   int m; // see SetKDim()
+
+   /// Workspace, kept between the calls to ArrayMult().
+   mutable DenseMatrix H, S;
+   mutable Vector cs, sn, h, target;
+   mutable Array<Vector *> v, W, T; // owned
+
+   /** @brief Orthonormalize @a w against v[0..nb) into v[nb], storing the
+       coefficients in @a hw; return the norm of the orthogonal part. */
+   double Orthonormalize(int nb, Vector &w, double *hw) const;
+   /// Compute M (B - A X) and its QR factorization, v[0..k) and S.
+   void Residual(const Array<const Vector *> &B, Array<Vector *> &X,
+                 bool zero_x) const;
+   /// Add to X the solutions of the least squares problems of size @a nc.
+   void UpdateSolution(int nc, Array<Vector *> &X) const;
+
+public:
+   BlockGMRESSolver() { m = 10; }
+
+#ifdef MFEM_USE_MPI
+   BlockGMRESSolver(MPI_Comm _comm) : IterativeSolver(_comm) { m = 10; }
+#endif
+
+   /** @brief Set the number of iterations to perform between restarts,
+       default is 10; with k right-hand sides, the basis has (m+1) k
+       vectors. */
+   void SetKDim(int dim) { m = dim; }
+
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /** @brief Solve A X[i] = B[i] for all i; with iterative_mode, X is the
+       initial guess. */
+   virtual void ArrayMult(const Array<const Vector *> &B,
+                          Array<Vector *> &X) const;
+
+   virtual ~BlockGMRESSolver();
+
+private:
+   // Prevent object copy and assignment
+   BlockGMRESSolver(const BlockGMRESSolver &);
+   BlockGMRESSolver &operator=(const BlockGMRESSolver &);
+};
+
 /// GMRES method. (tolerances are squared)
 int GMRES(const Operator &A, Vector &x, const Vector &b, Solver &M,
           int &max_iter, int m, double &tol, double atol, int printit);
@@ -338,6 +595,83 @@ public:
 };
 
 
+/** @brief Damped Jacobi smoother for a general Operator, given its diagonal,
+    x <- x + damping D^{-1} (b - A x). */
+/** Only the action of the operator is used, so the smoother can be used with
+    matrix-free operators, e.g. from partial assembly, see
+    BilinearForm::AssembleDiagonal(). The entries of the diagonal at the
+    essential dofs are replaced by 1, as in the ConstrainedOperator of
+    Operator::FormLinearSystem(). If the damping is not positive, it is set to
+    4/(3 lambda), where lambda estimates the largest eigenvalue of D^{-1} A
+    with PowerMethod, which uses local (serial) inner products. */
+class OperatorJacobiSmoother : public Solver
+{
+protected:
+   const Operator *oper;
+   Vector dinv;
+   double damping;
+   mutable Vector r;
+
+public:
+   OperatorJacobiSmoother(const Operator &A, const Vector &diag,
+                          const Array<int> &ess_tdof_list,
+                          double damping_ = 0.0);
+
+   /// Return the damping factor, e.g. as estimated by the constructor.
+   double GetDamping() const { return damping; }
+
+   /** @brief Apply one smoothing step to @a x, which is set to zero first if
+       iterative_mode is false. */
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /// Not supported; the operator is given to the constructor.
+   virtual void SetOperator(const Operator &op);
+};
+
+/** @brief Chebyshev polynomial smoother for a general Operator, given its
+    diagonal D. */
+/** One application multiplies the error by the Chebyshev polynomial of degree
+    @a order in D^{-1} A which is the smallest on the interval
+    [0.3 lambda, lambda] of the spectrum, where lambda is 1.1 times the
+    estimate of the largest eigenvalue of D^{-1} A. This damps the upper part
+    of the spectrum, as required from a multigrid smoother. Each degree costs
+    one application of the operator and one fused (OpenMP threaded) update of
+    the vectors, so unlike Gauss-Seidel the smoother only needs the action of
+    the operator, e.g. of a matrix-free operator with the diagonal from
+    BilinearForm::AssembleDiagonal(). The polynomial is symmetric with respect
+    to the D inner product, so the smoother can be used as a preconditioner for
+    CG. The essential dofs are treated as in OperatorJacobiSmoother. */
+class OperatorChebyshevSmoother : public Solver
+{
+protected:
+   const Operator *oper;
+   Vector dinv;
+   int order;
+   double max_eig_estimate;
+   mutable Vector r, d, z;
+
+public:
+   /** @brief Create the smoother of degree @a order for the operator @a A with
+       diagonal @a diag. */
+   /** If @a max_eig_estimate is not positive, the largest eigenvalue of
+       D^{-1} A is estimated with @a power_iterations iterations of
+       PowerMethod, which use local (serial) inner products. */
+   OperatorChebyshevSmoother(const Operator &A, const Vector &diag,
+                             const Array<int> &ess_tdof_list, int order_,
+                             double max_eig_estimate_ = 0.0,
+                             int power_iterations = 20);
+
+   /// Return the estimate of the largest eigenvalue of D^{-1} A.
+   double GetMaxEigenvalueEstimate() const { return max_eig_estimate; }
+
+   /** @brief Apply the polynomial to the residual of @a x, which is set to
+       zero first if iterative_mode is false. */
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /// Not supported; the operator is given to the constructor.
+   virtual void SetOperator(const Operator &op);
+};
+
 #ifdef MFEM_USE_SUITESPARSE
 
 /// Direct sparse solver using UMFPACK
@@ -0,0 +1,650 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class SparseCholeskySolver
+
+#include "linalg.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace mfem
+{
+
+// Breadth-first search from 'root' in the subgraph (I,J) of the nodes with
+// label[v] == id, whose levels must be -1. Set the levels of the nodes which
+// are reached and list them in 'queue', in the order of the search. Return
+// the number of levels.
+static int BreadthFirstSearch(const int *I, const int *J,
+                              const Array<int> &label, int id, int root,
+                              Array<int> &level, Array<int> &queue)
+{
+   queue.SetSize(0);
+   queue.Append(root);
+   level[root] = 0;
+   for (int h = 0; h < queue.Size(); h++)
+   {
+      const int v = queue[h];
+      for (int p = I[v]; p < I[v+1]; p++)
+      {
+         const int u = J[p];
+         if (label[u] == id && level[u] < 0)
+         {
+            level[u] = level[v] + 1;
+            queue.Append(u);
+         }
+      }
+   }
+   return level[queue.Last()] + 1;
+}
+
+// Append the nested dissection ordering of the subgraph of 'nodes' of the
+// graph (I,J) to 'order'. The subgraph is divided by the level structure of a
+// breadth-first search from a pseudo-peripheral node: the separator is the
+// part of the median level adjacent to the next level, and it is ordered
+// after the two parts, which are ordered recursively.
+static void NestedDissection(const int *I, const int *J,
+                             const Array<int> &nodes, int leaf_size,
+                             Array<int> &label, Array<int> &level,
+                             int &next_id, Array<int> &order)
+{
+   const int nn = nodes.Size();
+   if (nn <= leaf_size)
+   {
+      order.Append(nodes);
+      return;
+   }
+   const int id = next_id++;
+   for (int k = 0; k < nn; k++)
+   {
+      label[nodes[k]] = id;
+      level[nodes[k]] = -1;
+   }
+
+   Array<int> queue;
+   int num_levels =
+      BreadthFirstSearch(I, J, label, id, nodes[0], level, queue);
+   if (queue.Size() < nn)
+   {
+      // Order the connected components separately. They are all listed
+      // before the recursion, which relabels the nodes.
+      Array<int> comp_nodes(queue), comp_ptr;
+      comp_ptr.Append(0);
+      comp_ptr.Append(comp_nodes.Size());
+      for (int k = 0; k < nn; k++)
+      {
+         if (level[nodes[k]] < 0)
+         {
+            BreadthFirstSearch(I, J, label, id, nodes[k], level, queue);
+            comp_nodes.Append(queue);
+            comp_ptr.Append(comp_nodes.Size());
+         }
+      }
+      for (int c = 0; c+1 < comp_ptr.Size(); c++)
+      {
+         Array<int> comp(comp_nodes.GetData() + comp_ptr[c],
+                         comp_ptr[c+1] - comp_ptr[c]);
+         NestedDissection(I, J, comp, leaf_size, label, level, next_id,
+                          order);
+      }
+      return;
+   }
+
+   // Look for a pseudo-peripheral node: restart from a node of the last
+   // level with the smallest degree while the number of levels increases.
+   for (int t = 0; t < 5; t++)
+   {
+      int root = -1, min_deg = INT_MAX;
+      for (int h = nn-1; h >= 0 && level[queue[h]] == num_levels-1; h--)
+      {
+         const int v = queue[h], deg = I[v+1] - I[v];
+         if (deg < min_deg) { root = v; min_deg = deg; }
+      }
+      for (int k = 0; k < nn; k++) { level[nodes[k]] = -1; }
+      const int nl = BreadthFirstSearch(I, J, label, id, root, level, queue);
+      if (nl <= num_levels) { break; }
+      num_levels = nl;
+   }
+   if (num_levels < 3)
+   {
+      // (nearly) complete graph
+      order.Append(nodes);
+      return;
+   }
+
+   // the median level, excluding the first and the last ones
+   Array<int> count(num_levels);
+   count = 0;
+   for (int k = 0; k < nn; k++) { count[level[nodes[k]]]++; }
+   int m = 0, sum = 0;
+   while (m < num_levels-2 && 2*(sum + count[m]) < nn) { sum += count[m++]; }
+   m = std::max(m, 1);
+
+   Array<int> part1, part2, separator;
+   for (int k = 0; k < nn; k++)
+   {
+      const int v = nodes[k], l = level[v];
+      if (l < m) { part1.Append(v); }
+      else if (l > m) { part2.Append(v); }
+      else
+      {
+         bool adjacent = false;
+         for (int p = I[v]; p < I[v+1] && !adjacent; p++)
+         {
+            adjacent = (label[J[p]] == id && level[J[p]] == m+1);
+         }
+         if (adjacent) { separator.Append(v); }
+         else { part1.Append(v); }
+      }
+   }
+   NestedDissection(I, J, part1, leaf_size, label, level, next_id, order);
+   NestedDissection(I, J, part2, leaf_size, label, level, next_id, order);
+   order.Append(separator);
+}
+
+// Compute the elimination tree 'parent' of the symmetric matrix whose entries
+// below the diagonal are listed by rows in (I,J), with Liu's algorithm; the
+// roots have parent -1.
+static void EliminationTree(int n, const Array<int> &I, const Array<int> &J,
+                            Array<int> &parent)
+{
+   Array<int> ancestor(n);
+   parent.SetSize(n);
+   for (int i = 0; i < n; i++)
+   {
+      parent[i] = ancestor[i] = -1;
+      for (int p = I[i]; p < I[i+1]; p++)
+      {
+         // walk up from J[p] to the root of its current subtree, compressing
+         // the path to i
+         int k = J[p];
+         while (ancestor[k] != -1 && ancestor[k] != i)
+         {
+            const int next = ancestor[k];
+            ancestor[k] = i;
+            k = next;
+         }
+         if (ancestor[k] == -1)
+         {
+            ancestor[k] = i;
+            parent[k] = i;
+         }
+      }
+   }
+}
+
+// List the entries of A below the diagonal in the ordering 'perm' by rows.
+static void PermutedLowerRows(const SparseMatrix &A, const Array<int> &perm,
+                              const Array<int> &iperm, Array<int> &I,
+                              Array<int> &J)
+{
+   const int n = A.Height();
+   const int *Ai = A.GetI(), *Aj = A.GetJ();
+   I.SetSize(n+1);
+   I[0] = 0;
+   J.SetSize(0);
+   for (int i = 0; i < n; i++)
+   {
+      const int r = perm[i];
+      for (int p = Ai[r]; p < Ai[r+1]; p++)
+      {
+         const int j = iperm[Aj[p]];
+         if (j < i) { J.Append(j); }
+      }
+      I[i+1] = J.Size();
+   }
+}
+
+SparseCholeskySolver::SparseCholeskySolver(FactorizationType type_)
+   : Solver(0, false), type(type_), leaf_size(64), mat(NULL) { }
+
+SparseCholeskySolver::SparseCholeskySolver(const SparseMatrix &A,
+                                           FactorizationType type_)
+   : Solver(0, false), type(type_), leaf_size(64), mat(NULL)
+{
+   SetOperator(A);
+}
+
+void SparseCholeskySolver::SetOperator(const Operator &op)
+{
+   mat = dynamic_cast<const SparseMatrix *>(&op);
+   MFEM_VERIFY(mat && mat->Finalized(),
+               "SparseCholeskySolver: the operator is not a finalized "
+               "SparseMatrix");
+   MFEM_VERIFY(mat->Height() == mat->Width(),
+               "SparseCholeskySolver: the matrix is not square");
+   height = width = mat->Height();
+
+   const int n = height, nnz = mat->NumNonZeroElems();
+   const int *I = mat->GetI(), *J = mat->GetJ();
+   bool same_pattern = (pattern_I.Size() == n+1 && pattern_J.Size() == nnz);
+   for (int i = 0; same_pattern && i <= n; i++)
+   {
+      same_pattern = (pattern_I[i] == I[i]);
+   }
+   for (int p = 0; same_pattern && p < nnz; p++)
+   {
+      same_pattern = (pattern_J[p] == J[p]);
+   }
+   if (!same_pattern)
+   {
+      Array<int>(const_cast<int *>(I), n+1).Copy(pattern_I);
+      Array<int>(const_cast<int *>(J), nnz).Copy(pattern_J);
+      Order();
+      SymbolicFactorization();
+   }
+   NumericFactorization();
+   w.SetSize(n);
+   mat = NULL;
+}
+
+void SparseCholeskySolver::Order()
+{
+   const int n = height;
+   Array<int> nodes(n), label(n), level(n);
+   for (int i = 0; i < n; i++) { nodes[i] = i; }
+   label = -1;
+   int next_id = 0;
+   perm.SetSize(0);
+   NestedDissection(mat->GetI(), mat->GetJ(), nodes, leaf_size, label, level,
+                    next_id, perm);
+   MFEM_ASSERT(perm.Size() == n, "invalid ordering");
+}
+
+void SparseCholeskySolver::SymbolicFactorization()
+{
+   const int n = height;
+   Array<int> iperm(n), LI, LJ, parent;
+   for (int i = 0; i < n; i++) { iperm[perm[i]] = i; }
+
+   // Postorder the elimination tree, so that the subtrees, and in particular
+   // the chains of the supernodes, have consecutive indices.
+   PermutedLowerRows(*mat, perm, iperm, LI, LJ);
+   EliminationTree(n, LI, LJ, parent);
+   {
+      Array<int> head(n), next(n), stack, post;
+      head = -1;
+      for (int i = n-1; i >= 0; i--)
+      {
+         if (parent[i] >= 0)
+         {
+            next[i] = head[parent[i]];
+            head[parent[i]] = i;
+         }
+      }
+      for (int root = 0; root < n; root++)
+      {
+         if (parent[root] >= 0) { continue; }
+         stack.Append(root);
+         while (stack.Size())
+         {
+            const int v = stack.Last();
+            if (head[v] >= 0)
+            {
+               // visit the next child of v
+               const int c = head[v];
+               head[v] = next[c];
+               stack.Append(c);
+            }
+            else
+            {
+               post.Append(v);
+               stack.DeleteLast();
+            }
+         }
+      }
+      Array<int> nd_perm(perm);
+      for (int i = 0; i < n; i++) { perm[i] = nd_perm[post[i]]; }
+      for (int i = 0; i < n; i++) { iperm[perm[i]] = i; }
+   }
+   PermutedLowerRows(*mat, perm, iperm, LI, LJ);
+   EliminationTree(n, LI, LJ, parent);
+
+   // Entries on or below the diagonal by columns, with sorted rows.
+   {
+      const int *Ai = mat->GetI(), *Aj = mat->GetJ();
+      col_ptr.SetSize(n+1);
+      col_ptr = 0;
+      for (int r = 0; r < n; r++)
+      {
+         for (int p = Ai[r]; p < Ai[r+1]; p++)
+         {
+            if (iperm[Aj[p]] <= iperm[r]) { col_ptr[iperm[Aj[p]]+1]++; }
+         }
+      }
+      col_ptr.PartialSum();
+      col_rows.SetSize(col_ptr[n]);
+      col_pos.SetSize(col_ptr[n]);
+      Array<int> fill(col_ptr);
+      for (int i = 0; i < n; i++)
+      {
+         const int r = perm[i];
+         for (int p = Ai[r]; p < Ai[r+1]; p++)
+         {
+            const int j = iperm[Aj[p]];
+            if (j <= i)
+            {
+               col_rows[fill[j]] = i;
+               col_pos[fill[j]] = p;
+               fill[j]++;
+            }
+         }
+      }
+   }
+
+   // Column counts of L, from the row subtrees: the nonzeros of row i of L
+   // are the nodes on the paths from the columns of row i of A to i.
+   Array<int> col_count(n), mark(n);
+   col_count = 1;
+   mark = -1;
+   for (int i = 0; i < n; i++)
+   {
+      mark[i] = i;
+      for (int p = LI[i]; p < LI[i+1]; p++)
+      {
+         for (int k = LJ[p]; mark[k] != i; k = parent[k])
+         {
+            col_count[k]++;
+            mark[k] = i;
+         }
+      }
+   }
+
+   // Relaxed supernodes: column j is added to the supernode of j-1 if j is
+   // the parent of j-1, and the dense columns of the supernode do not have
+   // too many zeros. The rows of column j-1 below j are rows of column j, so
+   // the supernode of the columns f, ..., j has the rows f, ..., j and the
+   // ones of column j below j.
+   Array<int> snode(n);
+   sfirst.SetSize(0);
+   long nnz_cols = 0;
+   for (int j = 0; j < n; j++)
+   {
+      bool merge = (j > 0 && parent[j-1] == j);
+      if (merge)
+      {
+         const long f = sfirst.Last(), nc = j - f + 1;
+         const long m = nc + col_count[j] - 1;
+         const long size = m*nc - nc*(nc - 1)/2;
+         const long zeros = size - nnz_cols - col_count[j];
+         const double max_zeros = (nc <= 4) ? 1.0 : (nc <= 16) ? 0.8 :
+                                  (nc <= 48) ? 0.1 : 0.05;
+         merge = (zeros <= max_zeros*size);
+      }
+      if (!merge)
+      {
+         sfirst.Append(j);
+         nnz_cols = 0;
+      }
+      nnz_cols += col_count[j];
+      snode[j] = sfirst.Size() - 1;
+   }
+   const int ns = sfirst.Size();
+   sfirst.Append(n);
+
+   // Supernodal elimination tree.
+   Array<int> sparent(ns);
+   schildren.MakeI(ns);
+   for (int s = 0; s < ns; s++)
+   {
+      const int p = parent[sfirst[s+1]-1];
+      sparent[s] = (p >= 0) ? snode[p] : -1;
+      if (p >= 0) { schildren.AddAColumnInRow(sparent[s]); }
+   }
+   schildren.MakeJ();
+   for (int s = 0; s < ns; s++)
+   {
+      if (sparent[s] >= 0) { schildren.AddConnection(sparent[s], s); }
+   }
+   schildren.ShiftUpI();
+
+   // Rows of the supernodes: the union of the rows of the columns of A and of
+   // the rows of the children below the supernode.
+   srows_ptr.SetSize(ns+1);
+   srows_ptr[0] = 0;
+   srows.SetSize(0);
+   mark = -1;
+   long factor_size = 0;
+   sfactor_ptr.SetSize(ns+1);
+   sfactor_ptr[0] = 0;
+   for (int s = 0; s < ns; s++)
+   {
+      const int first = sfirst[s], last = sfirst[s+1]-1;
+      const int start = srows.Size();
+      for (int j = first; j <= last; j++) { srows.Append(j); }
+      for (int j = first; j <= last; j++)
+      {
+         for (int p = col_ptr[j]; p < col_ptr[j+1]; p++)
+         {
+            const int i = col_rows[p];
+            if (i > last && mark[i] != s) { mark[i] = s; srows.Append(i); }
+         }
+      }
+      for (int k = 0; k < schildren.RowSize(s); k++)
+      {
+         const int c = schildren.GetRow(s)[k];
+         for (int p = srows_ptr[c]; p < srows_ptr[c+1]; p++)
+         {
+            const int i = srows[p];
+            if (i > last && mark[i] != s) { mark[i] = s; srows.Append(i); }
+         }
+      }
+      std::sort(srows.GetData() + start + (last - first + 1),
+                srows.GetData() + srows.Size());
+      srows_ptr[s+1] = srows.Size();
+      MFEM_ASSERT(srows_ptr[s+1] - srows_ptr[s] ==
+                  last - first + col_count[last],
+                  "inconsistent symbolic factorization");
+      factor_size += (long)(srows_ptr[s+1] - srows_ptr[s])*(last - first + 1);
+      MFEM_VERIFY(factor_size <= INT_MAX,
+                  "SparseCholeskySolver: the factor is too large");
+      sfactor_ptr[s+1] = (int)factor_size;
+   }
+
+   // Levels of the supernodes: the height of their subtree. The children
+   // precede their parents.
+   Array<int> height_of(ns);
+   int max_height = 0;
+   for (int s = 0; s < ns; s++)
+   {
+      int h = 0;
+      for (int k = 0; k < schildren.RowSize(s); k++)
+      {
+         h = std::max(h, height_of[schildren.GetRow(s)[k]] + 1);
+      }
+      height_of[s] = h;
+      max_height = std::max(max_height, h);
+   }
+   Transpose(height_of, slevels, max_height + 1);
+}
+
+void SparseCholeskySolver::FactorSupernode(int s,
+                                           Array<DenseMatrix *> &updates)
+{
+   const int first = sfirst[s], ns = sfirst[s+1] - first;
+   const int *rows = srows.GetData() + srows_ptr[s];
+   const int m = srows_ptr[s+1] - srows_ptr[s], ms = m - ns;
+
+   // Frontal matrix: the columns of the supernode, P, and the Schur
+   // complement update of the rows below it, U (lower triangles).
+   DenseMatrix P(factor.GetData() + sfactor_ptr[s], m, ns);
+   P = 0.0;
+   DenseMatrix *U = NULL;
+   if (ms > 0)
+   {
+      U = new DenseMatrix(ms);
+      *U = 0.0;
+   }
+   const double *a = mat->GetData();
+   for (int k = 0; k < ns; k++)
+   {
+      const int j = first + k;
+      for (int p = col_ptr[j], l = k; p < col_ptr[j+1]; p++)
+      {
+         while (rows[l] != col_rows[p]) { l++; }
+         P(l,k) += a[col_pos[p]];
+      }
+   }
+   Array<int> loc;
+   for (int t = 0; t < schildren.RowSize(s); t++)
+   {
+      const int c = schildren.GetRow(s)[t];
+      DenseMatrix *Uc = updates[c];
+      if (!Uc) { continue; }
+      const int mc = Uc->Height();
+      const int *crows = srows.GetData() + srows_ptr[c+1] - mc;
+      loc.SetSize(mc);
+      for (int i = 0, l = 0; i < mc; i++)
+      {
+         while (rows[l] != crows[i]) { l++; }
+         loc[i] = l;
+      }
+      for (int jc = 0; jc < mc; jc++)
+      {
+         const int lj = loc[jc];
+         for (int ic = jc; ic < mc; ic++)
+         {
+            const int li = loc[ic];
+            if (lj < ns) { P(li,lj) += (*Uc)(ic,jc); }
+            else { (*U)(li-ns,lj-ns) += (*Uc)(ic,jc); }
+         }
+      }
+      delete Uc;
+      updates[c] = NULL;
+   }
+
+   // Factor the columns of the supernode, right-looking within P.
+   for (int k = 0; k < ns; k++)
+   {
+      const double pivot = P(k,k);
+      if (type == CHOLESKY)
+      {
+         MFEM_VERIFY(pivot > 0.0, "SparseCholeskySolver: the matrix is not "
+                     "positive definite, pivot " << pivot << " in row "
+                     << perm[first+k]);
+         const double ljj = std::sqrt(pivot);
+         P(k,k) = ljj;
+         for (int i = k+1; i < m; i++) { P(i,k) /= ljj; }
+         for (int j = k+1; j < ns; j++)
+         {
+            const double ljk = P(j,k);
+            for (int i = j; i < m; i++) { P(i,j) -= P(i,k)*ljk; }
+         }
+      }
+      else
+      {
+         MFEM_VERIFY(pivot != 0.0, "SparseCholeskySolver: zero pivot in row "
+                     << perm[first+k]);
+         diag(first+k) = pivot;
+         P(k,k) = 1.0;
+         for (int i = k+1; i < m; i++) { P(i,k) /= pivot; }
+         for (int j = k+1; j < ns; j++)
+         {
+            const double djk = pivot*P(j,k);
+            for (int i = j; i < m; i++) { P(i,j) -= P(i,k)*djk; }
+         }
+      }
+   }
+
+   // U -= L21 D L21^t
+   if (ms > 0)
+   {
+      DenseMatrix L21(ms, ns), W(ms, ns);
+      for (int k = 0; k < ns; k++)
+      {
+         const double d = (type == CHOLESKY) ? 1.0 : diag(first+k);
+         for (int i = 0; i < ms; i++)
+         {
+            L21(i,k) = P(ns+i,k);
+            W(i,k) = d*P(ns+i,k);
+         }
+      }
+      AddMult_a_ABt(-1.0, W, L21, *U);
+   }
+   updates[s] = U;
+}
+
+void SparseCholeskySolver::NumericFactorization()
+{
+   const int ns = GetNumSupernodes();
+   factor.SetSize(sfactor_ptr[ns]);
+   diag.SetSize((type == LDLT) ? height : 0);
+   Array<DenseMatrix *> updates(ns);
+   updates = NULL;
+   for (int c = 0; c < slevels.Size(); c++)
+   {
+      const int *snodes = slevels.GetRow(c), nr = slevels.RowSize(c);
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for schedule(dynamic)
+#endif
+      for (int r = 0; r < nr; r++)
+      {
+         FactorSupernode(snodes[r], updates);
+      }
+   }
+}
+
+long SparseCholeskySolver::GetFactorNNZ() const
+{
+   long nnz = 0;
+   for (int s = 0; s < GetNumSupernodes(); s++)
+   {
+      const long ns = sfirst[s+1] - sfirst[s];
+      const long m = srows_ptr[s+1] - srows_ptr[s];
+      nnz += ns*(ns + 1)/2 + (m - ns)*ns;
+   }
+   return nnz;
+}
+
+void SparseCholeskySolver::Mult(const Vector &b, Vector &x) const
+{
+   const int n = height, ns = GetNumSupernodes();
+   for (int i = 0; i < n; i++) { w(i) = b(perm[i]); }
+
+   // L y = b
+   for (int s = 0; s < ns; s++)
+   {
+      const int first = sfirst[s], nc = sfirst[s+1] - first;
+      const int *rows = srows.GetData() + srows_ptr[s];
+      const int m = srows_ptr[s+1] - srows_ptr[s];
+      const double *P = factor.GetData() + sfactor_ptr[s];
+      for (int k = 0; k < nc; k++, P += m)
+      {
+         double y = w(first+k);
+         if (type == CHOLESKY) { y /= P[k]; }
+         w(first+k) = y;
+         for (int i = k+1; i < m; i++) { w(rows[i]) -= P[i]*y; }
+      }
+   }
+   if (type == LDLT)
+   {
+      for (int i = 0; i < n; i++) { w(i) /= diag(i); }
+   }
+   // L^t x = y
+   for (int s = ns-1; s >= 0; s--)
+   {
+      const int first = sfirst[s], nc = sfirst[s+1] - first;
+      const int *rows = srows.GetData() + srows_ptr[s];
+      const int m = srows_ptr[s+1] - srows_ptr[s];
+      for (int k = nc-1; k >= 0; k--)
+      {
+         const double *P = factor.GetData() + sfactor_ptr[s] + k*m;
+         double y = w(first+k);
+         for (int i = k+1; i < m; i++) { y -= P[i]*w(rows[i]); }
+         if (type == CHOLESKY) { y /= P[k]; }
+         w(first+k) = y;
+      }
+   }
+
+   for (int i = 0; i < n; i++) { x(perm[i]) = w(i); }
+}
+
+}
@@ -0,0 +1,135 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_SPARSECHOLESKY
+#define MFEM_SPARSECHOLESKY
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "../general/table.hpp"
+#include "operator.hpp"
+#include "sparsemat.hpp"
+#include "densemat.hpp"
+
+namespace mfem
+{
+
+/** @brief Direct solver for symmetric SparseMatrix systems with a supernodal
+    Cholesky, A = L L^t, or LDL^t, A = L D L^t, factorization. */
+/** SetOperator() computes a fill-reducing nested dissection ordering of the
+    graph of the matrix and the symbolic factorization (elimination tree,
+    supernodes and the sparsity of L), and then the numeric factorization. The
+    symbolic factorization is reused by the following calls to SetOperator()
+    with matrices with the same sparsity pattern, e.g. in time-dependent or
+    nonlinear problems, and only the numeric factorization is recomputed.
+
+    The numeric factorization is multifrontal: the columns of each supernode
+    are factored in a dense frontal matrix, and the Schur complement update,
+    L21 D L21^t, is a dense matrix product, AddMult_a_ABt(). The supernodes of
+    one level of the supernodal elimination tree (the supernodes at the same
+    height above the leaves) are independent, so they are factored in parallel
+    with OpenMP.
+
+    The matrix must be symmetric and store both triangles; only the entries
+    on or below the diagonal in the new ordering are read. The Cholesky
+    factorization requires a positive definite matrix. The LDL^t factorization
+    does not pivot, so it is suitable for matrices whose leading minors are
+    nonsingular in any ordering, e.g. symmetric quasi-definite matrices. */
+class SparseCholeskySolver : public Solver
+{
+public:
+   /// Factorizations, see the class description.
+   enum FactorizationType { CHOLESKY, LDLT };
+
+protected:
+   FactorizationType type;
+   int leaf_size;
+   /// The matrix in SetOperator(), NULL otherwise.
+   const SparseMatrix *mat;
+
+   /// Sparsity pattern of the matrix of the symbolic factorization.
+   Array<int> pattern_I, pattern_J;
+   /// New ordering: row i of the factor is row perm[i] of the matrix.
+   Array<int> perm;
+   /** @brief Entries of the matrix on or below the diagonal in the new
+       ordering, by columns: rows and positions in the SparseMatrix data. */
+   Array<int> col_ptr, col_rows, col_pos;
+
+   /// Supernode s has the columns sfirst[s], ..., sfirst[s+1]-1.
+   Array<int> sfirst;
+   /** @brief Row indices of the dense columns of supernode s, which start with
+       its own columns; srows_ptr[s] is the offset of the first one. */
+   Array<int> srows_ptr, srows;
+   /// Offsets of the dense columns of the supernodes in #factor.
+   Array<int> sfactor_ptr;
+   /// Children of the supernodes in the supernodal elimination tree.
+   Table schildren;
+   /// Row c lists the supernodes whose subtrees have height c.
+   Table slevels;
+
+   /** @brief Columns of the supernodes of L: the dense m x n column-major
+       matrix of the rows #srows of a supernode with n columns. */
+   Vector factor;
+   /// The diagonal D of the LDL^t factorization.
+   Vector diag;
+   mutable Vector w;
+
+   /// Compute the nested dissection ordering #perm.
+   void Order();
+
+   /// Compute the symbolic factorization of the ordering #perm.
+   void SymbolicFactorization();
+
+   void NumericFactorization();
+
+   /** @brief Factor the supernode @a s, given the Schur complement updates of
+       its children in @a updates; store its own update in @a updates. */
+   void FactorSupernode(int s, Array<DenseMatrix *> &updates);
+
+public:
+   SparseCholeskySolver(FactorizationType type_ = CHOLESKY);
+
+   /// Factor the matrix @a A.
+   SparseCholeskySolver(const SparseMatrix &A,
+                        FactorizationType type_ = CHOLESKY);
+
+   /** @brief Factor @a op, which must be a finalized and symmetric
+       SparseMatrix; the symbolic factorization is reused if the sparsity
+       pattern did not change. */
+   /** The matrix is only read in this call. */
+   virtual void SetOperator(const Operator &op);
+
+   /** @brief Set the size of the subgraphs which are not divided further by
+       the nested dissection, 64 by default; this also affects the size of
+       the supernodes. */
+   void SetLeafSize(int size) { leaf_size = size; }
+
+   /// Return the new ordering of the rows, see #perm.
+   const Array<int> &GetPermutation() const { return perm; }
+
+   /// Return the number of supernodes.
+   int GetNumSupernodes() const { return sfirst.Size() - 1; }
+
+   /** @brief Return the number of entries of L, including the diagonal and
+       the zeros stored in the dense columns of the supernodes. */
+   long GetFactorNNZ() const;
+
+   /// Solve A x = b.
+   virtual void Mult(const Vector &b, Vector &x) const;
+
+   /// Same as Mult(), since the matrix is symmetric.
+   virtual void MultTranspose(const Vector &b, Vector &x) const
+   { Mult(b, x); }
+};
+
+}
+
+#endif
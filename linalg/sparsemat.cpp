@@ -21,6 +21,9 @@
 #include <algorithm>
 #include <limits>
 #include <cstring>
+#ifdef MFEM_USE_OPENMP
+#include <omp.h>
+#endif
 
 namespace mfem
 {
@@ -38,7 +41,11 @@ SparseMatrix::SparseMatrix(int nrows, int ncols)
      ColPtrNode(NULL),
      ownGraph(true),
      ownData(true),
-     isSorted(false)
+     isSorted(false),
+     transpose_mode(TRANSPOSE_SERIAL),
+     At(NULL),
+     coo(NULL),
+     coo_num_buffers(0)
 {
    for (int i = 0; i < nrows; i++)
    {
@@ -60,7 +67,11 @@ SparseMatrix::SparseMatrix(int *i, int *j, double *data, int m, int n)
      ColPtrNode(NULL),
      ownGraph(true),
      ownData(true),
-     isSorted(false)
+     isSorted(false),
+     transpose_mode(TRANSPOSE_SERIAL),
+     At(NULL),
+     coo(NULL),
+     coo_num_buffers(0)
 {
 #ifdef MFEM_USE_MEMALLOC
    NodesMem = NULL;
@@ -78,7 +89,11 @@ SparseMatrix::SparseMatrix(int *i, int *j, double *data, int m, int n,
      ColPtrNode(NULL),
      ownGraph(ownij),
      ownData(owna),
-     isSorted(issorted)
+     isSorted(issorted),
+     transpose_mode(TRANSPOSE_SERIAL),
+     At(NULL),
+     coo(NULL),
+     coo_num_buffers(0)
 {
 #ifdef MFEM_USE_MEMALLOC
    NodesMem = NULL;
@@ -104,6 +119,10 @@ SparseMatrix::SparseMatrix(int nrows, int ncols, int rowsize)
    , ownGraph(true)
    , ownData(true)
    , isSorted(false)
+   , transpose_mode(TRANSPOSE_SERIAL)
+   , At(NULL)
+   , coo(NULL)
+   , coo_num_buffers(0)
 {
 #ifdef MFEM_USE_MEMALLOC
    NodesMem = NULL;
@@ -121,6 +140,8 @@ SparseMatrix::SparseMatrix(int nrows, int ncols, int rowsize)
 SparseMatrix::SparseMatrix(const SparseMatrix &mat, bool copy_graph)
    : AbstractSparseMatrix(mat.Height(), mat.Width())
 {
+   MFEM_VERIFY(mat.coo == NULL,
+               "cannot copy a matrix in the COO assembly mode");
    if (mat.Finalized())
    {
       const int nnz = mat.I[height];
@@ -182,6 +203,10 @@ SparseMatrix::SparseMatrix(const SparseMatrix &mat, bool copy_graph)
    ColPtrJ = NULL;
    ColPtrNode = NULL;
    isSorted = mat.isSorted;
+   transpose_mode = mat.transpose_mode;
+   At = NULL;
+   coo = NULL;
+   coo_num_buffers = 0;
 }
 
 SparseMatrix::SparseMatrix(const Vector &v)
@@ -192,6 +217,10 @@ SparseMatrix::SparseMatrix(const Vector &v)
    , ownGraph(true)
    , ownData(true)
    , isSorted(true)
+   , transpose_mode(TRANSPOSE_SERIAL)
+   , At(NULL)
+   , coo(NULL)
+   , coo_num_buffers(0)
 {
 #ifdef MFEM_USE_MEMALLOC
    NodesMem = NULL;
@@ -247,6 +276,10 @@ void SparseMatrix::SetEmpty()
    NodesMem = NULL;
 #endif
    ownGraph = ownData = isSorted = false;
+   transpose_mode = TRANSPOSE_SERIAL;
+   At = NULL;
+   coo = NULL;
+   coo_num_buffers = 0;
 }
 
 int SparseMatrix::RowSize(const int i) const
@@ -580,9 +613,9 @@ void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
 
    int *Jp = J, *Ip = I;
 
+#ifndef MFEM_USE_OPENMP
    if (a == 1.0)
    {
-#ifndef MFEM_USE_OPENMP
       for (i = j = 0; i < height; i++)
       {
          double d = 0.0;
@@ -592,29 +625,93 @@ void SparseMatrix::AddMult(const Vector &x, Vector &y, const double a) const
          }
          yp[i] += d;
       }
-#else
-      #pragma omp parallel for private(j,end)
-      for (i = 0; i < height; i++)
+   }
+   else
+   {
+      for (i = j = 0; i < height; i++)
       {
          double d = 0.0;
-         for (j = Ip[i], end = Ip[i+1]; j < end; j++)
+         for (end = Ip[i+1]; j < end; j++)
          {
             d += Ap[j] * xp[Jp[j]];
          }
-         yp[i] += d;
+         yp[i] += a * d;
+      }
+   }
+#else
+   #pragma omp parallel for private(j,end)
+   for (i = 0; i < height; i++)
+   {
+      double d = 0.0;
+      for (j = Ip[i], end = Ip[i+1]; j < end; j++)
+      {
+         d += Ap[j] * xp[Jp[j]];
       }
+      yp[i] += (a == 1.0) ? d : a * d;
+   }
 #endif
+}
+
+void SparseMatrix::ArrayMult(const Array<const Vector *> &X,
+                             Array<Vector *> &Y) const
+{
+   MFEM_VERIFY(X.Size() == Y.Size(), "incompatible number of vectors");
+   for (int v = 0; v < Y.Size(); v++)
+   {
+      *Y[v] = 0.0;
    }
-   else
+   ArrayAddMult(X, Y);
+}
+
+void SparseMatrix::ArrayAddMult(const Array<const Vector *> &X,
+                                Array<Vector *> &Y, const double a) const
+{
+   MFEM_VERIFY(X.Size() == Y.Size(), "incompatible number of vectors");
+   const int nv = X.Size();
+   if (A == NULL)
    {
-      for (i = j = 0; i < height; i++)
+      for (int v = 0; v < nv; v++)
       {
-         double d = 0.0;
-         for (end = Ip[i+1]; j < end; j++)
+         AddMult(*X[v], *Y[v], a);
+      }
+      return;
+   }
+
+   // The vectors are processed in groups of up to max_group vectors; for each
+   // group, the entries of a row are read once and the sums of the group are
+   // accumulated in registers.
+   const int max_group = 8;
+   const int *Ip = I, *Jp = J;
+   const double *Ap = A;
+   for (int v0 = 0; v0 < nv; v0 += max_group)
+   {
+      const int ng = std::min(max_group, nv - v0);
+      const double *xp[max_group];
+      double *yp[max_group];
+      for (int v = 0; v < ng; v++)
+      {
+         MFEM_ASSERT(X[v0+v]->Size() == width && Y[v0+v]->Size() == height,
+                     "incompatible vector sizes");
+         xp[v] = X[v0+v]->GetData();
+         yp[v] = Y[v0+v]->GetData();
+      }
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for
+#endif
+      for (int i = 0; i < height; i++)
+      {
+         double d[max_group];
+         for (int v = 0; v < ng; v++) { d[v] = 0.0; }
+         for (int j = Ip[i], end = Ip[i+1]; j < end; j++)
          {
-            d += Ap[j] * xp[Jp[j]];
+            const double aij = Ap[j];
+            const int col = Jp[j];
+            for (int v = 0; v < ng; v++)
+            {
+               d[v] += aij * xp[v][col];
+            }
          }
-         yp[i] += a * d;
+         for (int v = 0; v < ng; v++) { yp[v][i] += a * d[v]; }
       }
    }
 }
@@ -653,9 +750,63 @@ void SparseMatrix::AddMultTranspose(const Vector &x, Vector &y,
       return;
    }
 
+   if (transpose_mode == TRANSPOSE_CACHED)
+   {
+      EnsureMultTranspose();
+      At->AddMult(x, y, a);
+      return;
+   }
+
+   const double *xp = x.GetData();
+#ifdef MFEM_USE_OPENMP
+   if (transpose_mode == TRANSPOSE_LOCAL && omp_get_max_threads() > 1 &&
+       !omp_in_parallel())
+   {
+      // Thread 0 accumulates into y, the other threads into their part of
+      // 'buf'; the parts are then summed into y, split by columns. The buffer
+      // is local to the call, so concurrent calls do not share it.
+      Vector buf;
+      #pragma omp parallel private(i,j,end)
+      {
+         const int nt = omp_get_num_threads(), t = omp_get_thread_num();
+         #pragma omp single
+         buf.SetSize((nt-1)*width);
+
+         double *yt = (t == 0) ? yp : buf.GetData() + (t-1)*width;
+         if (t > 0)
+         {
+            for (j = 0; j < width; j++) { yt[j] = 0.0; }
+         }
+         const int r_begin = (int)(((long)height*t)/nt);
+         const int r_end = (int)(((long)height*(t+1))/nt);
+         for (i = r_begin; i < r_end; i++)
+         {
+            const double xi = a * xp[i];
+            for (j = I[i], end = I[i+1]; j < end; j++)
+            {
+               yt[J[j]] += A[j]*xi;
+            }
+         }
+         #pragma omp barrier
+
+         #pragma omp for
+         for (j = 0; j < width; j++)
+         {
+            double d = 0.0;
+            for (int s = 0; s < nt-1; s++)
+            {
+               d += buf(j + s*width);
+            }
+            yp[j] += d;
+         }
+      }
+      return;
+   }
+#endif
+
    for (i = 0; i < height; i++)
    {
-      double xi = a * x(i);
+      double xi = a * xp[i];
       end = I[i+1];
       for (j = I[i]; j < end; j++)
       {
@@ -664,11 +815,23 @@ void SparseMatrix::AddMultTranspose(const Vector &x, Vector &y,
    }
 }
 
+void SparseMatrix::EnsureMultTranspose() const
+{
+   MFEM_VERIFY(Finalized(), "Matrix must be finalized.");
+   if (At == NULL)
+   {
+      At = Transpose(*this);
+   }
+}
+
 void SparseMatrix::PartMult(
    const Array<int> &rows, const Vector &x, Vector &y) const
 {
    MFEM_VERIFY(Finalized(), "Matrix must be finalized.");
 
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
    for (int i = 0; i < rows.Size(); i++)
    {
       int r = rows[i];
@@ -687,6 +850,9 @@ void SparseMatrix::PartAddMult(
 {
    MFEM_VERIFY(Finalized(), "Matrix must be finalized.");
 
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
    for (int i = 0; i < rows.Size(); i++)
    {
       int r = rows[i];
@@ -824,6 +990,12 @@ void SparseMatrix::Finalize(int skip_zeros, bool fix_empty_rows)
    delete [] ColPtrNode;
    ColPtrNode = NULL;
 
+   if (coo)
+   {
+      FinalizeCOO(skip_zeros, fix_empty_rows);
+      return;
+   }
+
    I = new int[height+1];
    I[0] = 0;
    for (i = 1; i <= height; i++)
@@ -892,6 +1064,214 @@ void SparseMatrix::Finalize(int skip_zeros, bool fix_empty_rows)
    Rows = NULL;
 }
 
+void SparseMatrix::UseCOOAssembly()
+{
+   MFEM_VERIFY(Rows != NULL && coo == NULL,
+               "the matrix must be empty and in LIL format");
+   for (int i = 0; i < height; i++)
+   {
+      MFEM_VERIFY(Rows[i] == NULL, "the matrix must be empty");
+   }
+   delete [] Rows;
+   Rows = NULL;
+#ifdef MFEM_USE_MEMALLOC
+   delete NodesMem;
+   NodesMem = NULL;
+#endif
+
+#ifdef MFEM_USE_OPENMP
+   coo_num_buffers = omp_get_max_threads();
+#else
+   coo_num_buffers = 1;
+#endif
+   coo = new Array<COOEntry>[coo_num_buffers];
+}
+
+Array<SparseMatrix::COOEntry> &SparseMatrix::GetCOOBuffer()
+{
+#ifdef MFEM_USE_OPENMP
+   const int t = omp_get_thread_num();
+   MFEM_VERIFY(t < coo_num_buffers, "the number of threads has increased"
+               " since the call to UseCOOAssembly()");
+   return coo[t];
+#else
+   return coo[0];
+#endif
+}
+
+void SparseMatrix::CompactCOOBuffer(Array<COOEntry> &buf)
+{
+   // Only the entries added since the last compaction, after the sorted
+   // prefix, are sorted; then both parts are merged. The sort and the merge
+   // are stable, so the duplicates are summed in the order they were added,
+   // as in the LIL format. Entries that sum to zero are kept, skip_zeros is
+   // applied by Finalize().
+   COOEntry *e = buf.GetData();
+   const int n = buf.Size();
+   if (n < 2) { return; }
+   int p = 1;
+   while (p < n && !(e[p] < e[p-1])) { p++; }
+   std::stable_sort(e + p, e + n);
+   std::inplace_merge(e, e + p, e + n);
+   int m = 0;
+   for (int k = 0; k < n; m++)
+   {
+      e[m] = e[k];
+      for (k++; k < n && e[k].row == e[m].row && e[k].col == e[m].col; k++)
+      {
+         e[m].value += e[k].value;
+      }
+   }
+   buf.SetSize(m);
+}
+
+inline void SparseMatrix::AddCOO(int i, int j, double a)
+{
+   Array<COOEntry> &buf = GetCOOBuffer();
+   if (buf.Size() == buf.Capacity() && buf.Size() >= 1024)
+   {
+      // grow the buffer only if more than half of it are distinct entries
+      CompactCOOBuffer(buf);
+      if (2*buf.Size() > buf.Capacity()) { buf.Reserve(2*buf.Capacity()); }
+   }
+   const COOEntry e = { i, j, a };
+   buf.Append(e);
+}
+
+// An entry of a row in FinalizeCOO(), ordered by column.
+struct COORowEntry
+{
+   int col;
+   double value;
+   bool operator<(const COORowEntry &e) const { return (col < e.col); }
+};
+
+void SparseMatrix::FinalizeCOO(int skip_zeros, bool fix_empty_rows)
+{
+   const int nb = coo_num_buffers;
+
+   // 0. Sum the duplicates in each buffer, so that the entries below are not
+   //    sized by the number of added entries.
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int b = 0; b < nb; b++)
+   {
+      CompactCOOBuffer(coo[b]);
+   }
+
+   // 1. Counting sort of the entries by rows: count the entries of each row
+   //    in each buffer, then compute the offset of each (row, buffer) pair.
+   Array<int> offsets((nb+1)*height + 1);
+   int *cnt = offsets.GetData(); // cnt[b*height + r], b < nb
+   int *row_ptr = cnt + nb*height; // size height+1
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int b = 0; b < nb; b++)
+   {
+      int *cb = cnt + b*height;
+      for (int r = 0; r < height; r++) { cb[r] = 0; }
+      for (int k = 0; k < coo[b].Size(); k++) { cb[coo[b][k].row]++; }
+   }
+   row_ptr[0] = 0;
+   for (int r = 0; r < height; r++)
+   {
+      int n = 0;
+      for (int b = 0; b < nb; b++) { n += cnt[b*height + r]; }
+      row_ptr[r+1] = row_ptr[r] + n;
+   }
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int r = 0; r < height; r++)
+   {
+      int pos = row_ptr[r];
+      for (int b = 0; b < nb; b++)
+      {
+         const int n = cnt[b*height + r];
+         cnt[b*height + r] = pos;
+         pos += n;
+      }
+   }
+
+   // 2. Move the entries, freeing each buffer once it is copied.
+   Array<COORowEntry> entries(row_ptr[height]);
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int b = 0; b < nb; b++)
+   {
+      int *cb = cnt + b*height;
+      for (int k = 0; k < coo[b].Size(); k++)
+      {
+         const COOEntry &e = coo[b][k];
+         COORowEntry &re = entries[cb[e.row]++];
+         re.col = e.col;
+         re.value = e.value;
+      }
+      coo[b].DeleteAll();
+   }
+   delete [] coo;
+   coo = NULL;
+   coo_num_buffers = 0;
+
+   // 3. Sort each row by columns and sum the duplicates in place; 'cnt' now
+   //    stores the number of CSR entries of each row. The sort is stable, so
+   //    the duplicates are summed in the order they were added, as in the LIL
+   //    format, and entries that cancel out are skipped consistently.
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int r = 0; r < height; r++)
+   {
+      COORowEntry *re = entries.GetData() + row_ptr[r];
+      const int n = row_ptr[r+1] - row_ptr[r];
+      // a single buffer is already sorted
+      if (nb > 1) { std::stable_sort(re, re + n); }
+      int m = 0;
+      for (int k = 0; k < n; )
+      {
+         const int c = re[k].col;
+         double v = 0.0;
+         for ( ; k < n && re[k].col == c; k++) { v += re[k].value; }
+         if (skip_zeros && v == 0.0) { continue; }
+         re[m].col = c;
+         re[m].value = v;
+         m++;
+      }
+      cnt[r] = m;
+   }
+
+   // 4. Build the CSR arrays.
+   I = new int[height+1];
+   I[0] = 0;
+   for (int r = 0; r < height; r++)
+   {
+      I[r+1] = I[r] + ((fix_empty_rows && cnt[r] == 0) ? 1 : cnt[r]);
+   }
+   J = new int[I[height]];
+   A = new double[I[height]];
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int r = 0; r < height; r++)
+   {
+      const COORowEntry *re = entries.GetData() + row_ptr[r];
+      if (cnt[r] == 0 && fix_empty_rows)
+      {
+         J[I[r]] = r;
+         A[I[r]] = 1.0;
+      }
+      for (int k = 0; k < cnt[r]; k++)
+      {
+         J[I[r] + k] = re[k].col;
+         A[I[r] + k] = re[k].value;
+      }
+   }
+   isSorted = true;
+}
+
 void SparseMatrix::GetBlocks(Array2D<SparseMatrix *> &blocks) const
 {
    int br = blocks.NumRows(), bc = blocks.NumCols();
@@ -1026,6 +1406,7 @@ double SparseMatrix::IsSymmetric() const
 
 void SparseMatrix::Symmetrize()
 {
+   ResetTranspose();
    MFEM_VERIFY(Finalized(), "Matrix must be finalized.");
 
    int i, j;
@@ -1143,6 +1524,7 @@ MatrixInverse *SparseMatrix::Inverse() const
 
 void SparseMatrix::EliminateRow(int row, const double sol, Vector &rhs)
 {
+   ResetTranspose();
    RowNode *aux;
 
    MFEM_ASSERT(row < height && row >= 0,
@@ -1159,6 +1541,7 @@ void SparseMatrix::EliminateRow(int row, const double sol, Vector &rhs)
 
 void SparseMatrix::EliminateRow(int row, DiagonalPolicy dpolicy)
 {
+   ResetTranspose();
    RowNode *aux;
 
    MFEM_ASSERT(row < height && row >= 0,
@@ -1191,6 +1574,7 @@ void SparseMatrix::EliminateRow(int row, DiagonalPolicy dpolicy)
 
 void SparseMatrix::EliminateCol(int col, DiagonalPolicy dpolicy)
 {
+   ResetTranspose();
    MFEM_ASSERT(col < width && col >= 0,
                "Col " << col << " not in matrix of width " << width);
    MFEM_ASSERT(dpolicy != DIAG_KEEP, "Diagonal policy must not be DIAG_KEEP");
@@ -1232,6 +1616,7 @@ void SparseMatrix::EliminateCol(int col, DiagonalPolicy dpolicy)
 void SparseMatrix::EliminateCols(const Array<int> &cols, const Vector *x,
                                  Vector *b)
 {
+   ResetTranspose();
    if (Rows == NULL)
    {
       for (int i = 0; i < height; i++)
@@ -1263,6 +1648,7 @@ void SparseMatrix::EliminateCols(const Array<int> &cols, const Vector *x,
 void SparseMatrix::EliminateRowCol(int rc, const double sol, Vector &rhs,
                                    DiagonalPolicy dpolicy)
 {
+   ResetTranspose();
    int col;
 
    MFEM_ASSERT(rc < height && rc >= 0,
@@ -1360,6 +1746,7 @@ void SparseMatrix::EliminateRowColMultipleRHS(int rc, const Vector &sol,
                                               DenseMatrix &rhs,
                                               DiagonalPolicy dpolicy)
 {
+   ResetTranspose();
    int col;
    int num_rhs = rhs.Width();
 
@@ -1482,6 +1869,7 @@ void SparseMatrix::EliminateRowColMultipleRHS(int rc, const Vector &sol,
 
 void SparseMatrix::EliminateRowCol(int rc, DiagonalPolicy dpolicy)
 {
+   ResetTranspose();
    int col;
 
    MFEM_ASSERT(rc < height && rc >= 0,
@@ -1555,6 +1943,7 @@ void SparseMatrix::EliminateRowCol(int rc, DiagonalPolicy dpolicy)
 // the A[j] = value; and aux->Value = value; lines.
 void SparseMatrix::EliminateRowColDiag(int rc, double value)
 {
+   ResetTranspose();
    int col;
 
    MFEM_ASSERT(rc < height && rc >= 0,
@@ -1613,6 +2002,7 @@ void SparseMatrix::EliminateRowColDiag(int rc, double value)
 void SparseMatrix::EliminateRowCol(int rc, SparseMatrix &Ae,
                                    DiagonalPolicy dpolicy)
 {
+   ResetTranspose();
    int col;
 
    if (Rows)
@@ -1706,6 +2096,7 @@ void SparseMatrix::EliminateRowCol(int rc, SparseMatrix &Ae,
 
 void SparseMatrix::SetDiagIdentity()
 {
+   ResetTranspose();
    for (int i = 0; i < height; i++)
       if (I[i+1] == I[i]+1 && fabs(A[I[i]]) < 1e-16)
       {
@@ -1715,6 +2106,7 @@ void SparseMatrix::SetDiagIdentity()
 
 void SparseMatrix::EliminateZeroRows(const double threshold)
 {
+   ResetTranspose();
    int i, j;
    double zero;
 
@@ -1890,6 +2282,84 @@ void SparseMatrix::Gauss_Seidel_back(const Vector &x, Vector &y) const
    }
 }
 
+int SparseMatrix::GetRowColoring(Table &color_rows) const
+{
+   MFEM_VERIFY(Finalized() && height == width,
+               "the matrix must be finalized and square");
+
+   // Rows i and j are coupled if they share a column of the Table 'ent': the
+   // off-diagonal entry k, in row i and column j, is a column of both rows.
+   Table ent;
+   ent.MakeI(height);
+   for (int i = 0; i < height; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (J[k] == i) { continue; }
+         ent.AddAColumnInRow(i);
+         ent.AddAColumnInRow(J[k]);
+      }
+   }
+   ent.MakeJ();
+   for (int i = 0; i < height; i++)
+   {
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (J[k] == i) { continue; }
+         ent.AddConnection(i, k);
+         ent.AddConnection(J[k], k);
+      }
+   }
+   ent.ShiftUpI();
+
+   return ColorTableRows(ent, color_rows, I[height]);
+}
+
+// Relax the uncoupled rows 'rows[0..nr-1]' of the CSR matrix (I,J,A) in
+// parallel: y_i <- (1-w) y_i + w (x_i - sum_{j!=i} A_ij y_j)/A_ii.
+static void GS_RelaxRows(const int *I, const int *J, const double *A,
+                         const int *rows, int nr, const double *x, double *y,
+                         double w)
+{
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int l = 0; l < nr; l++)
+   {
+      const int i = rows[l];
+      double sum = 0.0, d = 0.0;
+      for (int k = I[i]; k < I[i+1]; k++)
+      {
+         if (J[k] == i) { d = A[k]; }
+         else { sum += A[k]*y[J[k]]; }
+      }
+      MFEM_VERIFY(d != 0.0, "zero diagonal entry in row " << i);
+      y[i] = (w == 1.0) ? (x[i] - sum)/d : (1.0 - w)*y[i] + w*(x[i] - sum)/d;
+   }
+}
+
+void SparseMatrix::Gauss_Seidel_forw(const Vector &x, Vector &y,
+                                     const Table &color_rows, double w) const
+{
+   MFEM_VERIFY(Finalized(), "Matrix must be finalized.");
+   for (int c = 0; c < color_rows.Size(); c++)
+   {
+      GS_RelaxRows(I, J, A, color_rows.GetRow(c), color_rows.RowSize(c),
+                   x.GetData(), y.GetData(), w);
+   }
+}
+
+void SparseMatrix::Gauss_Seidel_back(const Vector &x, Vector &y,
+                                     const Table &color_rows, double w) const
+{
+   MFEM_VERIFY(Finalized(), "Matrix must be finalized.");
+   for (int c = color_rows.Size()-1; c >= 0; c--)
+   {
+      GS_RelaxRows(I, J, A, color_rows.GetRow(c), color_rows.RowSize(c),
+                   x.GetData(), y.GetData(), w);
+   }
+}
+
 double SparseMatrix::GetJacobiScaling() const
 {
    MFEM_VERIFY(Finalized(), "Matrix must be finalized.");
@@ -2037,9 +2507,11 @@ void SparseMatrix::Jacobi3(const Vector &b, const Vector &x0, Vector &x1,
 void SparseMatrix::AddSubMatrix(const Array<int> &rows, const Array<int> &cols,
                                 const DenseMatrix &subm, int skip_zeros)
 {
+   ResetTranspose();
    int i, j, gi, gj, s, t;
    double a;
 
+   const bool use_coo = (coo != NULL);
    for (i = 0; i < rows.Size(); i++)
    {
       if ((gi=rows[i]) < 0) { gi = -1-gi, s = -1; }
@@ -2047,7 +2519,7 @@ void SparseMatrix::AddSubMatrix(const Array<int> &rows, const Array<int> &cols,
       MFEM_ASSERT(gi < height,
                   "Trying to insert a row " << gi << " outside the matrix height "
                   << height);
-      SetColPtr(gi);
+      if (!use_coo) { SetColPtr(gi); }
       for (j = 0; j < cols.Size(); j++)
       {
          if ((gj=cols[j]) < 0) { gj = -1-gj, t = -s; }
@@ -2066,14 +2538,126 @@ void SparseMatrix::AddSubMatrix(const Array<int> &rows, const Array<int> &cols,
             }
          }
          if (t < 0) { a = -a; }
-         _Add_(gj, a);
+         if (use_coo)
+         {
+            AddCOO(gi, gj, a);
+         }
+         else
+         {
+            _Add_(gj, a);
+         }
+      }
+      if (!use_coo) { ClearColPtr(); }
+   }
+}
+
+void SparseMatrix::ThreadSafeAddSubMatrix(const Array<int> &rows,
+                                          const Array<int> &cols,
+                                          const DenseMatrix &subm,
+                                          int skip_zeros)
+{
+   MFEM_VERIFY(Finalized(), "the matrix must be finalized");
+
+   for (int i = 0; i < rows.Size(); i++)
+   {
+      int gi = rows[i], s = 1;
+      if (gi < 0) { gi = -1-gi, s = -1; }
+      MFEM_ASSERT(gi < height, "Trying to insert a row " << gi
+                  << " outside the matrix height " << height);
+      const int *row_J = J + I[gi], row_size = I[gi+1] - I[gi];
+      double *row_A = A + I[gi];
+      for (int j = 0; j < cols.Size(); j++)
+      {
+         int gj = cols[j], t = s;
+         if (gj < 0) { gj = -1-gj, t = -s; }
+         double a = subm(i, j);
+         if (skip_zeros && a == 0.0) { continue; }
+         if (t < 0) { a = -a; }
+
+         int k;
+         if (isSorted)
+         {
+            k = std::lower_bound(row_J, row_J + row_size, gj) - row_J;
+         }
+         else
+         {
+            for (k = 0; k < row_size && row_J[k] != gj; k++) { }
+         }
+         MFEM_VERIFY(k < row_size && row_J[k] == gj,
+                     "Could not find entry for row = " << gi << ", col = "
+                     << gj);
+         row_A[k] += a;
+      }
+   }
+}
+
+void SparseMatrix::GetSubMatrixMap(const Array<int> &rows,
+                                   const Array<int> &cols, int *map) const
+{
+   MFEM_VERIFY(Finalized(), "the matrix must be finalized");
+
+   const int nnz = I[height], nr = rows.Size();
+   for (int i = 0; i < nr; i++)
+   {
+      int gi = rows[i], s = 1;
+      if (gi < 0) { gi = -1-gi, s = -1; }
+      MFEM_ASSERT(gi < height, "Trying to insert a row " << gi
+                  << " outside the matrix height " << height);
+      const int *row_J = J + I[gi], row_size = I[gi+1] - I[gi];
+      for (int j = 0; j < cols.Size(); j++)
+      {
+         int gj = cols[j], t = s;
+         if (gj < 0) { gj = -1-gj, t = -s; }
+
+         int k;
+         if (isSorted)
+         {
+            k = std::lower_bound(row_J, row_J + row_size, gj) - row_J;
+         }
+         else
+         {
+            for (k = 0; k < row_size && row_J[k] != gj; k++) { }
+         }
+         if (k < row_size && row_J[k] == gj)
+         {
+            map[i+j*nr] = (t > 0) ? I[gi] + k : -1-(I[gi] + k);
+         }
+         else
+         {
+            map[i+j*nr] = nnz;
+         }
+      }
+   }
+}
+
+void SparseMatrix::AddSubMatrixByMap(const int *map, const DenseMatrix &subm)
+{
+   MFEM_ASSERT(Finalized(), "the matrix must be finalized");
+
+   const int nnz = I[height], n = subm.Height()*subm.Width();
+   const double *s = subm.Data();
+   for (int k = 0; k < n; k++)
+   {
+      const int m = map[k];
+      if (m >= 0 && m < nnz)
+      {
+         A[m] += s[k];
+      }
+      else if (m < 0)
+      {
+         A[-1-m] -= s[k];
+      }
+      else
+      {
+         MFEM_VERIFY(s[k] == 0.0, "entry #" << k << " of the submatrix is not"
+                     " in the sparsity pattern");
       }
-      ClearColPtr();
    }
 }
 
 void SparseMatrix::Set(const int i, const int j, const double A)
 {
+   ResetTranspose();
    double a = A;
    int gi, gj, s, t;
 
@@ -2093,6 +2677,7 @@ void SparseMatrix::Set(const int i, const int j, const double A)
 
 void SparseMatrix::Add(const int i, const int j, const double A)
 {
+   ResetTranspose();
    int gi, gj, s, t;
    double a = A;
 
@@ -2107,12 +2692,18 @@ void SparseMatrix::Add(const int i, const int j, const double A)
                "Trying to insert a column " << gj << " outside the matrix width "
                << width);
    if (t < 0) { a = -a; }
+   if (coo)
+   {
+      AddCOO(gi, gj, a);
+      return;
+   }
    _Add_(gi, gj, a);
 }
 
 void SparseMatrix::SetSubMatrix(const Array<int> &rows, const Array<int> &cols,
                                 const DenseMatrix &subm, int skip_zeros)
 {
+   ResetTranspose();
    int i, j, gi, gj, s, t;
    double a;
 
@@ -2148,6 +2739,7 @@ void SparseMatrix::SetSubMatrixTranspose(const Array<int> &rows,
                                          const DenseMatrix &subm,
                                          int skip_zeros)
 {
+   ResetTranspose();
    int i, j, gi, gj, s, t;
    double a;
 
@@ -2269,6 +2861,7 @@ int SparseMatrix::GetRow(const int row, Array<int> &cols, Vector &srow) const
 void SparseMatrix::SetRow(const int row, const Array<int> &cols,
                           const Vector &srow)
 {
+   ResetTranspose();
    int gi, gj, s, t;
    double a;
 
@@ -2317,6 +2910,7 @@ void SparseMatrix::SetRow(const int row, const Array<int> &cols,
 void SparseMatrix::AddRow(const int row, const Array<int> &cols,
                           const Vector &srow)
 {
+   ResetTranspose();
    int j, gi, gj, s, t;
    double a;
 
@@ -2348,6 +2942,7 @@ void SparseMatrix::AddRow(const int row, const Array<int> &cols,
 
 void SparseMatrix::ScaleRow(const int row, const double scale)
 {
+   ResetTranspose();
    int i;
 
    if ((i=row) < 0)
@@ -2376,6 +2971,7 @@ void SparseMatrix::ScaleRow(const int row, const double scale)
 
 void SparseMatrix::ScaleRows(const Vector & sl)
 {
+   ResetTranspose();
    double scale;
    if (Rows != NULL)
    {
@@ -2407,6 +3003,7 @@ void SparseMatrix::ScaleRows(const Vector & sl)
 
 void SparseMatrix::ScaleColumns(const Vector & sr)
 {
+   ResetTranspose();
    if (Rows != NULL)
    {
       RowNode *aux;
@@ -2435,6 +3032,7 @@ void SparseMatrix::ScaleColumns(const Vector & sr)
 
 SparseMatrix &SparseMatrix::operator+=(const SparseMatrix &B)
 {
+   ResetTranspose();
    MFEM_ASSERT(height == B.height && width == B.width,
                "Mismatch of this matrix size and rhs.  This height = "
                << height << ", width = " << width << ", B.height = "
@@ -2465,6 +3063,7 @@ SparseMatrix &SparseMatrix::operator+=(const SparseMatrix &B)
 
 void SparseMatrix::Add(const double a, const SparseMatrix &B)
 {
+   ResetTranspose();
    for (int i = 0; i < height; i++)
    {
       B.SetColPtr(i);
@@ -2488,6 +3087,7 @@ void SparseMatrix::Add(const double a, const SparseMatrix &B)
 
 SparseMatrix &SparseMatrix::operator=(double a)
 {
+   ResetTranspose();
    if (Rows == NULL)
       for (int i = 0, nnz = I[height]; i < nnz; i++)
       {
@@ -2506,6 +3106,7 @@ SparseMatrix &SparseMatrix::operator=(double a)
 
 SparseMatrix &SparseMatrix::operator*=(double a)
 {
+   ResetTranspose();
    if (Rows == NULL)
       for (int i = 0, nnz = I[height]; i < nnz; i++)
       {
@@ -2744,6 +3345,8 @@ void SparseMatrix::Destroy()
    {
       delete [] ColPtrNode;
    }
+   delete At;
+   delete [] coo;
 #ifdef MFEM_USE_MEMALLOC
    if (NodesMem != NULL)
    {
@@ -2923,69 +3526,70 @@ SparseMatrix *TransposeAbstractSparseMatrix (const AbstractSparseMatrix &A,
 SparseMatrix *Mult (const SparseMatrix &A, const SparseMatrix &B,
                     SparseMatrix *OAB)
 {
-   int nrowsA, ncolsA, nrowsB, ncolsB;
-   int *A_i, *A_j, *B_i, *B_j, *C_i, *C_j, *B_marker;
-   double *A_data, *B_data, *C_data;
-   int ia, ib, ic, ja, jb, num_nonzeros;
-   int row_start, counter;
-   double a_entry, b_entry;
-   SparseMatrix *C;
-
-   nrowsA = A.Height();
-   ncolsA = A.Width();
-   nrowsB = B.Height();
-   ncolsB = B.Width();
+   const int nrowsA = A.Height();
+   const int ncolsA = A.Width();
+   const int nrowsB = B.Height();
+   const int ncolsB = B.Width();
 
    MFEM_VERIFY(ncolsA == nrowsB,
                "number of columns of A (" << ncolsA
                << ") must equal number of rows of B (" << nrowsB << ")");
 
-   A_i    = A.GetI();
-   A_j    = A.GetJ();
-   A_data = A.GetData();
-   B_i    = B.GetI();
-   B_j    = B.GetJ();
-   B_data = B.GetData();
-
-   B_marker = new int[ncolsB];
-
-   for (ib = 0; ib < ncolsB; ib++)
-   {
-      B_marker[ib] = -1;
-   }
+   const int *A_i = A.GetI(), *A_j = A.GetJ();
+   const double *A_data = A.GetData();
+   const int *B_i = B.GetI(), *B_j = B.GetJ();
+   const double *B_data = B.GetData();
+   int *C_i, *C_j;
+   double *C_data;
+   SparseMatrix *C;
 
+   // The rows of C are computed independently by the threads, each with its
+   // own dense accumulator, B_marker: a symbolic pass computes the sizes of the
+   // rows, then a numeric pass computes their columns and values. The columns
+   // of a row are stored in the order they are found, so a matrix OAB computed
+   // by a previous call with the same sparsities of A and B can be reused,
+   // skipping the symbolic pass.
    if (OAB == NULL)
    {
       C_i = new int[nrowsA+1];
-
-      C_i[0] = num_nonzeros = 0;
-      for (ic = 0; ic < nrowsA; ic++)
+      C_i[0] = 0;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel
+#endif
       {
-         for (ia = A_i[ic]; ia < A_i[ic+1]; ia++)
+         Array<int> B_marker(ncolsB);
+         B_marker = -1;
+#ifdef MFEM_USE_OPENMP
+         #pragma omp for
+#endif
+         for (int ic = 0; ic < nrowsA; ic++)
          {
-            ja = A_j[ia];
-            for (ib = B_i[ja]; ib < B_i[ja+1]; ib++)
+            int num_nonzeros = 0;
+            for (int ia = A_i[ic]; ia < A_i[ic+1]; ia++)
             {
-               jb = B_j[ib];
-               if (B_marker[jb] != ic)
+               const int ja = A_j[ia];
+               for (int ib = B_i[ja]; ib < B_i[ja+1]; ib++)
                {
-                  B_marker[jb] = ic;
-                  num_nonzeros++;
+                  const int jb = B_j[ib];
+                  if (B_marker[jb] != ic)
+                  {
+                     B_marker[jb] = ic;
+                     num_nonzeros++;
+                  }
                }
             }
+            C_i[ic+1] = num_nonzeros;
          }
-         C_i[ic+1] = num_nonzeros;
+      }
+      for (int ic = 0; ic < nrowsA; ic++)
+      {
+         C_i[ic+1] += C_i[ic];
       }
 
-      C_j    = new int[num_nonzeros];
-      C_data = new double[num_nonzeros];
+      C_j    = new int[C_i[nrowsA]];
+      C_data = new double[C_i[nrowsA]];
 
       C = new SparseMatrix (C_i, C_j, C_data, nrowsA, ncolsB);
-
-      for (ib = 0; ib < ncolsB; ib++)
-      {
-         B_marker[ib] = -1;
-      }
    }
    else
    {
@@ -2998,50 +3602,67 @@ SparseMatrix *Mult (const SparseMatrix &A, const SparseMatrix &B,
                   << " ncolsB = " << ncolsB
                   << ", C->Width() = " << C->Width());
 
-      // C_i    = C -> GetI(); // not used
+      C_i    = C -> GetI();
       C_j    = C -> GetJ();
       C_data = C -> GetData();
+      C -> ResetTranspose();
    }
 
-   counter = 0;
-   for (ic = 0; ic < nrowsA; ic++)
+   // The rows of each thread are processed in increasing order, so the markers
+   // set for the previous rows are less than the start of the current row.
+   int num_bad_rows = 0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel reduction(+:num_bad_rows)
+#endif
    {
-      // row_start = C_i[ic];
-      row_start = counter;
-      for (ia = A_i[ic]; ia < A_i[ic+1]; ia++)
+      Array<int> B_marker(ncolsB);
+      B_marker = -1;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for schedule(static)
+#endif
+      for (int ic = 0; ic < nrowsA; ic++)
       {
-         ja = A_j[ia];
-         a_entry = A_data[ia];
-         for (ib = B_i[ja]; ib < B_i[ja+1]; ib++)
+         const int row_start = C_i[ic], row_end = C_i[ic+1];
+         int counter = row_start;
+         bool bad_row = false;
+         for (int ia = A_i[ic]; ia < A_i[ic+1]; ia++)
          {
-            jb = B_j[ib];
-            b_entry = B_data[ib];
-            if (B_marker[jb] < row_start)
+            const int ja = A_j[ia];
+            const double a_entry = A_data[ia];
+            for (int ib = B_i[ja]; ib < B_i[ja+1]; ib++)
             {
-               B_marker[jb] = counter;
-               if (OAB == NULL)
+               const int jb = B_j[ib];
+               const double b_entry = B_data[ib];
+               if (B_marker[jb] < row_start)
+               {
+                  // the row of OAB is too short or its columns do not match
+                  if (counter == row_end || (OAB && C_j[counter] != jb))
+                  {
+                     bad_row = true;
+                     continue;
+                  }
+                  B_marker[jb] = counter;
+                  if (OAB == NULL)
+                  {
+                     C_j[counter] = jb;
+                  }
+                  C_data[counter] = a_entry*b_entry;
+                  counter++;
+               }
+               else
                {
-                  C_j[counter] = jb;
+                  C_data[B_marker[jb]] += a_entry*b_entry;
                }
-               C_data[counter] = a_entry*b_entry;
-               counter++;
-            }
-            else
-            {
-               C_data[B_marker[jb]] += a_entry*b_entry;
             }
          }
+         if (bad_row || counter != row_end) { num_bad_rows++; }
       }
    }
 
-   MFEM_VERIFY(
-      OAB == NULL || counter == OAB->NumNonZeroElems(),
-      "With pre-allocated output matrix, number of non-zeros ("
-      << OAB->NumNonZeroElems()
-      << ") did not match number of entries changed from matrix-matrix multiply, "
-      << counter);
-
-   delete [] B_marker;
+   MFEM_VERIFY(num_bad_rows == 0,
+               "With pre-allocated output matrix, the sparsity of "
+               << num_bad_rows << " rows did not match the entries changed "
+               "from matrix-matrix multiply");
 
    return C;
 }
@@ -3209,6 +3830,40 @@ SparseMatrix *RAP(const SparseMatrix &Rt, const SparseMatrix &A,
    return out;
 }
 
+SparseRAP::SparseRAP(const SparseMatrix &Rt, const SparseMatrix &P_)
+   : P(P_), R(Transpose(Rt)), RA(NULL)
+{
+   MFEM_VERIFY(Rt.Height() == P.Height(), "incompatible R^T and P");
+}
+
+SparseMatrix *SparseRAP::Mult(const SparseMatrix &A)
+{
+   MFEM_VERIFY(A.Height() == R->Width() && A.Width() == P.Height(),
+               "incompatible matrix A");
+   if (RA)
+   {
+      mfem::Mult(*R, A, RA);
+   }
+   else
+   {
+      RA = mfem::Mult(*R, A);
+   }
+   return mfem::Mult(*RA, P);
+}
+
+void SparseRAP::Mult(const SparseMatrix &A, SparseMatrix &RAP)
+{
+   MFEM_VERIFY(RA, "Mult(A) must be called first");
+   mfem::Mult(*R, A, RA);
+   mfem::Mult(*RA, P, &RAP);
+}
+
+SparseRAP::~SparseRAP()
+{
+   delete RA;
+   delete R;
+}
+
 SparseMatrix *Mult_AtDA (const SparseMatrix &A, const Vector &D,
                          SparseMatrix *OAtDA)
 {
@@ -3480,6 +4135,10 @@ void SparseMatrix::Swap(SparseMatrix &other)
    mfem::Swap(ownGraph, other.ownGraph);
    mfem::Swap(ownData, other.ownData);
    mfem::Swap(isSorted, other.isSorted);
+   mfem::Swap(transpose_mode, other.transpose_mode);
+   mfem::Swap(At, other.At);
+   mfem::Swap(coo, other.coo);
+   mfem::Swap(coo_num_buffers, other.coo_num_buffers);
 }
 
 }
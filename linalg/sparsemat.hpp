@@ -37,6 +37,23 @@ public:
 /// Data type sparse matrix
 class SparseMatrix : public AbstractSparseMatrix
 {
+public:
+   /// Algorithms for the products with the transpose, see MultTranspose().
+   enum MultTransposeMode
+   {
+      /// Serial loop over the rows, scattering into the result.
+      TRANSPOSE_SERIAL,
+      /** @brief The rows are split between the OpenMP threads; each thread
+          accumulates into a private vector and the vectors are then summed.
+          Without OpenMP, or with one thread, this is TRANSPOSE_SERIAL. Each
+          product allocates one vector of size Width() per additional
+          thread. */
+      TRANSPOSE_LOCAL,
+      /** @brief Threaded row-wise product with a cached CSR transpose, see
+          EnsureMultTranspose(). */
+      TRANSPOSE_CACHED
+   };
+
 protected:
    /// @name Arrays used by the CSR storage format.
    /** */
@@ -77,6 +94,36 @@ protected:
    /// Are the columns sorted already.
    bool isSorted;
 
+   /// The algorithm used by MultTranspose() and AddMultTranspose().
+   MultTransposeMode transpose_mode;
+   /// Transpose used in the TRANSPOSE_CACHED mode, see EnsureMultTranspose().
+   mutable SparseMatrix *At;
+
+   /// An entry of the coordinate (COO) format, see UseCOOAssembly().
+   struct COOEntry
+   {
+      int row, col;
+      double value;
+      bool operator<(const COOEntry &e) const
+      { return (row < e.row || (row == e.row && col < e.col)); }
+   };
+   /** @brief Per-thread buffers of the entries added in the COO assembly mode,
+       see UseCOOAssembly(); NULL in the other modes. */
+   Array<COOEntry> *coo;
+   /// Number of buffers in #coo.
+   int coo_num_buffers;
+
+   // Return the COO buffer of the calling thread.
+   Array<COOEntry> &GetCOOBuffer();
+   // Append an entry to the COO buffer of the calling thread, compacting the
+   // buffer instead of growing it when enough of its entries are duplicates.
+   void AddCOO(int i, int j, double a);
+   // Sort the entries of a COO buffer by rows and columns and sum the
+   // duplicates, in the order they were added.
+   static void CompactCOOBuffer(Array<COOEntry> &buf);
+   // Convert the COO buffers to CSR format; used by Finalize().
+   void FinalizeCOO(int skip_zeros, bool fix_empty_rows);
+
    void Destroy();   // Delete all owned data
    void SetEmpty();  // Init all entries with empty values
 
@@ -132,7 +179,25 @@ public:
    void Clear() { Destroy(); SetEmpty(); }
 
    /// Check if the SparseMatrix is empty.
-   bool Empty() const { return (A == NULL) && (Rows == NULL); }
+   bool Empty() const { return (A == NULL) && (Rows == NULL) && (coo == NULL); }
+
+   /** @brief Switch an empty matrix in LIL format, as created by
+       SparseMatrix(int, int), to the coordinate (COO) assembly mode. */
+   /** In this mode, Add(const int, const int, const double) and AddSubMatrix()
+       append the entries, without searching, to a buffer of the calling OpenMP
+       thread, so they can be called concurrently by several threads, even for
+       the same rows. Finalize() then sorts the entries by rows and columns,
+       sums the duplicates, and builds the CSR arrays, in parallel with OpenMP.
+       No other method may be used before Finalize(). When a buffer is full,
+       its duplicates are summed before it grows, so the peak memory stays
+       close to that of the LIL format. In serial, this mode is slower than
+       the LIL format, e.g. 3.6 s versus 1.7 s, with the same 453 MB peak
+       memory, for a Q2 elasticity matrix on a 14x14x14 hexahedral mesh; it
+       is useful with several threads. */
+   void UseCOOAssembly();
+
+   /// Return true if the matrix is in the COO assembly mode.
+   bool UsesCOOAssembly() const { return (coo != NULL); }
 
    /// Return the array #I
    inline int *GetI() const { return I; }
@@ -199,14 +264,57 @@ public:
    /// y += A * x (default)  or  y += a * A * x
    void AddMult(const Vector &x, Vector &y, const double a = 1.0) const;
 
+   /** @brief Matrix multiplication of several vectors, Y[i] = A X[i]; each
+       entry of a finalized matrix is read once for up to eight vectors. */
+   virtual void ArrayMult(const Array<const Vector *> &X,
+                          Array<Vector *> &Y) const;
+
+   /// Y[i] += a * A * X[i] for all i, see ArrayMult().
+   void ArrayAddMult(const Array<const Vector *> &X, Array<Vector *> &Y,
+                     const double a = 1.0) const;
+
    /// Multiply a vector with the transposed matrix. y = At * x
+   /** The algorithm is selected with SetMultTransposeMode(). */
    void MultTranspose(const Vector &x, Vector &y) const;
 
    /// y += At * x (default)  or  y += a * At * x
    void AddMultTranspose(const Vector &x, Vector &y,
                          const double a = 1.0) const;
 
+   /** @brief Select the algorithm used by MultTranspose() and
+       AddMultTranspose() for a finalized matrix; the default is
+       TRANSPOSE_SERIAL. */
+   /** Products with a matrix that is not finalized are always serial. */
+   void SetMultTransposeMode(MultTransposeMode mode)
+   {
+      transpose_mode = mode;
+      if (mode != TRANSPOSE_CACHED) { ResetTranspose(); }
+   }
+
+   /// Return the algorithm used by MultTranspose() and AddMultTranspose().
+   MultTransposeMode GetMultTransposeMode() const { return transpose_mode; }
+
+   /** @brief Build the transpose used by MultTranspose() in the
+       TRANSPOSE_CACHED mode, if it is not built yet. */
+   /** The transpose is built on the first product, so calling this method is
+       only needed to exclude the construction from timings or to build it
+       before a threaded region. The transpose is a copy: the methods that
+       modify the matrix delete it, except ThreadSafeAddSubMatrix() and
+       AddSubMatrixByMap(), which can be called by several threads. If the
+       entries are modified through them, or through the arrays returned by
+       GetData(), GetRowEntries(), or operator()(), ResetTranspose() must be
+       called. */
+   void EnsureMultTranspose() const;
+
+   /// Delete the transpose built by EnsureMultTranspose().
+   void ResetTranspose() const { if (At) { delete At; At = NULL; } }
+
+   /** @brief For all i in @a rows, set y(i) = (A x)(i); the rows are processed
+       in parallel with OpenMP. */
    void PartMult(const Array<int> &rows, const Vector &x, Vector &y) const;
+   /** @brief For all i in @a rows, add a (A x)(i) to y(i); the entries of
+       @a rows must be distinct, since they are processed in parallel with
+       OpenMP. */
    void PartAddMult(const Array<int> &rows, const Vector &x, Vector &y,
                     const double a=1.0) const;
 
@@ -291,6 +399,24 @@ public:
    void Gauss_Seidel_forw(const Vector &x, Vector &y) const;
    void Gauss_Seidel_back(const Vector &x, Vector &y) const;
 
+   /** @brief Greedy coloring of the rows such that two rows i != j with the
+       same color are not coupled, i.e. A(i,j) = A(j,i) = 0; the matrix must be
+       finalized and square. */
+   /** On return, the row c of @a color_rows lists the rows with color c.
+       Returns the number of colors. */
+   int GetRowColoring(Table &color_rows) const;
+
+   /** @brief Multicolor Gauss-Seidel forward iteration with relaxation weight
+       @a w, using the coloring @a color_rows from GetRowColoring(). */
+   /** The colors are relaxed one after the other and the rows of each color
+       in parallel with OpenMP; every row must have a nonzero diagonal entry. */
+   void Gauss_Seidel_forw(const Vector &x, Vector &y, const Table &color_rows,
+                          double w = 1.0) const;
+   /** @brief Multicolor Gauss-Seidel backward iteration, i.e. with the colors
+       in reverse order, see Gauss_Seidel_forw(). */
+   void Gauss_Seidel_back(const Vector &x, Vector &y, const Table &color_rows,
+                          double w = 1.0) const;
+
    /// Determine appropriate scaling for Jacobi iteration
    double GetJacobiScaling() const;
    /** One scaled Jacobi iteration for the system A x = b.
@@ -355,6 +481,35 @@ public:
    void AddSubMatrix(const Array<int> &rows, const Array<int> &cols,
                      const DenseMatrix &subm, int skip_zeros = 1);
 
+   /** @brief Add @a subm to a finalized matrix; the method can be called
+       concurrently by threads adding to disjoint sets of @a rows. */
+   /** Unlike AddSubMatrix(), the internal column pointers are not used, so all
+       (nonzero) entries must already be present in the sparsity pattern. The
+       transpose of the TRANSPOSE_CACHED mode is not reset, see
+       EnsureMultTranspose(). */
+   void ThreadSafeAddSubMatrix(const Array<int> &rows, const Array<int> &cols,
+                               const DenseMatrix &subm,
+                               int skip_zeros = 1);
+
+   /** @brief Compute the positions, in the data array of the finalized matrix,
+       of the entries of a @a rows x @a cols submatrix, for use with
+       AddSubMatrixByMap(). */
+   /** The rows.Size() x cols.Size() positions are stored column-major in @a
+       map, like the entries of a DenseMatrix. A position k is stored as -1-k
+       when the entry is added with a minus sign, i.e. when exactly one of its
+       row and column indices is negative, and entries outside the sparsity
+       pattern are stored as the number of stored entries, GetI()[Height()]. */
+   void GetSubMatrixMap(const Array<int> &rows, const Array<int> &cols,
+                        int *map) const;
+
+   /** @brief Add @a subm to the finalized matrix, at the positions @a map
+       computed by GetSubMatrixMap(), without searching. */
+   /** Like ThreadSafeAddSubMatrix(), the method can be called concurrently by
+       threads adding to disjoint sets of rows, and it does not reset the
+       transpose of the TRANSPOSE_CACHED mode. The entries of @a subm outside
+       the sparsity pattern must be zero. */
+   void AddSubMatrixByMap(const int *map, const DenseMatrix &subm);
+
    bool RowIsEmpty(const int row) const;
 
    /// Extract all column indices and values from a given row.
@@ -486,6 +641,37 @@ SparseMatrix *RAP(const SparseMatrix &A, const SparseMatrix &R,
 SparseMatrix *RAP(const SparseMatrix &Rt, const SparseMatrix &A,
                   const SparseMatrix &P);
 
+/** @brief Repeated RAP products, R A P with R = Rt^T, for a sequence of
+    matrices A with the same sparsity, e.g. the gradients of a NonlinearForm. */
+/** The transpose R and the intermediate product R A are kept between the
+    calls, so that after the first product only the values are recomputed,
+    skipping the transposition and the symbolic phases of the two products.
+    The matrices Rt and P are not copied and must remain valid. */
+class SparseRAP
+{
+protected:
+   const SparseMatrix &P;
+   SparseMatrix *R, *RA;
+
+public:
+   /// Prepare the products R A P with R = @a Rt^T and the given @a P.
+   SparseRAP(const SparseMatrix &Rt, const SparseMatrix &P);
+
+   /** @brief Return a new matrix R A P. The sparsity of R A is computed in the
+       first call and reused in the next calls. */
+   SparseMatrix *Mult(const SparseMatrix &A);
+
+   /** @brief Compute R A P into @a RAP, a matrix returned by Mult(A) for a
+       matrix A with the same sparsity; only the values are recomputed. */
+   void Mult(const SparseMatrix &A, SparseMatrix &RAP);
+
+   ~SparseRAP();
+
+private:
+   SparseRAP(const SparseRAP &);
+   SparseRAP &operator=(const SparseRAP &);
+};
+
 /// Matrix multiplication A^t D A. All matrices must be finalized.
 SparseMatrix *Mult_AtDA(const SparseMatrix &A, const Vector &D,
                         SparseMatrix *OAtDA = NULL);
@@ -544,6 +730,7 @@ inline void SparseMatrix::SetColPtr(const int row) const
             ColPtrJ[i] = -1;
          }
       }
+      MFEM_ASSERT(coo == NULL, "the matrix must be finalized");
       for (int j = I[row], end = I[row+1]; j < end; j++)
       {
          ColPtrJ[J[j]] = j;
@@ -638,6 +825,7 @@ inline double &SparseMatrix::SearchRow(const int row, const int col)
    }
    else
    {
+      MFEM_ASSERT(coo == NULL, "the matrix must be finalized");
       int *Ip = I+row, *Jp = J;
       for (int k = Ip[0], end = Ip[1]; k < end; k++)
       {
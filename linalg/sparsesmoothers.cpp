@@ -16,6 +16,8 @@
 #include "sparsemat.hpp"
 #include "sparsesmoothers.hpp"
 #include <iostream>
+#include <algorithm>
+#include <cmath>
 
 namespace mfem
 {
@@ -51,6 +53,329 @@ void GSSmoother::Mult(const Vector &x, Vector &y) const
    }
 }
 
+MulticolorGSSmoother::MulticolorGSSmoother(const SparseMatrix &a, int t,
+                                           int it, double w)
+   : GSSmoother(a, t, it), weight(w)
+{
+   a.GetRowColoring(color_rows);
+}
+
+void MulticolorGSSmoother::SetOperator(const Operator &a)
+{
+   SparseSmoother::SetOperator(a);
+   oper->GetRowColoring(color_rows);
+}
+
+/// Matrix vector multiplication with the multicolor GS smoother.
+void MulticolorGSSmoother::Mult(const Vector &x, Vector &y) const
+{
+   if (!iterative_mode)
+   {
+      y = 0.0;
+   }
+   for (int i = 0; i < iterations; i++)
+   {
+      if (type != 2)
+      {
+         oper->Gauss_Seidel_forw(x, y, color_rows, weight);
+      }
+      if (type != 1)
+      {
+         oper->Gauss_Seidel_back(x, y, color_rows, weight);
+      }
+   }
+}
+
+// Return the position of column j in the sorted row i of the CSR matrix
+// (I,J), or -1.
+static inline int FindColumn(const int *I, const int *J, int i, int j)
+{
+   const int *p = std::lower_bound(J + I[i], J + I[i+1], j);
+   return (p != J + I[i+1] && *p == j) ? int(p - J) : -1;
+}
+
+// Group the rows 0..n-1 in levels, where row i depends on the rows
+// J[I[i]..E[i]-1], which precede it in the order of the solve: forward, or
+// backward if 'forward' is false. The level of a row is one more than the
+// largest level of the rows it depends on, i.e. the length of the longest
+// path to it in the dependency graph; row c of 'levels' lists the rows of
+// level c.
+static void GetRowLevels(int n, const int *I, const int *E, const int *J,
+                         bool forward, Table &levels)
+{
+   Array<int> level(n);
+   int num_levels = 0;
+   for (int r = 0; r < n; r++)
+   {
+      const int i = forward ? r : n-1-r;
+      int l = 0;
+      for (int p = I[i]; p < E[i]; p++) { l = std::max(l, level[J[p]]+1); }
+      level[i] = l;
+      num_levels = std::max(num_levels, l+1);
+   }
+   Transpose(level, levels, num_levels);
+}
+
+ILUSmoother::ILUSmoother(const SparseMatrix &a)
+   : lower(NULL), upper(NULL)
+{
+   SetOperator(a);
+}
+
+void ILUSmoother::SetOperator(const Operator &a)
+{
+   SparseSmoother::SetOperator(a);
+   MFEM_VERIFY(oper->Finalized() && height == width,
+               "the matrix must be finalized and square");
+   delete lower;
+   delete upper;
+   lower = upper = NULL;
+   Factor();
+   ComputeLevels();
+   z.SetSize(height);
+}
+
+void ILUSmoother::Factor()
+{
+   // Factor a copy of the matrix with sorted columns in place, row by row: the
+   // rows of one level only read the rows of the previous levels.
+   SparseMatrix LU(*oper);
+   LU.SortColumnIndices();
+   const int n = height;
+   const int *I = LU.GetI(), *J = LU.GetJ();
+   double *A = LU.GetData();
+   Array<int> diag(n);
+   for (int i = 0; i < n; i++)
+   {
+      diag[i] = FindColumn(I, J, i, i);
+      MFEM_VERIFY(diag[i] >= 0, "missing diagonal entry in row " << i);
+   }
+   // the levels of the factorization are the ones of the forward solve
+   Table levels;
+   GetRowLevels(n, I, diag, J, true, levels);
+   for (int c = 0; c < levels.Size(); c++)
+   {
+      const int *rows = levels.GetRow(c), nr = levels.RowSize(c);
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for if (nr > 64)
+#endif
+      for (int r = 0; r < nr; r++)
+      {
+         const int i = rows[r];
+         for (int p = I[i]; p < diag[i]; p++)
+         {
+            const int k = J[p];
+            MFEM_VERIFY(A[diag[k]] != 0.0, "zero pivot in row " << k);
+            A[p] /= A[diag[k]];
+            for (int q = diag[k]+1; q < I[k+1]; q++)
+            {
+               const int pos = FindColumn(I, J, i, J[q]);
+               if (pos >= 0) { A[pos] -= A[p]*A[q]; }
+            }
+         }
+      }
+   }
+
+   // Split the factors: L has a unit diagonal.
+   int *Li = new int[n+1], *Ui = new int[n+1];
+   Li[0] = Ui[0] = 0;
+   for (int i = 0; i < n; i++)
+   {
+      Li[i+1] = Li[i] + (diag[i] - I[i]);
+      Ui[i+1] = Ui[i] + (I[i+1] - diag[i] - 1);
+   }
+   int *Lj = new int[Li[n]], *Uj = new int[Ui[n]];
+   double *La = new double[Li[n]], *Ua = new double[Ui[n]];
+   lower_dinv.SetSize(n);
+   upper_dinv.SetSize(n);
+   lower_dinv = 1.0;
+   for (int i = 0; i < n; i++)
+   {
+      for (int p = I[i], q = Li[i]; p < diag[i]; p++, q++)
+      {
+         Lj[q] = J[p];
+         La[q] = A[p];
+      }
+      for (int p = diag[i]+1, q = Ui[i]; p < I[i+1]; p++, q++)
+      {
+         Uj[q] = J[p];
+         Ua[q] = A[p];
+      }
+      MFEM_VERIFY(A[diag[i]] != 0.0, "zero pivot in row " << i);
+      upper_dinv(i) = 1.0/A[diag[i]];
+   }
+   lower = new SparseMatrix(Li, Lj, La, n, n);
+   upper = new SparseMatrix(Ui, Uj, Ua, n, n);
+}
+
+void ILUSmoother::ComputeLevels()
+{
+   GetRowLevels(height, lower->GetI(), lower->GetI()+1, lower->GetJ(), true,
+                lower_levels);
+   GetRowLevels(height, upper->GetI(), upper->GetI()+1, upper->GetJ(), false,
+                upper_levels);
+}
+
+// Solve the triangular system (T + D) y = x level by level, where T is
+// strictly triangular and dinv the inverse of the diagonal D. The OpenMP
+// threads are only used for levels with enough rows to amortize them.
+static void LevelScheduledSolve(const SparseMatrix &T, const Vector &dinv,
+                                const Table &levels, const double *x,
+                                double *y)
+{
+   const int *I = T.GetI(), *J = T.GetJ();
+   const double *A = T.GetData();
+   const double *d = dinv.GetData();
+   for (int c = 0; c < levels.Size(); c++)
+   {
+      const int *rows = levels.GetRow(c), nr = levels.RowSize(c);
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for if (nr > 64)
+#endif
+      for (int r = 0; r < nr; r++)
+      {
+         const int i = rows[r];
+         double sum = x[i];
+         for (int p = I[i]; p < I[i+1]; p++) { sum -= A[p]*y[J[p]]; }
+         y[i] = d[i]*sum;
+      }
+   }
+}
+
+void ILUSmoother::Solve(const Vector &x, Vector &y) const
+{
+   LevelScheduledSolve(*lower, lower_dinv, lower_levels, x.GetData(),
+                       z.GetData());
+   LevelScheduledSolve(*upper, upper_dinv, upper_levels, z.GetData(),
+                       y.GetData());
+}
+
+void ILUSmoother::Mult(const Vector &x, Vector &y) const
+{
+   if (!iterative_mode)
+   {
+      Solve(x, y);
+      return;
+   }
+   r.SetSize(height);
+   oper->Mult(y, r);
+   subtract(x, r, r);
+   Solve(r, r);
+   y += r;
+}
+
+ILUSmoother::~ILUSmoother()
+{
+   delete lower;
+   delete upper;
+}
+
+ICSmoother::ICSmoother(const SparseMatrix &a, double shift_)
+   : shift(shift_)
+{
+   SetOperator(a);
+}
+
+void ICSmoother::Factor()
+{
+   // Left-looking factorization of the lower triangular part, row by row:
+   // L_ik = (A_ik - sum_{j<k} L_ij L_kj)/L_kk, where the sum runs over the
+   // common columns of the rows i and k of L.
+   const int n = height;
+   const int *Ai = oper->GetI(), *Aj = oper->GetJ();
+   const double *Aa = oper->GetData();
+   int *Li = new int[n+1];
+   Li[0] = 0;
+   for (int i = 0; i < n; i++)
+   {
+      int nnz = 0;
+      for (int p = Ai[i]; p < Ai[i+1]; p++) { if (Aj[p] <= i) { nnz++; } }
+      Li[i+1] = Li[i] + nnz;
+   }
+   int *Lj = new int[Li[n]];
+   double *La = new double[Li[n]];
+   for (int i = 0; i < n; i++)
+   {
+      int q = Li[i];
+      for (int p = Ai[i]; p < Ai[i+1]; p++)
+      {
+         if (Aj[p] <= i)
+         {
+            Lj[q] = Aj[p];
+            La[q] = (Aj[p] == i) ? (1.0 + shift)*Aa[p] : Aa[p];
+            q++;
+         }
+      }
+   }
+   SparseMatrix L(Li, Lj, La, n, n);
+   L.SortColumnIndices();
+   const int *I = L.GetI(), *J = L.GetJ();
+   double *A = L.GetData();
+   for (int i = 0; i < n; i++)
+   {
+      MFEM_VERIFY(I[i+1] > I[i] && J[I[i+1]-1] == i,
+                  "missing diagonal entry in row " << i);
+   }
+
+   Table levels;
+   Array<int> diag_end(n);
+   for (int i = 0; i < n; i++) { diag_end[i] = I[i+1]-1; }
+   GetRowLevels(n, I, diag_end, J, true, levels);
+   for (int c = 0; c < levels.Size(); c++)
+   {
+      const int *rows = levels.GetRow(c), nr = levels.RowSize(c);
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for if (nr > 64)
+#endif
+      for (int r = 0; r < nr; r++)
+      {
+         const int i = rows[r];
+         for (int p = I[i]; p < I[i+1]; p++)
+         {
+            const int k = J[p];
+            double s = A[p];
+            // merge the sorted columns j < k of the rows i and k
+            for (int pi = I[i], pk = I[k]; pi < p && J[pk] < k; )
+            {
+               if (J[pi] < J[pk]) { pi++; }
+               else if (J[pi] > J[pk]) { pk++; }
+               else { s -= A[pi++]*A[pk++]; }
+            }
+            if (k < i)
+            {
+               A[p] = s/A[I[k+1]-1];
+            }
+            else
+            {
+               MFEM_VERIFY(s > 0.0, "IC(0) breakdown in row " << i
+                           << ", try a diagonal shift");
+               A[p] = std::sqrt(s);
+            }
+         }
+      }
+   }
+
+   // Split L into its strictly lower part and diagonal; U = L^t.
+   int *Si = new int[n+1];
+   Si[0] = 0;
+   for (int i = 0; i < n; i++) { Si[i+1] = Si[i] + (I[i+1] - I[i] - 1); }
+   int *Sj = new int[Si[n]];
+   double *Sa = new double[Si[n]];
+   lower_dinv.SetSize(n);
+   for (int i = 0; i < n; i++)
+   {
+      for (int p = I[i], q = Si[i]; p < I[i+1]-1; p++, q++)
+      {
+         Sj[q] = J[p];
+         Sa[q] = A[p];
+      }
+      lower_dinv(i) = 1.0/A[I[i+1]-1];
+   }
+   upper_dinv = lower_dinv;
+   lower = new SparseMatrix(Si, Sj, Sa, n, n);
+   upper = Transpose(*lower);
+}
+
 /// Create the Jacobi smoother.
 DSmoother::DSmoother(const SparseMatrix &a, int t, double s, int it)
    : SparseSmoother(a)
@@ -51,6 +51,117 @@ public:
    virtual void Mult(const Vector &x, Vector &y) const;
 };
 
+/** @brief Multicolor Gauss-Seidel smoother of sparse matrix: a threaded
+    alternative to GSSmoother with the same types, plus a relaxation weight. */
+/** The rows are colored once, in SetOperator(), so that rows with the same
+    color are not coupled (see SparseMatrix::GetRowColoring()); the colors are
+    then relaxed one after the other, and the rows of one color in parallel
+    with OpenMP. The result depends on the coloring, so it differs from the
+    one of GSSmoother, which relaxes the rows in their natural order. With
+    type 0 (symmetric), the smoother is the multicolor SSOR method with weight
+    @a w, and it is symmetric when the matrix is. */
+class MulticolorGSSmoother : public GSSmoother
+{
+protected:
+   double weight;
+   Table color_rows;
+
+public:
+   /// Create MulticolorGSSmoother.
+   MulticolorGSSmoother(int t = 0, int it = 1, double w = 1.0)
+      : GSSmoother(t, it), weight(w) { }
+
+   /// Create MulticolorGSSmoother and color the rows of @a a.
+   MulticolorGSSmoother(const SparseMatrix &a, int t = 0, int it = 1,
+                        double w = 1.0);
+
+   /// Set the matrix and color its rows.
+   virtual void SetOperator(const Operator &a);
+
+   /// Return the number of colors.
+   int GetNumColors() const { return color_rows.Size(); }
+
+   /// Return the coloring: row c lists the rows of the matrix with color c.
+   const Table &GetColoring() const { return color_rows; }
+
+   /// Matrix vector multiplication with the multicolor GS smoother.
+   virtual void Mult(const Vector &x, Vector &y) const;
+};
+
+/** @brief Incomplete LU factorization with zero fill-in, ILU(0), of a sparse
+    matrix: A ~ L U with the sparsity of A. */
+/** The factors are computed in SetOperator(), and Mult() solves with L and U;
+    in iterative mode, y <- y + (LU)^{-1} (x - A y). The rows are grouped in
+    levels, i.e. the levels of the dependency graph of the triangular solves,
+    computed once in the setup: the rows of one level only depend on rows of
+    the previous levels, so the factorization and the triangular solves
+    process the rows of each level in parallel with OpenMP. The factors and
+    the results do not depend on the number of threads. The matrix must have
+    nonzero diagonal entries. */
+class ILUSmoother : public SparseSmoother
+{
+protected:
+   /// Strictly lower and upper triangular parts of the factors.
+   SparseMatrix *lower, *upper;
+   /// Inverses of the diagonals of the factors; the one of ILU's L is 1.
+   Vector lower_dinv, upper_dinv;
+   /// Row c lists the rows of level c of the forward and backward solves.
+   Table lower_levels, upper_levels;
+   mutable Vector z, r;
+
+   /// Compute the factors of #oper.
+   virtual void Factor();
+
+   /// Compute #lower_levels and #upper_levels from the factors.
+   void ComputeLevels();
+
+   // Solve with L and U; x and y can be the same vector
+   void Solve(const Vector &x, Vector &y) const;
+
+public:
+   ILUSmoother() : lower(NULL), upper(NULL) { }
+
+   /// Create the smoother and compute the factors of @a a.
+   ILUSmoother(const SparseMatrix &a);
+
+   /// Set the matrix and compute its factors.
+   virtual void SetOperator(const Operator &a);
+
+   /// Return the number of levels of the forward solve.
+   int GetNumLevels() const { return lower_levels.Size(); }
+
+   /// Apply the preconditioner.
+   virtual void Mult(const Vector &x, Vector &y) const;
+
+   virtual ~ILUSmoother();
+};
+
+/** @brief Incomplete Cholesky factorization with zero fill-in, IC(0), of a
+    symmetric positive definite sparse matrix: A ~ L L^t with the sparsity of
+    the lower triangular part of A. */
+/** Only the lower triangular part of the matrix is used. The factorization
+    and the solves are level-scheduled as in ILUSmoother, and the smoother is
+    symmetric, so it can be used as a preconditioner for CG. The factorization
+    breaks down for some positive definite matrices which are not M-matrices;
+    a diagonal shift, see SetShift(), can then be used. */
+class ICSmoother : public ILUSmoother
+{
+protected:
+   double shift;
+
+   virtual void Factor();
+
+public:
+   ICSmoother() : shift(0.0) { }
+
+   /// Create the smoother and compute the factors of @a a.
+   ICSmoother(const SparseMatrix &a, double shift_ = 0.0);
+
+   /** @brief Factor A + shift diag(A) instead of A, for a following call to
+       SetOperator(). */
+   void SetShift(double shift_) { shift = shift_; }
+};
+
 /// Data type for scaled Jacobi-type smoother of sparse matrix
 class DSmoother : public SparseSmoother
 {
@@ -208,9 +208,15 @@ Vector &Vector::Add(const double a, const Vector &Va)
 #endif
    if (a != 0.0)
    {
-      for (int i = 0; i < size; i++)
+      const double *vp = Va.data;
+      double *p = data;
+      const int s = size;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp parallel for
+#endif
+      for (int i = 0; i < s; i++)
       {
-         data[i] += a * Va(i);
+         p[i] += a * vp[i];
       }
    }
    return *this;
@@ -438,6 +444,90 @@ void subtract(const double a, const Vector &x, const Vector &y, Vector &z)
    }
 }
 
+void add(const double a, const Vector &x, const double b, const Vector &y,
+         const double c, const Vector &w, Vector &z)
+{
+   MFEM_ASSERT(x.size == z.size && y.size == z.size && w.size == z.size,
+               "incompatible Vectors!");
+
+   const double *xp = x.data, *yp = y.data, *wp = w.data;
+   double *zp = z.data;
+   const int s = z.size;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for
+#endif
+   for (int i = 0; i < s; i++)
+   {
+      zp[i] = a*xp[i] + b*yp[i] + c*wp[i];
+   }
+}
+
+double AddAndDot(const Vector &x, const double a, const Vector &y, Vector &z,
+                 const Vector &w)
+{
+   MFEM_ASSERT(x.size == z.size && y.size == z.size && w.size == z.size,
+               "incompatible Vectors!");
+
+   const double *xp = x.data, *yp = y.data, *wp = w.data;
+   double *zp = z.data;
+   const int s = z.size;
+   double prod = 0.0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for reduction(+:prod)
+#endif
+   for (int i = 0; i < s; i++)
+   {
+      const double zi = xp[i] + a*yp[i];
+      zp[i] = zi;
+      prod += zi*wp[i]; // w may be z
+   }
+   return prod;
+}
+
+void AddAndDot2(const Vector &x, const double a, const Vector &y, Vector &z,
+                const Vector &w, double dots[2])
+{
+   MFEM_ASSERT(x.size == z.size && y.size == z.size && w.size == z.size,
+               "incompatible Vectors!");
+
+   const double *xp = x.data, *yp = y.data, *wp = w.data;
+   double *zp = z.data;
+   const int s = z.size;
+   double zz = 0.0, zw = 0.0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for reduction(+:zz,zw)
+#endif
+   for (int i = 0; i < s; i++)
+   {
+      const double zi = xp[i] + a*yp[i];
+      zp[i] = zi;
+      zz += zi*zi;
+      zw += zi*wp[i];
+   }
+   dots[0] = zz;
+   dots[1] = zw;
+}
+
+void Dot2(const Vector &x, const Vector &y1, const Vector &y2, double dots[2])
+{
+   MFEM_ASSERT(y1.size == x.size && y2.size == x.size,
+               "incompatible Vectors!");
+
+   const double *xp = x.data, *y1p = y1.data, *y2p = y2.data;
+   const int s = x.size;
+   double d1 = 0.0, d2 = 0.0;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel for reduction(+:d1,d2)
+#endif
+   for (int i = 0; i < s; i++)
+   {
+      d1 += xp[i]*y1p[i];
+      d2 += xp[i]*y2p[i];
+   }
+   dots[0] = d1;
+   dots[1] = d2;
+}
+
 void Vector::median(const Vector &lo, const Vector &hi)
 {
    double *v = data;
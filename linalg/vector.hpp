@@ -222,6 +222,26 @@ public:
    friend void subtract(const double a, const Vector &x,
                         const Vector &y, Vector &z);
 
+   /// z = a * x + b * y + c * w
+   friend void add(const double a, const Vector &x, const double b,
+                   const Vector &y, const double c, const Vector &w,
+                   Vector &z);
+
+   /** @brief Set z = x + a * y and return the local inner product (z, w),
+       computed in the same sweep over the data; @a w may be @a z. */
+   friend double AddAndDot(const Vector &x, const double a, const Vector &y,
+                           Vector &z, const Vector &w);
+
+   /** @brief Set z = x + a * y and the local inner products dots[0] = (z, z)
+       and dots[1] = (z, w), computed in the same sweep over the data. */
+   friend void AddAndDot2(const Vector &x, const double a, const Vector &y,
+                          Vector &z, const Vector &w, double dots[2]);
+
+   /** @brief Set the local inner products dots[0] = (x, y1) and
+       dots[1] = (x, y2), computed in the same sweep over the data. */
+   friend void Dot2(const Vector &x, const Vector &y1, const Vector &y2,
+                    double dots[2]);
+
    /// v = median(v,lo,hi) entrywise.  Implementation assumes lo <= hi.
    void median(const Vector &lo, const Vector &hi);
 
@@ -0,0 +1,225 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class BoundingVolumeHierarchy
+
+#include "bvh.hpp"
+
+#include <algorithm>
+
+namespace mfem
+{
+
+namespace internal
+{
+
+// Order box indices by the coordinate 'axis' of their centers.
+struct CompareBoxCenters
+{
+   const DenseMatrix &centers;
+   int axis;
+
+   CompareBoxCenters(const DenseMatrix &c, int a) : centers(c), axis(a) { }
+
+   bool operator()(int a, int b) const
+   { return centers(axis, a) < centers(axis, b); }
+};
+
+}
+
+void BoundingVolumeHierarchy::Build(const DenseMatrix &bmin,
+                                    const DenseMatrix &bmax,
+                                    int max_leaf_size)
+{
+   MFEM_VERIFY(bmin.Height() == bmax.Height() && bmin.Width() == bmax.Width(),
+               "incompatible box corners");
+   MFEM_VERIFY(max_leaf_size > 0, "invalid leaf size: " << max_leaf_size);
+
+   dim = bmin.Height();
+   num_boxes = bmin.Width();
+   leaf_size = max_leaf_size;
+   box_min = bmin;
+   box_max = bmax;
+
+   DenseMatrix centers(dim, num_boxes);
+   for (int i = 0; i < num_boxes; i++)
+   {
+      for (int d = 0; d < dim; d++)
+      {
+         centers(d, i) = 0.5*(bmin(d, i) + bmax(d, i));
+      }
+   }
+
+   perm.SetSize(num_boxes);
+   for (int i = 0; i < num_boxes; i++) { perm[i] = i; }
+
+   nodes.SetSize(0);
+   node_box.SetSize(0);
+   if (num_boxes > 0) { BuildNode(0, num_boxes, centers); }
+}
+
+void BoundingVolumeHierarchy::ComputeNodeBox(int n)
+{
+   double *nmin = NodeMin(n), *nmax = NodeMax(n);
+   for (int d = 0; d < dim; d++)
+   {
+      nmin[d] = box_min(d, perm[nodes[n].begin]);
+      nmax[d] = box_max(d, perm[nodes[n].begin]);
+   }
+   for (int i = nodes[n].begin + 1; i < nodes[n].end; i++)
+   {
+      const double *bmin = box_min.GetColumn(perm[i]);
+      const double *bmax = box_max.GetColumn(perm[i]);
+      for (int d = 0; d < dim; d++)
+      {
+         nmin[d] = std::min(nmin[d], bmin[d]);
+         nmax[d] = std::max(nmax[d], bmax[d]);
+      }
+   }
+}
+
+int BoundingVolumeHierarchy::BuildNode(int begin, int end,
+                                       const DenseMatrix &centers)
+{
+   const int n = nodes.Append(Node()) - 1;
+   node_box.SetSize(2*dim*nodes.Size());
+   nodes[n].left = nodes[n].right = -1;
+   nodes[n].begin = begin;
+   nodes[n].end = end;
+   ComputeNodeBox(n);
+
+   if (end - begin <= leaf_size) { return n; }
+
+   // Split at the median of the box centers along the longest axis of the
+   // bounding box of the centers.
+   int axis = 0;
+   double max_ext = -1.0;
+   for (int d = 0; d < dim; d++)
+   {
+      double cmin = centers(d, perm[begin]), cmax = cmin;
+      for (int i = begin + 1; i < end; i++)
+      {
+         cmin = std::min(cmin, centers(d, perm[i]));
+         cmax = std::max(cmax, centers(d, perm[i]));
+      }
+      if (cmax - cmin > max_ext) { max_ext = cmax - cmin; axis = d; }
+   }
+   const int mid = (begin + end)/2;
+   int *p = perm.GetData();
+   std::nth_element(p + begin, p + mid, p + end,
+                    internal::CompareBoxCenters(centers, axis));
+
+   const int left = BuildNode(begin, mid, centers);
+   const int right = BuildNode(mid, end, centers);
+   nodes[n].left = left;
+   nodes[n].right = right;
+   return n;
+}
+
+int BoundingVolumeHierarchy::GetDepth() const
+{
+   if (nodes.Size() == 0) { return 0; }
+   // The children of a node are created after the node itself.
+   Array<int> depth(nodes.Size());
+   for (int n = nodes.Size()-1; n >= 0; n--)
+   {
+      const Node &node = nodes[n];
+      depth[n] = (node.left < 0) ? 1 :
+                 1 + std::max(depth[node.left], depth[node.right]);
+   }
+   return depth[0];
+}
+
+void BoundingVolumeHierarchy::GetBoundingBox(Vector &bmin, Vector &bmax) const
+{
+   MFEM_VERIFY(nodes.Size() > 0, "the hierarchy is empty");
+   bmin.SetSize(dim);
+   bmax.SetSize(dim);
+   for (int d = 0; d < dim; d++)
+   {
+      bmin(d) = NodeMin(0)[d];
+      bmax(d) = NodeMax(0)[d];
+   }
+}
+
+void BoundingVolumeHierarchy::FindPoint(const double *x,
+                                        Array<int> &boxes) const
+{
+   if (nodes.Size() == 0) { return; }
+
+   int stack[64], top = 0;
+   stack[top++] = 0;
+   while (top > 0)
+   {
+      const int n = stack[--top];
+      const Node &node = nodes[n];
+      if (!BoxContains(NodeMin(n), NodeMax(n), x, dim))
+      {
+         continue;
+      }
+      if (node.left >= 0)
+      {
+         stack[top++] = node.right;
+         stack[top++] = node.left;
+         continue;
+      }
+      for (int i = node.begin; i < node.end; i++)
+      {
+         const int b = perm[i];
+         if (BoxContains(box_min.GetColumn(b), box_max.GetColumn(b), x, dim))
+         {
+            boxes.Append(b);
+         }
+      }
+   }
+}
+
+void BoundingVolumeHierarchy::FindBox(const double *bmin, const double *bmax,
+                                      Array<int> &boxes) const
+{
+   if (nodes.Size() == 0) { return; }
+
+   int stack[64], top = 0;
+   stack[top++] = 0;
+   while (top > 0)
+   {
+      const int n = stack[--top];
+      const Node &node = nodes[n];
+      if (!BoxesIntersect(NodeMin(n), NodeMax(n), bmin, bmax, dim))
+      {
+         continue;
+      }
+      if (node.left >= 0)
+      {
+         stack[top++] = node.right;
+         stack[top++] = node.left;
+         continue;
+      }
+      for (int i = node.begin; i < node.end; i++)
+      {
+         const int b = perm[i];
+         if (BoxesIntersect(box_min.GetColumn(b), box_max.GetColumn(b),
+                            bmin, bmax, dim))
+         {
+            boxes.Append(b);
+         }
+      }
+   }
+}
+
+long BoundingVolumeHierarchy::MemoryUsage() const
+{
+   return (nodes.Capacity()*sizeof(Node) + perm.Capacity()*sizeof(int) +
+           (node_box.Capacity() + box_min.Height()*box_min.Width() +
+            box_max.Height()*box_max.Width())*sizeof(double));
+}
+
+}
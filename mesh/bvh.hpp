@@ -0,0 +1,122 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_BVH
+#define MFEM_BVH
+
+#include "../config/config.hpp"
+#include "../general/array.hpp"
+#include "../linalg/densemat.hpp"
+
+namespace mfem
+{
+
+/** @brief Bounding volume hierarchy (BVH) of axis-aligned bounding boxes.
+
+    The hierarchy is a binary tree built top-down over a set of boxes: each
+    tree node stores the bounding box of all boxes below it and the boxes are
+    split at the median of their centers along the longest axis of the node.
+    Point queries descend only into the nodes whose box contains the point,
+    i.e. a query costs O(log N) node visits for well-shaped sets of boxes.
+
+    The tree is used by Mesh::FindPoints() to locate candidate elements and by
+    ParMesh::FindPoints() to locate candidate ranks. */
+class BoundingVolumeHierarchy
+{
+protected:
+   struct Node
+   {
+      int left, right; ///< indices of the children, or -1 for a leaf
+      int begin, end;  ///< range of the boxes in #perm below this node
+   };
+
+   int dim, num_boxes, leaf_size;
+   Array<Node> nodes;
+   Array<double> node_box;         // node bounding boxes, (min,max) pairs
+   DenseMatrix box_min, box_max;   // the input boxes, one per column
+   Array<int> perm;                // box indices, ordered by tree leaves
+
+   double *NodeMin(int n) { return node_box.GetData() + 2*dim*n; }
+   double *NodeMax(int n) { return node_box.GetData() + 2*dim*n + dim; }
+   const double *NodeMin(int n) const
+   { return node_box.GetData() + 2*dim*n; }
+   const double *NodeMax(int n) const
+   { return node_box.GetData() + 2*dim*n + dim; }
+
+   void ComputeNodeBox(int n);
+   int BuildNode(int begin, int end, const DenseMatrix &centers);
+
+   static bool BoxContains(const double *bmin, const double *bmax,
+                           const double *x, int dim)
+   {
+      for (int d = 0; d < dim; d++)
+      {
+         if (x[d] < bmin[d] || x[d] > bmax[d]) { return false; }
+      }
+      return true;
+   }
+
+   static bool BoxesIntersect(const double *amin, const double *amax,
+                              const double *bmin, const double *bmax, int dim)
+   {
+      for (int d = 0; d < dim; d++)
+      {
+         if (amax[d] < bmin[d] || bmax[d] < amin[d]) { return false; }
+      }
+      return true;
+   }
+
+public:
+   /// Create an empty hierarchy, see Build().
+   BoundingVolumeHierarchy() : dim(0), num_boxes(0), leaf_size(4) { }
+
+   /** @brief Build the hierarchy over the boxes given by the columns of
+       @a bmin and @a bmax (lower and upper corners, respectively). */
+   /** Leaves of the tree will contain at most @a max_leaf_size boxes. */
+   BoundingVolumeHierarchy(const DenseMatrix &bmin, const DenseMatrix &bmax,
+                           int max_leaf_size = 4)
+   { Build(bmin, bmax, max_leaf_size); }
+
+   /// (Re)build the hierarchy, see the corresponding constructor.
+   void Build(const DenseMatrix &bmin, const DenseMatrix &bmax,
+              int max_leaf_size = 4);
+
+   /// Return the space dimension of the boxes.
+   int Dimension() const { return dim; }
+
+   /// Return the number of boxes in the hierarchy.
+   int GetNumBoxes() const { return num_boxes; }
+
+   /// Return the number of tree nodes.
+   int GetNumNodes() const { return nodes.Size(); }
+
+   /// Return the depth of the tree; an empty tree has depth 0.
+   int GetDepth() const;
+
+   /// Return the lower and upper corners of the box enclosing all boxes.
+   void GetBoundingBox(Vector &bmin, Vector &bmax) const;
+
+   /** @brief Append to @a boxes the indices of all boxes that contain the
+       point @a x (an array of Dimension() doubles). */
+   void FindPoint(const double *x, Array<int> &boxes) const;
+
+   /** @brief Append to @a boxes the indices of all boxes that intersect the box
+       with lower and upper corners @a bmin and @a bmax. */
+   void FindBox(const double *bmin, const double *bmax,
+                Array<int> &boxes) const;
+
+   /// Return the approximate memory used by the hierarchy, in bytes.
+   long MemoryUsage() const;
+};
+
+}
+
+#endif
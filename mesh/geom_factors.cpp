@@ -0,0 +1,139 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+// Implementation of class GeometricFactors
+
+#include "mesh_headers.hpp"
+
+namespace mfem
+{
+
+GeometricFactors::GeometricFactors(Mesh *mesh, Geometry::Type g,
+                                   const IntegrationRule &ir, int flags)
+   : geom(g), IntRule(ir), computed_factors(0), nodes_checksum(0), next(NULL)
+{
+   NE = mesh->GetNE();
+   NQ = ir.GetNPoints();
+   SDim = mesh->SpaceDimension();
+   Dim = Geometry::Dimension[g];
+   sequence = mesh->GetSequence();
+   Compute(mesh, flags);
+}
+
+void GeometricFactors::Compute(Mesh *mesh, int flags)
+{
+   MFEM_VERIFY(mesh->GetNE() == NE && mesh->SpaceDimension() == SDim,
+               "the mesh was modified");
+   const int new_factors = flags & ~computed_factors;
+   if (new_factors == 0) { return; }
+
+   const bool jac = (new_factors & JACOBIANS);
+   const bool inv = (new_factors & INVERSES);
+   const bool det = (new_factors & DETERMINANTS);
+   if (jac) { J.SetSize(NQ*SDim*Dim*NE); J = 0.0; }
+   if (inv) { invJ.SetSize(NQ*Dim*SDim*NE); invJ = 0.0; }
+   if (det) { detJ.SetSize(NQ*NE); detJ = 0.0; }
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp parallel
+#endif
+   {
+      IsoparametricTransformation T;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp for
+#endif
+      for (int e = 0; e < NE; e++)
+      {
+         if (mesh->GetElementBaseGeometry(e) != geom) { continue; }
+         mesh->GetElementTransformation(e, &T);
+         for (int q = 0; q < NQ; q++)
+         {
+            T.SetIntPoint(&IntRule.IntPoint(q));
+            if (jac)
+            {
+               const DenseMatrix &Jq = T.Jacobian();
+               double *Je = J.GetData() + NQ*SDim*Dim*e;
+               for (int j = 0; j < Dim; j++)
+               {
+                  for (int i = 0; i < SDim; i++)
+                  {
+                     Je[q + NQ*(i + SDim*j)] = Jq(i,j);
+                  }
+               }
+            }
+            if (inv)
+            {
+               const DenseMatrix &iJq = T.InverseJacobian();
+               double *iJe = invJ.GetData() + NQ*Dim*SDim*e;
+               for (int j = 0; j < SDim; j++)
+               {
+                  for (int i = 0; i < Dim; i++)
+                  {
+                     iJe[q + NQ*(i + Dim*j)] = iJq(i,j);
+                  }
+               }
+            }
+            if (det)
+            {
+               detJ(q + NQ*e) = T.Weight();
+            }
+         }
+      }
+   }
+   // publish the new factors after their data
+#ifdef MFEM_USE_OPENMP
+   #pragma omp flush
+   #pragma omp atomic write
+#endif
+   computed_factors = computed_factors | new_factors;
+}
+
+bool GeometricFactors::Matches(Geometry::Type g,
+                               const IntegrationRule &ir) const
+{
+   if (g != geom || ir.GetNPoints() != NQ) { return false; }
+   for (int q = 0; q < NQ; q++)
+   {
+      const IntegrationPoint &a = ir.IntPoint(q), &b = IntRule.IntPoint(q);
+      if (a.x != b.x || a.y != b.y || a.z != b.z) { return false; }
+   }
+   return true;
+}
+
+void GeometricFactors::GetJacobian(int e, int q, DenseMatrix &Jq) const
+{
+   MFEM_ASSERT(computed_factors & JACOBIANS, "Jacobians are not computed");
+   const double *Je = J.GetData() + NQ*SDim*Dim*e;
+   Jq.SetSize(SDim, Dim);
+   for (int j = 0; j < Dim; j++)
+   {
+      for (int i = 0; i < SDim; i++)
+      {
+         Jq(i,j) = Je[q + NQ*(i + SDim*j)];
+      }
+   }
+}
+
+void GeometricFactors::GetInverseJacobian(int e, int q, DenseMatrix &iJq) const
+{
+   MFEM_ASSERT(computed_factors & INVERSES, "inverses are not computed");
+   const double *iJe = invJ.GetData() + NQ*Dim*SDim*e;
+   iJq.SetSize(Dim, SDim);
+   for (int j = 0; j < SDim; j++)
+   {
+      for (int i = 0; i < Dim; i++)
+      {
+         iJq(i,j) = iJe[q + NQ*(i + Dim*j)];
+      }
+   }
+}
+
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#ifndef MFEM_GEOM_FACTORS
+#define MFEM_GEOM_FACTORS
+
+#include "../config/config.hpp"
+#include "../linalg/vector.hpp"
+#include "../linalg/densemat.hpp"
+#include "../fem/intrules.hpp"
+#include "../fem/geom.hpp"
+
+namespace mfem
+{
+
+class Mesh;
+
+/** @brief Geometric factors of the elements of a Mesh at the points of an
+    IntegrationRule: the Jacobians of the element transformations, their
+    weights (determinants) and their (pseudo-)inverses. */
+/** The factors are computed for all elements of one reference Geometry; the
+    entries of the elements of other geometries are zero. They are stored per
+    element in a structure-of-arrays layout: for element @a e, each entry of
+    the Jacobian is an array over the NQ points of the rule,
+    - #J(q,i,j,e) at offset q + NQ*(i + SDim*(j + Dim*e)), size SDim x Dim,
+    - #invJ(q,i,j,e) at offset q + NQ*(i + Dim*(j + SDim*e)), size Dim x SDim,
+    - #detJ(q,e) at offset q + NQ*e.
+
+    The factors are usually obtained from the cache of the Mesh, see
+    Mesh::GetGeometricFactors(), and are used through
+    ElementTransformation::SetIntPoint(const IntegrationPoint *,
+    const GeometricFactors *, int). */
+class GeometricFactors
+{
+public:
+   enum FactorFlags
+   {
+      JACOBIANS    = 1 << 0, ///< The Jacobian matrices, #J.
+      DETERMINANTS = 1 << 1, ///< The Jacobian weights, #detJ.
+      INVERSES     = 1 << 2  ///< The Jacobian (pseudo-)inverses, #invJ.
+   };
+
+   Geometry::Type geom;  ///< Reference geometry of the elements.
+   IntegrationRule IntRule; ///< Copy of the integration rule.
+   int computed_factors; ///< Bitwise OR of the computed FactorFlags.
+   int NE, NQ, SDim, Dim;
+   long sequence;        ///< Mesh sequence at the time of the computation.
+   /// Checksum of the mesh nodes at the time of the computation.
+   unsigned long nodes_checksum;
+   /// Next factors in the cache of the Mesh, see Mesh::GetGeometricFactors().
+   GeometricFactors *next;
+
+   /// Jacobians of the element transformations, see the class description.
+   Vector J;
+   /// Inverse Jacobians, see ElementTransformation::InverseJacobian().
+   Vector invJ;
+   /// Jacobian weights, see ElementTransformation::Weight().
+   Vector detJ;
+
+   /** @brief Compute the factors given by @a flags for the elements of @a mesh
+       with geometry @a g at the points of @a ir. */
+   GeometricFactors(Mesh *mesh, Geometry::Type g, const IntegrationRule &ir,
+                    int flags);
+
+   /** @brief Compute the factors given by @a flags that have not been computed
+       yet, for the current nodes of @a mesh. */
+   /** The factors computed earlier are not modified, so other threads can
+       keep reading them, and #computed_factors is updated last. */
+   void Compute(Mesh *mesh, int flags);
+
+   /** @brief Return true if the factors are defined for elements with
+       geometry @a g and the points of the rule @a ir. */
+   /** The rule is compared by its point coordinates, so an equal rule stored
+       at a different address matches too. */
+   bool Matches(Geometry::Type g, const IntegrationRule &ir) const;
+
+   /// Copy the Jacobian of element @a e at point @a q into @a Jq.
+   void GetJacobian(int e, int q, DenseMatrix &Jq) const;
+
+   /// Copy the inverse Jacobian of element @a e at point @a q into @a iJq.
+   void GetInverseJacobian(int e, int q, DenseMatrix &iJq) const;
+
+   /// Return the Jacobian weight of element @a e at point @a q.
+   double GetWeight(int e, int q) const { return detJ(q + NQ*e); }
+
+   /// Return the size of the stored data in bytes.
+   long MemoryUsage() const
+   {
+      return sizeof(double)*(J.Size() + invJ.Size() + detJ.Size());
+   }
+};
+
+}
+
+#endif
@@ -335,6 +335,7 @@ void Mesh::GetElementTransformation(int i, IsoparametricTransformation *ElTr)
 {
    ElTr->Attribute = GetAttribute(i);
    ElTr->ElementNo = i;
+   ElTr->mesh = this;
    if (Nodes == NULL)
    {
       GetPointMatrix(i, ElTr->GetPointMat());
@@ -365,6 +366,7 @@ void Mesh::GetElementTransformation(int i, const Vector &nodes,
 {
    ElTr->Attribute = GetAttribute(i);
    ElTr->ElementNo = i;
+   ElTr->mesh = NULL; // the nodes may differ from the mesh nodes
    DenseMatrix &pm = ElTr->GetPointMat();
    if (Nodes == NULL)
    {
@@ -418,6 +420,7 @@ void Mesh::GetBdrElementTransformation(int i, IsoparametricTransformation* ElTr)
 {
    ElTr->Attribute = GetBdrAttribute(i);
    ElTr->ElementNo = i; // boundary element number
+   ElTr->mesh = NULL;
    if (Nodes == NULL)
    {
       GetBdrPointMatrix(i, ElTr->GetPointMat());
@@ -447,6 +450,7 @@ void Mesh::GetFaceTransformation(int FaceNo, IsoparametricTransformation *FTr)
 {
    FTr->Attribute = (Dim == 1) ? 1 : faces[FaceNo]->GetAttribute();
    FTr->ElementNo = FaceNo;
+   FTr->mesh = NULL;
    DenseMatrix &pm = FTr->GetPointMat();
    if (Nodes == NULL)
    {
@@ -487,18 +491,22 @@ void Mesh::GetFaceTransformation(int FaceNo, IsoparametricTransformation *FTr)
          Geometry::Type face_geom = GetFaceGeometryType(FaceNo);
          Element::Type  face_type = GetFaceElementType(FaceNo);
 
+         // Use local temporaries, so that the method does not modify data
+         // owned by the Mesh.
+         IntegrationPointTransformation loc1;
          GetLocalFaceTransformation(face_type,
                                     GetElementType(face_info.Elem1No),
-                                    FaceElemTr.Loc1.Transf, face_info.Elem1Inf);
-         // NOTE: FaceElemTr.Loc1 is overwritten here -- used as a temporary
+                                    loc1.Transf, face_info.Elem1Inf);
 
          face_el = Nodes->FESpace()->GetTraceElement(face_info.Elem1No,
                                                      face_geom);
 
          IntegrationRule eir(face_el->GetDof());
-         FaceElemTr.Loc1.Transform(face_el->GetNodes(), eir);
-         // 'Transformation' is not used
-         Nodes->GetVectorValues(Transformation, eir, pm);
+         loc1.Transform(face_el->GetNodes(), eir);
+         // only the element number of 'eltr1' is used
+         IsoparametricTransformation eltr1;
+         eltr1.ElementNo = face_info.Elem1No;
+         Nodes->GetVectorValues(eltr1, eir, pm);
 
          FTr->SetFE(face_el);
       }
@@ -526,6 +534,7 @@ void Mesh::GetEdgeTransformation(int EdgeNo, IsoparametricTransformation *EdTr)
 
    EdTr->Attribute = 1;
    EdTr->ElementNo = EdgeNo;
+   EdTr->mesh = NULL;
    DenseMatrix &pm = EdTr->GetPointMat();
    if (Nodes == NULL)
    {
@@ -775,36 +784,53 @@ void Mesh::GetLocalFaceTransformation(
 
 FaceElementTransformations *Mesh::GetFaceElementTransformations(int FaceNo,
                                                                 int mask)
+{
+   GetFaceElementTransformations(FaceNo, FaceElemTr, Transformation,
+                                 Transformation2, FaceTransformation, mask);
+   return &FaceElemTr;
+}
+
+void Mesh::GetFaceElementTransformations(int FaceNo,
+                                         FaceElementTransformations &FElTr,
+                                         IsoparametricTransformation &ElTr1,
+                                         IsoparametricTransformation &ElTr2,
+                                         IsoparametricTransformation &FTr,
+                                         int mask)
 {
    FaceInfo &face_info = faces_info[FaceNo];
 
-   FaceElemTr.Elem1 = NULL;
-   FaceElemTr.Elem2 = NULL;
+   FElTr.Elem1 = NULL;
+   FElTr.Elem2 = NULL;
 
    // setup the transformation for the first element
-   FaceElemTr.Elem1No = face_info.Elem1No;
+   FElTr.Elem1No = face_info.Elem1No;
    if (mask & 1)
    {
-      GetElementTransformation(FaceElemTr.Elem1No, &Transformation);
-      FaceElemTr.Elem1 = &Transformation;
+      GetElementTransformation(FElTr.Elem1No, &ElTr1);
+      FElTr.Elem1 = &ElTr1;
    }
 
    //  setup the transformation for the second element
    //     return NULL in the Elem2 field if there's no second element, i.e.
    //     the face is on the "boundary"
-   FaceElemTr.Elem2No = face_info.Elem2No;
-   if ((mask & 2) && FaceElemTr.Elem2No >= 0)
+   FElTr.Elem2No = face_info.Elem2No;
+   if ((mask & 2) && FElTr.Elem2No >= 0)
    {
 #ifdef MFEM_DEBUG
       if (NURBSext && (mask & 1)) { MFEM_ABORT("NURBS mesh not supported!"); }
 #endif
-      GetElementTransformation(FaceElemTr.Elem2No, &Transformation2);
-      FaceElemTr.Elem2 = &Transformation2;
+      GetElementTransformation(FElTr.Elem2No, &ElTr2);
+      FElTr.Elem2 = &ElTr2;
    }
 
    // setup the face transformation
-   FaceElemTr.FaceGeom = GetFaceGeometryType(FaceNo);
-   FaceElemTr.Face = (mask & 16) ? GetFaceTransformation(FaceNo) : NULL;
+   FElTr.FaceGeom = GetFaceGeometryType(FaceNo);
+   FElTr.Face = NULL;
+   if (mask & 16)
+   {
+      GetFaceTransformation(FaceNo, &FTr);
+      FElTr.Face = &FTr;
+   }
 
    // setup Loc1 & Loc2
    int face_type = GetFaceElementType(FaceNo);
@@ -812,30 +838,28 @@ FaceElementTransformations *Mesh::GetFaceElementTransformations(int FaceNo,
    {
       int elem_type = GetElementType(face_info.Elem1No);
       GetLocalFaceTransformation(face_type, elem_type,
-                                 FaceElemTr.Loc1.Transf, face_info.Elem1Inf);
+                                 FElTr.Loc1.Transf, face_info.Elem1Inf);
    }
-   if ((mask & 8) && FaceElemTr.Elem2No >= 0)
+   if ((mask & 8) && FElTr.Elem2No >= 0)
    {
       int elem_type = GetElementType(face_info.Elem2No);
       GetLocalFaceTransformation(face_type, elem_type,
-                                 FaceElemTr.Loc2.Transf, face_info.Elem2Inf);
+                                 FElTr.Loc2.Transf, face_info.Elem2Inf);
 
       // NC meshes: prepend slave edge/face transformation to Loc2
       if (Nonconforming() && IsSlaveFace(face_info))
       {
-         ApplyLocalSlaveTransformation(FaceElemTr.Loc2.Transf, face_info);
+         ApplyLocalSlaveTransformation(FElTr.Loc2.Transf, face_info);
 
          if (face_type == Element::SEGMENT)
          {
             // flip Loc2 to match Loc1 and Face
-            DenseMatrix &pm = FaceElemTr.Loc2.Transf.GetPointMat();
+            DenseMatrix &pm = FElTr.Loc2.Transf.GetPointMat();
             std::swap(pm(0,0), pm(0,1));
             std::swap(pm(1,0), pm(1,1));
          }
       }
    }
-
-   return &FaceElemTr;
 }
 
 bool Mesh::IsSlaveFace(const FaceInfo &fi) const
@@ -859,7 +883,20 @@ void Mesh::ApplyLocalSlaveTransformation(IsoparametricTransformation &transf,
 
 FaceElementTransformations *Mesh::GetBdrFaceTransformations(int BdrElemNo)
 {
-   FaceElementTransformations *tr;
+   if (!GetBdrFaceTransformations(BdrElemNo, FaceElemTr, Transformation,
+                                  Transformation2, FaceTransformation))
+   {
+      return NULL;
+   }
+   return &FaceElemTr;
+}
+
+bool Mesh::GetBdrFaceTransformations(int BdrElemNo,
+                                     FaceElementTransformations &FElTr,
+                                     IsoparametricTransformation &ElTr1,
+                                     IsoparametricTransformation &ElTr2,
+                                     IsoparametricTransformation &FTr)
+{
    int fn;
    if (Dim == 3)
    {
@@ -876,11 +913,11 @@ FaceElementTransformations *Mesh::GetBdrFaceTransformations(int BdrElemNo)
    // Check if the face is interior, shared, or non-conforming.
    if (FaceIsTrueInterior(fn) || faces_info[fn].NCFace >= 0)
    {
-      return NULL;
+      return false;
    }
-   tr = GetFaceElementTransformations(fn);
-   tr->Face->Attribute = boundary[BdrElemNo]->GetAttribute();
-   return tr;
+   GetFaceElementTransformations(fn, FElTr, ElTr1, ElTr2, FTr);
+   FTr.Attribute = boundary[BdrElemNo]->GetAttribute();
+   return true;
 }
 
 void Mesh::GetFaceElements(int Face, int *Elem1, int *Elem2) const
@@ -916,6 +953,12 @@ void Mesh::Init()
    sequence = 0;
    Nodes = NULL;
    own_nodes = 1;
+   elem_bvh = NULL;
+   elem_bvh_sequence = -1;
+   elem_bvh_contains = true;
+   find_points_bvh = true;
+   for (int g = 0; g < Geometry::NumGeom; g++) { geom_factors[g] = NULL; }
+   geom_factors_cache = false;
    NURBSext = NULL;
    ncmesh = NULL;
    last_operation = Mesh::NONE;
@@ -952,6 +995,8 @@ void Mesh::DestroyPointers()
 {
    if (own_nodes) { delete Nodes; }
 
+   NodesUpdated();
+
    delete ncmesh;
 
    delete NURBSext;
@@ -2530,6 +2575,16 @@ Mesh::Mesh(const Mesh &mesh, bool copy_nodes)
    sequence = 0;
    last_operation = Mesh::NONE;
 
+   // Do NOT copy the element bounding volume hierarchy
+   elem_bvh = NULL;
+   elem_bvh_sequence = -1;
+   elem_bvh_contains = true;
+   find_points_bvh = mesh.find_points_bvh;
+
+   // Do NOT copy the geometric factors
+   for (int g = 0; g < Geometry::NumGeom; g++) { geom_factors[g] = NULL; }
+   geom_factors_cache = mesh.geom_factors_cache;
+
    // Duplicate the elements
    elements.SetSize(NumOfElements);
    for (int i = 0; i < NumOfElements; i++)
@@ -5590,6 +5645,7 @@ void Mesh::MoveVertices(const Vector &displacements)
       {
          vertices[i](j) += displacements(j*nv+i);
       }
+   NodesUpdated();
 }
 
 void Mesh::GetVertices(Vector &vert_coord) const
@@ -5610,6 +5666,7 @@ void Mesh::SetVertices(const Vector &vert_coord)
       {
          vertices[i](j) = vert_coord(j*nv+i);
       }
+   NodesUpdated();
 }
 
 void Mesh::GetNode(int i, double *coord)
@@ -5649,6 +5706,7 @@ void Mesh::SetNode(int i, const double *coord)
       }
 
    }
+   NodesUpdated();
 }
 
 void Mesh::MoveNodes(const Vector &displacements)
@@ -5656,6 +5714,7 @@ void Mesh::MoveNodes(const Vector &displacements)
    if (Nodes)
    {
       (*Nodes) += displacements;
+      NodesUpdated();
    }
    else
    {
@@ -5680,6 +5739,7 @@ void Mesh::SetNodes(const Vector &node_coord)
    if (Nodes)
    {
       (*Nodes) = node_coord;
+      NodesUpdated();
    }
    else
    {
@@ -5699,12 +5759,14 @@ void Mesh::NewNodes(GridFunction &nodes, bool make_owner)
       delete NURBSext;
       NURBSext = nodes.FESpace()->StealNURBSext();
    }
+   NodesUpdated();
 }
 
 void Mesh::SwapNodes(GridFunction *&nodes, int &own_nodes_)
 {
    mfem::Swap<GridFunction*>(Nodes, nodes);
    mfem::Swap<int>(own_nodes, own_nodes_);
+   NodesUpdated();
    // TODO:
    // if (nodes)
    //    nodes->FESpace()->MakeNURBSextOwner();
@@ -6939,6 +7001,9 @@ void Mesh::Swap(Mesh& other, bool non_geometry)
       mfem::Swap(Nodes, other.Nodes);
       mfem::Swap(own_nodes, other.own_nodes);
    }
+
+   NodesUpdated();
+   other.NodesUpdated();
 }
 
 void Mesh::GetElementData(const Array<Element*> &elem_array, int geom,
@@ -9027,6 +9092,7 @@ void Mesh::Transform(void (*f)(const Vector&, Vector&))
       xnew.ProjectCoefficient(f_pert);
       *Nodes = xnew;
    }
+   NodesUpdated();
 }
 
 void Mesh::Transform(VectorCoefficient &deformation)
@@ -9051,6 +9117,7 @@ void Mesh::Transform(VectorCoefficient &deformation)
       xnew.ProjectCoefficient(deformation);
       *Nodes = xnew;
    }
+   NodesUpdated();
 }
 
 void Mesh::RemoveUnusedVertices()
@@ -9273,6 +9340,306 @@ std::ostream &operator<<(std::ostream &out, const Mesh &mesh)
    return out;
 }
 
+void Mesh::NodesUpdated()
+{
+   delete elem_bvh;
+   elem_bvh = NULL;
+   elem_bvh_sequence = -1;
+   elem_bvh_contains = true;
+
+   DeleteGeometricFactors();
+}
+
+void Mesh::DeleteGeometricFactors()
+{
+   for (int g = 0; g < Geometry::NumGeom; g++)
+   {
+      while (geom_factors[g])
+      {
+         GeometricFactors *gf = geom_factors[g];
+         geom_factors[g] = gf->next;
+         delete gf;
+      }
+   }
+   for (int i = 0; i < old_geom_factors.Size(); i++)
+   {
+      delete old_geom_factors[i];
+   }
+   old_geom_factors.DeleteAll();
+}
+
+unsigned long Mesh::NodesChecksum() const
+{
+   const double *x = NULL;
+   int n = 0;
+   if (Nodes)
+   {
+      x = Nodes->GetData();
+      n = Nodes->Size();
+   }
+   else if (vertices.Size() > 0)
+   {
+      x = vertices[0]();
+      n = 3*vertices.Size();
+   }
+   // FNV-1a hash of the bytes of the coordinates
+   const unsigned char *bytes = reinterpret_cast<const unsigned char *>(x);
+   unsigned long h = 2166136261UL;
+   for (size_t i = 0; i < n*sizeof(double); i++)
+   {
+      h = (h ^ bytes[i])*16777619UL;
+   }
+   return h;
+}
+
+void Mesh::SetGeometricFactorsCaching(bool use)
+{
+   geom_factors_cache = use;
+   if (!use) { DeleteGeometricFactors(); }
+}
+
+const GeometricFactors *Mesh::GetGeometricFactors(const IntegrationRule &ir,
+                                                  int flags,
+                                                  Geometry::Type geom)
+{
+   if (geom == Geometry::INVALID)
+   {
+      MFEM_VERIFY(GetNE() > 0, "the mesh has no elements");
+      geom = GetElementBaseGeometry(0);
+   }
+
+   // Search the list without a lock: the entries are complete before they
+   // are linked, their rules and 'next' pointers are not modified, and the
+   // entries are not deleted while they can be in use.
+   GeometricFactors *gf;
+#ifdef MFEM_USE_OPENMP
+   #pragma omp atomic read
+#endif
+   gf = geom_factors[geom];
+   while (gf && !gf->Matches(geom, ir)) { gf = gf->next; }
+   if (gf && gf->sequence == sequence)
+   {
+      int computed;
+#ifdef MFEM_USE_OPENMP
+      #pragma omp atomic read
+#endif
+      computed = gf->computed_factors;
+      if ((flags & ~computed) == 0)
+      {
+#ifdef MFEM_USE_OPENMP
+         #pragma omp flush
+#endif
+         return gf;
+      }
+   }
+
+#ifdef MFEM_USE_OPENMP
+   #pragma omp critical (MFEM_GEOMETRIC_FACTORS)
+#endif
+   {
+      // search again, another thread may have added the factors
+      GeometricFactors **link = &geom_factors[geom];
+      while (*link && !(*link)->Matches(geom, ir)) { link = &(*link)->next; }
+      gf = *link;
+      const unsigned long checksum = NodesChecksum();
+      if (gf && (gf->sequence != sequence || gf->nodes_checksum != checksum))
+      {
+         // the mesh was modified: recompute all factors that were requested;
+         // other threads may still be reading the old entry
+         flags |= gf->computed_factors;
+         *link = gf->next;
+         old_geom_factors.Append(gf);
+         gf = NULL;
+      }
+      if (gf)
+      {
+         gf->Compute(this, flags);
+      }
+      else
+      {
+         gf = new GeometricFactors(this, geom, ir, flags);
+         gf->nodes_checksum = checksum;
+         gf->next = geom_factors[geom];
+#ifdef MFEM_USE_OPENMP
+         #pragma omp flush
+         #pragma omp atomic write
+#endif
+         geom_factors[geom] = gf;
+      }
+   }
+   return gf;
+}
+
+void Mesh::CheckGeometricFactors()
+{
+   bool cached = false;
+   for (int g = 0; g < Geometry::NumGeom; g++)
+   {
+      if (geom_factors[g]) { cached = true; }
+   }
+   if (!cached) { return; }
+   const unsigned long checksum = NodesChecksum();
+   for (int g = 0; g < Geometry::NumGeom; g++)
+   {
+      GeometricFactors **link = &geom_factors[g];
+      while (*link)
+      {
+         GeometricFactors *gf = *link;
+         if (gf->sequence != sequence || gf->nodes_checksum != checksum)
+         {
+            *link = gf->next;
+            delete gf;
+         }
+         else { link = &gf->next; }
+      }
+   }
+   for (int i = 0; i < old_geom_factors.Size(); i++)
+   {
+      delete old_geom_factors[i];
+   }
+   old_geom_factors.DeleteAll();
+}
+
+// Maps from the node values of curved elements to the coefficients of the same
+// polynomials in the Bernstein basis of their order, i.e. to the control points
+// of the elements. The Bernstein basis is nonnegative and a partition of unity,
+// so an element is contained in the convex hull of its control points.
+class ControlPointMaps
+{
+   Array<const FiniteElement *> fes;
+   Array<DenseMatrix *> maps;
+   Array<FiniteElementCollection *> fecs;
+
+public:
+   // Return the map for the element 'fe', or NULL if 'fe' is not a nodal
+   // element with the polynomial space of the Bernstein basis of its order.
+   const DenseMatrix *GetMap(const FiniteElement &fe)
+   {
+      const int k = fes.Find(&fe);
+      if (k >= 0) { return maps[k]; }
+
+      DenseMatrix *map = NULL;
+      const int dim = fe.GetDim(), p = fe.GetOrder();
+      if (dynamic_cast<const NodalFiniteElement *>(&fe) && p >= 1 && dim >= 1)
+      {
+         FiniteElementCollection *fec = new H1Pos_FECollection(p, dim);
+         fecs.Append(fec);
+         const FiniteElement *pos = fec->FiniteElementForGeometry(
+                                       fe.GetGeomType());
+         const int nd = fe.GetDof();
+         if (pos && pos->GetDof() == nd)
+         {
+            // B(i,j) is the Bernstein basis function j at node i of 'fe', and
+            // the map is B^{-1}
+            DenseMatrix B(nd);
+            Vector shape(nd);
+            for (int i = 0; i < nd; i++)
+            {
+               pos->CalcShape(fe.GetNodes().IntPoint(i), shape);
+               B.SetRow(i, shape);
+            }
+            map = new DenseMatrix(nd);
+            DenseMatrixInverse(B).GetInverseMatrix(*map);
+         }
+      }
+      fes.Append(&fe);
+      maps.Append(map);
+      return map;
+   }
+
+   ~ControlPointMaps()
+   {
+      for (int i = 0; i < maps.Size(); i++) { delete maps[i]; }
+      for (int i = 0; i < fecs.Size(); i++) { delete fecs[i]; }
+   }
+};
+
+// Compute the box of the element with transformation T, see
+// Mesh::GetElementBoundingBox(), and return true if it contains the element.
+static bool ElementBoundingBox(IsoparametricTransformation &T, int sdim,
+                               ControlPointMaps &cp_maps,
+                               Vector &bmin, Vector &bmax)
+{
+   // Linear and multilinear elements are contained in the convex hull of their
+   // vertices, positive (Bernstein) elements in the one of their nodes, and
+   // other curved nodal elements in the one of their control points.
+   const FiniteElement &fe = *T.GetFE();
+   const DenseMatrix &pm = T.GetPointMat();
+   const DenseMatrix *map = NULL;
+   bool contains = true;
+   if (T.Order() > 1 && !dynamic_cast<const PositiveFiniteElement *>(&fe))
+   {
+      map = cp_maps.GetMap(fe);
+      contains = (map != NULL);
+   }
+   DenseMatrix cp;
+   if (map)
+   {
+      cp.SetSize(pm.Height(), pm.Width());
+      MultABt(pm, *map, cp);
+   }
+   const DenseMatrix &pts = map ? cp : pm;
+
+   bmin.SetSize(sdim);
+   bmax.SetSize(sdim);
+   for (int d = 0; d < sdim; d++)
+   {
+      bmin(d) = bmax(d) = pts(d, 0);
+      for (int j = 1; j < pts.Width(); j++)
+      {
+         bmin(d) = std::min(bmin(d), pts(d, j));
+         bmax(d) = std::max(bmax(d), pts(d, j));
+      }
+   }
+   // Pad by a round-off tolerance or, for the elements without a bound from
+   // their nodes, e.g. NURBS elements, by a fraction of the box size.
+   const double rel_pad = contains ? 1e-12 : 0.1;
+   double diam = 0.0;
+   for (int d = 0; d < sdim; d++)
+   {
+      diam = std::max(diam, bmax(d) - bmin(d));
+   }
+   for (int d = 0; d < sdim; d++)
+   {
+      bmin(d) -= rel_pad*diam;
+      bmax(d) += rel_pad*diam;
+   }
+   return contains;
+}
+
+bool Mesh::GetElementBoundingBox(int i, Vector &bmin, Vector &bmax)
+{
+   IsoparametricTransformation T;
+   GetElementTransformation(i, &T);
+   ControlPointMaps cp_maps;
+   return ElementBoundingBox(T, spaceDim, cp_maps, bmin, bmax);
+}
+
+const BoundingVolumeHierarchy &Mesh::GetElementBVH()
+{
+   if (elem_bvh && elem_bvh_sequence == sequence) { return *elem_bvh; }
+
+   DenseMatrix bmin(spaceDim, GetNE()), bmax(spaceDim, GetNE());
+   Vector emin, emax;
+   IsoparametricTransformation T;
+   ControlPointMaps cp_maps;
+   elem_bvh_contains = true;
+   for (int i = 0; i < GetNE(); i++)
+   {
+      GetElementTransformation(i, &T);
+      if (!ElementBoundingBox(T, spaceDim, cp_maps, emin, emax))
+      {
+         elem_bvh_contains = false;
+      }
+      bmin.SetCol(i, emin);
+      bmax.SetCol(i, emax);
+   }
+   delete elem_bvh;
+   elem_bvh = new BoundingVolumeHierarchy(bmin, bmax);
+   elem_bvh_sequence = sequence;
+   return *elem_bvh;
+}
+
 int Mesh::FindPoints(DenseMatrix &point_mat, Array<int>& elem_ids,
                      Array<IntegrationPoint>& ips, bool warn,
                      InverseElementTransformation *inv_trans)
@@ -9289,7 +9656,46 @@ int Mesh::FindPoints(DenseMatrix &point_mat, Array<int>& elem_ids,
    InverseElementTransformation *inv_tr = inv_trans;
    inv_tr = inv_tr ? inv_tr : new InverseElementTransformation;
 
-   // For each point in 'point_mat', find the element whose center is closest.
+   int pts_found = 0;
+   if (find_points_bvh)
+   {
+      // Try only the elements whose bounding boxes contain the point.
+      const BoundingVolumeHierarchy &bvh = GetElementBVH();
+      Array<int> cand;
+      Vector pt(NULL, spaceDim);
+      for (int k = 0; k < npts; k++)
+      {
+         pt.SetData(data+k*spaceDim);
+         cand.SetSize(0);
+         bvh.FindPoint(pt.GetData(), cand);
+         for (int j = 0; j < cand.Size(); j++)
+         {
+            inv_tr->SetTransformation(*GetElementTransformation(cand[j]));
+            int res = inv_tr->Transform(pt, ips[k]);
+            if (res == InverseElementTransformation::Inside)
+            {
+               elem_ids[k] = cand[j];
+               pts_found++;
+               break;
+            }
+         }
+      }
+      // If some boxes only approximate their elements, search the points not
+      // found with the closest element centers below.
+      if (pts_found == npts || elem_bvh_contains)
+      {
+         if (inv_trans == NULL) { delete inv_tr; }
+
+         if (warn && pts_found != npts)
+         {
+            MFEM_WARNING((npts-pts_found) << " points were not found");
+         }
+         return pts_found;
+      }
+   }
+
+   // For each point in 'point_mat' not found yet, find the element whose
+   // center is closest.
    Vector min_dist(npts);
    Array<int> e_idx(npts);
    min_dist = std::numeric_limits<double>::max();
@@ -9302,6 +9708,7 @@ int Mesh::FindPoints(DenseMatrix &point_mat, Array<int>& elem_ids,
          Geometries.GetCenter(GetElementBaseGeometry(i)), pt);
       for (int k = 0; k < npts; k++)
       {
+         if (elem_ids[k] != -1) { continue; }
          double dist = pt.DistanceTo(data+k*spaceDim);
          if (dist < min_dist(k))
          {
@@ -9312,10 +9719,10 @@ int Mesh::FindPoints(DenseMatrix &point_mat, Array<int>& elem_ids,
    }
 
    // Checks if the points lie in the closest element
-   int pts_found = 0;
    pt.NewDataAndSize(NULL, spaceDim);
    for (int k = 0; k < npts; k++)
    {
+      if (elem_ids[k] != -1) { continue; }
       pt.SetData(data+k*spaceDim);
       inv_tr->SetTransformation(*GetElementTransformation(e_idx[k]));
       int res = inv_tr->Transform(pt, ips[k]);
@@ -19,6 +19,8 @@
 #include "tetrahedron.hpp"
 #include "vertex.hpp"
 #include "ncmesh.hpp"
+#include "bvh.hpp"
+#include "geom_factors.hpp"
 #include "../fem/eltrans.hpp"
 #include "../fem/coefficient.hpp"
 #include "../general/gzstream.hpp"
@@ -150,6 +152,24 @@ protected:
    GridFunction *Nodes;
    int own_nodes;
 
+   // Bounding volume hierarchy over the element bounding boxes, built on first
+   // use by GetElementBVH(). It is deleted by NodesUpdated() and rebuilt when
+   // the mesh 'sequence' changes. 'elem_bvh_contains' is false if some boxes
+   // may not contain their elements, see GetElementBoundingBox().
+   BoundingVolumeHierarchy *elem_bvh;
+   long elem_bvh_sequence;
+   bool elem_bvh_contains;
+   bool find_points_bvh;
+
+   // Geometric factors at the points of integration rules, computed on first
+   // use by GetGeometricFactors() and deleted by NodesUpdated(). There is one
+   // list per geometry, linked by GeometricFactors::next, which is searched
+   // without a lock: entries are only prepended, and out-of-date entries are
+   // unlinked and kept in 'old_geom_factors' until no thread can use them.
+   GeometricFactors *geom_factors[Geometry::NumGeom];
+   Array<GeometricFactors*> old_geom_factors;
+   bool geom_factors_cache;
+
    static const int vtk_quadratic_tet[10];
    static const int vtk_quadratic_wedge[18];
    static const int vtk_quadratic_hex[27];
@@ -190,6 +210,9 @@ protected:
    void SetEmpty();  // Init all data members with empty values
    void DestroyTables();
    void DeleteTables() { DestroyTables(); InitTables(); }
+   void DeleteGeometricFactors();
+   // Return a checksum of the node (or vertex) coordinates.
+   unsigned long NodesChecksum() const;
    void DestroyPointers(); // Delete data specifically allocated by class Mesh.
    void Destroy();         // Delete all owned data.
    void DeleteLazyTables();
@@ -910,6 +933,18 @@ public:
    FaceElementTransformations *GetFaceElementTransformations(int FaceNo,
                                                              int mask = 31);
 
+   /** @brief Same as GetFaceElementTransformations(int, int), but the
+       transformations are stored in the user-defined variables @a FElTr,
+       @a ElTr1, @a ElTr2, and @a FTr. */
+   /** Since no data owned by the Mesh is modified, this method can be called
+       concurrently, e.g. in threaded assembly. */
+   void GetFaceElementTransformations(int FaceNo,
+                                      FaceElementTransformations &FElTr,
+                                      IsoparametricTransformation &ElTr1,
+                                      IsoparametricTransformation &ElTr2,
+                                      IsoparametricTransformation &FTr,
+                                      int mask = 31);
+
    FaceElementTransformations *GetInteriorFaceTransformations (int FaceNo)
    {
       if (faces_info[FaceNo].Elem2No < 0) { return NULL; }
@@ -918,6 +953,19 @@ public:
 
    FaceElementTransformations *GetBdrFaceTransformations (int BdrElemNo);
 
+   /** @brief Same as GetBdrFaceTransformations(int), but the transformations
+       are stored in user-defined variables, see
+       GetFaceElementTransformations(int, FaceElementTransformations &,
+       IsoparametricTransformation &, IsoparametricTransformation &,
+       IsoparametricTransformation &, int). */
+   /** Returns false if the face of the boundary element is interior, shared,
+       or non-conforming. */
+   bool GetBdrFaceTransformations(int BdrElemNo,
+                                  FaceElementTransformations &FElTr,
+                                  IsoparametricTransformation &ElTr1,
+                                  IsoparametricTransformation &ElTr2,
+                                  IsoparametricTransformation &FTr);
+
    /// Return true if the given face is interior. @sa FaceIsTrueInterior().
    bool FaceIsInterior(int FaceNo) const
    {
@@ -1007,6 +1055,13 @@ public:
        with the given ones. */
    void SwapNodes(GridFunction *&nodes, int &own_nodes_);
 
+   /** @brief Notify the Mesh that its node (or vertex) coordinates were
+       modified, so that cached geometric data is recomputed when needed. */
+   /** All Mesh methods that move the nodes, e.g. MoveNodes(), SetNodes(), or
+       Transform(), call this method. It has to be called explicitly only when
+       the coordinates are modified directly, e.g. through GetNodes(). */
+   void NodesUpdated();
+
    /// Return the mesh nodes/vertices projected on the given GridFunction.
    void GetNodes(GridFunction &nodes) const;
    /** Replace the internal node GridFunction with a new GridFunction defined
@@ -1234,6 +1289,72 @@ public:
                           Array<IntegrationPoint>& ips, bool warn = true,
                           InverseElementTransformation *inv_trans = NULL);
 
+   /** @brief Select the search strategy used by FindPoints(): the element
+       bounding volume hierarchy (default, see GetElementBVH()) or, if @a use is
+       false, the brute-force comparison of every point with every element
+       center. */
+   /** If some bounding boxes are only estimates, see GetElementBoundingBox(),
+       the points not found with the hierarchy are searched with the
+       brute-force strategy. */
+   void SetFindPointsBVH(bool use) { find_points_bvh = use; }
+
+   /** @brief Compute the lower and upper corners, @a bmin and @a bmax, of an
+       axis-aligned box containing element @a i; return false if the box is
+       only an estimate. */
+   /** For linear and multilinear elements, this is the box of the vertices.
+       For curved elements with nodal (e.g. H1 or L2) or positive basis nodes,
+       it is the box of the Bernstein control points of the element, which
+       contain the element in their convex hull. For other curved elements,
+       e.g. NURBS elements, the box of the nodes is enlarged by a fraction of
+       its size and the function returns false. */
+   bool GetElementBoundingBox(int i, Vector &bmin, Vector &bmax);
+
+   /** @brief Return a bounding volume hierarchy over the bounding boxes of all
+       mesh elements, see GetElementBoundingBox(). */
+   /** The hierarchy is built on the first call and reused until the mesh is
+       modified, or until NodesUpdated() is called. The box indices in the
+       hierarchy are the element indices. */
+   const BoundingVolumeHierarchy &GetElementBVH();
+
+   /** @brief Enable or disable the use of the cached geometric factors by the
+       element transformations, see
+       ElementTransformation::GetGeometricFactors(). Disabled by default. */
+   /** When enabled, the integrators and methods that support the cache, e.g.
+       MassIntegrator, DiffusionIntegrator, or GridFunction::ComputeL2Error(),
+       evaluate the Jacobians of the element transformations only once per
+       integration rule, instead of once per call. This trades memory for speed
+       when the same mesh is integrated over repeatedly: every cached rule
+       stores, for every element, (2 SDim Dim + 1) values per point. Disabling
+       the cache frees it. */
+   void SetGeometricFactorsCaching(bool use);
+
+   /// Return true if the geometric factors cache is enabled.
+   bool GetGeometricFactorsCaching() const { return geom_factors_cache; }
+
+   /** @brief Return the geometric factors @a flags (see
+       GeometricFactors::FactorFlags) of the elements with geometry @a geom at
+       the points of @a ir. */
+   /** The factors are computed on the first call and reused until the mesh is
+       modified, or until NodesUpdated() or CheckGeometricFactors() drop them,
+       independent of the setting of SetGeometricFactorsCaching(). The rule
+       @a ir is identified by its points, so it does not have to outlive the
+       call. If @a geom is Geometry::INVALID, the geometry of the first element
+       is used. This method may be called concurrently by multiple threads:
+       the factors that are already computed are found without a lock. */
+   const GeometricFactors *GetGeometricFactors(
+      const IntegrationRule &ir, int flags,
+      Geometry::Type geom = Geometry::INVALID);
+
+   /** @brief Drop the cached geometric factors if the node (or vertex)
+       coordinates changed since they were computed. */
+   /** This compares checksums of the coordinates, so it detects nodes that
+       were modified through GetNodes() without a call to NodesUpdated(). It
+       is called at the start of BilinearForm::Assemble(),
+       LinearForm::Assemble(), the partial assembly setup, and the
+       GridFunction error computations, and must not be called concurrently
+       with GetGeometricFactors(). */
+   void CheckGeometricFactors();
+
    /// Destroys Mesh.
    virtual ~Mesh() { DestroyPointers(); }
 };
@@ -23,6 +23,8 @@
 #include "hexahedron.hpp"
 #include "tetrahedron.hpp"
 #include "ncmesh.hpp"
+#include "bvh.hpp"
+#include "geom_factors.hpp"
 #include "mesh.hpp"
 #include "mesh_operators.hpp"
 #include "nurbs.hpp"
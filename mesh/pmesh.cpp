@@ -22,6 +22,7 @@
 
 #include <iostream>
 #include <fstream>
+#include <limits>
 
 using namespace std;
 
@@ -1587,6 +1588,7 @@ void ParMesh::GetFaceNbrElementTransformation(
 
    ElTr->Attribute = elem->GetAttribute();
    ElTr->ElementNo = NumOfElements + i;
+   ElTr->mesh = NULL;
 
    if (Nodes == NULL)
    {
@@ -5062,6 +5064,162 @@ int ParMesh::FindPoints(DenseMatrix& point_mat, Array<int>& elem_id,
    return pts_found;
 }
 
+int ParMesh::FindPointsDistributed(const DenseMatrix &point_mat,
+                                   Array<int> &proc_ids, Array<int> &elem_ids,
+                                   Array<IntegrationPoint> &ips, bool warn,
+                                   InverseElementTransformation *inv_trans)
+{
+   const int sdim = SpaceDimension();
+   const int npts = point_mat.Width();
+   MFEM_VERIFY(npts == 0 || point_mat.Height() == sdim,
+               "Invalid points matrix");
+   proc_ids.SetSize(npts);
+   elem_ids.SetSize(npts);
+   ips.SetSize(npts);
+   proc_ids = -1;
+   elem_ids = -1;
+
+   // 1. Exchange the bounding boxes of the local elements; empty ranks use an
+   //    inverted box that contains no points.
+   Vector my_box(2*sdim);
+   if (GetNE() > 0)
+   {
+      Vector bmin, bmax;
+      GetElementBVH().GetBoundingBox(bmin, bmax);
+      for (int d = 0; d < sdim; d++)
+      {
+         my_box(d) = bmin(d);
+         my_box(sdim+d) = bmax(d);
+      }
+   }
+   else
+   {
+      for (int d = 0; d < sdim; d++)
+      {
+         my_box(d) = numeric_limits<double>::max();
+         my_box(sdim+d) = -numeric_limits<double>::max();
+      }
+   }
+   Vector all_boxes(2*sdim*NRanks);
+   MPI_Allgather(my_box.GetData(), 2*sdim, MPI_DOUBLE, all_boxes.GetData(),
+                 2*sdim, MPI_DOUBLE, MyComm);
+   DenseMatrix rank_min(sdim, NRanks), rank_max(sdim, NRanks);
+   for (int r = 0; r < NRanks; r++)
+   {
+      for (int d = 0; d < sdim; d++)
+      {
+         rank_min(d, r) = all_boxes(2*sdim*r + d);
+         rank_max(d, r) = all_boxes(2*sdim*r + sdim + d);
+      }
+   }
+   BoundingVolumeHierarchy rank_bvh(rank_min, rank_max, 1);
+
+   // 2. Route each local point to its candidate ranks, ordered by rank.
+   Table pt_ranks;
+   pt_ranks.MakeI(npts);
+   Array<int> cand;
+   for (int k = 0; k < npts; k++)
+   {
+      cand.SetSize(0);
+      rank_bvh.FindPoint(point_mat.GetColumn(k), cand);
+      pt_ranks.AddColumnsInRow(k, cand.Size());
+   }
+   pt_ranks.MakeJ();
+   for (int k = 0; k < npts; k++)
+   {
+      cand.SetSize(0);
+      rank_bvh.FindPoint(point_mat.GetColumn(k), cand);
+      cand.Sort();
+      pt_ranks.AddConnections(k, cand.GetData(), cand.Size());
+   }
+   pt_ranks.ShiftUpI();
+   Table rank_pts;
+   Transpose(pt_ranks, rank_pts, NRanks);
+
+   Array<int> send_cnt(NRanks), recv_cnt(NRanks);
+   for (int r = 0; r < NRanks; r++) { send_cnt[r] = rank_pts.RowSize(r); }
+   MPI_Alltoall(send_cnt.GetData(), 1, MPI_INT, recv_cnt.GetData(), 1, MPI_INT,
+                MyComm);
+
+   Array<int> send_off(NRanks+1), recv_off(NRanks+1);
+   send_off[0] = recv_off[0] = 0;
+   for (int r = 0; r < NRanks; r++)
+   {
+      send_off[r+1] = send_off[r] + send_cnt[r];
+      recv_off[r+1] = recv_off[r] + recv_cnt[r];
+   }
+   const int nsend = send_off[NRanks], nrecv = recv_off[NRanks];
+
+   // 3. Send the coordinates of the points to the candidate ranks.
+   DenseMatrix send_pts(sdim, nsend), recv_pts(sdim, nrecv);
+   for (int i = 0; i < nsend; i++)
+   {
+      const double *x = point_mat.GetColumn(rank_pts.GetJ()[i]);
+      for (int d = 0; d < sdim; d++) { send_pts(d, i) = x[d]; }
+   }
+   Array<int> dsend_cnt(NRanks), dsend_off(NRanks);
+   Array<int> drecv_cnt(NRanks), drecv_off(NRanks);
+   for (int r = 0; r < NRanks; r++)
+   {
+      dsend_cnt[r] = sdim*send_cnt[r];  dsend_off[r] = sdim*send_off[r];
+      drecv_cnt[r] = sdim*recv_cnt[r];  drecv_off[r] = sdim*recv_off[r];
+   }
+   MPI_Alltoallv(send_pts.GetData(), dsend_cnt.GetData(), dsend_off.GetData(),
+                 MPI_DOUBLE, recv_pts.GetData(), drecv_cnt.GetData(),
+                 drecv_off.GetData(), MPI_DOUBLE, MyComm);
+
+   // 4. Search the received points in the local mesh.
+   Array<int> loc_elem_ids;
+   Array<IntegrationPoint> loc_ips;
+   Mesh::FindPoints(recv_pts, loc_elem_ids, loc_ips, false, inv_trans);
+
+   // 5. Return (element, reference point) for each received point; the replies
+   //    follow the order of the requests.
+   Array<int> reply_elem(nsend);
+   MPI_Alltoallv(loc_elem_ids.GetData(), recv_cnt.GetData(),
+                 recv_off.GetData(), MPI_INT, reply_elem.GetData(),
+                 send_cnt.GetData(), send_off.GetData(), MPI_INT, MyComm);
+
+   DenseMatrix loc_ref(3, nrecv), reply_ref(3, nsend);
+   for (int i = 0; i < nrecv; i++)
+   {
+      loc_ref(0, i) = loc_ips[i].x;
+      loc_ref(1, i) = loc_ips[i].y;
+      loc_ref(2, i) = loc_ips[i].z;
+   }
+   for (int r = 0; r < NRanks; r++)
+   {
+      dsend_cnt[r] = 3*send_cnt[r];  dsend_off[r] = 3*send_off[r];
+      drecv_cnt[r] = 3*recv_cnt[r];  drecv_off[r] = 3*recv_off[r];
+   }
+   MPI_Alltoallv(loc_ref.GetData(), drecv_cnt.GetData(), drecv_off.GetData(),
+                 MPI_DOUBLE, reply_ref.GetData(), dsend_cnt.GetData(),
+                 dsend_off.GetData(), MPI_DOUBLE, MyComm);
+
+   // 6. Since the ranks are traversed in increasing order, the first rank that
+   //    found a point is the one with the minimal rank.
+   int pts_found = 0;
+   for (int r = 0; r < NRanks; r++)
+   {
+      for (int i = send_off[r]; i < send_off[r+1]; i++)
+      {
+         const int k = rank_pts.GetJ()[i];
+         if (proc_ids[k] >= 0 || reply_elem[i] < 0) { continue; }
+         proc_ids[k] = r;
+         elem_ids[k] = reply_elem[i];
+         ips[k].Set3(reply_ref(0, i), reply_ref(1, i), reply_ref(2, i));
+         pts_found++;
+      }
+   }
+
+   if (warn && pts_found != npts)
+   {
+      MFEM_WARNING("rank " << MyRank << ": " << (npts-pts_found)
+                   << " points were not found");
+   }
+   return pts_found;
+}
+
 static void PrintVertex(const Vertex &v, int space_dim, ostream &out)
 {
    out << v(0);
@@ -323,6 +323,29 @@ public:
                           Array<IntegrationPoint>& ips, bool warn = true,
                           InverseElementTransformation *inv_trans = NULL);
 
+   /** @brief Find the ranks, element ids, and reference coordinates of points
+       that are distributed across the ranks.
+
+       Unlike FindPoints(), each rank passes only its own points in the columns
+       of @a point_mat (SpaceDimension() rows); the matrices on different ranks
+       are generally different. The ranks exchange the bounding boxes of their
+       local elements and each point is sent only to the ranks whose boxes
+       contain it, where it is searched with Mesh::FindPoints(). The results are
+       returned to the owner of the point: for the k-th local point, @a
+       proc_ids[k] is the rank that found it, @a elem_ids[k] is the local
+       element index on that rank, and @a ips[k] is the reference point. If a
+       point is found by several ranks, the one with the minimal rank is used.
+       If the point is not found, @a proc_ids[k] and @a elem_ids[k] are -1.
+
+       This is a collective operation; its cost and memory depend only on the
+       number of local points and on the number of candidate ranks per point.
+
+       @returns The number of local points that were found. */
+   int FindPointsDistributed(const DenseMatrix &point_mat,
+                             Array<int> &proc_ids, Array<int> &elem_ids,
+                             Array<IntegrationPoint> &ips, bool warn = true,
+                             InverseElementTransformation *inv_trans = NULL);
+
    /// Debugging method
    void PrintSharedEntities(const char *fname_prefix) const;
 
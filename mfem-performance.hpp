@@ -26,5 +26,6 @@
 #include "fem/tevaluator.hpp"
 #include "fem/tbilininteg.hpp"
 #include "fem/tbilinearform.hpp"
+#include "fem/tfactory.hpp"
 
 #endif
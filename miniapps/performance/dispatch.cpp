@@ -0,0 +1,163 @@
+//                MFEM Templated Bilinear Form Dispatch Example
+//
+// Compile with: make dispatch
+//
+// Sample runs:  dispatch -m ../../data/fichera.mesh -o 2
+//               dispatch -m ../../data/star.mesh -r 3 -o 3
+//               dispatch -m ../../data/inline-quad.mesh -r 3 -o 5
+//               dispatch -m ../../data/inline-hex.mesh -r 1 -o 3 -i mass
+//
+// Description:  This miniapp shows how to select, at runtime, one of several
+//               precompiled instantiations of the templated TBilinearForm,
+//               based on the mesh geometry, the mesh order, and the order of
+//               the finite element space, using TBilinearFormFactory and
+//               DispatchedBilinearForm. The instantiations registered below
+//               cover quadrilateral and hexahedral meshes with bi/tri-linear
+//               nodes and solution orders 1 to 4; for other inputs the generic
+//               BilinearForm is used instead. The miniapp reports which path
+//               was chosen, the assembly time and the throughput of the
+//               operator action, and then solves the Poisson problem with
+//               unit right-hand side and homogeneous Dirichlet boundary
+//               conditions (or the projection of 1 for the mass kernel) with
+//               CG, without forming a sparse matrix in the templated and the
+//               partially assembled cases.
+
+#include "mfem-performance.hpp"
+#include <fstream>
+#include <iostream>
+#include <cstring>
+
+using namespace std;
+using namespace mfem;
+
+int main(int argc, char *argv[])
+{
+   // 1. Parse command-line options.
+   const char *mesh_file = "../../data/fichera.mesh";
+   const char *integ = "diffusion";
+   int ref_levels = 1;
+   int order = 2;
+   int nmult = 10;
+
+   OptionsParser args(argc, argv);
+   args.AddOption(&mesh_file, "-m", "--mesh",
+                  "Mesh file to use.");
+   args.AddOption(&ref_levels, "-r", "--refine",
+                  "Number of times to refine the mesh uniformly.");
+   args.AddOption(&order, "-o", "--order",
+                  "Finite element order (polynomial degree).");
+   args.AddOption(&integ, "-i", "--integrator",
+                  "Kernel: mass or diffusion.");
+   args.AddOption(&nmult, "-n", "--num-mult",
+                  "Number of operator applications to time.");
+   args.Parse();
+   if (!args.Good())
+   {
+      args.PrintUsage(cout);
+      return 1;
+   }
+   args.PrintOptions(cout);
+
+   TKernelType::Type kernel;
+   if (!strcmp(integ, "mass")) { kernel = TKernelType::MASS; }
+   else if (!strcmp(integ, "diffusion")) { kernel = TKernelType::DIFFUSION; }
+   else
+   {
+      cerr << "Unknown kernel: " << integ << endl;
+      return 2;
+   }
+
+   // 2. Register the templated instantiations. Each one is compiled into this
+   //    executable, so the list should be limited to the cases of interest.
+   TBilinearFormFactory factory;
+   factory.AddRange<Geometry::SQUARE, 1, 4, TDiffusionKernel>();
+   factory.AddRange<Geometry::CUBE, 1, 4, TDiffusionKernel>();
+   factory.AddRange<Geometry::SQUARE, 1, 4, TMassKernel>();
+   factory.AddRange<Geometry::CUBE, 1, 4, TMassKernel>();
+   cout << "Number of registered instantiations: " << factory.Size() << endl;
+
+   // 3. Read and refine the mesh. The templated forms require the mesh nodes
+   //    to be stored in an H1 GridFunction of the matching order, ordered
+   //    byNODES, so linear meshes are converted accordingly.
+   Mesh *mesh = new Mesh(mesh_file, 1, 1);
+   const int dim = mesh->Dimension();
+   for (int l = 0; l < ref_levels; l++)
+   {
+      mesh->UniformRefinement();
+   }
+   if (!mesh->GetNodes())
+   {
+      mesh->SetCurvature(1, false, -1, Ordering::byNODES);
+   }
+
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(mesh, &fec);
+   cout << "Number of elements: " << mesh->GetNE() << endl;
+   cout << "Number of unknowns: " << fes.GetTrueVSize() << endl;
+
+   // 4. Create and assemble the operator, timing the assembly.
+   tic_toc.Clear();
+   tic_toc.Start();
+   DispatchedBilinearForm a(factory, kernel, fes);
+   tic_toc.Stop();
+   const double t_asm = tic_toc.RealTime();
+   if (a.UsesTemplatedForm())
+   {
+      cout << "Using the templated form." << endl;
+   }
+   else
+   {
+      cout << "No matching instantiation, using the generic form ("
+           << (a.GetFallbackForm()->GetAssemblyLevel() ==
+               AssemblyLevel::PARTIAL ? "partial" : "full")
+           << " assembly)." << endl;
+   }
+
+   // 5. Time the action of the operator.
+   Vector x(fes.GetVSize()), y(fes.GetVSize());
+   x.Randomize(1);
+   a.Mult(x, y); // warm up
+   tic_toc.Clear();
+   tic_toc.Start();
+   for (int i = 0; i < nmult; i++)
+   {
+      a.Mult(x, y);
+   }
+   tic_toc.Stop();
+   const double t_mult = tic_toc.RealTime()/max(nmult, 1);
+   cout << "Assembly " << t_asm << " s, action " << t_mult << " s ("
+        << 1e-6*fes.GetVSize()/t_mult << " MDofs/s)" << endl;
+
+   // 6. Solve the linear system A X = B with CG, using the constrained
+   //    operator returned by Operator::FormLinearSystem().
+   Array<int> ess_tdof_list;
+   if (kernel == TKernelType::DIFFUSION && mesh->bdr_attributes.Size())
+   {
+      Array<int> ess_bdr(mesh->bdr_attributes.Max());
+      ess_bdr = 1;
+      fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+   }
+   ConstantCoefficient one(1.0);
+   LinearForm b(&fes);
+   b.AddDomainIntegrator(new DomainLFIntegrator(one));
+   b.Assemble();
+   GridFunction sol(&fes);
+   sol = 0.0;
+
+   Operator *A;
+   Vector B, X;
+   a.FormLinearSystem(ess_tdof_list, sol, b, A, X, B);
+   tic_toc.Clear();
+   tic_toc.Start();
+   CG(*A, B, X, 1, 2000, 1e-12, 0.0);
+   tic_toc.Stop();
+   cout << "CG time: " << tic_toc.RealTime() << " s" << endl;
+   a.RecoverFEMSolution(X, b, sol);
+   cout << "Solution norm: " << sol.Normlinf() << endl;
+
+   // 7. Free the used memory.
+   delete A;
+   delete mesh;
+
+   return 0;
+}
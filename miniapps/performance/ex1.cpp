@@ -60,6 +60,11 @@ typedef TIntegrator<coeff_t,TDiffusionKernel> integ_t;
 // Static bilinear form type, combining the above types
 typedef TBilinearForm<mesh_t,sol_fes_t,int_rule_t,integ_t> HPCBilinearForm;
 
+// Estimate of the number of floating-point operations in the action of the
+// partially assembled diffusion operator on one element, assuming sum
+// factorization for tensor product elements.
+double HPCMultFlopsPerElement();
+
 int main(int argc, char *argv[])
 {
    // 1. Parse command-line options.
@@ -295,6 +300,29 @@ int main(int argc, char *argv[])
    tic_toc.Stop();
    cout << " done, " << tic_toc.RealTime() << "s." << endl;
 
+   if (perf && matrix_free)
+   {
+      // Measure the throughput of the partially assembled operator action,
+      // where batches of elements are processed in the lanes of the SIMD
+      // registers.
+      const int nmult = 10;
+      Vector mx(fespace->GetVSize()), my(fespace->GetVSize());
+      mx.Randomize(1);
+      a_hpc->Mult(mx, my); // warm up
+      tic_toc.Clear();
+      tic_toc.Start();
+      for (int i = 0; i < nmult; i++)
+      {
+         a_hpc->Mult(mx, my);
+      }
+      tic_toc.Stop();
+      const double t_mult = tic_toc.RealTime()/nmult;
+      cout << "Operator action (" << AutoSIMDTraits<double,double>::simd_size
+           << " elements per SIMD batch): " << t_mult << "s, "
+           << 1e-9*HPCMultFlopsPerElement()*mesh->GetNE()/t_mult
+           << " GFLOP/s." << endl;
+   }
+
    // 12. Solve the system A X = B with CG. In the standard case, use a simple
    //     symmetric Gauss-Seidel preconditioner.
 
@@ -399,3 +427,23 @@ int main(int argc, char *argv[])
 
    return 0;
 }
+
+double HPCMultFlopsPerElement()
+{
+   const int D = sol_fe_t::dofs, Q = int_rule_t::qpts;
+   // gradient at the quadrature points, its transpose, and the kernel
+   const double kernel_flops = double(rdim*(2*rdim-1))*Q;
+   if (!sol_fe_t::tensor_prod)
+   {
+      return 2.0*(2*rdim*D*Q) + kernel_flops;
+   }
+   const int D1 = int(floor(pow(double(D), 1.0/rdim) + 0.5));
+   const int Q1 = int(floor(pow(double(Q), 1.0/rdim) + 0.5));
+   // one sum-factorized evaluation: rdim 1D contractions of multiply-adds
+   double contr = 0.0;
+   for (int k = 1; k <= rdim; k++)
+   {
+      contr += 2.0*pow(double(Q1), k)*pow(double(D1), rdim-k+1);
+   }
+   return 2.0*rdim*contr + kernel_flops;
+}
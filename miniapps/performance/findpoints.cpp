@@ -0,0 +1,132 @@
+//                MFEM Point Location Benchmark
+//
+// Compile with: make findpoints
+//
+// Sample runs:  findpoints -m ../../data/star.mesh -r 3 -n 10000
+//               findpoints -m ../../data/fichera.mesh -r 2 -n 10000
+//               findpoints -m ../../data/fichera-q3.mesh -r 1 -n 10000
+//               findpoints -m ../../data/inline-hex.mesh -r 3 -n 100000 -no-bf
+//
+// Description:  This miniapp measures the performance of Mesh::FindPoints()
+//               with the element bounding volume hierarchy (BVH) and with the
+//               brute-force search that compares every point with the center
+//               of every element. Random points are generated in the bounding
+//               box of the mesh; the two searches are timed separately, with
+//               the BVH construction time reported on its own, and the element
+//               ids found by both searches are compared.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <cstdlib>
+
+using namespace std;
+using namespace mfem;
+
+int main(int argc, char *argv[])
+{
+   // 1. Parse command-line options.
+   const char *mesh_file = "../../data/fichera.mesh";
+   int ref_levels = 2;
+   int npts = 10000;
+   int seed = 1;
+   bool brute_force = true;
+
+   OptionsParser args(argc, argv);
+   args.AddOption(&mesh_file, "-m", "--mesh",
+                  "Mesh file to use.");
+   args.AddOption(&ref_levels, "-r", "--refine",
+                  "Number of times to refine the mesh uniformly.");
+   args.AddOption(&npts, "-n", "--num-points",
+                  "Number of random points to locate.");
+   args.AddOption(&seed, "-s", "--seed",
+                  "Seed for the random point generator.");
+   args.AddOption(&brute_force, "-bf", "--brute-force", "-no-bf",
+                  "--no-brute-force",
+                  "Also run (and compare with) the brute-force search.");
+   args.Parse();
+   if (!args.Good())
+   {
+      args.PrintUsage(cout);
+      return 1;
+   }
+   args.PrintOptions(cout);
+
+   // 2. Read and refine the mesh.
+   Mesh *mesh = new Mesh(mesh_file, 1, 1);
+   for (int l = 0; l < ref_levels; l++)
+   {
+      mesh->UniformRefinement();
+   }
+   const int sdim = mesh->SpaceDimension();
+   cout << "Number of elements: " << mesh->GetNE() << endl;
+
+   // 3. Generate random points in the bounding box of the mesh.
+   Vector bb_min, bb_max;
+   mesh->GetBoundingBox(bb_min, bb_max);
+   srand(seed);
+   DenseMatrix points(sdim, npts);
+   for (int k = 0; k < npts; k++)
+   {
+      for (int d = 0; d < sdim; d++)
+      {
+         const double r = rand()/(RAND_MAX + 1.0);
+         points(d, k) = bb_min(d) + r*(bb_max(d) - bb_min(d));
+      }
+   }
+
+   // 4. Locate the points using the bounding volume hierarchy.
+   Array<int> bvh_ids, bf_ids;
+   Array<IntegrationPoint> bvh_ips, bf_ips;
+
+   tic_toc.Clear();
+   tic_toc.Start();
+   const BoundingVolumeHierarchy &bvh = mesh->GetElementBVH();
+   tic_toc.Stop();
+   const double bvh_build = tic_toc.RealTime();
+   cout << "BVH: nodes = " << bvh.GetNumNodes() << ", depth = "
+        << bvh.GetDepth() << ", memory = " << bvh.MemoryUsage()/1024
+        << " KB, build time = " << bvh_build << " s" << endl;
+
+   mesh->SetFindPointsBVH(true);
+   tic_toc.Clear();
+   tic_toc.Start();
+   const int bvh_found = mesh->FindPoints(points, bvh_ids, bvh_ips, false);
+   tic_toc.Stop();
+   const double bvh_time = tic_toc.RealTime();
+   cout << "BVH search:         " << bvh_found << " / " << npts
+        << " points found in " << bvh_time << " s ("
+        << npts/bvh_time << " points/s)" << endl;
+
+   // 5. Locate the points using the brute-force search and compare.
+   if (brute_force)
+   {
+      mesh->SetFindPointsBVH(false);
+      tic_toc.Clear();
+      tic_toc.Start();
+      const int bf_found = mesh->FindPoints(points, bf_ids, bf_ips, false);
+      tic_toc.Stop();
+      const double bf_time = tic_toc.RealTime();
+      cout << "Brute-force search: " << bf_found << " / " << npts
+           << " points found in " << bf_time << " s ("
+           << npts/bf_time << " points/s)" << endl;
+      cout << "Speedup (search only): " << bf_time/bvh_time
+           << ", including BVH build: " << bf_time/(bvh_time + bvh_build)
+           << endl;
+
+      // Points on shared element faces may be assigned to different elements,
+      // so only the points found by one search but not the other are counted.
+      int mismatch = 0;
+      for (int k = 0; k < npts; k++)
+      {
+         if ((bvh_ids[k] < 0) != (bf_ids[k] < 0)) { mismatch++; }
+      }
+      cout << "Points found by only one of the searches: " << mismatch
+           << endl;
+   }
+
+   // 6. Free the used memory.
+   delete mesh;
+
+   return 0;
+}
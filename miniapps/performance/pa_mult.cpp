@@ -0,0 +1,164 @@
+//                MFEM Partial Assembly Benchmark
+//
+// Compile with: make pa_mult
+//
+// Sample runs:  pa_mult -m ../../data/star.mesh -r 3 -o 3
+//               pa_mult -m ../../data/fichera.mesh -r 2 -o 2
+//               pa_mult -m ../../data/inline-hex.mesh -r 2 -o 4 -i mass
+//               pa_mult -m ../../data/inline-quad.mesh -r 4 -o 6 -i convection
+//
+// Description:  This miniapp compares the full (SparseMatrix) and the partial
+//               assembly levels of BilinearForm for one of the integrators
+//               supporting partial assembly: mass, diffusion, vector mass, or
+//               convection. For both levels, it reports the assembly time, the
+//               memory used by the assembled data, and the throughput of the
+//               operator action (in millions of dofs per second), and it checks
+//               that the two actions agree. The mesh must consist of
+//               quadrilaterals or hexahedra.
+
+#include "mfem.hpp"
+#include <fstream>
+#include <iostream>
+#include <cstring>
+
+using namespace std;
+using namespace mfem;
+
+void velocity(const Vector &x, Vector &v)
+{
+   v.SetSize(x.Size());
+   v = 1.0;
+   v(0) += x(1);
+}
+
+int main(int argc, char *argv[])
+{
+   // 1. Parse command-line options.
+   const char *mesh_file = "../../data/fichera.mesh";
+   const char *integ = "diffusion";
+   int ref_levels = 2;
+   int order = 2;
+   int nmult = 20;
+
+   OptionsParser args(argc, argv);
+   args.AddOption(&mesh_file, "-m", "--mesh",
+                  "Mesh file to use.");
+   args.AddOption(&ref_levels, "-r", "--refine",
+                  "Number of times to refine the mesh uniformly.");
+   args.AddOption(&order, "-o", "--order",
+                  "Finite element order (polynomial degree).");
+   args.AddOption(&integ, "-i", "--integrator",
+                  "Integrator: mass, diffusion, vector-mass, or convection.");
+   args.AddOption(&nmult, "-n", "--num-mult",
+                  "Number of operator applications to time.");
+   args.Parse();
+   if (!args.Good())
+   {
+      args.PrintUsage(cout);
+      return 1;
+   }
+   args.PrintOptions(cout);
+
+   // 2. Read and refine the mesh, and define the finite element space.
+   Mesh *mesh = new Mesh(mesh_file, 1, 1);
+   const int dim = mesh->Dimension();
+   for (int l = 0; l < ref_levels; l++)
+   {
+      mesh->UniformRefinement();
+   }
+   const bool vector_space = !strcmp(integ, "vector-mass");
+   H1_FECollection fec(order, dim);
+   FiniteElementSpace fes(mesh, &fec, vector_space ? dim : 1);
+   const int size = fes.GetVSize();
+   cout << "Number of elements: " << mesh->GetNE() << endl;
+   cout << "Number of unknowns: " << size << endl;
+
+   // 3. Set up the two bilinear forms.
+   ConstantCoefficient one(1.0);
+   VectorFunctionCoefficient vel(dim, velocity);
+   BilinearForm a_fa(&fes), a_pa(&fes);
+   BilinearForm *forms[2] = { &a_fa, &a_pa };
+   for (int k = 0; k < 2; k++)
+   {
+      BilinearFormIntegrator *bfi = NULL;
+      if (!strcmp(integ, "mass"))
+      {
+         bfi = new MassIntegrator(one);
+      }
+      else if (!strcmp(integ, "diffusion"))
+      {
+         bfi = new DiffusionIntegrator(one);
+      }
+      else if (vector_space)
+      {
+         bfi = new VectorMassIntegrator(one);
+      }
+      else if (!strcmp(integ, "convection"))
+      {
+         bfi = new ConvectionIntegrator(vel);
+      }
+      else
+      {
+         cerr << "Unknown integrator: " << integ << endl;
+         return 2;
+      }
+      forms[k]->AddDomainIntegrator(bfi);
+   }
+   a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+
+   // 4. Assemble and time the actions of both forms.
+   Vector x(size), y_fa(size), y_pa(size);
+   x.Randomize(1);
+   const char *names[2] = { "Full assembly:   ", "Partial assembly:" };
+   Vector *ys[2] = { &y_fa, &y_pa };
+   for (int k = 0; k < 2; k++)
+   {
+      tic_toc.Clear();
+      tic_toc.Start();
+      forms[k]->Assemble();
+      forms[k]->Finalize();
+      tic_toc.Stop();
+      const double t_asm = tic_toc.RealTime();
+
+      forms[k]->Mult(x, *ys[k]); // warm up
+      tic_toc.Clear();
+      tic_toc.Start();
+      for (int i = 0; i < nmult; i++)
+      {
+         forms[k]->Mult(x, *ys[k]);
+      }
+      tic_toc.Stop();
+      const double t_mult = tic_toc.RealTime()/nmult;
+
+      long memory;
+      if (k == 0)
+      {
+         const SparseMatrix &A = a_fa.SpMat();
+         memory = A.NumNonZeroElems()*(sizeof(double) + sizeof(int)) +
+                  (A.Height() + 1)*sizeof(int);
+      }
+      else
+      {
+         // the quadrature point data and the element to dof map
+         Array<BilinearFormIntegrator*> &dbfi = *a_pa.GetDBFI();
+         memory = fes.GetFE(0)->GetDof()*fes.GetVDim()*mesh->GetNE()*
+                  sizeof(int);
+         for (int i = 0; i < dbfi.Size(); i++)
+         {
+            memory += dbfi[i]->GetPAData().Size()*sizeof(double);
+         }
+      }
+      cout << names[k] << " assembly " << t_asm << " s, memory ~ "
+           << memory/1024 << " KB, action " << t_mult << " s ("
+           << 1e-6*size/t_mult << " MDofs/s)" << endl;
+   }
+
+   y_pa -= y_fa;
+   cout << "Relative difference of the actions: "
+        << y_pa.Normlinf()/y_fa.Normlinf() << endl;
+
+   // 5. Free the used memory.
+   delete mesh;
+
+   return 0;
+}
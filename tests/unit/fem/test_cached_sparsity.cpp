@@ -0,0 +1,229 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace cached_sparsity
+{
+
+double coeff(const Vector &x) { return 1.0 + x(0)*x(0) + 2.0*x(1); }
+
+static double amplitude = 0.0;
+
+void deformation(const Vector &x, Vector &y)
+{
+   y.SetSize(x.Size());
+   for (int d = 0; d < x.Size(); d++)
+   {
+      y(d) = x(d) + amplitude*x(d)*x((d+1) % x.Size());
+   }
+}
+
+// Relative difference of the actions of A and B.
+static double MatrixDiff(const SparseMatrix &A, const SparseMatrix &B)
+{
+   Vector x(A.Width()), Ax(A.Height()), Bx(B.Height());
+   x.Randomize(1);
+   A.Mult(x, Ax);
+   B.Mult(x, Bx);
+   Ax -= Bx;
+   return Ax.Normlinf()/std::max(Bx.Normlinf(), 1.0);
+}
+
+TEST_CASE("BilinearForm cached sparsity", "[BilinearForm]")
+{
+   Mesh mesh(3, 3, 3, Element::HEXAHEDRON, true);
+   FunctionCoefficient q(coeff);
+   ConstantCoefficient one(1.0);
+
+   SECTION("Vector H1 space")
+   {
+      for (int ordering = Ordering::byNODES; ordering <= Ordering::byVDIM;
+           ordering++)
+      {
+         H1_FECollection fec(2, 3);
+         FiniteElementSpace fes(&mesh, &fec, 3, ordering);
+
+         BilinearForm a(&fes), a_c(&fes);
+         BilinearForm *forms[2] = { &a, &a_c };
+         for (int k = 0; k < 2; k++)
+         {
+            forms[k]->AddDomainIntegrator(new ElasticityIntegrator(q, one));
+            forms[k]->AddBoundaryIntegrator(new VectorMassIntegrator(q));
+         }
+         a_c.UsePrecomputedSparsity();
+         a_c.UseCachedSparsity();
+         a.Assemble();
+         a.Finalize();
+         a_c.Assemble();
+         REQUIRE(a_c.SpMat().Finalized());
+         a_c.Finalize();
+         REQUIRE(MatrixDiff(a_c.SpMat(), a.SpMat()) < 1e-12);
+
+         // the dofs of an element are coupled in all the components
+         const int ndofs = fes.GetFE(0)->GetDof();
+         REQUIRE(a_c.SpMat().RowSize(fes.DofToVDof(0, 0)) == 3*ndofs);
+
+         // reassembly with the cached positions
+         a_c = 0.0;
+         a_c.Assemble();
+         REQUIRE(MatrixDiff(a_c.SpMat(), a.SpMat()) < 1e-12);
+         a_c.Assemble();
+         a_c.SpMat() *= 0.5;
+         REQUIRE(MatrixDiff(a_c.SpMat(), a.SpMat()) < 1e-12);
+      }
+   }
+
+   SECTION("ND space")
+   {
+      // signed dofs, added with negative signs to the matrix
+      ND_FECollection fec(2, 3);
+      FiniteElementSpace fes(&mesh, &fec);
+
+      BilinearForm a(&fes), a_c(&fes);
+      BilinearForm *forms[2] = { &a, &a_c };
+      for (int k = 0; k < 2; k++)
+      {
+         forms[k]->AddDomainIntegrator(new CurlCurlIntegrator(one));
+         forms[k]->AddDomainIntegrator(new VectorFEMassIntegrator(q));
+      }
+      a_c.UseCachedSparsity();
+      a.Assemble();
+      a.Finalize();
+      a_c.Assemble();
+      a_c.Finalize();
+      a_c = 0.0;
+      a_c.Assemble();
+      REQUIRE(MatrixDiff(a_c.SpMat(), a.SpMat()) < 1e-12);
+
+      // the cache is dropped with the matrix
+      delete a_c.LoseMat();
+      a_c.Assemble();
+      a_c.Finalize();
+      REQUIRE(MatrixDiff(a_c.SpMat(), a.SpMat()) < 1e-12);
+   }
+
+   SECTION("Threaded assembly")
+   {
+      H1_FECollection fec(2, 3);
+      FiniteElementSpace fes(&mesh, &fec, 3, Ordering::byVDIM);
+
+      BilinearForm a(&fes), a_c(&fes);
+      BilinearForm *forms[2] = { &a, &a_c };
+      for (int k = 0; k < 2; k++)
+      {
+         forms[k]->AddDomainIntegrator(new ElasticityIntegrator(q, one));
+         forms[k]->AddBoundaryIntegrator(new VectorMassIntegrator(q));
+      }
+      a_c.EnableThreadedAssembly();
+      a_c.UseCachedSparsity();
+      a.Assemble();
+      a.Finalize();
+      a_c.Assemble();
+      a_c = 0.0;
+      a_c.Assemble();
+      REQUIRE(MatrixDiff(a_c.SpMat(), a.SpMat()) < 1e-12);
+   }
+
+   SECTION("MixedBilinearForm")
+   {
+      H1_FECollection h1_fec(2, 3);
+      ND_FECollection nd_fec(2, 3);
+      FiniteElementSpace h1_fes(&mesh, &h1_fec), nd_fes(&mesh, &nd_fec);
+
+      MixedBilinearForm b(&h1_fes, &nd_fes), b_c(&h1_fes, &nd_fes);
+      b.AddDomainIntegrator(new MixedVectorGradientIntegrator(q));
+      b_c.AddDomainIntegrator(new MixedVectorGradientIntegrator(q));
+      b_c.UsePrecomputedSparsity();
+      b_c.UseCachedSparsity();
+      b.Assemble();
+      b.Finalize();
+      b_c.Assemble();
+      REQUIRE(b_c.SpMat().Finalized());
+      REQUIRE(MatrixDiff(b_c.SpMat(), b.SpMat()) < 1e-12);
+
+      b_c = 0.0;
+      b_c.Assemble();
+      REQUIRE(MatrixDiff(b_c.SpMat(), b.SpMat()) < 1e-12);
+   }
+}
+
+TEST_CASE("NonlinearForm cached sparsity", "[NonlinearForm]")
+{
+   Mesh mesh(2, 2, 2, Element::HEXAHEDRON, true);
+   H1_FECollection fec(2, 3);
+   FiniteElementSpace fes(&mesh, &fec, 3);
+   NeoHookeanModel model(1.0, 2.0);
+
+   NonlinearForm f(&fes), f_c(&fes);
+   f.AddDomainIntegrator(new HyperelasticNLFIntegrator(&model));
+   f_c.AddDomainIntegrator(new HyperelasticNLFIntegrator(&model));
+   f_c.UseCachedSparsity();
+
+   GridFunction x(&fes);
+   VectorFunctionCoefficient y(3, deformation);
+   for (int k = 0; k < 3; k++)
+   {
+      amplitude = 0.05*k;
+      x.ProjectCoefficient(y);
+      const SparseMatrix *J =
+         dynamic_cast<const SparseMatrix *>(&f.GetGradient(x));
+      const SparseMatrix *J_c =
+         dynamic_cast<const SparseMatrix *>(&f_c.GetGradient(x));
+      REQUIRE(J != NULL);
+      REQUIRE(J_c != NULL);
+      REQUIRE(MatrixDiff(*J_c, *J) < 1e-12);
+   }
+}
+
+TEST_CASE("NonlinearForm gradient on a nonconforming mesh", "[NonlinearForm]")
+{
+   // the conforming gradient, cP^t Grad cP, reuses the sparsity of the RAP
+   // product in the repeated calls
+   Mesh mesh(2, 2, 2, Element::HEXAHEDRON, true);
+   mesh.EnsureNCMesh();
+   Array<int> refs(1);
+   refs[0] = 0;
+   mesh.GeneralRefinement(refs);
+   H1_FECollection fec(2, 3);
+   FiniteElementSpace fes(&mesh, &fec, 3);
+   REQUIRE(fes.GetConformingProlongation() != NULL);
+   NeoHookeanModel model(1.0, 2.0);
+
+   NonlinearForm f(&fes);
+   f.AddDomainIntegrator(new HyperelasticNLFIntegrator(&model));
+
+   GridFunction x(&fes);
+   Vector tx(fes.GetTrueVSize());
+   VectorFunctionCoefficient y(3, deformation);
+   for (int k = 0; k < 3; k++)
+   {
+      amplitude = 0.05*k;
+      x.ProjectCoefficient(y);
+      fes.GetRestrictionMatrix()->Mult(x, tx);
+
+      NonlinearForm g(&fes);
+      g.AddDomainIntegrator(new HyperelasticNLFIntegrator(&model));
+      const SparseMatrix *J =
+         dynamic_cast<const SparseMatrix *>(&f.GetGradient(tx));
+      const SparseMatrix *J_g =
+         dynamic_cast<const SparseMatrix *>(&g.GetGradient(tx));
+      REQUIRE(J != NULL);
+      REQUIRE(J_g != NULL);
+      REQUIRE(J->Height() == fes.GetTrueVSize());
+      REQUIRE(MatrixDiff(*J, *J_g) < 1e-12);
+   }
+}
+
+} // namespace cached_sparsity
@@ -0,0 +1,90 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace coefficient
+{
+
+double func(const Vector &x)
+{
+   return x(0)*x(0) + 2.0*x(1) - x(0)*x(1);
+}
+
+double td_func(const Vector &x, double t)
+{
+   return (1.0 + t)*x(0) - x(1);
+}
+
+double sqr(double a) { return a*a; }
+
+// Compare the batch evaluation of Q with the pointwise one on every element.
+double BatchEvalDiff(Coefficient &Q, Mesh &mesh, const IntegrationRule &ir)
+{
+   double max_diff = 0.0;
+   Vector V;
+   for (int e = 0; e < mesh.GetNE(); e++)
+   {
+      ElementTransformation &T = *mesh.GetElementTransformation(e);
+      Q.Eval(V, T, ir);
+      REQUIRE(V.Size() == ir.GetNPoints());
+      for (int i = 0; i < ir.GetNPoints(); i++)
+      {
+         const IntegrationPoint &ip = ir.IntPoint(i);
+         T.SetIntPoint(&ip);
+         max_diff = std::max(max_diff, fabs(V(i) - Q.Eval(T, ip)));
+      }
+   }
+   return max_diff;
+}
+
+TEST_CASE("Coefficient batch evaluation", "[Coefficient]")
+{
+   Mesh mesh(3, 2, Element::QUADRILATERAL, true, 2.0, 1.0);
+   for (int e = 0; e < mesh.GetNE(); e++)
+   {
+      mesh.SetAttribute(e, 1 + e%3);
+   }
+   mesh.SetAttributes();
+   mesh.SetCurvature(2);
+   const IntegrationRule &ir = IntRules.Get(Geometry::SQUARE, 4);
+
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   GridFunction x(&fes);
+   FunctionCoefficient f(func);
+   x.ProjectCoefficient(f);
+
+   ConstantCoefficient c(3.0);
+   Vector pw(3);
+   pw(0) = 1.0; pw(1) = -2.0; pw(2) = 5.0;
+   PWConstCoefficient pwc(pw);
+   FunctionCoefficient tdf(td_func);
+   tdf.SetTime(0.5);
+   GridFunctionCoefficient gfc(&x);
+   SumCoefficient sum(f, pwc, 2.0, -1.0);
+   ProductCoefficient prod(gfc, tdf);
+   TransformedCoefficient tc(&f, sqr);
+
+   REQUIRE(BatchEvalDiff(c, mesh, ir) == 0.0);
+   REQUIRE(BatchEvalDiff(pwc, mesh, ir) == 0.0);
+   REQUIRE(BatchEvalDiff(f, mesh, ir) < 1e-14);
+   REQUIRE(BatchEvalDiff(tdf, mesh, ir) < 1e-14);
+   REQUIRE(BatchEvalDiff(gfc, mesh, ir) < 1e-14);
+   REQUIRE(BatchEvalDiff(sum, mesh, ir) < 1e-14);
+   REQUIRE(BatchEvalDiff(prod, mesh, ir) < 1e-14);
+   REQUIRE(BatchEvalDiff(tc, mesh, ir) < 1e-14);
+}
+
+} // namespace coefficient
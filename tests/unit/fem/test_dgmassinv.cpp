@@ -0,0 +1,171 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace dg_mass_inverse
+{
+
+double coeff(const Vector &x)
+{
+   return 1.0 + x(0)*x(0) + x(1);
+}
+
+void distort(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.05*sin(3.0*x(1));
+}
+
+}
+
+TEST_CASE("DG mass matrix inverse", "[DGMassInverse]")
+{
+   Mesh mesh(5, 4, Element::QUADRILATERAL, true, 1.0, 2.0);
+   // distort the mesh, so that the element mass matrices differ
+   mesh.Transform(dg_mass_inverse::distort);
+
+   for (int vdim = 1; vdim <= 2; vdim++)
+   {
+      L2_FECollection fec(3, 2);
+      FiniteElementSpace fes(&mesh, &fec, vdim);
+      FunctionCoefficient Q(dg_mass_inverse::coeff);
+
+      BilinearForm m(&fes);
+      if (vdim == 1) { m.AddDomainIntegrator(new MassIntegrator(Q)); }
+      else { m.AddDomainIntegrator(new VectorMassIntegrator(Q)); }
+      m.Assemble();
+      m.Finalize();
+
+      DGMassInverse m_inv(fes, &Q);
+      Vector x(fes.GetVSize()), b(fes.GetVSize()), r(fes.GetVSize());
+      b.Randomize(vdim);
+      m_inv.Mult(b, x);
+      m.Mult(x, r);
+      r -= b;
+      REQUIRE(r.Normlinf() < 1e-12*b.Normlinf());
+   }
+}
+
+TEST_CASE("Static condensation and hybridization", "[StaticCondensation]")
+{
+   Mesh mesh(4, 4, Element::QUADRILATERAL, true);
+   const int dim = mesh.Dimension();
+   ConstantCoefficient one(1.0);
+
+   SECTION("Static condensation")
+   {
+      H1_FECollection fec(4, dim);
+      FiniteElementSpace fes(&mesh, &fec);
+      Array<int> ess_bdr(mesh.bdr_attributes.Max()), ess_tdofs;
+      ess_bdr = 1;
+      fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+      LinearForm b(&fes);
+      b.AddDomainIntegrator(new DomainLFIntegrator(one));
+      b.Assemble();
+
+      GridFunction x0(&fes), x1(&fes);
+      GridFunction *x[2] = { &x0, &x1 };
+      for (int sc = 0; sc < 2; sc++)
+      {
+         BilinearForm a(&fes);
+         a.AddDomainIntegrator(new DiffusionIntegrator);
+         a.AddDomainIntegrator(new MassIntegrator);
+         if (sc) { a.EnableStaticCondensation(); }
+         a.Assemble();
+         *x[sc] = 0.0;
+         SparseMatrix A;
+         Vector X, B;
+         a.FormLinearSystem(ess_tdofs, *x[sc], b, A, X, B);
+         SparseCholeskySolver(A).Mult(B, X);
+         a.RecoverFEMSolution(X, b, *x[sc]);
+      }
+      x1 -= x0;
+      REQUIRE(x1.Normlinf() < 1e-12*x0.Normlinf());
+   }
+
+   SECTION("Static condensation with repeated element matrices")
+   {
+      H1_FECollection fec(3, dim);
+      FiniteElementSpace fes(&mesh, &fec);
+      DiffusionIntegrator diff;
+      MassIntegrator mass;
+
+      // The Schur complement is linear in the scaling of the element matrix,
+      // so adding the element matrix in two halves gives the same matrix.
+      StaticCondensation sc1(&fes), sc2(&fes);
+      sc1.Init(false, false);
+      sc2.Init(false, false);
+      DenseMatrix elmat, mass_mat;
+      for (int e = 0; e < fes.GetNE(); e++)
+      {
+         ElementTransformation &T = *fes.GetElementTransformation(e);
+         diff.AssembleElementMatrix(*fes.GetFE(e), T, elmat);
+         mass.AssembleElementMatrix(*fes.GetFE(e), T, mass_mat);
+         elmat += mass_mat;
+         sc1.AssembleMatrix(e, elmat);
+         elmat *= 0.5;
+         sc2.AssembleMatrix(e, elmat);
+         sc2.AssembleMatrix(e, elmat);
+      }
+      sc1.Finalize();
+      sc2.Finalize();
+
+      Vector v(sc1.GetMatrix().Width()), y1(v.Size()), y2(v.Size());
+      v.Randomize(1);
+      sc1.GetMatrix().Mult(v, y1);
+      sc2.GetMatrix().Mult(v, y2);
+      y2 -= y1;
+      REQUIRE(y2.Normlinf() < 1e-12*y1.Normlinf());
+   }
+
+   SECTION("Hybridization")
+   {
+      RT_FECollection fec(2, dim);
+      FiniteElementSpace fes(&mesh, &fec);
+      DG_Interface_FECollection hfec(2, dim);
+      FiniteElementSpace hfes(&mesh, &hfec);
+      Array<int> ess_tdofs;
+      Vector f(dim);
+      f(0) = 1.0;
+      f(1) = -2.0;
+      VectorConstantCoefficient F(f);
+      LinearForm b(&fes);
+      b.AddDomainIntegrator(new VectorFEDomainLFIntegrator(F));
+      b.Assemble();
+
+      GridFunction x0(&fes), x1(&fes);
+      GridFunction *x[2] = { &x0, &x1 };
+      for (int hb = 0; hb < 2; hb++)
+      {
+         BilinearForm a(&fes);
+         a.AddDomainIntegrator(new DivDivIntegrator);
+         a.AddDomainIntegrator(new VectorFEMassIntegrator);
+         if (hb)
+         {
+            a.EnableHybridization(&hfes, new NormalTraceJumpIntegrator,
+                                  ess_tdofs);
+         }
+         a.Assemble();
+         *x[hb] = 0.0;
+         SparseMatrix A;
+         Vector X, B;
+         a.FormLinearSystem(ess_tdofs, *x[hb], b, A, X, B);
+         SparseCholeskySolver(A).Mult(B, X);
+         a.RecoverFEMSolution(X, b, *x[hb]);
+      }
+      x1 -= x0;
+      REQUIRE(x1.Normlinf() < 1e-10*x0.Normlinf());
+   }
+}
@@ -0,0 +1,215 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace element_matrices
+{
+
+double coeff(const Vector &x)
+{
+   return 1.0 + x(0)*x(0) + ((x.Size() > 1) ? 0.5*x(1) : 0.0);
+}
+
+void matrix_coeff(const Vector &x, DenseMatrix &K)
+{
+   const int dim = x.Size();
+   K.SetSize(dim);
+   K = 0.0;
+   for (int i = 0; i < dim; i++)
+   {
+      K(i,i) = 2.0 + x(i);
+      if (i > 0) { K(i,i-1) = K(i-1,i) = 0.5*x(0); }
+   }
+}
+
+// Distort the unit square/cube, so that the Jacobians are not constant.
+void distort(const Vector &x, Vector &y)
+{
+   const int dim = x.Size();
+   y = x;
+   if (dim == 1) { y(0) += 0.1*x(0)*x(0); return; }
+   y(0) += 0.1*sin(3.0*x(1));
+   y(1) += 0.1*x(0)*x(0);
+   if (dim == 3) { y(2) += 0.1*x(0)*x(1); }
+}
+
+// The gradients of the basis in physical space at the current point of T.
+static void PhysicalGradients(const FiniteElement &el,
+                              ElementTransformation &T, DenseMatrix &gshape)
+{
+   DenseMatrix dshape(el.GetDof(), el.GetDim());
+   el.CalcDShape(T.GetIntPoint(), dshape);
+   gshape.SetSize(el.GetDof(), el.GetDim());
+   Mult(dshape, T.InverseJacobian(), gshape);
+}
+
+// Reference diffusion matrix, assembled point by point.
+static void DiffusionMatrix(const FiniteElement &el, ElementTransformation &T,
+                            const IntegrationRule &ir, Coefficient *Q,
+                            MatrixCoefficient *MQ, DenseMatrix &elmat)
+{
+   const int nd = el.GetDof(), dim = el.GetDim();
+   DenseMatrix gshape, gK(nd, dim), K(dim);
+   elmat.SetSize(nd);
+   elmat = 0.0;
+   for (int q = 0; q < ir.GetNPoints(); q++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(q);
+      T.SetIntPoint(&ip);
+      PhysicalGradients(el, T, gshape);
+      double w = ip.weight*T.Weight();
+      if (MQ)
+      {
+         MQ->Eval(K, T, ip);
+      }
+      else
+      {
+         K.Diag(Q ? Q->Eval(T, ip) : 1.0, dim);
+      }
+      Mult(gshape, K, gK);
+      AddMult_a_ABt(w, gK, gshape, elmat);
+   }
+}
+
+// Reference elasticity matrix, assembled point by point.
+static void ElasticityMatrix(const FiniteElement &el, ElementTransformation &T,
+                             const IntegrationRule &ir, Coefficient &lambda,
+                             Coefficient &mu, DenseMatrix &elmat)
+{
+   const int nd = el.GetDof(), dim = el.GetDim();
+   DenseMatrix gshape;
+   elmat.SetSize(nd*dim);
+   elmat = 0.0;
+   for (int q = 0; q < ir.GetNPoints(); q++)
+   {
+      const IntegrationPoint &ip = ir.IntPoint(q);
+      T.SetIntPoint(&ip);
+      PhysicalGradients(el, T, gshape);
+      const double w = ip.weight*T.Weight();
+      const double L = w*lambda.Eval(T, ip), M = w*mu.Eval(T, ip);
+      for (int a = 0; a < dim; a++)
+      {
+         for (int b = 0; b < dim; b++)
+         {
+            for (int j = 0; j < nd; j++)
+            {
+               for (int i = 0; i < nd; i++)
+               {
+                  double v = L*gshape(i,a)*gshape(j,b) +
+                             M*gshape(i,b)*gshape(j,a);
+                  if (a == b)
+                  {
+                     for (int c = 0; c < dim; c++)
+                     {
+                        v += M*gshape(i,c)*gshape(j,c);
+                     }
+                  }
+                  elmat(nd*a+i, nd*b+j) += v;
+               }
+            }
+         }
+      }
+   }
+}
+
+// Return the largest relative difference of the element matrices of the
+// integrators and of the reference implementations on the elements of fes.
+static double CompareElementMatrices(FiniteElementSpace &fes)
+{
+   const int dim = fes.GetMesh()->Dimension();
+   FunctionCoefficient Q(coeff);
+   MatrixFunctionCoefficient MQ(dim, matrix_coeff);
+   ConstantCoefficient lambda(2.0);
+   DiffusionIntegrator diff, diff_q(Q), diff_mq(MQ);
+   ElasticityIntegrator elast(lambda, Q);
+
+   double max_diff = 0.0;
+   DenseMatrix elmat, ref;
+   for (int e = 0; e < fes.GetNE(); e++)
+   {
+      const FiniteElement &el = *fes.GetFE(e);
+      ElementTransformation &T = *fes.GetElementTransformation(e);
+      const int order = 2*el.GetOrder() + dim - 1;
+      const IntegrationRule &ir = IntRules.Get(el.GetGeomType(), order);
+      diff.SetIntRule(&ir);
+      diff_q.SetIntRule(&ir);
+      diff_mq.SetIntRule(&ir);
+      elast.SetIntRule(&ir);
+
+      for (int k = 0; k < 4; k++)
+      {
+         if (k < 3)
+         {
+            DiffusionIntegrator &integ = (k == 0) ? diff : (k == 1) ? diff_q :
+                                         diff_mq;
+            integ.AssembleElementMatrix(el, T, elmat);
+            DiffusionMatrix(el, T, ir, (k == 1) ? &Q : NULL,
+                            (k == 2) ? &MQ : NULL, ref);
+         }
+         else
+         {
+            elast.AssembleElementMatrix(el, T, elmat);
+            ElasticityMatrix(el, T, ir, lambda, Q, ref);
+         }
+         REQUIRE(elmat.Height() == ref.Height());
+         elmat -= ref;
+         max_diff = std::max(max_diff, elmat.MaxMaxNorm()/ref.MaxMaxNorm());
+      }
+   }
+   return max_diff;
+}
+
+}
+
+TEST_CASE("Diffusion and elasticity element matrices",
+          "[DiffusionIntegrator][ElasticityIntegrator]")
+{
+   SECTION("1D")
+   {
+      // segments are tensor product elements, but do not use sum
+      // factorization
+      Mesh mesh(3, 1.0);
+      mesh.Transform(element_matrices::distort);
+      for (int p = 1; p <= 4; p++)
+      {
+         H1_FECollection fec(p, 1);
+         FiniteElementSpace fes(&mesh, &fec);
+         REQUIRE(element_matrices::CompareElementMatrices(fes) < 1e-12);
+      }
+   }
+
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      for (int simplex = 0; simplex <= 1; simplex++)
+      {
+         Element::Type type = (dim == 2) ?
+                              (simplex ? Element::TRIANGLE :
+                               Element::QUADRILATERAL) :
+                              (simplex ? Element::TETRAHEDRON :
+                               Element::HEXAHEDRON);
+         Mesh *mesh = (dim == 2) ? new Mesh(2, 2, type, true) :
+                      new Mesh(1, 1, 1, type, true);
+         mesh->Transform(element_matrices::distort);
+         for (int p = 1; p <= 4; p++)
+         {
+            H1_FECollection fec(p, dim);
+            FiniteElementSpace fes(mesh, &fec);
+            // tensor product elements with p >= 2 use sum factorization
+            REQUIRE(element_matrices::CompareElementMatrices(fes) < 1e-12);
+         }
+         delete mesh;
+      }
+   }
+}
@@ -0,0 +1,154 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace multigrid_test
+{
+
+double u_exact(const Vector &x)
+{
+   return sin(M_PI*x(0))*sin(M_PI*x(1));
+}
+
+double f_exact(const Vector &x)
+{
+   return 2.0*M_PI*M_PI*sin(M_PI*x(0))*sin(M_PI*x(1));
+}
+
+double bilinear(const Vector &x)
+{
+   return 1.0 + 2.0*x(0) - x(1) + 3.0*x(0)*x(1);
+}
+
+// Solve the Poisson problem on the finest level of the hierarchy with CG and
+// the geometric multigrid preconditioner; return the number of iterations.
+int SolvePoisson(FiniteElementSpaceHierarchy &fespaces,
+                 AssemblyLevel::Type assembly, double &error)
+{
+   Mesh &mesh = fespaces.GetMeshAtLevel(0);
+   Array<int> ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   GeometricMultigrid mg(fespaces, ess_bdr);
+   for (int l = 0; l < fespaces.GetNumLevels(); l++)
+   {
+      BilinearForm *a = new BilinearForm(&fespaces.GetFESpaceAtLevel(l));
+      a->SetAssemblyLevel(assembly);
+      a->AddDomainIntegrator(new DiffusionIntegrator);
+      a->Assemble();
+      mg.AddForm(a);
+   }
+
+   FiniteElementSpace &fes = fespaces.GetFinestFESpace();
+   FunctionCoefficient f(f_exact), u(u_exact);
+   LinearForm b(&fes);
+   b.AddDomainIntegrator(new DomainLFIntegrator(f));
+   b.Assemble();
+   GridFunction x(&fes);
+   x = 0.0;
+
+   OperatorHandle A;
+   Vector X, B;
+   mg.FormFineLinearSystem(x, b, A, X, B);
+   CGSolver cg;
+   cg.SetOperator(*A.Ptr());
+   cg.SetPreconditioner(mg);
+   cg.SetRelTol(1e-10);
+   cg.SetMaxIter(100);
+   cg.Mult(B, X);
+   REQUIRE(cg.GetConverged());
+   mg.RecoverFineFEMSolution(X, b, x);
+   error = x.ComputeL2Error(u);
+   return cg.GetNumIterations();
+}
+
+}
+
+TEST_CASE("Geometric multigrid", "[GeometricMultigrid]")
+{
+   SECTION("h-refinement hierarchies")
+   {
+      Array<int> its;
+      for (int levels = 2; levels <= 4; levels++)
+      {
+         Mesh *mesh = new Mesh(4, 4, Element::QUADRILATERAL, true);
+         H1_FECollection fec(1, 2);
+         FiniteElementSpace *fes = new FiniteElementSpace(mesh, &fec);
+         FiniteElementSpaceHierarchy fespaces(mesh, fes, true, true);
+         for (int l = 1; l < levels; l++)
+         {
+            fespaces.AddUniformlyRefinedLevel();
+         }
+         REQUIRE(fespaces.GetNumLevels() == levels);
+         REQUIRE(fespaces.GetFinestFESpace().GetMesh()->GetNE() ==
+                 16 << (2*(levels-1)));
+
+         double error;
+         its.Append(multigrid_test::SolvePoisson(fespaces, AssemblyLevel::FULL,
+                                                 error));
+         REQUIRE(error < 0.1);
+      }
+      // mesh independent convergence
+      REQUIRE(its.Last() <= its[0] + 2);
+   }
+
+   SECTION("Prolongations interpolate exactly")
+   {
+      Mesh *mesh = new Mesh(3, 2, Element::QUADRILATERAL, true);
+      H1_FECollection fec(1, 2);
+      FiniteElementSpace *fes = new FiniteElementSpace(mesh, &fec);
+      FiniteElementSpaceHierarchy fespaces(mesh, fes, true, true);
+      fespaces.AddUniformlyRefinedLevel();
+      fespaces.AddOrderRefinedLevel(new H1_FECollection(3, 2));
+
+      // a bilinear function is represented exactly on all the levels
+      FunctionCoefficient bilinear(multigrid_test::bilinear);
+      GridFunction coarse(&fespaces.GetFESpaceAtLevel(0));
+      coarse.ProjectCoefficient(bilinear);
+      Vector v(coarse);
+      for (int l = 1; l < fespaces.GetNumLevels(); l++)
+      {
+         GridFunction fine(&fespaces.GetFESpaceAtLevel(l));
+         fespaces.GetProlongationAtLevel(l).Mult(v, fine);
+         REQUIRE(fine.ComputeL2Error(bilinear) < 1e-12);
+         v = fine;
+      }
+   }
+
+   SECTION("Matrix-free levels with p-coarsening")
+   {
+      Mesh *mesh = new Mesh(4, 4, Element::QUADRILATERAL, true);
+      H1_FECollection fec(1, 2);
+      FiniteElementSpace *fes = new FiniteElementSpace(mesh, &fec);
+      FiniteElementSpaceHierarchy fespaces(mesh, fes, true, true);
+      fespaces.AddUniformlyRefinedLevel();
+      fespaces.AddUniformlyRefinedLevel();
+      fespaces.AddOrderRefinedLevel(new H1_FECollection(2, 2));
+      fespaces.AddOrderRefinedLevel(new H1_FECollection(4, 2));
+
+      double error_full, error_pa;
+      const int its_full =
+         multigrid_test::SolvePoisson(fespaces, AssemblyLevel::FULL,
+                                      error_full);
+      const int its_pa =
+         multigrid_test::SolvePoisson(fespaces, AssemblyLevel::PARTIAL,
+                                      error_pa);
+      // the partial assembly uses higher order quadrature rules, so the
+      // discretizations differ slightly
+      REQUIRE(its_full < 30);
+      REQUIRE(its_pa < 30);
+      REQUIRE(error_full < 1e-5);
+      REQUIRE(error_pa < 1e-5);
+   }
+}
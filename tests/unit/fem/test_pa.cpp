@@ -0,0 +1,154 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace pa
+{
+
+double coeff(const Vector &x) { return 1.0 + x(0)*x(0) + 0.5*x(1); }
+
+void velocity(const Vector &x, Vector &v)
+{
+   v.SetSize(x.Size());
+   v(0) = 1.0 + x(1);
+   v(1) = -x(0);
+   if (x.Size() == 3) { v(2) = 0.5 + x(0)*x(2); }
+}
+
+// Return the relative difference of the full and partial assembly actions.
+static double CompareActions(FiniteElementSpace &fes,
+                             BilinearFormIntegrator *(*make_integ)(int dim),
+                             bool transpose)
+{
+   const int dim = fes.GetMesh()->Dimension();
+   BilinearForm a_fa(&fes), a_pa(&fes);
+   a_fa.AddDomainIntegrator(make_integ(dim));
+   a_pa.AddDomainIntegrator(make_integ(dim));
+   a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   a_fa.Assemble();
+   a_fa.Finalize();
+   a_pa.Assemble();
+
+   Vector x(fes.GetVSize()), y_fa(fes.GetVSize()), y_pa(fes.GetVSize());
+   x.Randomize(1);
+   if (transpose)
+   {
+      a_fa.MultTranspose(x, y_fa);
+      a_pa.MultTranspose(x, y_pa);
+   }
+   else
+   {
+      a_fa.Mult(x, y_fa);
+      a_pa.Mult(x, y_pa);
+   }
+   y_pa -= y_fa;
+   return y_pa.Normlinf()/std::max(y_fa.Normlinf(), 1e-12);
+}
+
+static FunctionCoefficient q_coeff(coeff);
+
+static BilinearFormIntegrator *MakeMass(int)
+{ return new MassIntegrator(q_coeff); }
+
+static BilinearFormIntegrator *MakeDiffusion(int)
+{ return new DiffusionIntegrator(q_coeff); }
+
+static BilinearFormIntegrator *MakeVectorMass(int)
+{ return new VectorMassIntegrator(q_coeff); }
+
+static BilinearFormIntegrator *MakeConvection(int dim)
+{
+   static VectorFunctionCoefficient *v2 = NULL, *v3 = NULL;
+   if (!v2) { v2 = new VectorFunctionCoefficient(2, velocity); }
+   if (!v3) { v3 = new VectorFunctionCoefficient(3, velocity); }
+   return new ConvectionIntegrator((dim == 2) ? *v2 : *v3, -1.0);
+}
+
+TEST_CASE("Partial assembly", "[BilinearForm][PartialAssembly]")
+{
+   for (int dim = 2; dim <= 3; dim++)
+   {
+      Mesh *mesh = (dim == 2) ?
+                   new Mesh(3, 2, Element::QUADRILATERAL, true, 1.0, 1.0) :
+                   new Mesh(2, 2, 2, Element::HEXAHEDRON, true, 1.0, 1.0, 1.0);
+      // Perturb the nodes to get non-affine elements
+      mesh->SetCurvature(1);
+      GridFunction &nodes = *mesh->GetNodes();
+      for (int i = 0; i < nodes.Size(); i++)
+      {
+         nodes(i) += 0.02*sin(7.0*i);
+      }
+
+      for (int p = 1; p <= 3; p++)
+      {
+         H1_FECollection h1_fec(p, dim);
+         L2_FECollection l2_fec(p, dim, BasisType::GaussLegendre);
+         FiniteElementSpace h1_fes(mesh, &h1_fec);
+         FiniteElementSpace l2_fes(mesh, &l2_fec);
+         FiniteElementSpace vec_fes(mesh, &h1_fec, dim);
+
+         REQUIRE(CompareActions(h1_fes, MakeMass, false) < 1e-12);
+         REQUIRE(CompareActions(l2_fes, MakeMass, false) < 1e-12);
+         REQUIRE(CompareActions(h1_fes, MakeDiffusion, false) < 1e-12);
+         REQUIRE(CompareActions(vec_fes, MakeVectorMass, false) < 1e-12);
+         REQUIRE(CompareActions(h1_fes, MakeConvection, false) < 1e-12);
+         REQUIRE(CompareActions(h1_fes, MakeConvection, true) < 1e-12);
+      }
+      delete mesh;
+   }
+}
+
+TEST_CASE("Partial assembly solve", "[BilinearForm][PartialAssembly]")
+{
+   Mesh mesh(4, 4, Element::QUADRILATERAL, true, 1.0, 1.0);
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+
+   Array<int> ess_tdof_list, ess_bdr(mesh.bdr_attributes.Max());
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+   ConstantCoefficient one(1.0);
+   LinearForm b(&fes);
+   b.AddDomainIntegrator(new DomainLFIntegrator(one));
+   b.Assemble();
+
+   GridFunction x_fa(&fes), x_pa(&fes);
+   BilinearForm a_fa(&fes), a_pa(&fes);
+   a_fa.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a_pa.AddDomainIntegrator(new DiffusionIntegrator(one));
+   a_pa.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+   a_fa.Assemble();
+   a_fa.Finalize();
+   a_pa.Assemble();
+
+   BilinearForm *forms[2] = { &a_fa, &a_pa };
+   GridFunction *sols[2] = { &x_fa, &x_pa };
+   for (int k = 0; k < 2; k++)
+   {
+      GridFunction &x = *sols[k];
+      x = 0.0;
+      Operator *A;
+      Vector X, B;
+      forms[k]->FormLinearSystem(ess_tdof_list, x, b, A, X, B);
+      CG(*A, B, X, 0, 1000, 1e-24, 0.0);
+      forms[k]->RecoverFEMSolution(X, b, x);
+      delete A;
+   }
+   x_pa -= x_fa;
+   REQUIRE(x_pa.Normlinf() < 1e-10);
+}
+
+} // namespace pa
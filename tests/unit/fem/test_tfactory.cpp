@@ -0,0 +1,84 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem-performance.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+TEST_CASE("Templated bilinear form factory", "[TBilinearFormFactory]")
+{
+   TBilinearFormFactory factory;
+   factory.AddRange<Geometry::SQUARE, 1, 2, TMassKernel>();
+   factory.Add<Geometry::SQUARE, 1, 2, TDiffusionKernel>();
+   REQUIRE(factory.Size() == 3);
+
+   Mesh mesh(3, 3, Element::QUADRILATERAL, true);
+   // the templated forms require H1 nodes ordered byNODES
+   mesh.SetCurvature(1, false, -1, Ordering::byNODES);
+
+   SECTION("Find() matches the geometry, the orders, and the kernel")
+   {
+      H1_FECollection fec1(1, 2), fec2(2, 2), fec3(3, 2);
+      FiniteElementSpace fes1(&mesh, &fec1), fes2(&mesh, &fec2),
+                         fes3(&mesh, &fec3);
+      REQUIRE(factory.Find(TKernelType::MASS, fes1) == 0);
+      REQUIRE(factory.Find(TKernelType::MASS, fes2) == 1);
+      REQUIRE(factory.Find(TKernelType::DIFFUSION, fes2) == 2);
+      REQUIRE(factory.Find(TKernelType::DIFFUSION, fes1) == -1);
+      REQUIRE(factory.Find(TKernelType::MASS, fes3) == -1);
+
+      Mesh tri_mesh(3, 3, Element::TRIANGLE, true);
+      tri_mesh.SetCurvature(1, false, -1, Ordering::byNODES);
+      FiniteElementSpace tri_fes(&tri_mesh, &fec1);
+      REQUIRE(factory.Find(TKernelType::MASS, tri_fes) == -1);
+   }
+
+   SECTION("A mesh without elements has no match")
+   {
+      Mesh empty(2, 0, 0);
+      empty.FinalizeTopology();
+      H1_FECollection fec(1, 2);
+      FiniteElementSpace fes(&empty, &fec);
+      REQUIRE(factory.Find(TKernelType::MASS, fes) == -1);
+      REQUIRE(factory.Create(TKernelType::MASS, fes) == NULL);
+   }
+
+   SECTION("The templated and the generic forms agree")
+   {
+      for (int k = 0; k < 2; k++)
+      {
+         const TKernelType::Type kernel = k ? TKernelType::DIFFUSION :
+                                          TKernelType::MASS;
+         for (int p = 2; p <= 3; p++)
+         {
+            H1_FECollection fec(p, 2);
+            FiniteElementSpace fes(&mesh, &fec);
+            DispatchedBilinearForm a(factory, kernel, fes, 2.0);
+            REQUIRE(a.UsesTemplatedForm() == (p == 2));
+
+            ConstantCoefficient two(2.0);
+            BilinearForm b(&fes);
+            if (k) { b.AddDomainIntegrator(new DiffusionIntegrator(two)); }
+            else { b.AddDomainIntegrator(new MassIntegrator(two)); }
+            b.Assemble();
+            b.Finalize();
+
+            Vector x(fes.GetVSize()), y(fes.GetVSize()), z(fes.GetVSize());
+            x.Randomize(1);
+            a.Mult(x, y);
+            b.Mult(x, z);
+            z -= y;
+            REQUIRE(z.Normlinf() < 1e-12*y.Normlinf());
+         }
+      }
+   }
+}
@@ -0,0 +1,302 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+#ifdef MFEM_USE_OPENMP
+#include <omp.h>
+#endif
+
+using namespace mfem;
+
+namespace threaded_assembly
+{
+
+double coeff(const Vector &x) { return 1.0 + x(0)*x(0) + 2.0*x(1); }
+
+// Check that the items with the same color share no dofs.
+static bool ColoringIsConflictFree(const Table &colors, int ndofs,
+                                   void (*get_dofs)(const FiniteElementSpace &,
+                                                    int, Array<int> &),
+                                   const FiniteElementSpace &fes)
+{
+   Array<int> marker(ndofs), dofs;
+   marker = -1;
+   for (int c = 0; c < colors.Size(); c++)
+   {
+      for (int j = 0; j < colors.RowSize(c); j++)
+      {
+         get_dofs(fes, colors.GetRow(c)[j], dofs);
+         for (int k = 0; k < dofs.Size(); k++)
+         {
+            const int d = (dofs[k] >= 0) ? dofs[k] : -1-dofs[k];
+            if (marker[d] == c) { return false; }
+            marker[d] = c;
+         }
+      }
+   }
+   return true;
+}
+
+static void ElementDofs(const FiniteElementSpace &fes, int i, Array<int> &d)
+{ fes.GetElementDofs(i, d); }
+
+static void BdrElementDofs(const FiniteElementSpace &fes, int i, Array<int> &d)
+{ fes.GetBdrElementDofs(i, d); }
+
+static void FaceDofs(const FiniteElementSpace &fes, int f, Array<int> &d)
+{
+   Array<int> d2;
+   int e1, e2;
+   fes.GetMesh()->GetFaceElements(f, &e1, &e2);
+   fes.GetElementDofs(e1, d);
+   if (e2 >= 0) { fes.GetElementDofs(e2, d2); d.Append(d2); }
+   // the two elements share the dofs on the face
+   for (int k = 0; k < d.Size(); k++) { if (d[k] < 0) { d[k] = -1-d[k]; } }
+   d.Sort();
+   d.Unique();
+}
+
+static double MatrixDiff(const SparseMatrix &A, const SparseMatrix &B)
+{
+   Vector x(A.Width()), Ax(A.Height()), Bx(B.Height());
+   x.Randomize(1);
+   A.Mult(x, Ax);
+   B.Mult(x, Bx);
+   Ax -= Bx;
+   return Ax.Normlinf()/std::max(Bx.Normlinf(), 1.0);
+}
+
+TEST_CASE("Element coloring", "[FiniteElementSpace]")
+{
+   Mesh mesh(4, 3, Element::QUADRILATERAL, true, 1.0, 1.0);
+   mesh.UniformRefinement();
+   H1_FECollection h1_fec(2, 2);
+   ND_FECollection nd_fec(1, 2);
+   FiniteElementSpace h1_fes(&mesh, &h1_fec), nd_fes(&mesh, &nd_fec);
+
+   FiniteElementSpace *spaces[2] = { &h1_fes, &nd_fes };
+   for (int s = 0; s < 2; s++)
+   {
+      const FiniteElementSpace &fes = *spaces[s];
+      const Table &el_colors = fes.GetElementColoring();
+      const Table &be_colors = fes.GetBdrElementColoring();
+      const Table &f_colors = fes.GetFaceColoring();
+
+      REQUIRE(el_colors.Size_of_connections() == mesh.GetNE());
+      REQUIRE(be_colors.Size_of_connections() == mesh.GetNBE());
+      REQUIRE(f_colors.Size_of_connections() == mesh.GetNumFaces());
+
+      REQUIRE(ColoringIsConflictFree(el_colors, fes.GetNDofs(), ElementDofs,
+                                     fes));
+      REQUIRE(ColoringIsConflictFree(be_colors, fes.GetNDofs(),
+                                     BdrElementDofs, fes));
+      REQUIRE(ColoringIsConflictFree(f_colors, fes.GetNDofs(), FaceDofs,
+                                     fes));
+   }
+   // On a quad mesh, the greedy coloring of Q2 elements needs few colors.
+   REQUIRE(h1_fes.GetElementColoring().Size() <= 8);
+}
+
+TEST_CASE("Thread-safe integrators", "[BilinearForm][LinearForm]")
+{
+   ConstantCoefficient one(1.0);
+   Vector v(2);
+   v = 1.0;
+   VectorConstantCoefficient vone(v);
+
+   // Integrators that keep no scratch data in their members with
+   // MFEM_THREAD_SAFE are used concurrently by the threaded assembly, the
+   // others are used serially.
+   DiffusionIntegrator diff(one);
+   MassIntegrator mass(one);
+   VectorMassIntegrator vmass(one);
+   ElasticityIntegrator elast(one, one);
+   DGDiffusionIntegrator dg_diff(one, -1.0, 2.0);
+   MixedScalarMassIntegrator mixed_mass(one);
+   VectorFEMassIntegrator nd_mass(one);
+   REQUIRE(diff.IsThreadSafe());
+   REQUIRE(mass.IsThreadSafe());
+   REQUIRE(vmass.IsThreadSafe());
+   REQUIRE(elast.IsThreadSafe());
+   REQUIRE(dg_diff.IsThreadSafe());
+   REQUIRE(mixed_mass.IsThreadSafe());
+   REQUIRE(!nd_mass.IsThreadSafe());
+
+   DomainLFIntegrator d_lf(one);
+   BoundaryLFIntegrator b_lf(one);
+   DGDirichletLFIntegrator dg_lf(one, one, -1.0, 2.0);
+   VectorDomainLFIntegrator vd_lf(vone);
+   REQUIRE(d_lf.IsThreadSafe());
+   REQUIRE(b_lf.IsThreadSafe());
+   REQUIRE(dg_lf.IsThreadSafe());
+   REQUIRE(!vd_lf.IsThreadSafe());
+}
+
+TEST_CASE("Threaded assembly", "[BilinearForm][LinearForm]")
+{
+#ifdef MFEM_USE_OPENMP
+   // Use several threads, even on a machine with a single core.
+   const int num_threads = omp_get_max_threads();
+   omp_set_num_threads(4);
+#endif
+   Mesh mesh(3, 4, Element::QUADRILATERAL, true, 1.0, 1.0);
+   mesh.UniformRefinement();
+   FunctionCoefficient q(coeff);
+   ConstantCoefficient one(1.0);
+
+   SECTION("BilinearForm")
+   {
+      H1_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+
+      BilinearForm a(&fes), a_col(&fes);
+      BilinearForm *forms[2] = { &a, &a_col };
+      for (int k = 0; k < 2; k++)
+      {
+         forms[k]->AddDomainIntegrator(new DiffusionIntegrator(q));
+         forms[k]->AddDomainIntegrator(new MassIntegrator(one));
+         forms[k]->AddBoundaryIntegrator(new MassIntegrator(q));
+      }
+      a_col.EnableThreadedAssembly();
+      a.Assemble();
+      a.Finalize();
+      a_col.Assemble();
+      a_col.Finalize();
+      REQUIRE(MatrixDiff(a_col.SpMat(), a.SpMat()) < 1e-12);
+
+      // reassembly into the finalized matrix
+      a_col = 0.0;
+      a_col.Assemble();
+      REQUIRE(MatrixDiff(a_col.SpMat(), a.SpMat()) < 1e-12);
+   }
+
+   SECTION("BilinearForm with COO assembly")
+   {
+      H1_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec, 2);
+
+      BilinearForm a(&fes), a_col(&fes);
+      BilinearForm *forms[2] = { &a, &a_col };
+      for (int k = 0; k < 2; k++)
+      {
+         forms[k]->AddDomainIntegrator(new ElasticityIntegrator(q, one));
+         forms[k]->AddBoundaryIntegrator(new VectorMassIntegrator(q));
+      }
+      a_col.UseCOOAssembly();
+      a_col.EnableThreadedAssembly();
+      a.Assemble(0);
+      a.Finalize(0);
+      a_col.Assemble(0);
+      REQUIRE(a_col.SpMat().Finalized());
+      REQUIRE(MatrixDiff(a_col.SpMat(), a.SpMat()) < 1e-12);
+
+      // reassembly into the finalized matrix
+      a_col = 0.0;
+      a_col.Assemble(0);
+      REQUIRE(MatrixDiff(a_col.SpMat(), a.SpMat()) < 1e-12);
+   }
+
+   SECTION("BilinearForm with face integrators")
+   {
+      L2_FECollection fec(1, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+
+      BilinearForm a(&fes), a_col(&fes);
+      BilinearForm *forms[2] = { &a, &a_col };
+      for (int k = 0; k < 2; k++)
+      {
+         forms[k]->AddDomainIntegrator(new DiffusionIntegrator(q));
+         forms[k]->AddInteriorFaceIntegrator(
+            new DGDiffusionIntegrator(q, -1.0, 2.0));
+         forms[k]->AddBdrFaceIntegrator(
+            new DGDiffusionIntegrator(q, -1.0, 2.0));
+      }
+      a_col.EnableThreadedAssembly();
+      a.Assemble();
+      a.Finalize();
+      a_col.Assemble();
+      a_col.Finalize();
+      REQUIRE(MatrixDiff(a_col.SpMat(), a.SpMat()) < 1e-12);
+
+      a_col = 0.0;
+      a_col.Assemble();
+      REQUIRE(MatrixDiff(a_col.SpMat(), a.SpMat()) < 1e-12);
+   }
+
+   SECTION("BilinearForm with integrators that are not thread-safe")
+   {
+      ND_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+
+      BilinearForm a(&fes), a_col(&fes);
+      BilinearForm *forms[2] = { &a, &a_col };
+      for (int k = 0; k < 2; k++)
+      {
+         forms[k]->AddDomainIntegrator(new CurlCurlIntegrator(q));
+         forms[k]->AddDomainIntegrator(new VectorFEMassIntegrator(one));
+      }
+      a_col.EnableThreadedAssembly();
+      a.Assemble();
+      a.Finalize();
+      a_col.Assemble();
+      a_col.Finalize();
+      REQUIRE(MatrixDiff(a_col.SpMat(), a.SpMat()) < 1e-12);
+   }
+
+   SECTION("MixedBilinearForm")
+   {
+      H1_FECollection trial_fec(2, 2);
+      L2_FECollection test_fec(1, 2);
+      FiniteElementSpace trial_fes(&mesh, &trial_fec);
+      FiniteElementSpace test_fes(&mesh, &test_fec);
+
+      MixedBilinearForm b(&trial_fes, &test_fes), b_col(&trial_fes, &test_fes);
+      b.AddDomainIntegrator(new MixedScalarMassIntegrator(q));
+      b_col.AddDomainIntegrator(new MixedScalarMassIntegrator(q));
+      b_col.EnableThreadedAssembly();
+      b.Assemble();
+      b.Finalize();
+      b_col.Assemble();
+      b_col.Finalize();
+      REQUIRE(MatrixDiff(b_col.SpMat(), b.SpMat()) < 1e-12);
+
+      b_col = 0.0;
+      b_col.Assemble();
+      REQUIRE(MatrixDiff(b_col.SpMat(), b.SpMat()) < 1e-12);
+   }
+
+   SECTION("LinearForm")
+   {
+      L2_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+
+      LinearForm b(&fes), b_col(&fes);
+      LinearForm *forms[2] = { &b, &b_col };
+      for (int k = 0; k < 2; k++)
+      {
+         forms[k]->AddDomainIntegrator(new DomainLFIntegrator(q));
+         forms[k]->AddBdrFaceIntegrator(
+            new DGDirichletLFIntegrator(q, one, -1.0, 2.0));
+      }
+      b_col.EnableThreadedAssembly();
+      b.Assemble();
+      b_col.Assemble();
+
+      b_col -= b;
+      REQUIRE(b_col.Normlinf() < 1e-12*std::max(b.Normlinf(), 1.0));
+   }
+#ifdef MFEM_USE_OPENMP
+   omp_set_num_threads(num_threads);
+#endif
+}
+
+} // namespace threaded_assembly
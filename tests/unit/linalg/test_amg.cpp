@@ -0,0 +1,146 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace amg_test
+{
+
+// Number of AMG preconditioned CG iterations to reduce the residual by 1e-8.
+int PCGIterations(const SparseMatrix &A, Solver &amg)
+{
+   const int n = A.Height();
+   Vector b(n), x(n);
+   b.Randomize(1);
+   x = 0.0;
+   CGSolver cg;
+   cg.SetOperator(A);
+   cg.SetPreconditioner(amg);
+   cg.SetRelTol(1e-8);
+   cg.SetMaxIter(200);
+   cg.Mult(b, x);
+   REQUIRE(cg.GetConverged());
+   return cg.GetNumIterations();
+}
+
+// Assemble the diffusion matrix of a refined square with Dirichlet conditions.
+SparseMatrix *Laplacian(Mesh &mesh, FiniteElementSpace &fes)
+{
+   Array<int> ess_bdr(mesh.bdr_attributes.Max()), ess_tdofs;
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator);
+   a.Assemble();
+   a.Finalize();
+   SparseMatrix *A = new SparseMatrix(a.SpMat());
+   for (int i = 0; i < ess_tdofs.Size(); i++)
+   {
+      A->EliminateRowCol(ess_tdofs[i]);
+   }
+   return A;
+}
+
+}
+
+TEST_CASE("Smoothed aggregation AMG", "[AMGSolver]")
+{
+   SECTION("Scalable diffusion")
+   {
+      Array<int> its;
+      for (int ne = 16; ne <= 64; ne *= 2)
+      {
+         Mesh mesh(ne, ne, Element::QUADRILATERAL, true);
+         H1_FECollection fec(1, 2);
+         FiniteElementSpace fes(&mesh, &fec);
+         SparseMatrix *A = amg_test::Laplacian(mesh, fes);
+
+         AMGSolver amg;
+         amg.SetCoarseSize(50);
+         amg.SetOperator(*A);
+         REQUIRE(amg.GetNumLevels() > 1);
+         REQUIRE(amg.GetOperatorComplexity() < 2.0);
+         its.Append(amg_test::PCGIterations(*A, amg));
+         delete A;
+      }
+      // the iteration counts grow much slower than with a one-level method
+      REQUIRE(its.Last() <= 2*its[0]);
+   }
+
+   SECTION("Symmetric cycles and smoothers")
+   {
+      Mesh mesh(24, 24, Element::QUADRILATERAL, true);
+      H1_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+      SparseMatrix *A = amg_test::Laplacian(mesh, fes);
+      const int n = A->Height();
+
+      for (int t = 0; t < 4; t++)
+      {
+         AMGSolver amg;
+         amg.SetStrengthThreshold(0.08);
+         amg.SetCoarseSize(40);
+         amg.SetCycleType((t % 2) ? AMGSolver::W_CYCLE : AMGSolver::V_CYCLE);
+         amg.SetSmoother((t / 2) ? AMGSolver::CHEBYSHEV : AMGSolver::JACOBI,
+                         2);
+         amg.SetOperator(*A);
+
+         Vector u(n), v(n), Su(n), Sv(n);
+         u.Randomize(2);
+         v.Randomize(3);
+         amg.Mult(u, Su);
+         amg.Mult(v, Sv);
+         REQUIRE(fabs((Su*v) - (Sv*u)) < 1e-10*fabs(Su*v));
+         REQUIRE(amg_test::PCGIterations(*A, amg) < 40);
+      }
+      delete A;
+   }
+
+   SECTION("Elasticity with rigid body modes")
+   {
+      Mesh mesh(24, 6, Element::QUADRILATERAL, true, 4.0, 1.0);
+      H1_FECollection fec(1, 2);
+      FiniteElementSpace fes(&mesh, &fec, 2);
+      Array<int> ess_bdr(mesh.bdr_attributes.Max()), ess_tdofs;
+      ess_bdr = 0;
+      ess_bdr[3] = 1;
+      fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+      ConstantCoefficient one(1.0);
+      BilinearForm a(&fes);
+      a.AddDomainIntegrator(new ElasticityIntegrator(one, one));
+      a.Assemble();
+      // keep the exact zeros so that the sparsity stays symmetric
+      a.Finalize(0);
+      SparseMatrix A(a.SpMat());
+      for (int i = 0; i < ess_tdofs.Size(); i++)
+      {
+         A.EliminateRowCol(ess_tdofs[i]);
+      }
+
+      AMGSolver amg_sys;
+      amg_sys.SetSystemsOptions(2, true);
+      amg_sys.SetCoarseSize(30);
+      amg_sys.SetOperator(A);
+      const int its_sys = amg_test::PCGIterations(A, amg_sys);
+
+      AMGSolver amg_rbm;
+      amg_rbm.SetElasticityOptions(&fes);
+      amg_rbm.SetCoarseSize(30);
+      amg_rbm.SetOperator(A);
+      REQUIRE(amg_rbm.GetNumLevels() > 1);
+      // the coarse spaces contain the three rigid body modes per aggregate
+      REQUIRE(amg_rbm.GetLevelMatrix(1).Height() % 3 == 0);
+      REQUIRE(amg_test::PCGIterations(A, amg_rbm) <= its_sys);
+   }
+}
@@ -155,3 +155,158 @@ TEST_CASE("DenseMatrix A*B^T methods",
    }
 }
 
+
+TEST_CASE("Batched LU and Cholesky factorizations", "[DenseMatrix]")
+{
+   // the number of matrices is not a multiple of the batch size
+   const int m = 7, nk = 11;
+   double tol = 1e-12;
+
+   DenseTensor A(m, m, nk);
+   Vector b(m*nk);
+   b.Randomize(1);
+   for (int k = 0; k < nk; k++)
+   {
+      Vector a_k(m*m);
+      a_k.Randomize(k+2);
+      A(k) = a_k.GetData();
+   }
+
+   SECTION("LU")
+   {
+      DenseTensor LU(A);
+      Array<int> P;
+      BatchLUFactor(LU, P);
+
+      Vector x(b);
+      BatchLUSolve(LU, P, x);
+      for (int k = 0; k < nk; k++)
+      {
+         // same factors as LUFactors
+         DenseMatrix lu_k(A(k));
+         Array<int> p_k(m);
+         LUFactors(lu_k.Data(), p_k.GetData()).Factor(m);
+         for (int i = 0; i < m; i++) { REQUIRE(P[k*m+i] == p_k[i]); }
+         lu_k -= LU(k);
+         REQUIRE(lu_k.MaxMaxNorm() < tol);
+
+         Vector b_k(b.GetData() + k*m, m), x_k(x.GetData() + k*m, m), r(m);
+         A(k).Mult(x_k, r);
+         r -= b_k;
+         REQUIRE(r.Normlinf() < tol*b_k.Normlinf()*A(k).MaxMaxNorm());
+      }
+   }
+
+   SECTION("Cholesky")
+   {
+      // symmetric positive definite matrices A A^t + I
+      DenseTensor S(m, m, nk);
+      for (int k = 0; k < nk; k++)
+      {
+         MultAAt(A(k), S(k));
+         for (int i = 0; i < m; i++) { S(k)(i,i) += 1.0; }
+      }
+      DenseTensor L(S);
+      BatchCholeskyFactor(L);
+
+      Vector x(b);
+      BatchCholeskySolve(L, x);
+      for (int k = 0; k < nk; k++)
+      {
+         DenseMatrix LLt(m);
+         MultAAt(L(k), LLt);
+         LLt -= S(k);
+         REQUIRE(LLt.MaxMaxNorm() < tol*S(k).MaxMaxNorm());
+         REQUIRE(L(k)(0,m-1) == 0.0);
+
+         Vector b_k(b.GetData() + k*m, m), x_k(x.GetData() + k*m, m), r(m);
+         S(k).Mult(x_k, r);
+         r -= b_k;
+         REQUIRE(r.Normlinf() < tol*b_k.Normlinf()*S(k).MaxMaxNorm());
+      }
+   }
+}
+
+TEST_CASE("DenseMatrix products of large matrices", "[DenseMatrix]")
+{
+   // sizes larger than the blocks of the matrix products, and not multiples
+   // of them
+   const int m = 101, n = 37, k = 290;
+   const double a = -1.5;
+   double tol = 1e-12;
+
+   DenseMatrix A(m, k), B(n, k), C(k, n), D(k, m);
+   Vector data;
+   data.SetDataAndSize(A.Data(), m*k);
+   data.Randomize(1);
+   data.SetDataAndSize(B.Data(), n*k);
+   data.Randomize(2);
+   data.SetDataAndSize(C.Data(), k*n);
+   data.Randomize(3);
+   data.SetDataAndSize(D.Data(), k*m);
+   data.Randomize(4);
+   data.SetDataAndSize(NULL, 0);
+
+   // reference products
+   DenseMatrix ABt(m, n), AC(m, n), DtC(m, n), AAt(m, m);
+   ABt = 0.0;
+   AC = 0.0;
+   DtC = 0.0;
+   AAt = 0.0;
+   for (int i = 0; i < m; i++)
+   {
+      for (int l = 0; l < k; l++)
+      {
+         for (int j = 0; j < n; j++)
+         {
+            ABt(i,j) += A(i,l)*B(j,l);
+            AC(i,j) += A(i,l)*C(l,j);
+            DtC(i,j) += D(l,i)*C(l,j);
+         }
+         for (int j = 0; j < m; j++)
+         {
+            AAt(i,j) += A(i,l)*A(j,l);
+         }
+      }
+   }
+
+   DenseMatrix X(m, n);
+   Mult(A, C, X);
+   X -= AC;
+   REQUIRE(X.MaxMaxNorm() < tol*AC.MaxMaxNorm());
+
+   X = AC;
+   AddMult(A, C, X);
+   X.Add(-2.0, AC);
+   REQUIRE(X.MaxMaxNorm() < tol*AC.MaxMaxNorm());
+
+   MultABt(A, B, X);
+   X -= ABt;
+   REQUIRE(X.MaxMaxNorm() < tol*ABt.MaxMaxNorm());
+
+   X = 0.0;
+   AddMultABt(A, B, X);
+   AddMult_a_ABt(-1.0, A, B, X);
+   REQUIRE(X.MaxMaxNorm() < tol*ABt.MaxMaxNorm());
+
+   MultAtB(D, C, X);
+   X -= DtC;
+   REQUIRE(X.MaxMaxNorm() < tol*DtC.MaxMaxNorm());
+
+   DenseMatrix Y(AAt);
+   AddMult_a_AAt(a, A, Y);
+   Y.Add(-(1.0 + a), AAt);
+   REQUIRE(Y.MaxMaxNorm() < tol*AAt.MaxMaxNorm());
+
+   // the product is added to both triangles of a non-symmetric matrix
+   DenseMatrix N(m, m);
+   for (int j = 0; j < m; j++)
+   {
+      for (int i = 0; i < m; i++) { N(i,j) = 1.0 + i - 0.5*j; }
+   }
+   Y = N;
+   AddMult_a_AAt(a, A, Y);
+   Y -= N;
+   Y.Add(-a, AAt);
+   REQUIRE(Y.MaxMaxNorm() < tol*AAt.MaxMaxNorm());
+}
@@ -0,0 +1,552 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace iterative_solvers
+{
+
+// Finite difference Laplacian on an n x n grid, plus the shift c times the
+// identity, with an optional convection term making it nonsymmetric.
+SparseMatrix *Laplacian2D(int n, double c, double conv = 0.0)
+{
+   SparseMatrix *A = new SparseMatrix(n*n);
+   for (int j = 0; j < n; j++)
+   {
+      for (int i = 0; i < n; i++)
+      {
+         const int k = i + j*n;
+         A->Add(k, k, 4.0 + c);
+         if (i > 0) { A->Add(k, k-1, -1.0 - conv); }
+         if (i < n-1) { A->Add(k, k+1, -1.0 + conv); }
+         if (j > 0) { A->Add(k, k-n, -1.0); }
+         if (j < n-1) { A->Add(k, k+n, -1.0); }
+      }
+   }
+   A->Finalize();
+   return A;
+}
+
+TEST_CASE("Fused vector kernels", "[Vector]")
+{
+   const int n = 1001;
+   Vector x(n), y(n), w(n), z(n), z0(n);
+   x.Randomize(1);
+   y.Randomize(2);
+   w.Randomize(3);
+
+   add(x, -0.7, y, z0);
+   const double tol = 1e-12*n;
+
+   double d = AddAndDot(x, -0.7, y, z, w);
+   REQUIRE(z.DistanceTo(z0) == 0.0);
+   REQUIRE(d == Approx(z0*w).epsilon(tol));
+
+   // the result overwrites x and the inner product is with itself
+   z = x;
+   d = AddAndDot(z, -0.7, y, z, z);
+   REQUIRE(z.DistanceTo(z0) == 0.0);
+   REQUIRE(d == Approx(z0*z0).epsilon(tol));
+
+   double dots[2];
+   AddAndDot2(x, -0.7, y, z, w, dots);
+   REQUIRE(z.DistanceTo(z0) == 0.0);
+   REQUIRE(dots[0] == Approx(z0*z0).epsilon(tol));
+   REQUIRE(dots[1] == Approx(z0*w).epsilon(tol));
+
+   Dot2(x, y, w, dots);
+   REQUIRE(dots[0] == Approx(x*y).epsilon(tol));
+   REQUIRE(dots[1] == Approx(x*w).epsilon(tol));
+
+   add(2.0, x, -1.0, y, 0.5, w, z);
+   for (int i = 0; i < n; i++)
+   {
+      REQUIRE(z(i) == Approx(2.0*x(i) - y(i) + 0.5*w(i)));
+   }
+   // z may be one of the inputs
+   z = y;
+   add(2.0, x, -1.0, z, 0.5, w, z);
+   for (int i = 0; i < n; i++)
+   {
+      REQUIRE(z(i) == Approx(2.0*x(i) - y(i) + 0.5*w(i)));
+   }
+}
+
+TEST_CASE("Krylov solvers", "[IterativeSolver]")
+{
+   const int n = 30;
+   const double tol = 1e-10;
+
+   SECTION("CG")
+   {
+      SparseMatrix *A = Laplacian2D(n, 0.1);
+      DSmoother jacobi(*A);
+      Vector b(n*n), x(n*n), r(n*n);
+      b.Randomize(1);
+
+      for (int p = 0; p < 2; p++)
+      {
+         CGSolver cg;
+         cg.SetRelTol(tol);
+         cg.SetMaxIter(500);
+         if (p) { cg.SetPreconditioner(jacobi); }
+         cg.SetOperator(*A);
+         x = 0.0;
+         cg.Mult(b, x);
+         REQUIRE(cg.GetConverged());
+         A->Mult(x, r);
+         r -= b;
+         REQUIRE(r.Norml2() < 10*tol*b.Norml2());
+      }
+      delete A;
+   }
+
+   SECTION("CG variants")
+   {
+      // the pipelined and s-step variants reach the tolerance of CG in about
+      // the same number of iterations
+      SparseMatrix *A = Laplacian2D(n, 0.1);
+      DSmoother jacobi(*A);
+      Vector b(n*n), x(n*n), r(n*n);
+      b.Randomize(1);
+
+      for (int p = 0; p < 2; p++)
+      {
+         CGSolver cg;
+         PipelinedCGSolver pcg;
+         SStepCGSolver scg[3];
+         scg[1].SetStepSize(1);
+         scg[2].SetStepSize(8);
+         IterativeSolver *solvers[5] =
+         { &cg, &pcg, &scg[0], &scg[1], &scg[2] };
+         const int steps[5] = { 1, 1, 4, 1, 8 };
+         for (int k = 0; k < 5; k++)
+         {
+            IterativeSolver &solver = *solvers[k];
+            solver.SetRelTol(tol);
+            solver.SetMaxIter(500);
+            if (p) { solver.SetPreconditioner(jacobi); }
+            solver.SetOperator(*A);
+            x = 0.0;
+            solver.Mult(b, x);
+            REQUIRE(solver.GetConverged());
+            A->Mult(x, r);
+            r -= b;
+            REQUIRE(r.Norml2() < 10*tol*b.Norml2());
+            const int it = solver.GetNumIterations();
+            REQUIRE(it % steps[k] == 0);
+            REQUIRE(it <= cg.GetNumIterations() + 2*steps[k]);
+            REQUIRE(it >= cg.GetNumIterations() - 2);
+         }
+      }
+
+      // initial guess and zero right-hand side
+      PipelinedCGSolver pcg;
+      SStepCGSolver scg;
+      IterativeSolver *solvers[2] = { &pcg, &scg };
+      for (int k = 0; k < 2; k++)
+      {
+         IterativeSolver &solver = *solvers[k];
+         solver.SetRelTol(tol);
+         solver.SetMaxIter(500);
+         solver.SetOperator(*A);
+         solver.iterative_mode = true;
+         x.Randomize(2);
+         solver.Mult(b, x);
+         REQUIRE(solver.GetConverged());
+         A->Mult(x, r);
+         r -= b;
+         REQUIRE(r.Norml2() < 100*tol*b.Norml2());
+
+         Vector zero(n*n);
+         zero = 0.0;
+         x = 0.0;
+         solver.Mult(zero, x);
+         REQUIRE(solver.GetConverged());
+         REQUIRE(solver.GetNumIterations() == 0);
+         REQUIRE(x.Normlinf() == 0.0);
+      }
+      delete A;
+   }
+
+   SECTION("GMRES")
+   {
+      SparseMatrix *A = Laplacian2D(n, 0.1, 0.5);
+      Vector b(n*n), x(n*n), r(n*n);
+      b.Randomize(1);
+
+      GMRESSolver gmres;
+      gmres.SetRelTol(tol);
+      gmres.SetMaxIter(1000);
+      gmres.SetKDim(20);
+      gmres.SetOperator(*A);
+      // repeated solves reuse the workspace; then with a new Krylov dimension
+      // and a new operator size
+      for (int k = 0; k < 3; k++)
+      {
+         if (k == 1) { gmres.SetKDim(30); }
+         if (k == 2)
+         {
+            delete A;
+            A = Laplacian2D(n+1, 0.1, 0.5);
+            b.SetSize((n+1)*(n+1));
+            b.Randomize(2);
+            x.SetSize(b.Size());
+            r.SetSize(b.Size());
+            gmres.SetOperator(*A);
+         }
+         x = 0.0;
+         gmres.Mult(b, x);
+         REQUIRE(gmres.GetConverged());
+         A->Mult(x, r);
+         r -= b;
+         REQUIRE(r.Norml2() < 10*tol*b.Norml2());
+      }
+      delete A;
+   }
+
+   SECTION("BiCGSTAB")
+   {
+      SparseMatrix *A = Laplacian2D(n, 0.1, 0.5);
+      DSmoother jacobi(*A);
+      Vector b(n*n), x(n*n), r(n*n);
+      b.Randomize(1);
+
+      for (int p = 0; p < 2; p++)
+      {
+         BiCGSTABSolver bicgstab;
+         bicgstab.SetRelTol(tol);
+         bicgstab.SetMaxIter(500);
+         if (p) { bicgstab.SetPreconditioner(jacobi); }
+         bicgstab.SetOperator(*A);
+         x = 0.0;
+         bicgstab.Mult(b, x);
+         REQUIRE(bicgstab.GetConverged());
+         A->Mult(x, r);
+         r -= b;
+         REQUIRE(r.Norml2() < 10*tol*b.Norml2());
+      }
+      delete A;
+   }
+}
+
+TEST_CASE("Block Krylov solvers", "[IterativeSolver]")
+{
+   // several right-hand sides, including a repeated one and a zero one
+   const int n = 30, k = 6;
+   const double tol = 1e-10;
+   Array<Vector *> B(k), X(k);
+   for (int c = 0; c < k; c++)
+   {
+      B[c] = new Vector(n*n);
+      X[c] = new Vector(n*n);
+      B[c]->Randomize(c+1);
+   }
+   *B[3] = *B[1];
+   *B[4] = 0.0;
+   Array<const Vector *> cB(k), cX(k);
+   for (int c = 0; c < k; c++) { cB[c] = B[c]; cX[c] = X[c]; }
+   Vector r(n*n);
+
+   SECTION("SparseMatrix ArrayMult")
+   {
+      SparseMatrix *A = Laplacian2D(n, 0.1, 0.5);
+      A->ArrayMult(cB, X);
+      for (int c = 0; c < k; c++)
+      {
+         A->Mult(*B[c], r);
+         r -= *X[c];
+         REQUIRE(r.Normlinf() == 0.0);
+      }
+      delete A;
+   }
+
+   SECTION("BlockCG")
+   {
+      SparseMatrix *A = Laplacian2D(n, 0.1);
+      DSmoother jacobi(*A);
+      for (int p = 0; p < 2; p++)
+      {
+         CGSolver cg;
+         BlockCGSolver bcg;
+         IterativeSolver *solvers[2] = { &cg, &bcg };
+         for (int l = 0; l < 2; l++)
+         {
+            solvers[l]->SetRelTol(tol);
+            solvers[l]->SetMaxIter(500);
+            if (p) { solvers[l]->SetPreconditioner(jacobi); }
+            solvers[l]->SetOperator(*A);
+         }
+         *X[0] = 0.0;
+         cg.Mult(*B[0], *X[0]);
+         const int cg_iter = cg.GetNumIterations();
+
+         bcg.iterative_mode = false;
+         bcg.ArrayMult(cB, X);
+         REQUIRE(bcg.GetConverged());
+         REQUIRE(bcg.GetNumIterations() < cg_iter);
+         for (int c = 0; c < k; c++)
+         {
+            A->Mult(*X[c], r);
+            r -= *B[c];
+            REQUIRE(r.Norml2() <= 10*tol*std::max(B[c]->Norml2(), 1.0));
+         }
+         REQUIRE(X[4]->Normlinf() == 0.0);
+
+         // one right-hand side: the iterates of CG
+         *X[0] = 0.0;
+         bcg.Mult(*B[0], *X[0]);
+         REQUIRE(bcg.GetConverged());
+         REQUIRE(std::abs(bcg.GetNumIterations() - cg_iter) <= 2);
+      }
+      delete A;
+   }
+
+   SECTION("BlockGMRES")
+   {
+      SparseMatrix *A = Laplacian2D(n, 0.1, 0.5);
+      DSmoother jacobi(*A);
+      for (int p = 0; p < 2; p++)
+      {
+         GMRESSolver gmres;
+         BlockGMRESSolver bgmres;
+         IterativeSolver *solvers[2] = { &gmres, &bgmres };
+         for (int l = 0; l < 2; l++)
+         {
+            solvers[l]->SetRelTol(tol);
+            solvers[l]->SetMaxIter(1000);
+            if (p) { solvers[l]->SetPreconditioner(jacobi); }
+            solvers[l]->SetOperator(*A);
+         }
+         gmres.SetKDim(50);
+         bgmres.SetKDim(50);
+         *X[0] = 0.0;
+         gmres.Mult(*B[0], *X[0]);
+         const int gmres_iter = gmres.GetNumIterations();
+
+         bgmres.iterative_mode = false;
+         bgmres.ArrayMult(cB, X);
+         REQUIRE(bgmres.GetConverged());
+         REQUIRE(bgmres.GetNumIterations() <= gmres_iter);
+         for (int c = 0; c < k; c++)
+         {
+            A->Mult(*X[c], r);
+            r -= *B[c];
+            REQUIRE(r.Norml2() <= 100*tol*std::max(B[c]->Norml2(), 1.0));
+         }
+         REQUIRE(X[4]->Normlinf() == 0.0);
+
+         // a converged initial guess, and one right-hand side
+         bgmres.iterative_mode = true;
+         bgmres.SetAbsTol(100*tol);
+         bgmres.ArrayMult(cB, X);
+         REQUIRE(bgmres.GetConverged());
+         REQUIRE(bgmres.GetNumIterations() == 0);
+         *X[0] = 0.0;
+         bgmres.Mult(*B[0], *X[0]);
+         REQUIRE(bgmres.GetConverged());
+      }
+      delete A;
+   }
+
+   SECTION("BilinearForm with several right-hand sides")
+   {
+      Mesh mesh(4, 4, Element::QUADRILATERAL, true);
+      mesh.EnsureNCMesh();
+      Array<int> refs(1);
+      refs[0] = 0;
+      mesh.GeneralRefinement(refs);
+      H1_FECollection fec(2, 2);
+      FiniteElementSpace fes(&mesh, &fec);
+      Array<int> ess_tdof_list, ess_bdr(mesh.bdr_attributes.Max());
+      ess_bdr = 1;
+      fes.GetEssentialTrueDofs(ess_bdr, ess_tdof_list);
+
+      ConstantCoefficient one(1.0);
+      BilinearForm a(&fes), a_1(&fes);
+      a.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a_1.AddDomainIntegrator(new DiffusionIntegrator(one));
+      a.Assemble();
+      a_1.Assemble();
+
+      const int nrhs = 3;
+      Array<Vector *> x(nrhs), b(nrhs), Xf(nrhs), Bf(nrhs);
+      for (int i = 0; i < nrhs; i++)
+      {
+         x[i] = new Vector(fes.GetVSize());
+         b[i] = new Vector(fes.GetVSize());
+         Xf[i] = new Vector;
+         Bf[i] = new Vector;
+         x[i]->Randomize(2*i+1);
+         b[i]->Randomize(2*i+2);
+      }
+      Vector x_1(fes.GetVSize()), b_1(fes.GetVSize()), X_1, B_1;
+      x_1 = *x[nrhs-1];
+      b_1 = *b[nrhs-1];
+
+      SparseMatrix A, A_1;
+      a.FormLinearSystem(ess_tdof_list, x, b, A, Xf, Bf);
+      a_1.FormLinearSystem(ess_tdof_list, x_1, b_1, A_1, X_1, B_1);
+      X_1 -= *Xf[nrhs-1];
+      B_1 -= *Bf[nrhs-1];
+      REQUIRE(X_1.Normlinf() == 0.0);
+      REQUIRE(B_1.Normlinf() < 1e-12);
+
+      BlockCGSolver bcg;
+      bcg.iterative_mode = false;
+      bcg.SetRelTol(tol);
+      bcg.SetMaxIter(500);
+      bcg.SetOperator(A);
+      Array<const Vector *> cBf(nrhs);
+      for (int i = 0; i < nrhs; i++) { cBf[i] = Bf[i]; }
+      bcg.ArrayMult(cBf, Xf);
+      REQUIRE(bcg.GetConverged());
+      for (int i = 0; i < nrhs; i++)
+      {
+         Vector res(Xf[i]->Size());
+         A.Mult(*Xf[i], res);
+         res -= *Bf[i];
+         REQUIRE(res.Norml2() <= 10*tol*Bf[i]->Norml2());
+         a.RecoverFEMSolution(*Xf[i], *b[i], *x[i]);
+         delete x[i];
+         delete b[i];
+         delete Xf[i];
+         delete Bf[i];
+      }
+   }
+
+   for (int c = 0; c < k; c++)
+   {
+      delete B[c];
+      delete X[c];
+   }
+}
+
+} // namespace iterative_solvers
+
+TEST_CASE("Power method", "[PowerMethod]")
+{
+   // the largest eigenvalue of the Laplacian is 4 + 4 cos(pi/(n+1)), and its
+   // diagonal is 4 + c
+   const int n = 8;
+   const double c = 1.0;
+   SparseMatrix *A = iterative_solvers::Laplacian2D(n, c);
+   const double lambda = 4.0 + c + 4.0*cos(M_PI/(n+1));
+   Vector dinv(n*n);
+   dinv = 1.0/(4.0 + c);
+   DSmoother jacobi(*A, 0, 1.0, 1);
+
+   PowerMethod power;
+   const double l0 = power.EstimateLargestEigenvalue(*A, NULL);
+   const double l1 = power.EstimateLargestEigenvalue(*A, dinv);
+   const double l2 = power.EstimateLargestEigenvalue(*A, &jacobi);
+   // the Rayleigh quotients are lower bounds
+   REQUIRE(l0 <= lambda*(1.0 + 1e-12));
+   REQUIRE(l0 > 0.9*lambda);
+   REQUIRE(fabs(l1 - l0/(4.0 + c)) < 1e-12*l1);
+   REQUIRE(fabs(l2 - l1) < 1e-12*l1);
+   REQUIRE(fabs(power.EstimateLargestEigenvalue(*A, NULL, 200) - lambda) <
+           1e-6*lambda);
+   delete A;
+}
+
+TEST_CASE("Chebyshev smoother", "[OperatorChebyshevSmoother]")
+{
+   SECTION("Matrix-free operator")
+   {
+      Mesh mesh(8, 8, 8, Element::HEXAHEDRON, true);
+      H1_FECollection fec(3, 3);
+      FiniteElementSpace fes(&mesh, &fec);
+      Array<int> ess_bdr(mesh.bdr_attributes.Max()), ess_tdofs;
+      ess_bdr = 1;
+      fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+
+      BilinearForm a(&fes);
+      a.SetAssemblyLevel(AssemblyLevel::PARTIAL);
+      a.AddDomainIntegrator(new DiffusionIntegrator);
+      a.Assemble();
+      Vector diag;
+      a.AssembleDiagonal(diag);
+
+      LinearForm f(&fes);
+      ConstantCoefficient one(1.0);
+      f.AddDomainIntegrator(new DomainLFIntegrator(one));
+      f.Assemble();
+      GridFunction u(&fes);
+      u = 0.0;
+      Operator *A;
+      Vector X, B;
+      a.FormLinearSystem(ess_tdofs, u, f, A, X, B);
+      const int n = A->Height();
+
+      OperatorJacobiSmoother jacobi(*A, diag, ess_tdofs);
+      OperatorChebyshevSmoother cheb(*A, diag, ess_tdofs, 4);
+      REQUIRE(cheb.GetMaxEigenvalueEstimate() > 1.0);
+
+      // symmetric, so the smoother can precondition CG
+      Vector v(n), w(n), Sv(n), Sw(n);
+      v.Randomize(1);
+      w.Randomize(2);
+      cheb.Mult(v, Sv);
+      cheb.Mult(w, Sw);
+      REQUIRE(fabs((Sv*w) - (Sw*v)) < 1e-10*fabs(Sv*w));
+
+      int its[2];
+      for (int p = 0; p < 2; p++)
+      {
+         CGSolver cg;
+         cg.SetOperator(*A);
+         cg.SetPreconditioner(p ? (Solver &)cheb : (Solver &)jacobi);
+         cg.SetRelTol(1e-10);
+         cg.SetMaxIter(1000);
+         X = 0.0;
+         cg.Mult(B, X);
+         REQUIRE(cg.GetConverged());
+         its[p] = cg.GetNumIterations();
+      }
+      // each application costs 4 operator applications, but the polynomial
+      // reduces the iterations by more than a factor of 2
+      REQUIRE(2*its[1] < its[0]);
+      delete A;
+   }
+
+   SECTION("Smoothing steps")
+   {
+      // the error in the upper part of the spectrum, [0.33 lambda, 1.1 lambda],
+      // is reduced at least by the factor 1/T_4(13/7) < 0.02
+      const int m = 30;
+      SparseMatrix *A = iterative_solvers::Laplacian2D(m, 0.0);
+      Vector diag;
+      A->GetDiag(diag);
+      Array<int> no_ess;
+      OperatorChebyshevSmoother cheb(*A, diag, no_ess, 4);
+      cheb.iterative_mode = true;
+
+      // highly oscillatory error, close to the largest eigenvector
+      Vector x(m*m), b(m*m);
+      b = 0.0;
+      for (int j = 0; j < m; j++)
+      {
+         for (int i = 0; i < m; i++)
+         {
+            x(i + j*m) = sin(M_PI*(m*(i+1))/(m+1)) *
+                         sin(M_PI*(m*(j+1))/(m+1));
+         }
+      }
+      const double e0 = x.Norml2();
+      cheb.Mult(b, x);
+      REQUIRE(x.Norml2() < 0.05*e0);
+      delete A;
+   }
+}
@@ -0,0 +1,176 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "linalg/simd.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace simd_test
+{
+
+// Check the lane-wise operations of simd_t against the scalar ones.
+template <typename simd_t>
+void CheckArithmetic()
+{
+   typedef typename simd_t::scalar_type scalar_t;
+   const int S = simd_t::size;
+   simd_t a, b, c;
+   for (int i = 0; i < S; i++)
+   {
+      a[i] = scalar_t(i + 1);
+      b[i] = scalar_t(2*i + 3);
+   }
+   const scalar_t e = scalar_t(0.5);
+
+   // the data is aligned to align_size values
+   simd_t arr[3];
+   for (int k = 0; k < 3; k++)
+   {
+      const size_t addr = reinterpret_cast<size_t>(&arr[k]);
+      REQUIRE(addr % (simd_t::align_size*sizeof(scalar_t)) == 0);
+   }
+
+   c = e;
+   for (int i = 0; i < S; i++) { REQUIRE(c[i] == e); }
+
+   c = a + b;
+   for (int i = 0; i < S; i++) { REQUIRE(c[i] == a[i] + b[i]); }
+   c = a - b;
+   for (int i = 0; i < S; i++) { REQUIRE(c[i] == a[i] - b[i]); }
+   c = a * b;
+   for (int i = 0; i < S; i++) { REQUIRE(c[i] == a[i] * b[i]); }
+   c = a / b;
+   for (int i = 0; i < S; i++) { REQUIRE(c[i] == a[i] / b[i]); }
+   c = -a;
+   for (int i = 0; i < S; i++) { REQUIRE(c[i] == -a[i]); }
+
+   c = a + e;
+   for (int i = 0; i < S; i++) { REQUIRE(c[i] == a[i] + e); }
+   c = a - e;
+   for (int i = 0; i < S; i++) { REQUIRE(c[i] == a[i] - e); }
+   c = a * e;
+   for (int i = 0; i < S; i++) { REQUIRE(c[i] == a[i] * e); }
+   c = a / e;
+   for (int i = 0; i < S; i++) { REQUIRE(c[i] == a[i] / e); }
+
+   c = e + a;
+   for (int i = 0; i < S; i++) { REQUIRE(c[i] == e + a[i]); }
+   c = e - a;
+   for (int i = 0; i < S; i++) { REQUIRE(c[i] == e - a[i]); }
+   c = e * a;
+   for (int i = 0; i < S; i++) { REQUIRE(c[i] == e * a[i]); }
+   c = e / a;
+   for (int i = 0; i < S; i++) { REQUIRE(c[i] == e / a[i]); }
+
+   c = a;
+   c += b;
+   c *= b;
+   c -= e;
+   c /= b;
+   c += e;
+   c *= e;
+   c -= a;
+   c /= e;
+   for (int i = 0; i < S; i++)
+   {
+      const scalar_t r = ((((a[i] + b[i])*b[i] - e)/b[i] + e)*e - a[i])/e;
+      REQUIRE(c[i] == Approx(r));
+   }
+
+   const int lanes = internal::SIMDSize<simd_t>::value;
+   REQUIRE(lanes == S);
+   for (int i = 0; i < S; i++)
+   {
+      internal::SIMDLane(c, i) = a[i];
+      REQUIRE(c[i] == a[i]);
+   }
+}
+
+// Check the alignment and the size of arrays from AlignedNew().
+template <typename T>
+void CheckAlignedNew(size_t align)
+{
+   for (int n = 0; n <= 17; n++)
+   {
+      T *ptr = AlignedNew<T>(n);
+      REQUIRE(ptr != NULL);
+      REQUIRE(reinterpret_cast<size_t>(ptr) % align == 0);
+      // the whole array is writable
+      char *bytes = reinterpret_cast<char *>(ptr);
+      for (size_t i = 0; i < n*sizeof(T); i++) { bytes[i] = char(i); }
+      for (size_t i = 0; i < n*sizeof(T); i++)
+      {
+         REQUIRE(bytes[i] == char(i));
+      }
+      AlignedDelete(ptr);
+   }
+}
+
+}
+
+TEST_CASE("SIMD value types", "[AutoSIMD]")
+{
+   SECTION("Default width")
+   {
+      typedef AutoSIMDTraits<double,double> traits_t;
+      const int lanes = traits_t::simd_size;
+      REQUIRE(lanes == MFEM_SIMD_SIZE/int(sizeof(double)));
+      simd_test::CheckArithmetic<traits_t::vcomplex_t>();
+   }
+
+   SECTION("Specialized and generic widths")
+   {
+      // the specializations for double are used when the instruction sets are
+      // enabled, the generic implementation otherwise
+      simd_test::CheckArithmetic<AutoSIMD<double,2,2> >();
+      simd_test::CheckArithmetic<AutoSIMD<double,4,4> >();
+      simd_test::CheckArithmetic<AutoSIMD<double,8,8> >();
+      simd_test::CheckArithmetic<AutoSIMD<double,3,4> >();
+      simd_test::CheckArithmetic<AutoSIMD<float,4,4> >();
+   }
+
+   SECTION("Scalar lanes")
+   {
+      double x = 1.0;
+      const int lanes = internal::SIMDSize<double>::value;
+      REQUIRE(lanes == 1);
+      internal::SIMDLane(x, 0) = 2.0;
+      REQUIRE(x == 2.0);
+      typedef NoSIMDTraits<double,double> traits_t;
+      const int no_simd_lanes = traits_t::simd_size;
+      REQUIRE(no_simd_lanes == 1);
+   }
+}
+
+TEST_CASE("Aligned allocation", "[AlignedNew]")
+{
+   const size_t align = (MFEM_SIMD_SIZE > 16) ? MFEM_SIMD_SIZE : 16;
+   simd_test::CheckAlignedNew<char>(align);
+   simd_test::CheckAlignedNew<double>(align);
+   simd_test::CheckAlignedNew<AutoSIMDTraits<double,double>::vcomplex_t>(
+      align);
+
+   // the arrays of SIMD values can be used for SIMD access
+   typedef AutoSIMDTraits<double,double>::vcomplex_t simd_t;
+   const int n = 5;
+   simd_t *v = AlignedNew<simd_t>(n);
+   for (int k = 0; k < n; k++) { v[k] = double(k); }
+   for (int k = 1; k < n; k++) { v[k] += v[k-1]; }
+   for (int i = 0; i < simd_t::size; i++)
+   {
+      REQUIRE(v[n-1][i] == double(n*(n-1)/2));
+   }
+   AlignedDelete(v);
+
+   AlignedDelete<double>(NULL);
+}
@@ -0,0 +1,136 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace sparse_formats
+{
+
+double DiffMult(const Operator &A, const Operator &B, bool transp)
+{
+   const int n = transp ? A.Height() : A.Width();
+   const int m = transp ? A.Width() : A.Height();
+   Vector x(n), y1(m), y2(m);
+   x.Randomize(3);
+   if (transp)
+   {
+      A.MultTranspose(x, y1);
+      B.MultTranspose(x, y2);
+   }
+   else
+   {
+      A.Mult(x, y1);
+      B.Mult(x, y2);
+   }
+   y1 -= y2;
+   return y1.Normlinf()/y2.Normlinf();
+}
+
+TEST_CASE("BSRMatrix", "[BSRMatrix]")
+{
+   Mesh mesh(3, 3, 2, Element::HEXAHEDRON, true);
+   H1_FECollection fec(2, 3);
+   FiniteElementSpace fes(&mesh, &fec, 3, Ordering::byVDIM);
+   BilinearForm a(&fes);
+   ConstantCoefficient lambda(1.0), mu(2.0);
+   a.AddDomainIntegrator(new ElasticityIntegrator(lambda, mu));
+   a.Assemble();
+   a.Finalize();
+   SparseMatrix &S = a.SpMat();
+
+   for (int bs = 1; bs <= 3; bs += 2)
+   {
+      BSRMatrix B(S, bs);
+      REQUIRE(B.GetBlockSize() == bs);
+      REQUIRE(B.Height() == S.Height());
+      REQUIRE(DiffMult(S, B, false) < 1e-14);
+      REQUIRE(DiffMult(S, B, true) < 1e-14);
+   }
+
+   // one block per pair of coupled nodes, i.e. per entry of a scalar matrix
+   BSRMatrix B(S, 3);
+   FiniteElementSpace sfes(&mesh, &fec);
+   BilinearForm m(&sfes);
+   m.AddDomainIntegrator(new MassIntegrator);
+   m.Assemble();
+   m.Finalize();
+   REQUIRE(B.NumBlocks() == m.SpMat().GetI()[m.Height()]);
+
+   // a rectangular matrix with a block size without a specialized kernel
+   SparseMatrix R(10, 15);
+   for (int i = 0; i < 10; i++)
+   {
+      R.Add(i, (3*i) % 15, 1.0 + i);
+      R.Add(i, (7*i + 2) % 15, -0.5*i);
+   }
+   R.Finalize();
+   BSRMatrix BR(R, 5);
+   REQUIRE(DiffMult(R, BR, false) < 1e-14);
+   REQUIRE(DiffMult(R, BR, true) < 1e-14);
+
+   S *= 2.0;
+   B.Update(S);
+   REQUIRE(DiffMult(S, B, false) < 1e-14);
+}
+
+TEST_CASE("SELLMatrix", "[SELLMatrix]")
+{
+   // rows of different lengths: quadratic triangles and a mass term
+   Mesh mesh(5, 4, Element::TRIANGLE, true);
+   H1_FECollection fec(2, 2);
+   FiniteElementSpace fes(&mesh, &fec);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator);
+   a.AddDomainIntegrator(new MassIntegrator);
+   a.Assemble();
+   a.Finalize();
+   SparseMatrix &S = a.SpMat();
+
+   const int chunk_sizes[4] = { 0, 3, 8, 16 };
+   const int windows[3] = { 1, 8, 1000 };
+   for (int i = 0; i < 4; i++)
+   {
+      for (int j = 0; j < 3; j++)
+      {
+         SELLMatrix L(S, chunk_sizes[i], windows[j]);
+         REQUIRE(L.NumStoredEntries() >= S.GetI()[S.Height()]);
+         REQUIRE(DiffMult(S, L, false) < 1e-14);
+         REQUIRE(DiffMult(S, L, true) < 1e-14);
+      }
+   }
+
+   SELLMatrix L(S);
+   REQUIRE(L.GetChunkSize() == SELLMatrix::DefaultChunkSize());
+   SELLMatrix L2(L);
+   REQUIRE(DiffMult(S, L2, false) < 1e-14);
+
+   S *= 0.5;
+   L.Update(S);
+   REQUIRE(DiffMult(S, L, false) < 1e-14);
+
+   SECTION("Use as an Operator")
+   {
+      OperatorHandle A(new SELLMatrix(S));
+      REQUIRE(A.Type() == Operator::ANY_TYPE);
+      Vector b(S.Height()), x(S.Height()), r(S.Height());
+      b.Randomize(5);
+      x = 0.0;
+      CG(*A.Ptr(), b, x, 0, 1000, 1e-24, 0.0);
+      S.Mult(x, r);
+      r -= b;
+      REQUIRE(r.Normlinf() < 1e-10);
+   }
+}
+
+} // namespace sparse_formats
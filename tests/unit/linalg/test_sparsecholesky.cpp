@@ -0,0 +1,121 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace sparse_cholesky
+{
+
+// Relative residual of the solution of A x = b with the solver S.
+double RelativeResidual(const SparseMatrix &A, const Solver &S,
+                        const Vector &b)
+{
+   Vector x(b.Size()), r(b.Size());
+   S.Mult(b, x);
+   A.Mult(x, r);
+   r -= b;
+   return r.Normlinf()/b.Normlinf();
+}
+
+}
+
+TEST_CASE("Sparse Cholesky solver", "[SparseCholeskySolver]")
+{
+   Mesh mesh(6, 6, 6, Element::HEXAHEDRON, true);
+   H1_FECollection fec(2, 3);
+   FiniteElementSpace fes(&mesh, &fec);
+   Array<int> ess_bdr(mesh.bdr_attributes.Max()), ess_tdofs;
+   ess_bdr = 1;
+   fes.GetEssentialTrueDofs(ess_bdr, ess_tdofs);
+
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator);
+   a.Assemble();
+   a.Finalize(0);
+   SparseMatrix A;
+   a.FormSystemMatrix(ess_tdofs, A);
+   const int n = A.Height();
+   Vector b(n);
+   b.Randomize(1);
+
+   SECTION("Cholesky with nested dissection")
+   {
+      SparseCholeskySolver chol(A);
+      REQUIRE(sparse_cholesky::RelativeResidual(A, chol, b) < 1e-10);
+      REQUIRE(chol.GetNumSupernodes() < n/2);
+
+      // the ordering is a permutation
+      Array<int> p(chol.GetPermutation());
+      p.Sort();
+      p.Unique();
+      REQUIRE(p.Size() == n);
+
+      // without the dissection, the factor is much denser
+      SparseCholeskySolver natural;
+      natural.SetLeafSize(n);
+      natural.SetOperator(A);
+      REQUIRE(sparse_cholesky::RelativeResidual(A, natural, b) < 1e-10);
+      REQUIRE(2*chol.GetFactorNNZ() < natural.GetFactorNNZ());
+   }
+
+   SECTION("Numeric refactorization")
+   {
+      SparseCholeskySolver chol(A);
+      const int num_supernodes = chol.GetNumSupernodes();
+
+      // same sparsity pattern, different values
+      BilinearForm m(&fes);
+      ConstantCoefficient ten(10.0);
+      m.AddDomainIntegrator(new DiffusionIntegrator);
+      m.AddDomainIntegrator(new MassIntegrator(ten));
+      m.Assemble();
+      m.Finalize(0);
+      SparseMatrix M;
+      m.FormSystemMatrix(ess_tdofs, M);
+      chol.SetOperator(M);
+      REQUIRE(chol.GetNumSupernodes() == num_supernodes);
+      REQUIRE(sparse_cholesky::RelativeResidual(M, chol, b) < 1e-10);
+   }
+
+   SECTION("LDLt of a quasi-definite matrix")
+   {
+      // K = [A B; B -C] with the mass matrices B and C of the space
+      BilinearForm m(&fes);
+      m.AddDomainIntegrator(new MassIntegrator);
+      m.Assemble();
+      m.Finalize(0);
+      const SparseMatrix &B = m.SpMat();
+      SparseMatrix K(2*n);
+      for (int i = 0; i < n; i++)
+      {
+         for (int p = A.GetI()[i]; p < A.GetI()[i+1]; p++)
+         {
+            K.Add(i, A.GetJ()[p], A.GetData()[p]);
+         }
+         for (int p = B.GetI()[i]; p < B.GetI()[i+1]; p++)
+         {
+            const int j = B.GetJ()[p];
+            K.Add(i, n+j, B.GetData()[p]);
+            K.Add(n+i, j, B.GetData()[p]);
+            K.Add(n+i, n+j, -B.GetData()[p]);
+         }
+      }
+      K.Finalize();
+
+      SparseCholeskySolver ldlt(K, SparseCholeskySolver::LDLT);
+      Vector bk(2*n);
+      bk.Randomize(2);
+      REQUIRE(sparse_cholesky::RelativeResidual(K, ldlt, bk) < 1e-9);
+   }
+}
@@ -0,0 +1,333 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+namespace sparsematrix
+{
+
+// A rectangular matrix with a few pseudo-random entries per row.
+SparseMatrix *RandomSparseMatrix(int m, int n)
+{
+   SparseMatrix *S = new SparseMatrix(m, n);
+   for (int i = 0; i < m; i++)
+   {
+      for (int k = 0; k < 5; k++)
+      {
+         const int j = (7*i + 13*k*k + 3) % n;
+         S->Add(i, j, 1.0 + 0.1*((i + 2*j + k) % 17));
+      }
+   }
+   S->Finalize();
+   return S;
+}
+
+TEST_CASE("SparseMatrix transpose products", "[SparseMatrix]")
+{
+   const int m = 513, n = 301;
+   SparseMatrix *S = RandomSparseMatrix(m, n);
+   SparseMatrix *St = Transpose(*S);
+
+   Vector x(m), y(n), y0(n), z(m), z0(m), ones(n);
+   ones = 1.0;
+   x.Randomize(1);
+
+   // reference result
+   St->Mult(x, y0);
+   y0 *= 2.0;
+   y0 += ones;
+
+   REQUIRE(S->GetMultTransposeMode() == SparseMatrix::TRANSPOSE_SERIAL);
+   const SparseMatrix::MultTransposeMode modes[3] =
+   {
+      SparseMatrix::TRANSPOSE_SERIAL,
+      SparseMatrix::TRANSPOSE_LOCAL,
+      SparseMatrix::TRANSPOSE_CACHED
+   };
+   for (int k = 0; k < 3; k++)
+   {
+      S->SetMultTransposeMode(modes[k]);
+      REQUIRE(S->GetMultTransposeMode() == modes[k]);
+
+      y = 1.0;
+      S->AddMultTranspose(x, y, 2.0);
+      y -= y0;
+      REQUIRE(y.Normlinf() < 1e-12);
+
+      S->MultTranspose(x, y);
+      y *= 2.0;
+      y += ones;
+      y -= y0;
+      REQUIRE(y.Normlinf() < 1e-12);
+   }
+
+   SECTION("Cached transpose reset")
+   {
+      // the methods modifying the matrix delete the cached transpose
+      S->SetMultTransposeMode(SparseMatrix::TRANSPOSE_CACHED);
+      S->EnsureMultTranspose();
+      *S *= 3.0;
+      S->MultTranspose(x, y);
+      y *= 2.0/3.0;
+      y += ones;
+      y -= y0;
+      REQUIRE(y.Normlinf() < 1e-12);
+
+      Vector s(m);
+      s = 1.0/3.0;
+      S->ScaleRows(s);
+      S->MultTranspose(x, y);
+      y *= 2.0;
+      y += ones;
+      y -= y0;
+      REQUIRE(y.Normlinf() < 1e-12);
+   }
+
+   SECTION("Copies")
+   {
+      S->SetMultTransposeMode(SparseMatrix::TRANSPOSE_CACHED);
+      S->EnsureMultTranspose();
+      SparseMatrix C(*S);
+      REQUIRE(C.GetMultTransposeMode() == SparseMatrix::TRANSPOSE_CACHED);
+      C.MultTranspose(x, y);
+      y *= 2.0;
+      y += ones;
+      y -= y0;
+      REQUIRE(y.Normlinf() < 1e-12);
+   }
+
+   SECTION("AddMult and PartMult")
+   {
+      Vector u(n);
+      u.Randomize(2);
+      St->MultTranspose(u, z0);
+
+      z = 1.0;
+      S->AddMult(u, z, -0.5);
+      z -= 1.0;
+      z *= -2.0;
+      z -= z0;
+      REQUIRE(z.Normlinf() < 1e-12);
+
+      Array<int> rows;
+      for (int i = 0; i < m; i += 3) { rows.Append(i); }
+      z = 0.0;
+      S->PartMult(rows, u, z);
+      S->PartAddMult(rows, u, z, 2.0);
+      for (int i = 0; i < m; i++)
+      {
+         REQUIRE(z(i) == Approx((i % 3 == 0) ? 3.0*z0(i) : 0.0));
+      }
+   }
+
+   delete St;
+   delete S;
+}
+
+// Max norm of the difference of two finalized matrices.
+double MaxDiff(const SparseMatrix &A, const SparseMatrix &B)
+{
+   SparseMatrix *D = Add(1.0, A, -1.0, B);
+   const double d = D->MaxNorm();
+   delete D;
+   return d;
+}
+
+TEST_CASE("SparseMatrix COO assembly", "[SparseMatrix]")
+{
+   SECTION("Add and AddSubMatrix")
+   {
+      const int n = 40;
+      SparseMatrix A(n), B(n);
+      B.UseCOOAssembly();
+      REQUIRE(B.UsesCOOAssembly());
+
+      Array<int> dofs(3);
+      DenseMatrix elmat(3);
+      for (int e = 0; e < n - 10; e++)
+      {
+         // signed dofs, as with ND spaces; rows n-10..n-1 stay empty
+         dofs[0] = e;
+         dofs[1] = -1 - (e + 1) % (n - 10);
+         dofs[2] = (3*e + 2) % (n - 10);
+         for (int j = 0; j < 3; j++)
+         {
+            for (int i = 0; i < 3; i++) { elmat(i,j) = 1.0 + i + 2*j + e; }
+         }
+         A.AddSubMatrix(dofs, dofs, elmat);
+         B.AddSubMatrix(dofs, dofs, elmat);
+         A.Add(e, e + 5, 0.5);
+         B.Add(e, e + 5, 0.5);
+      }
+      // entries that cancel out
+      A.Add(1, 2, 1.0); A.Add(1, 2, -1.0);
+      B.Add(1, 2, 1.0); B.Add(1, 2, -1.0);
+
+      A.Finalize(1, true);
+      B.Finalize(1, true);
+      REQUIRE(!B.UsesCOOAssembly());
+      REQUIRE(B.Finalized());
+      REQUIRE(B.areColumnsSorted());
+      REQUIRE(B.NumNonZeroElems() == A.NumNonZeroElems());
+      REQUIRE(B.GetI()[n] == A.GetI()[n]);
+      REQUIRE(MaxDiff(A, B) < 1e-12);
+      for (int i = n - 10; i < n; i++)
+      {
+         REQUIRE(B.RowSize(i) == 1);
+         REQUIRE(B(i, i) == 1.0);
+      }
+
+      SparseMatrix C(n);
+      C.UseCOOAssembly();
+      C.Add(1, 2, 1.0); C.Add(1, 2, -1.0);
+      C.Finalize(0);
+      REQUIRE(C.RowSize(1) == 1);
+      REQUIRE(C(1, 2) == 0.0);
+      REQUIRE(C.RowSize(0) == 0);
+   }
+
+   SECTION("BilinearForm")
+   {
+      Mesh mesh(4, 4, 4, Element::HEXAHEDRON, true);
+      for (int vdim = 1; vdim <= 3; vdim += 2)
+      {
+         H1_FECollection fec(2, 3);
+         FiniteElementSpace fes(&mesh, &fec, vdim);
+         ConstantCoefficient one(1.0);
+
+         BilinearForm a(&fes), b(&fes);
+         if (vdim == 1)
+         {
+            a.AddDomainIntegrator(new DiffusionIntegrator(one));
+            b.AddDomainIntegrator(new DiffusionIntegrator(one));
+            a.AddBoundaryIntegrator(new MassIntegrator(one));
+            b.AddBoundaryIntegrator(new MassIntegrator(one));
+         }
+         else
+         {
+            a.AddDomainIntegrator(new ElasticityIntegrator(one, one));
+            b.AddDomainIntegrator(new ElasticityIntegrator(one, one));
+            a.AddBoundaryIntegrator(new VectorMassIntegrator(one));
+            b.AddBoundaryIntegrator(new VectorMassIntegrator(one));
+         }
+         // the duplicates are summed in the same order in both formats, so
+         // the same entries cancel out
+         b.UseCOOAssembly();
+         a.Assemble();
+         a.Finalize();
+         b.Assemble();
+         REQUIRE(b.SpMat().Finalized());
+         b.Finalize();
+         REQUIRE(b.SpMat().GetI()[fes.GetVSize()] ==
+                 a.SpMat().GetI()[fes.GetVSize()]);
+         REQUIRE(MaxDiff(a.SpMat(), b.SpMat()) < 1e-12);
+
+         // reassembly into the CSR sparsity, keeping the zeros
+         BilinearForm c(&fes);
+         if (vdim == 1) { c.AddDomainIntegrator(new MassIntegrator(one)); }
+         else { c.AddDomainIntegrator(new VectorMassIntegrator(one)); }
+         c.UseCOOAssembly();
+         c.Assemble(0);
+         c.Finalize(0);
+         SparseMatrix M(c.SpMat());
+         c.Assemble(0);
+         c.Finalize(0);
+         SparseMatrix *A2 = Add(2.0, M, 0.0, M);
+         REQUIRE(MaxDiff(*A2, c.SpMat()) < 1e-12);
+         delete A2;
+      }
+   }
+}
+
+TEST_CASE("SparseMatrix products", "[SparseMatrix]")
+{
+   const int m = 301, n = 513;
+   SparseMatrix *A = RandomSparseMatrix(m, n);
+   SparseMatrix *B = RandomSparseMatrix(n, m);
+
+   Vector x(m), y(m), y0(m), t(n);
+   x.Randomize(1);
+
+   SECTION("Mult")
+   {
+      SparseMatrix *AB = Mult(*A, *B);
+      REQUIRE(AB->Height() == m);
+      REQUIRE(AB->Width() == m);
+      B->Mult(x, t);
+      A->Mult(t, y0);
+      AB->Mult(x, y);
+      y -= y0;
+      REQUIRE(y.Normlinf() < 1e-12*y0.Normlinf());
+
+      // no duplicated columns in the rows
+      for (int i = 0; i < m; i++)
+      {
+         // sort a copy: the columns of AB are reused below in their order
+         Array<int> cols;
+         Array<int>(AB->GetRowColumns(i), AB->RowSize(i)).Copy(cols);
+         cols.Sort();
+         cols.Unique();
+         REQUIRE(cols.Size() == AB->RowSize(i));
+      }
+
+      // reuse of the sparsity
+      SparseMatrix AB0(*AB);
+      *A *= 2.0;
+      REQUIRE(Mult(*A, *B, AB) == AB);
+      SparseMatrix *AB2 = Add(2.0, AB0, 0.0, AB0);
+      REQUIRE(MaxDiff(*AB, *AB2) < 1e-12);
+      delete AB2;
+      delete AB;
+   }
+
+   SECTION("RAP")
+   {
+      // B^T An B, computed by the different functions
+      SparseMatrix *An = RandomSparseMatrix(n, n);
+      SparseMatrix *Bt = Transpose(*B);
+      SparseMatrix *BtAnB = RAP(*An, *Bt);
+      SparseMatrix *C = RAP(*B, *An, *B);
+      REQUIRE(MaxDiff(*BtAnB, *C) < 1e-12);
+      SparseMatrix *BtAn = TransposeMult(*B, *An);
+      SparseMatrix *D = Mult(*BtAn, *B);
+      REQUIRE(MaxDiff(*D, *C) < 1e-12);
+
+      SparseRAP rap(*B, *B);
+      SparseMatrix *E = rap.Mult(*An);
+      REQUIRE(MaxDiff(*E, *C) < 1e-12);
+
+      // repeated products with the same sparsity
+      *An *= 3.0;
+      SparseMatrix *F = rap.Mult(*An);
+      rap.Mult(*An, *E);
+      SparseMatrix *C3 = Add(3.0, *C, 0.0, *C);
+      REQUIRE(MaxDiff(*E, *C3) < 1e-12);
+      REQUIRE(MaxDiff(*F, *C3) < 1e-12);
+
+      delete C3;
+      delete F;
+      delete E;
+      delete D;
+      delete BtAn;
+      delete C;
+      delete BtAnB;
+      delete Bt;
+      delete An;
+   }
+
+   delete B;
+   delete A;
+}
+
+} // namespace sparsematrix
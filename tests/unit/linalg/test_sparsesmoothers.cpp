@@ -0,0 +1,223 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+TEST_CASE("Multicolor Gauss-Seidel smoother", "[MulticolorGSSmoother]")
+{
+   Mesh mesh(6, 5, 4, Element::HEXAHEDRON, true);
+   H1_FECollection fec(2, 3);
+   FiniteElementSpace fes(&mesh, &fec);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator);
+   a.AddDomainIntegrator(new MassIntegrator);
+   a.Assemble();
+   a.Finalize();
+   const SparseMatrix &A = a.SpMat();
+   const int n = A.Height();
+
+   MulticolorGSSmoother S(A);
+   const Table &colors = S.GetColoring();
+
+   SECTION("Coloring")
+   {
+      // every row has exactly one color and rows of one color are uncoupled
+      REQUIRE(colors.Size_of_connections() == n);
+      Array<int> color(n);
+      color = -1;
+      int conflicts = 0;
+      for (int c = 0; c < colors.Size(); c++)
+      {
+         for (int l = 0; l < colors.RowSize(c); l++)
+         {
+            if (color[colors.GetRow(c)[l]] != -1) { conflicts++; }
+            color[colors.GetRow(c)[l]] = c;
+         }
+      }
+      for (int i = 0; i < n; i++)
+      {
+         for (int k = A.GetI()[i]; k < A.GetI()[i+1]; k++)
+         {
+            const int j = A.GetJ()[k];
+            if (j != i && color[i] == color[j]) { conflicts++; }
+         }
+      }
+      REQUIRE(conflicts == 0);
+      // a Q2 stencil spans 5x5x5 nodes, so a few tens of colors are expected
+      REQUIRE(S.GetNumColors() < 64);
+   }
+
+   SECTION("Smoothing iterations")
+   {
+      // a mass dominated matrix, for which the iterations converge quickly
+      BilinearForm m(&fes);
+      ConstantCoefficient eps(0.01);
+      m.AddDomainIntegrator(new DiffusionIntegrator(eps));
+      m.AddDomainIntegrator(new MassIntegrator);
+      m.Assemble();
+      m.Finalize();
+      const SparseMatrix &M = m.SpMat();
+
+      Vector b(n), x(n), r(n);
+      b.Randomize(1);
+      for (int t = 0; t < 3; t++)
+      {
+         MulticolorGSSmoother St(t, 200);
+         St.SetOperator(M);
+         St.Mult(b, x);
+         M.Mult(x, r);
+         r -= b;
+         REQUIRE(r.Normlinf() < 1e-8*b.Normlinf());
+      }
+      MulticolorGSSmoother Sw(M, 1, 200, 1.2);
+      Sw.Mult(b, x);
+      M.Mult(x, r);
+      r -= b;
+      REQUIRE(r.Normlinf() < 1e-8*b.Normlinf());
+   }
+
+   SECTION("Symmetric preconditioner")
+   {
+      Vector u(n), v(n), Su(n), Sv(n);
+      u.Randomize(2);
+      v.Randomize(3);
+      S.Mult(u, Su);
+      S.Mult(v, Sv);
+      REQUIRE(fabs((Su*v) - (Sv*u)) < 1e-12*fabs(Su*v));
+
+      Vector b(n), x(n);
+      b.Randomize(4);
+      x = 0.0;
+      CGSolver cg;
+      cg.SetOperator(A);
+      cg.SetPreconditioner(S);
+      cg.SetRelTol(1e-10);
+      cg.SetMaxIter(500);
+      cg.Mult(b, x);
+      REQUIRE(cg.GetConverged());
+   }
+}
+
+TEST_CASE("Incomplete factorization smoothers", "[ILUSmoother][ICSmoother]")
+{
+   Mesh mesh(8, 8, 8, Element::HEXAHEDRON, true);
+   H1_FECollection fec(1, 3);
+   FiniteElementSpace fes(&mesh, &fec);
+   BilinearForm a(&fes);
+   a.AddDomainIntegrator(new DiffusionIntegrator);
+   a.AddDomainIntegrator(new MassIntegrator);
+   a.Assemble();
+   a.Finalize();
+   const SparseMatrix &A = a.SpMat();
+   const int n = A.Height();
+
+   SECTION("Exact for tridiagonal matrices")
+   {
+      // there is no fill-in, so the incomplete factors are exact
+      const int m = 100;
+      SparseMatrix T(m);
+      for (int i = 0; i < m; i++)
+      {
+         T.Add(i, i, 4.0);
+         if (i > 0) { T.Add(i, i-1, -1.0); }
+         if (i < m-1) { T.Add(i, i+1, -2.0); }
+      }
+      T.Finalize();
+      Vector b(m), x(m), r(m);
+      b.Randomize(1);
+      ILUSmoother ilu(T);
+      REQUIRE(ilu.GetNumLevels() == m);
+      ilu.Mult(b, x);
+      T.Mult(x, r);
+      r -= b;
+      REQUIRE(r.Normlinf() < 1e-12*b.Normlinf());
+   }
+
+   SECTION("ILU(0) preconditioner")
+   {
+      ILUSmoother ilu(A);
+      // the levels are wavefronts through the 9x9x9 grid of vertices
+      REQUIRE(ilu.GetNumLevels() > 1);
+      REQUIRE(ilu.GetNumLevels() < n/10);
+
+      Vector b(n), x(n);
+      b.Randomize(2);
+      int its[2];
+      for (int p = 0; p < 2; p++)
+      {
+         x = 0.0;
+         GMRESSolver gmres;
+         gmres.SetOperator(A);
+         if (p) { gmres.SetPreconditioner(ilu); }
+         gmres.SetRelTol(1e-10);
+         gmres.SetKDim(50);
+         gmres.SetMaxIter(500);
+         gmres.Mult(b, x);
+         REQUIRE(gmres.GetConverged());
+         its[p] = gmres.GetNumIterations();
+      }
+      REQUIRE(its[1] < its[0]/2);
+   }
+
+   SECTION("IC(0) preconditioner")
+   {
+      ICSmoother ic(A);
+      Vector u(n), v(n), Su(n), Sv(n);
+      u.Randomize(3);
+      v.Randomize(4);
+      ic.Mult(u, Su);
+      ic.Mult(v, Sv);
+      REQUIRE(fabs((Su*v) - (Sv*u)) < 1e-12*fabs(Su*v));
+
+      Vector b(n), x(n);
+      b.Randomize(5);
+      int its[2];
+      for (int p = 0; p < 2; p++)
+      {
+         x = 0.0;
+         CGSolver cg;
+         cg.SetOperator(A);
+         if (p) { cg.SetPreconditioner(ic); }
+         cg.SetRelTol(1e-10);
+         cg.SetMaxIter(500);
+         cg.Mult(b, x);
+         REQUIRE(cg.GetConverged());
+         its[p] = cg.GetNumIterations();
+      }
+      REQUIRE(its[1] < its[0]/2);
+   }
+
+   SECTION("Iterative mode")
+   {
+      // the iterations y <- y + (LU)^{-1} (b - A y) converge quickly for a
+      // mass dominated matrix
+      BilinearForm m(&fes);
+      ConstantCoefficient eps(0.01);
+      m.AddDomainIntegrator(new DiffusionIntegrator(eps));
+      m.AddDomainIntegrator(new MassIntegrator);
+      m.Assemble();
+      m.Finalize();
+      const SparseMatrix &M = m.SpMat();
+
+      ILUSmoother ilu(M);
+      ilu.iterative_mode = true;
+      Vector b(n), x(n), r(n);
+      b.Randomize(6);
+      x = 0.0;
+      for (int it = 0; it < 20; it++) { ilu.Mult(b, x); }
+      M.Mult(x, r);
+      r -= b;
+      REQUIRE(r.Normlinf() < 1e-8*b.Normlinf());
+   }
+}
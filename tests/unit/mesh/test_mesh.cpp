@@ -95,3 +95,234 @@ TEST_CASE("Gecko integration in MFEM", "[Mesh]")
 }
 
 #endif
+
+TEST_CASE("Element bounding volume hierarchy", "[Mesh]")
+{
+   Mesh mesh(4, 5, 3, Element::HEXAHEDRON, false, 1.0, 2.0, 3.0);
+   mesh.SetCurvature(2);
+
+   const BoundingVolumeHierarchy &bvh = mesh.GetElementBVH();
+   REQUIRE(bvh.GetNumBoxes() == mesh.GetNE());
+   REQUIRE(bvh.GetDepth() > 1);
+
+   SECTION("Point queries return the containing element")
+   {
+      Vector c(3), bmin, bmax;
+      Array<int> boxes;
+      for (int i = 0; i < mesh.GetNE(); i++)
+      {
+         mesh.GetElementTransformation(i)->Transform(
+            Geometries.GetCenter(Geometry::CUBE), c);
+         boxes.SetSize(0);
+         bvh.FindPoint(c.GetData(), boxes);
+         REQUIRE(boxes.Find(i) >= 0);
+         for (int j = 0; j < boxes.Size(); j++)
+         {
+            mesh.GetElementBoundingBox(boxes[j], bmin, bmax);
+            for (int d = 0; d < 3; d++)
+            {
+               REQUIRE(c(d) >= bmin(d));
+               REQUIRE(c(d) <= bmax(d));
+            }
+         }
+      }
+   }
+
+   SECTION("FindPoints agrees with the brute-force search")
+   {
+      const int npts = 50;
+      DenseMatrix points(3, npts);
+      for (int k = 0; k < npts; k++)
+      {
+         points(0, k) = 1.1*((k*7) % npts)/npts - 0.05;
+         points(1, k) = 2.1*((k*11) % npts)/npts - 0.05;
+         points(2, k) = 3.0*((k*13) % npts + 0.5)/npts;
+      }
+      Array<int> bvh_ids, bf_ids;
+      Array<IntegrationPoint> bvh_ips, bf_ips;
+      int bvh_found = mesh.FindPoints(points, bvh_ids, bvh_ips, false);
+      mesh.SetFindPointsBVH(false);
+      int bf_found = mesh.FindPoints(points, bf_ids, bf_ips, false);
+      REQUIRE(bvh_found == bf_found);
+      for (int k = 0; k < npts; k++)
+      {
+         REQUIRE((bvh_ids[k] >= 0) == (bf_ids[k] >= 0));
+      }
+   }
+
+   SECTION("The hierarchy is rebuilt when the nodes move")
+   {
+      Vector disp(mesh.GetNodes()->Size());
+      disp = 10.0;
+      mesh.MoveNodes(disp);
+      Vector bmin, bmax;
+      mesh.GetElementBVH().GetBoundingBox(bmin, bmax);
+      REQUIRE(bmin.Min() > 9.0);
+   }
+}
+
+static void wavy_nodes(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.15*sin(2.0*M_PI*x(1));
+   y(1) += 0.15*sin(2.0*M_PI*x(0));
+}
+
+TEST_CASE("Bounding boxes of curved elements", "[Mesh]")
+{
+   for (int simplex = 0; simplex <= 1; simplex++)
+   {
+      Mesh mesh(2, 2, simplex ? Element::TRIANGLE : Element::QUADRILATERAL,
+                false, 1.0, 1.0);
+      mesh.SetCurvature(3);
+      mesh.Transform(wavy_nodes);
+
+      // The element boxes contain the whole elements, not only the nodes.
+      const int n = 12;
+      Vector x(2), bmin, bmax;
+      DenseMatrix points(2, n*n*mesh.GetNE());
+      int npts = 0;
+      for (int i = 0; i < mesh.GetNE(); i++)
+      {
+         REQUIRE(mesh.GetElementBoundingBox(i, bmin, bmax));
+         ElementTransformation &T = *mesh.GetElementTransformation(i);
+         for (int k = 0; k < n*n; k++)
+         {
+            IntegrationPoint ip;
+            ip.Set2((k%n + 0.5)/n, (k/n + 0.5)/n);
+            if (simplex && ip.x + ip.y > 1.0 - 0.5/n) { continue; }
+            T.Transform(ip, x);
+            for (int d = 0; d < 2; d++)
+            {
+               REQUIRE(x(d) >= bmin(d));
+               REQUIRE(x(d) <= bmax(d));
+            }
+            points.SetCol(npts++, x);
+         }
+      }
+
+      // All the points are found with the hierarchy.
+      DenseMatrix found_points(points.Data(), 2, npts);
+      Array<int> ids;
+      Array<IntegrationPoint> ips;
+      REQUIRE(mesh.FindPoints(found_points, ids, ips, false) == npts);
+   }
+}
+
+static void perturbed_hex_nodes(const Vector &x, Vector &y)
+{
+   y = x;
+   y(0) += 0.05*sin(3.0*x(1))*x(2);
+   y(1) += 0.05*cos(2.0*x(0));
+   y(2) += 0.1*x(0)*x(1);
+}
+
+TEST_CASE("Geometric factors cache", "[Mesh]")
+{
+   Mesh mesh(2, 3, 2, Element::HEXAHEDRON, false, 1.0, 1.0, 1.0);
+   mesh.SetCurvature(2);
+   mesh.Transform(perturbed_hex_nodes);
+
+   const IntegrationRule &ir = IntRules.Get(Geometry::CUBE, 5);
+   const int flags = GeometricFactors::JACOBIANS |
+                     GeometricFactors::DETERMINANTS |
+                     GeometricFactors::INVERSES;
+
+   SECTION("The factors match the element transformations")
+   {
+      const GeometricFactors *gf = mesh.GetGeometricFactors(ir, flags);
+      REQUIRE(gf->NE == mesh.GetNE());
+      REQUIRE(gf->NQ == ir.GetNPoints());
+      IsoparametricTransformation T;
+      DenseMatrix J, iJ;
+      for (int e = 0; e < mesh.GetNE(); e++)
+      {
+         mesh.GetElementTransformation(e, &T);
+         for (int q = 0; q < ir.GetNPoints(); q++)
+         {
+            T.SetIntPoint(&ir.IntPoint(q));
+            gf->GetJacobian(e, q, J);
+            gf->GetInverseJacobian(e, q, iJ);
+            J -= T.Jacobian();
+            iJ -= T.InverseJacobian();
+            REQUIRE(J.MaxMaxNorm() == Approx(0.0));
+            REQUIRE(iJ.MaxMaxNorm() == Approx(0.0));
+            REQUIRE(gf->GetWeight(e, q) == Approx(T.Weight()));
+         }
+      }
+   }
+
+   SECTION("The factors are reused for equal rules")
+   {
+      const GeometricFactors *gf =
+         mesh.GetGeometricFactors(ir, GeometricFactors::DETERMINANTS);
+      IntegrationRule ir_copy(ir);
+      REQUIRE(mesh.GetGeometricFactors(ir_copy, flags) == gf);
+      REQUIRE(gf->computed_factors == flags);
+      REQUIRE(mesh.GetGeometricFactors(IntRules.Get(Geometry::CUBE, 3),
+                                       flags) != gf);
+   }
+
+   SECTION("The integrators give the same results with the cache")
+   {
+      H1_FECollection fec(2, 3);
+      FiniteElementSpace fes(&mesh, &fec);
+      ConstantCoefficient one(1.0);
+      DenseMatrix m1, m2, d1, d2;
+      MassIntegrator mass(one);
+      DiffusionIntegrator diff(one);
+      const int e = mesh.GetNE()/2;
+      mass.AssembleElementMatrix(*fes.GetFE(e),
+                                 *fes.GetElementTransformation(e), m1);
+      diff.AssembleElementMatrix(*fes.GetFE(e),
+                                 *fes.GetElementTransformation(e), d1);
+      mesh.SetGeometricFactorsCaching(true);
+      mass.AssembleElementMatrix(*fes.GetFE(e),
+                                 *fes.GetElementTransformation(e), m2);
+      diff.AssembleElementMatrix(*fes.GetFE(e),
+                                 *fes.GetElementTransformation(e), d2);
+      m2 -= m1;
+      d2 -= d1;
+      REQUIRE(m2.MaxMaxNorm() < 1e-12*m1.MaxMaxNorm());
+      REQUIRE(d2.MaxMaxNorm() < 1e-12*d1.MaxMaxNorm());
+   }
+
+   SECTION("The cache is invalidated when the nodes move")
+   {
+      mesh.SetGeometricFactorsCaching(true);
+      H1_FECollection fec(1, 3);
+      FiniteElementSpace fes(&mesh, &fec);
+      GridFunction x(&fes);
+      x = 0.0;
+      ConstantCoefficient one(1.0);
+      const double vol = x.ComputeL2Error(one);
+      Vector disp(mesh.GetNodes()->Size());
+      disp = *mesh.GetNodes();
+      mesh.MoveNodes(disp); // scale the mesh by 2
+      REQUIRE(x.ComputeL2Error(one) == Approx(sqrt(8.0)*vol));
+   }
+
+   SECTION("The cache is checked against nodes modified directly")
+   {
+      mesh.SetGeometricFactorsCaching(true);
+      H1_FECollection fec(1, 3);
+      FiniteElementSpace fes(&mesh, &fec);
+      GridFunction x(&fes);
+      x = 0.0;
+      ConstantCoefficient one(1.0);
+      const double vol = x.ComputeL2Error(one);
+      const GeometricFactors *gf = mesh.GetGeometricFactors(
+                                      ir, GeometricFactors::DETERMINANTS);
+      REQUIRE(mesh.GetGeometricFactors(ir, GeometricFactors::DETERMINANTS) ==
+              gf);
+      *mesh.GetNodes() *= 2.0; // without NodesUpdated()
+      REQUIRE(x.ComputeL2Error(one) == Approx(sqrt(8.0)*vol));
+      // the factors of the rule are recomputed on the next request
+      const double w = mesh.GetGeometricFactors(
+                          ir, GeometricFactors::DETERMINANTS)->GetWeight(0, 0);
+      IsoparametricTransformation T;
+      mesh.GetElementTransformation(0, &T);
+      T.SetIntPoint(&ir.IntPoint(0));
+      REQUIRE(w == Approx(T.Weight()));
+   }
+}
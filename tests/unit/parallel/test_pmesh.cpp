@@ -0,0 +1,91 @@
+// Copyright (c) 2010, Lawrence Livermore National Security, LLC. Produced at
+// the Lawrence Livermore National Laboratory. LLNL-CODE-443211. All Rights
+// reserved. See file COPYRIGHT for details.
+//
+// This file is part of the MFEM library. For more information and source code
+// availability see http://mfem.org.
+//
+// MFEM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License (as published by the Free
+// Software Foundation) version 2.1 dated February 1999.
+
+#include "mfem.hpp"
+#include "catch.hpp"
+
+using namespace mfem;
+
+TEST_CASE("Distributed point location", "[ParMesh][Parallel]")
+{
+   int num_procs, myid;
+   MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
+   MPI_Comm_rank(MPI_COMM_WORLD, &myid);
+
+   Mesh mesh(6, 5, 4, Element::HEXAHEDRON, false, 1.0, 1.0, 1.0);
+   mesh.SetCurvature(2);
+   int *partitioning = mesh.GeneratePartitioning(num_procs);
+   ParMesh pmesh(MPI_COMM_WORLD, mesh, partitioning);
+
+   // The global index of the local element l of rank r is glob_elem[r][l]; the
+   // ParMesh keeps the order of the serial elements.
+   Array<Array<int> *> glob_elem(num_procs);
+   for (int r = 0; r < num_procs; r++) { glob_elem[r] = new Array<int>; }
+   for (int i = 0; i < mesh.GetNE(); i++)
+   {
+      glob_elem[partitioning[i]]->Append(i);
+   }
+
+   // The results are checked on every rank and reduced before the REQUIRE: a
+   // REQUIRE failing on one rank between the collective calls would leave the
+   // other ranks waiting.
+   bool ok = (glob_elem[myid]->Size() == pmesh.GetNE());
+
+   // Every rank asks for points scattered over the whole domain, most of them
+   // in the elements of other ranks, and for one point outside of the domain.
+   const int npts = 40;
+   DenseMatrix points(3, npts + 1);
+   for (int k = 0; k < npts; k++)
+   {
+      const int j = k + myid*npts;
+      points(0, k) = ((j*7) % 97 + 0.5)/97;
+      points(1, k) = ((j*11) % 89 + 0.5)/89;
+      points(2, k) = ((j*13) % 83 + 0.5)/83;
+   }
+   points(0, npts) = points(1, npts) = points(2, npts) = 2.0;
+
+   Array<int> proc_ids, elem_ids;
+   Array<IntegrationPoint> ips;
+   const int found = pmesh.FindPointsDistributed(points, proc_ids, elem_ids,
+                                                 ips, false);
+   ok = ok && (found == npts);
+   ok = ok && (proc_ids.Size() == npts + 1) && (elem_ids.Size() == npts + 1);
+   ok = ok && (proc_ids[npts] == -1) && (elem_ids[npts] == -1);
+
+   // The element and the reference point map to the point on the serial mesh.
+   Vector x(3);
+   for (int k = 0; ok && k < npts; k++)
+   {
+      ok = (proc_ids[k] >= 0 && proc_ids[k] < num_procs &&
+            elem_ids[k] >= 0 && elem_ids[k] < glob_elem[proc_ids[k]]->Size());
+      if (!ok) { break; }
+      const int e = (*glob_elem[proc_ids[k]])[elem_ids[k]];
+      mesh.GetElementTransformation(e)->Transform(ips[k], x);
+      for (int d = 0; d < 3; d++)
+      {
+         ok = ok && (fabs(x(d) - points(d, k)) < 1e-10);
+      }
+   }
+
+   // A rank without points still takes part in the collective search.
+   DenseMatrix no_points(3, 0);
+   const int found_2 =
+      pmesh.FindPointsDistributed((myid == 0) ? no_points : points, proc_ids,
+                                  elem_ids, ips, false);
+   ok = ok && (found_2 == ((myid == 0) ? 0 : npts));
+
+   int loc_ok = ok, glob_ok = 0;
+   MPI_Allreduce(&loc_ok, &glob_ok, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+   REQUIRE(glob_ok == 1);
+
+   for (int r = 0; r < num_procs; r++) { delete glob_elem[r]; }
+   delete [] partitioning;
+}